@@ -0,0 +1,8 @@
+#include "header.h"
+
+// comment in source file
+#define SOURCE_MACRO 1
+
+class Source
+{
+};
@@ -0,0 +1,8 @@
+#include "nested.h"
+
+// comment in skipped header
+#define HEADER_MACRO 1
+
+class Header
+{
+};
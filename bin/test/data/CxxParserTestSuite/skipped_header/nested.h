@@ -0,0 +1,3 @@
+class Nested
+{
+};
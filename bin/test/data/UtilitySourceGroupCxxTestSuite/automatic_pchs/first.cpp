@@ -0,0 +1,5 @@
+#include <vector>
+#include "common.h"
+#include "first.h"
+
+void first() {}
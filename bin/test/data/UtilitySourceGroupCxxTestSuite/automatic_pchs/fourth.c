@@ -0,0 +1,4 @@
+#include <stdio.h>
+#include "common.h"
+
+void fourth() {}
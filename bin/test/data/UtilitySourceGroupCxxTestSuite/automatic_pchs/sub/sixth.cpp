@@ -0,0 +1,4 @@
+#include <vector>
+#include "common.h"
+
+void sixth() {}
@@ -0,0 +1,17 @@
+// file comment
+/* block comment
+   spanning lines */
+
+#include <vector>
+/* inline comment */ #include "a.h"
+#include "b.h" // trailing comment
+  #  include <c.h>
+
+#include "d.h"
+
+int main()
+{
+	return 0;
+}
+
+#include "e.h"
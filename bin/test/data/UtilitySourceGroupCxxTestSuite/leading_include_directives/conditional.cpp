@@ -0,0 +1,5 @@
+#include <vector>
+#if defined(FOO)
+#	include "a.h"
+#endif
+#include "b.h"
@@ -0,0 +1,3 @@
+#include <vector>
+#include HEADER
+#include "a.h"
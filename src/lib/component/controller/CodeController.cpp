@@ -18,7 +18,10 @@
 #include "utility.h"
 #include "utilityString.h"
 
-CodeController::CodeController(StorageAccess* storageAccess): m_storageAccess(storageAccess) {}
+CodeController::CodeController(StorageAccess* storageAccess)
+	: m_storageAccess(storageAccess), m_fullTextSearchGeneration(0)
+{
+}
 
 Id CodeController::getSchedulerId() const
 {
@@ -64,13 +67,62 @@ void CodeController::handleMessage(MessageActivateFullTextSearch* message)
 
 	saveOrRestoreViewMode(message);
 
-	m_collection = m_storageAccess->getFullTextSearchLocations(
-		message->searchTerm, message->caseSensitive);
-
 	CodeView::CodeParams params;
 	params.clearSnippets = true;
 	params.useSingleFileCache = false;
 
+	// in list mode the files are shown one by one while the search is still running
+	const bool showFilesWhileSearching = !message->isReplayed() && getView()->isInListMode();
+
+	// every interrupt starts a new generation, so an interrupt is never lost by another search
+	const size_t fullTextSearchGeneration = m_fullTextSearchGeneration;
+	m_files.clear();
+	clearReferences();
+
+	m_collection = m_storageAccess->getFullTextSearchLocations(
+		message->searchTerm,
+		message->caseSensitive,
+		std::max(0, ApplicationSettings::getInstance()->getCodeFullTextSearchMaxResultCount()),
+		[&](std::shared_ptr<SourceLocationFile> locationFile) {
+			if (m_fullTextSearchGeneration != fullTextSearchGeneration)
+			{
+				return false;
+			}
+
+			if (showFilesWhileSearching)
+			{
+				CodeFileParams file;
+				file.locationFile = locationFile;
+
+				std::vector<FileInfo> fileInfos = m_storageAccess->getFileInfosForFilePaths(
+					{locationFile->getFilePath()});
+				if (fileInfos.size())
+				{
+					file.modificationTime = fileInfos[0].lastWriteTime;
+				}
+
+				m_files.push_back(file);
+				if (m_files.size() <= 3)
+				{
+					setFileState(
+						m_files.back(), MessageChangeFileView::FILE_SNIPPETS, params.useSingleFileCache);
+				}
+
+				getView()->showSnippets({m_files.back()}, params, CodeScrollParams());
+				params.clearSnippets = false;
+			}
+			return true;
+		});
+
+	if (showFilesWhileSearching)
+	{
+		// the shown files stay in place, only the references and navigation state get updated
+		params.clearSnippets = m_files.empty();
+		createReferences();
+		showFiles(params, CodeScrollParams(), true);
+		return;
+	}
+
 	m_files = getFilesForCollection(m_collection);
 	createReferences();
 	expandVisibleFiles(params.useSingleFileCache);
@@ -440,6 +492,11 @@ void CodeController::handleMessage(MessageFocusOut* message)
 	getView()->defocusTokenIds();
 }
 
+void CodeController::handleMessage(MessageInterruptFullTextSearch* message)
+{
+	m_fullTextSearchGeneration++;
+}
+
 void CodeController::handleMessage(MessageScrollToLine* message)
 {
 	getView()->scrollTo(
@@ -1,6 +1,7 @@
 #ifndef CODE_CONTROLLER_H
 #define CODE_CONTROLLER_H
 
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -22,6 +23,7 @@
 #include "MessageFlushUpdates.h"
 #include "MessageFocusIn.h"
 #include "MessageFocusOut.h"
+#include "MessageInterruptFullTextSearch.h"
 #include "MessageListener.h"
 #include "MessageScrollCode.h"
 #include "MessageScrollToLine.h"
@@ -57,6 +59,7 @@ class CodeController
 	, public MessageListener<MessageFlushUpdates>
 	, public MessageListener<MessageFocusIn>
 	, public MessageListener<MessageFocusOut>
+	, public MessageListener<MessageInterruptFullTextSearch>
 	, public MessageListener<MessageScrollCode>
 	, public MessageListener<MessageScrollToLine>
 	, public MessageListener<MessageShowError>
@@ -95,6 +98,7 @@ private:
 	void handleMessage(MessageFlushUpdates* message) override;
 	void handleMessage(MessageFocusIn* message) override;
 	void handleMessage(MessageFocusOut* message) override;
+	void handleMessage(MessageInterruptFullTextSearch* message) override;
 	void handleMessage(MessageScrollCode* message) override;
 	void handleMessage(MessageScrollToLine* message) override;
 	void handleMessage(MessageShowError* message) override;
@@ -168,6 +172,8 @@ private:
 
 	std::vector<Reference> m_localReferences;
 	int m_localReferenceIndex = -1;
+
+	std::atomic<size_t> m_fullTextSearchGeneration;
 };
 
 #endif	  // CODE_CONTROLLER_H
@@ -23,7 +23,7 @@
 #include "utilityString.h"
 
 GraphController::GraphController(StorageAccess* storageAccess)
-	: m_storageAccess(storageAccess), m_useBezierEdges(false)
+	: m_storageAccess(storageAccess), m_useBezierEdges(false), m_trailGeneration(0)
 {
 }
 
@@ -215,6 +215,12 @@ void GraphController::handleMessage(MessageActivateTrail* message)
 
 	m_activeEdgeIds.clear();
 
+	// every interrupt starts a new generation, so an interrupt is never lost by another trail
+	const size_t trailGeneration = m_trailGeneration;
+	auto isInterrupted = [this, trailGeneration]() {
+		return m_trailGeneration != trailGeneration;
+	};
+
 	std::shared_ptr<Graph> graph = m_storageAccess->getGraphForTrail(
 		message->originId,
 		message->targetId,
@@ -222,7 +228,16 @@ void GraphController::handleMessage(MessageActivateTrail* message)
 		message->edgeTypes,
 		message->nodeNonIndexed,
 		message->depth,
-		true /* !message->custom || (message->originId && message->targetId) */);
+		true /* !message->custom || (message->originId && message->targetId) */,
+		ApplicationSettings::getInstance()->getGraphTrailShortestPathsOnly(),
+		std::max(0, ApplicationSettings::getInstance()->getGraphTrailMaxNodeCount()),
+		isInterrupted);
+
+	if (isInterrupted())
+	{
+		MessageStatus(L"Trail search was interrupted.").dispatch();
+		return;
+	}
 
 	// remove non-indexed files from include graph if indexed file is origin
 	if (!message->custom && message->edgeTypes & Edge::EDGE_INCLUDE)
@@ -334,6 +349,11 @@ void GraphController::handleMessage(MessageFlushUpdates* message)
 	buildGraph(message, params);
 }
 
+void GraphController::handleMessage(MessageInterruptTrail* message)
+{
+	m_trailGeneration++;
+}
+
 void GraphController::handleMessage(MessageScrollGraph* message)
 {
 	if (message->isReplayed())
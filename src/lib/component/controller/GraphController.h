@@ -1,6 +1,7 @@
 #ifndef GRAPH_CONTROLLER_H
 #define GRAPH_CONTROLLER_H
 
+#include <atomic>
 #include <list>
 #include <vector>
 
@@ -19,6 +20,7 @@
 #include "MessageGraphNodeExpand.h"
 #include "MessageGraphNodeHide.h"
 #include "MessageGraphNodeMove.h"
+#include "MessageInterruptTrail.h"
 #include "MessageListener.h"
 #include "MessageScrollGraph.h"
 #include "MessageShowReference.h"
@@ -49,6 +51,7 @@ class GraphController
 	, public MessageListener<MessageGraphNodeExpand>
 	, public MessageListener<MessageGraphNodeHide>
 	, public MessageListener<MessageGraphNodeMove>
+	, public MessageListener<MessageInterruptTrail>
 	, public MessageListener<MessageScrollGraph>
 	, public MessageListener<MessageShowReference>
 {
@@ -74,6 +77,7 @@ private:
 	void handleMessage(MessageGraphNodeExpand* message) override;
 	void handleMessage(MessageGraphNodeHide* message) override;
 	void handleMessage(MessageGraphNodeMove* message) override;
+	void handleMessage(MessageInterruptTrail* message) override;
 	void handleMessage(MessageScrollGraph* message) override;
 	void handleMessage(MessageShowReference* message) override;
 
@@ -170,6 +174,8 @@ private:
 
 	bool m_useBezierEdges = false;
 	bool m_showsLegend = false;
+
+	std::atomic<size_t> m_trailGeneration;
 };
 
 #endif	  // GRAPH_CONTROLLER_H
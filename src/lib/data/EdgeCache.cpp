@@ -0,0 +1,409 @@
+#include "EdgeCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FilePath.h"
+#include "logging.h"
+#include "tracing.h"
+
+namespace
+{
+const SidecarFile edgeCacheFile(
+	"edge cache", EdgeCacheFileHeader::MAGIC, EdgeCacheFileHeader::VERSION);
+
+struct AdjacencyData
+{
+	std::vector<uint64_t> nodeIds;
+	std::vector<uint32_t> rangeStarts;
+	std::vector<uint32_t> edgeIndices;
+};
+
+AdjacencyData buildAdjacency(const std::vector<StorageEdge>& edges, bool outgoing)
+{
+	// the edges are sorted by id, so the edges of each node stay sorted by id as well
+	std::vector<std::pair<uint64_t, uint32_t>> nodeEdges;
+	nodeEdges.reserve(edges.size());
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		nodeEdges.emplace_back(
+			outgoing ? edges[i].sourceNodeId : edges[i].targetNodeId, static_cast<uint32_t>(i));
+	}
+	std::sort(nodeEdges.begin(), nodeEdges.end());
+
+	AdjacencyData adjacency;
+	adjacency.edgeIndices.reserve(nodeEdges.size());
+	for (const std::pair<uint64_t, uint32_t>& nodeEdge: nodeEdges)
+	{
+		if (adjacency.nodeIds.empty() || adjacency.nodeIds.back() != nodeEdge.first)
+		{
+			adjacency.nodeIds.push_back(nodeEdge.first);
+			adjacency.rangeStarts.push_back(static_cast<uint32_t>(adjacency.edgeIndices.size()));
+		}
+		adjacency.edgeIndices.push_back(nodeEdge.second);
+	}
+	adjacency.rangeStarts.push_back(static_cast<uint32_t>(adjacency.edgeIndices.size()));
+	return adjacency;
+}
+
+uint64_t appendData(std::vector<char>& buffer, const void* data, size_t size)
+{
+	// keep all arrays 8 byte aligned, so they can be accessed in place when the file is mapped
+	buffer.resize((buffer.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t));
+
+	const uint64_t offset = buffer.size();
+	const char* begin = static_cast<const char*>(data);
+	buffer.insert(buffer.end(), begin, begin + size);
+	return offset;
+}
+
+EdgeCacheFileAdjacency appendAdjacency(std::vector<char>& buffer, const AdjacencyData& adjacency)
+{
+	EdgeCacheFileAdjacency fileAdjacency;
+	fileAdjacency.nodeCount = adjacency.nodeIds.size();
+	fileAdjacency.nodeIdsOffset = appendData(
+		buffer, adjacency.nodeIds.data(), adjacency.nodeIds.size() * sizeof(uint64_t));
+	fileAdjacency.rangeStartsOffset = appendData(
+		buffer, adjacency.rangeStarts.data(), adjacency.rangeStarts.size() * sizeof(uint32_t));
+	fileAdjacency.edgeIndicesOffset = appendData(
+		buffer, adjacency.edgeIndices.data(), adjacency.edgeIndices.size() * sizeof(uint32_t));
+	return fileAdjacency;
+}
+
+bool isInBounds(uint64_t offset, uint64_t count, size_t elementSize, size_t size)
+{
+	return offset <= size && count <= (size - offset) / elementSize;
+}
+
+StorageEdge toStorageEdge(const EdgeCacheFileEdge& edge)
+{
+	return StorageEdge(edge.id, edge.type, edge.sourceNodeId, edge.targetNodeId);
+}
+}	 // namespace
+
+EdgeCache::EdgeCache() {}
+
+EdgeCache::~EdgeCache() {}
+
+void EdgeCache::build(std::vector<StorageEdge> edges)
+{
+	TRACE();
+
+	clear();
+
+	if (edges.size() >= std::numeric_limits<uint32_t>::max())
+	{
+		LOG_ERROR("Too many edges for edge cache.");
+		return;
+	}
+
+	std::sort(edges.begin(), edges.end(), [](const StorageEdge& a, const StorageEdge& b) {
+		return a.id < b.id;
+	});
+
+	std::vector<EdgeCacheFileEdge> fileEdges;
+	fileEdges.reserve(edges.size());
+	for (const StorageEdge& edge: edges)
+	{
+		EdgeCacheFileEdge fileEdge;
+		fileEdge.id = edge.id;
+		fileEdge.sourceNodeId = edge.sourceNodeId;
+		fileEdge.targetNodeId = edge.targetNodeId;
+		fileEdge.type = edge.type;
+		fileEdge.reserved = 0;
+		fileEdges.push_back(fileEdge);
+	}
+
+	EdgeCacheFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	edgeCacheFile.initHeader(&header.sidecar, "");
+	header.edgeCount = fileEdges.size();
+
+	std::vector<char> buffer(sizeof(header));
+	header.edgesOffset = appendData(
+		buffer, fileEdges.data(), fileEdges.size() * sizeof(EdgeCacheFileEdge));
+	header.outgoing = appendAdjacency(buffer, buildAdjacency(edges, true));
+	header.incoming = appendAdjacency(buffer, buildAdjacency(edges, false));
+	std::memcpy(buffer.data(), &header, sizeof(header));
+
+	m_buffer = std::move(buffer);
+	if (!attach(m_buffer.data(), m_buffer.size()))
+	{
+		clear();
+	}
+}
+
+bool EdgeCache::load(const FilePath& filePath, const std::string& storageTime)
+{
+	TRACE();
+
+	clear();
+
+	std::unique_ptr<boost::interprocess::file_mapping> mapping;
+	std::unique_ptr<boost::interprocess::mapped_region> region;
+	if (!edgeCacheFile.map(filePath, sizeof(EdgeCacheFileHeader), &mapping, &region))
+	{
+		return false;
+	}
+
+	const char* data = static_cast<const char*>(region->get_address());
+	const size_t size = region->get_size();
+
+	EdgeCacheFileHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (!edgeCacheFile.checkHeader(&header.sidecar, storageTime))
+	{
+		return false;
+	}
+
+	if (!attach(data, size))
+	{
+		LOG_WARNING("Edge cache file is corrupted.");
+		clear();
+		return false;
+	}
+
+	m_mapping = std::move(mapping);
+	m_region = std::move(region);
+	return true;
+}
+
+bool EdgeCache::save(const FilePath& filePath, const std::string& storageTime) const
+{
+	TRACE();
+
+	if (!m_data)
+	{
+		return false;
+	}
+
+	EdgeCacheFileHeader header;
+	std::memcpy(&header, m_data, sizeof(header));
+	if (!edgeCacheFile.initHeader(&header.sidecar, storageTime))
+	{
+		return false;
+	}
+
+	return edgeCacheFile.write(filePath, [&](std::ostream& stream) {
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(m_data + sizeof(header), m_size - sizeof(header));
+		return true;
+	});
+}
+
+bool EdgeCache::isBuilt() const
+{
+	return m_data != nullptr;
+}
+
+size_t EdgeCache::getEdgeCount() const
+{
+	return m_edgeCount;
+}
+
+bool EdgeCache::isEdge(Id edgeId) const
+{
+	return findEdge(edgeId) != nullptr;
+}
+
+StorageEdge EdgeCache::getEdgeById(Id edgeId) const
+{
+	if (const EdgeCacheFileEdge* edge = findEdge(edgeId))
+	{
+		return toStorageEdge(*edge);
+	}
+	return StorageEdge();
+}
+
+std::vector<StorageEdge> EdgeCache::getEdgesByIds(const std::vector<Id>& edgeIds) const
+{
+	std::vector<Id> sortedEdgeIds = edgeIds;
+	std::sort(sortedEdgeIds.begin(), sortedEdgeIds.end());
+	sortedEdgeIds.erase(
+		std::unique(sortedEdgeIds.begin(), sortedEdgeIds.end()), sortedEdgeIds.end());
+
+	std::vector<StorageEdge> edges;
+	for (Id edgeId: sortedEdgeIds)
+	{
+		if (const EdgeCacheFileEdge* edge = findEdge(edgeId))
+		{
+			edges.push_back(toStorageEdge(*edge));
+		}
+	}
+	return edges;
+}
+
+std::vector<StorageEdge> EdgeCache::getEdgesBySourceId(Id sourceId) const
+{
+	std::vector<StorageEdge> edges;
+	addEdgesOfNode(m_outgoing, sourceId, edges);
+	return edges;
+}
+
+std::vector<StorageEdge> EdgeCache::getEdgesBySourceIds(const std::vector<Id>& sourceIds) const
+{
+	return getEdgesOfNodes(m_outgoing, sourceIds);
+}
+
+std::vector<StorageEdge> EdgeCache::getEdgesByTargetId(Id targetId) const
+{
+	std::vector<StorageEdge> edges;
+	addEdgesOfNode(m_incoming, targetId, edges);
+	return edges;
+}
+
+std::vector<StorageEdge> EdgeCache::getEdgesByTargetIds(const std::vector<Id>& targetIds) const
+{
+	return getEdgesOfNodes(m_incoming, targetIds);
+}
+
+std::vector<StorageEdge> EdgeCache::getEdgesBySourceOrTargetId(Id id) const
+{
+	std::vector<StorageEdge> edges;
+	addEdgesOfNode(m_outgoing, id, edges);
+	addEdgesOfNode(m_incoming, id, edges);
+
+	// edges from a node to itself are part of both lists
+	std::sort(edges.begin(), edges.end(), [](const StorageEdge& a, const StorageEdge& b) {
+		return a.id < b.id;
+	});
+	edges.erase(
+		std::unique(
+			edges.begin(),
+			edges.end(),
+			[](const StorageEdge& a, const StorageEdge& b) { return a.id == b.id; }),
+		edges.end());
+	return edges;
+}
+
+void EdgeCache::clear()
+{
+	m_buffer.clear();
+	m_buffer.shrink_to_fit();
+	m_region.reset();
+	m_mapping.reset();
+
+	m_data = nullptr;
+	m_size = 0;
+	m_edges = nullptr;
+	m_edgeCount = 0;
+	m_outgoing = Adjacency();
+	m_incoming = Adjacency();
+}
+
+bool EdgeCache::attach(const char* data, size_t size)
+{
+	if (size < sizeof(EdgeCacheFileHeader))
+	{
+		return false;
+	}
+
+	EdgeCacheFileHeader header;
+	std::memcpy(&header, data, sizeof(header));
+
+	if (header.sidecar.magic != EdgeCacheFileHeader::MAGIC ||
+		header.sidecar.version != EdgeCacheFileHeader::VERSION ||
+		header.edgeCount >= std::numeric_limits<uint32_t>::max() ||
+		!isInBounds(header.edgesOffset, header.edgeCount, sizeof(EdgeCacheFileEdge), size))
+	{
+		return false;
+	}
+
+	m_edgeCount = header.edgeCount;
+
+	Adjacency outgoing;
+	Adjacency incoming;
+	if (!attachAdjacency(header.outgoing, data, size, outgoing) ||
+		!attachAdjacency(header.incoming, data, size, incoming))
+	{
+		m_edgeCount = 0;
+		return false;
+	}
+
+	m_data = data;
+	m_size = size;
+	m_edges = reinterpret_cast<const EdgeCacheFileEdge*>(data + header.edgesOffset);
+	m_outgoing = outgoing;
+	m_incoming = incoming;
+	return true;
+}
+
+bool EdgeCache::attachAdjacency(
+	const EdgeCacheFileAdjacency& fileAdjacency,
+	const char* data,
+	size_t size,
+	Adjacency& adjacency) const
+{
+	if (!isInBounds(fileAdjacency.nodeIdsOffset, fileAdjacency.nodeCount, sizeof(uint64_t), size) ||
+		!isInBounds(
+			fileAdjacency.rangeStartsOffset, fileAdjacency.nodeCount + 1, sizeof(uint32_t), size) ||
+		!isInBounds(fileAdjacency.edgeIndicesOffset, m_edgeCount, sizeof(uint32_t), size))
+	{
+		return false;
+	}
+
+	adjacency.nodeIds = reinterpret_cast<const uint64_t*>(data + fileAdjacency.nodeIdsOffset);
+	adjacency.rangeStarts = reinterpret_cast<const uint32_t*>(
+		data + fileAdjacency.rangeStartsOffset);
+	adjacency.edgeIndices = reinterpret_cast<const uint32_t*>(
+		data + fileAdjacency.edgeIndicesOffset);
+	adjacency.nodeCount = fileAdjacency.nodeCount;
+
+	return adjacency.rangeStarts[adjacency.nodeCount] == m_edgeCount;
+}
+
+const EdgeCacheFileEdge* EdgeCache::findEdge(Id edgeId) const
+{
+	const EdgeCacheFileEdge* end = m_edges + m_edgeCount;
+	const EdgeCacheFileEdge* it = std::lower_bound(
+		m_edges, end, edgeId, [](const EdgeCacheFileEdge& edge, Id id) { return edge.id < id; });
+
+	if (it != end && it->id == edgeId)
+	{
+		return it;
+	}
+	return nullptr;
+}
+
+void EdgeCache::addEdgesOfNode(
+	const Adjacency& adjacency, Id nodeId, std::vector<StorageEdge>& edges) const
+{
+	const uint64_t* end = adjacency.nodeIds + adjacency.nodeCount;
+	const uint64_t* it = std::lower_bound(adjacency.nodeIds, end, uint64_t(nodeId));
+	if (it == end || *it != nodeId)
+	{
+		return;
+	}
+
+	const size_t nodeIndex = it - adjacency.nodeIds;
+	const uint32_t rangeEnd = std::min<uint32_t>(
+		adjacency.rangeStarts[nodeIndex + 1], static_cast<uint32_t>(m_edgeCount));
+	for (uint32_t i = adjacency.rangeStarts[nodeIndex]; i < rangeEnd; i++)
+	{
+		const uint32_t edgeIndex = adjacency.edgeIndices[i];
+		if (edgeIndex < m_edgeCount)
+		{
+			edges.push_back(toStorageEdge(m_edges[edgeIndex]));
+		}
+	}
+}
+
+std::vector<StorageEdge> EdgeCache::getEdgesOfNodes(
+	const Adjacency& adjacency, const std::vector<Id>& nodeIds) const
+{
+	std::vector<Id> sortedNodeIds = nodeIds;
+	std::sort(sortedNodeIds.begin(), sortedNodeIds.end());
+	sortedNodeIds.erase(
+		std::unique(sortedNodeIds.begin(), sortedNodeIds.end()), sortedNodeIds.end());
+
+	std::vector<StorageEdge> edges;
+	for (Id nodeId: sortedNodeIds)
+	{
+		addEdgesOfNode(adjacency, nodeId, edges);
+	}
+	return edges;
+}
@@ -0,0 +1,91 @@
+#ifndef EDGE_CACHE_H
+#define EDGE_CACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EdgeCacheFile.h"
+#include "StorageEdge.h"
+#include "types.h"
+
+namespace boost
+{
+namespace interprocess
+{
+class file_mapping;
+class mapped_region;
+}	 // namespace interprocess
+}	 // namespace boost
+
+class FilePath;
+
+// Keeps all edges of the storage in compressed sparse row format, so the graph, trail and tooltip
+// queries can look up the edges of a node without running a database query for each click. The
+// cache is either built from the edges of the storage or memory-mapped from the file written by
+// save.
+class EdgeCache
+{
+public:
+	EdgeCache();
+	~EdgeCache();
+
+	void build(std::vector<StorageEdge> edges);
+
+	// memory-maps a cache file, fails if the file was written for a different storage state
+	bool load(const FilePath& filePath, const std::string& storageTime);
+	bool save(const FilePath& filePath, const std::string& storageTime) const;
+
+	bool isBuilt() const;
+	size_t getEdgeCount() const;
+
+	bool isEdge(Id edgeId) const;
+
+	// returns an empty StorageEdge if there is no edge with that id
+	StorageEdge getEdgeById(Id edgeId) const;
+	std::vector<StorageEdge> getEdgesByIds(const std::vector<Id>& edgeIds) const;
+
+	std::vector<StorageEdge> getEdgesBySourceId(Id sourceId) const;
+	std::vector<StorageEdge> getEdgesBySourceIds(const std::vector<Id>& sourceIds) const;
+	std::vector<StorageEdge> getEdgesByTargetId(Id targetId) const;
+	std::vector<StorageEdge> getEdgesByTargetIds(const std::vector<Id>& targetIds) const;
+	std::vector<StorageEdge> getEdgesBySourceOrTargetId(Id id) const;
+
+	void clear();
+
+private:
+	struct Adjacency
+	{
+		const uint64_t* nodeIds = nullptr;
+		const uint32_t* rangeStarts = nullptr;
+		const uint32_t* edgeIndices = nullptr;
+		size_t nodeCount = 0;
+	};
+
+	bool attach(const char* data, size_t size);
+	bool attachAdjacency(
+		const EdgeCacheFileAdjacency& fileAdjacency,
+		const char* data,
+		size_t size,
+		Adjacency& adjacency) const;
+
+	const EdgeCacheFileEdge* findEdge(Id edgeId) const;
+	void addEdgesOfNode(
+		const Adjacency& adjacency, Id nodeId, std::vector<StorageEdge>& edges) const;
+	std::vector<StorageEdge> getEdgesOfNodes(
+		const Adjacency& adjacency, const std::vector<Id>& nodeIds) const;
+
+	std::vector<char> m_buffer;
+	std::unique_ptr<boost::interprocess::file_mapping> m_mapping;
+	std::unique_ptr<boost::interprocess::mapped_region> m_region;
+
+	const char* m_data = nullptr;
+	size_t m_size = 0;
+
+	const EdgeCacheFileEdge* m_edges = nullptr;
+	size_t m_edgeCount = 0;
+	Adjacency m_outgoing;
+	Adjacency m_incoming;
+};
+
+#endif	  // EDGE_CACHE_H
@@ -0,0 +1,45 @@
+#ifndef EDGE_CACHE_FILE_H
+#define EDGE_CACHE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SidecarFile.h"
+
+// On-disk layout of the edge cache that is stored next to the index database. The header is
+// followed by all edges sorted by id and two adjacency lists in compressed sparse row format, one
+// for the outgoing and one for the incoming edges of the nodes. Each adjacency list consists of the
+// sorted ids of all nodes with edges, the start of each node's range in the edge index array plus
+// a final end, and the edge index array itself. All offsets are in bytes, relative to the start of
+// the file.
+
+struct EdgeCacheFileAdjacency
+{
+	uint64_t nodeCount;
+	uint64_t nodeIdsOffset;		  // uint64_t[nodeCount]
+	uint64_t rangeStartsOffset;	  // uint32_t[nodeCount + 1]
+	uint64_t edgeIndicesOffset;	  // uint32_t[edgeCount]
+};
+
+struct EdgeCacheFileHeader
+{
+	static const uint64_t MAGIC = 0x4745445254435253;	// "SRCTRDEG"
+	static const uint32_t VERSION = 1;
+
+	SidecarFileHeader sidecar;
+	uint64_t edgeCount;
+	uint64_t edgesOffset;
+	EdgeCacheFileAdjacency outgoing;
+	EdgeCacheFileAdjacency incoming;
+};
+
+struct EdgeCacheFileEdge
+{
+	uint64_t id;
+	uint64_t sourceNodeId;
+	uint64_t targetNodeId;
+	int32_t type;
+	uint32_t reserved;
+};
+
+#endif	  // EDGE_CACHE_FILE_H
@@ -1,5 +1,38 @@
 #include "HierarchyCache.h"
 
+#include <cstring>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "logging.h"
+#include "tracing.h"
+
+namespace
+{
+const SidecarFile hierarchyCacheFile(
+	"hierarchy cache", HierarchyCacheFileHeader::MAGIC, HierarchyCacheFileHeader::VERSION);
+
+template <typename T>
+bool readArray(
+	boost::filesystem::ifstream& stream, uint64_t offset, uint64_t count, std::vector<T>& array)
+{
+	stream.seekg(offset);
+	array.resize(count);
+	stream.read(reinterpret_cast<char*>(array.data()), count * sizeof(T));
+	return stream.good();
+}
+
+template <typename T>
+uint64_t writeArray(std::ostream& stream, const std::vector<T>& array)
+{
+	const uint64_t offset = stream.tellp();
+	stream.write(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(T));
+	return offset;
+}
+}	 // namespace
+
 HierarchyCache::HierarchyNode::HierarchyNode(Id nodeId)
 	: m_nodeId(nodeId), m_edgeId(0), m_parent(nullptr), m_isVisible(true), m_isImplicit(false)
 {
@@ -141,9 +174,123 @@ void HierarchyCache::HierarchyNode::addInheritanceEdgesRecursive(
 }
 
 
+bool HierarchyCache::save(
+	const FilePath& filePath,
+	const std::string& storageTime,
+	const std::vector<HierarchyCacheFileConnection>& connections,
+	const std::vector<HierarchyCacheFileInheritance>& inheritances,
+	const std::vector<HierarchyCacheFileMemberEdgeOrder>& memberEdgeOrders)
+{
+	TRACE();
+
+	HierarchyCacheFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	if (!hierarchyCacheFile.initHeader(&header.sidecar, storageTime))
+	{
+		return false;
+	}
+	header.connectionCount = connections.size();
+	header.inheritanceCount = inheritances.size();
+	header.memberEdgeOrderCount = memberEdgeOrders.size();
+
+	return hierarchyCacheFile.write(filePath, [&](std::ostream& stream) {
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		header.connectionsOffset = writeArray(stream, connections);
+		header.inheritancesOffset = writeArray(stream, inheritances);
+		header.memberEdgeOrdersOffset = writeArray(stream, memberEdgeOrders);
+
+		stream.seekp(0);
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		return true;
+	});
+}
+
 void HierarchyCache::clear()
 {
 	m_nodes.clear();
+	m_memberEdgeOrderIds.clear();
+}
+
+void HierarchyCache::build(
+	const std::vector<HierarchyCacheFileConnection>& connections,
+	const std::vector<HierarchyCacheFileInheritance>& inheritances,
+	const std::vector<HierarchyCacheFileMemberEdgeOrder>& memberEdgeOrders)
+{
+	TRACE();
+
+	clear();
+
+	for (const HierarchyCacheFileConnection& connection: connections)
+	{
+		createConnection(
+			connection.edgeId,
+			connection.fromId,
+			connection.toId,
+			connection.sourceVisible,
+			connection.sourceImplicit,
+			connection.targetImplicit);
+	}
+
+	for (const HierarchyCacheFileInheritance& inheritance: inheritances)
+	{
+		createInheritance(inheritance.edgeId, inheritance.fromId, inheritance.toId);
+	}
+
+	m_memberEdgeOrderIds.reserve(memberEdgeOrders.size());
+	for (const HierarchyCacheFileMemberEdgeOrder& memberEdgeOrder: memberEdgeOrders)
+	{
+		createMemberEdgeOrder(memberEdgeOrder.edgeId, memberEdgeOrder.orderId);
+	}
+}
+
+bool HierarchyCache::load(const FilePath& filePath, const std::string& storageTime)
+{
+	TRACE();
+
+	clear();
+
+	if (!filePath.recheckExists())
+	{
+		return false;
+	}
+
+	boost::filesystem::ifstream stream(filePath.getPath(), std::ios::in | std::ios::binary);
+
+	HierarchyCacheFileHeader header;
+	stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!stream.good())
+	{
+		return false;
+	}
+
+	if (!hierarchyCacheFile.checkHeader(&header.sidecar, storageTime))
+	{
+		return false;
+	}
+
+	const uint64_t size = FileSystem::getFileByteSize(filePath);
+	if (header.connectionCount > size / sizeof(HierarchyCacheFileConnection) ||
+		header.inheritanceCount > size / sizeof(HierarchyCacheFileInheritance) ||
+		header.memberEdgeOrderCount > size / sizeof(HierarchyCacheFileMemberEdgeOrder))
+	{
+		LOG_WARNING("Hierarchy cache file is corrupted.");
+		return false;
+	}
+
+	std::vector<HierarchyCacheFileConnection> connections;
+	std::vector<HierarchyCacheFileInheritance> inheritances;
+	std::vector<HierarchyCacheFileMemberEdgeOrder> memberEdgeOrders;
+	if (!readArray(stream, header.connectionsOffset, header.connectionCount, connections) ||
+		!readArray(stream, header.inheritancesOffset, header.inheritanceCount, inheritances) ||
+		!readArray(
+			stream, header.memberEdgeOrdersOffset, header.memberEdgeOrderCount, memberEdgeOrders))
+	{
+		LOG_WARNING("Hierarchy cache file is corrupted.");
+		return false;
+	}
+
+	build(connections, inheritances, memberEdgeOrders);
+	return true;
 }
 
 void HierarchyCache::createConnection(
@@ -180,6 +327,21 @@ void HierarchyCache::createInheritance(Id edgeId, Id fromId, Id toId)
 	from->addBase(to, edgeId);
 }
 
+void HierarchyCache::createMemberEdgeOrder(Id edgeId, Id orderId)
+{
+	m_memberEdgeOrderIds.emplace(edgeId, orderId);
+}
+
+Id HierarchyCache::getMemberEdgeOrderId(Id edgeId) const
+{
+	auto it = m_memberEdgeOrderIds.find(edgeId);
+	if (it != m_memberEdgeOrderIds.end())
+	{
+		return it->second;
+	}
+	return edgeId;
+}
+
 Id HierarchyCache::getLastVisibleParentNodeId(Id nodeId) const
 {
 	HierarchyNode* node = nullptr;
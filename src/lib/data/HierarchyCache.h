@@ -4,18 +4,43 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "HierarchyCacheFile.h"
 #include "types.h"
 
+class FilePath;
+
 class HierarchyCache
 {
 public:
+	// writes the data the cache is set up from, so it can be loaded without the database
+	static bool save(
+		const FilePath& filePath,
+		const std::string& storageTime,
+		const std::vector<HierarchyCacheFileConnection>& connections,
+		const std::vector<HierarchyCacheFileInheritance>& inheritances,
+		const std::vector<HierarchyCacheFileMemberEdgeOrder>& memberEdgeOrders);
+
 	void clear();
 
+	void build(
+		const std::vector<HierarchyCacheFileConnection>& connections,
+		const std::vector<HierarchyCacheFileInheritance>& inheritances,
+		const std::vector<HierarchyCacheFileMemberEdgeOrder>& memberEdgeOrders);
+
+	// fails if the file was written for a different storage state
+	bool load(const FilePath& filePath, const std::string& storageTime);
+
 	void createConnection(
 		Id edgeId, Id fromId, Id toId, bool sourceVisible, bool sourceImplicit, bool targetImplicit);
 	void createInheritance(Id edgeId, Id fromId, Id toId);
+	void createMemberEdgeOrder(Id edgeId, Id orderId);
+
+	// returns the edge id if no order was created for the edge
+	Id getMemberEdgeOrderId(Id edgeId) const;
 
 	Id getLastVisibleParentNodeId(Id nodeId) const;
 	size_t getIndexOfLastVisibleParentNode(Id nodeId) const;
@@ -92,6 +117,7 @@ private:
 	HierarchyNode* createNode(Id nodeId);
 
 	std::map<Id, std::unique_ptr<HierarchyNode>> m_nodes;
+	std::unordered_map<Id, Id> m_memberEdgeOrderIds;
 };
 
 #endif	  // HIERARCHY_CACHE_H
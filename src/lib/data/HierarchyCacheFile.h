@@ -0,0 +1,52 @@
+#ifndef HIERARCHY_CACHE_FILE_H
+#define HIERARCHY_CACHE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SidecarFile.h"
+
+// On-disk layout of the hierarchy cache that is stored next to the index database. The header is
+// followed by the member connections, the inheritance edges and the member edge order of the
+// storage, so the cache can be set up again without querying the database. All offsets are in
+// bytes, relative to the start of the file.
+
+struct HierarchyCacheFileHeader
+{
+	static const uint64_t MAGIC = 0x4549485254435253;	// "SRCTRHIE"
+	static const uint32_t VERSION = 1;
+
+	SidecarFileHeader sidecar;
+	uint64_t connectionCount;
+	uint64_t connectionsOffset;
+	uint64_t inheritanceCount;
+	uint64_t inheritancesOffset;
+	uint64_t memberEdgeOrderCount;
+	uint64_t memberEdgeOrdersOffset;
+};
+
+struct HierarchyCacheFileConnection
+{
+	uint64_t edgeId;
+	uint64_t fromId;
+	uint64_t toId;
+	uint8_t sourceVisible;
+	uint8_t sourceImplicit;
+	uint8_t targetImplicit;
+	uint8_t reserved[5];
+};
+
+struct HierarchyCacheFileInheritance
+{
+	uint64_t edgeId;
+	uint64_t fromId;
+	uint64_t toId;
+};
+
+struct HierarchyCacheFileMemberEdgeOrder
+{
+	uint64_t edgeId;
+	uint64_t orderId;
+};
+
+#endif	  // HIERARCHY_CACHE_FILE_H
@@ -5,6 +5,7 @@
 #include "DialogView.h"
 #include "FilePath.h"
 #include "PersistentStorage.h"
+#include "logging.h"
 
 TaskCleanStorage::TaskCleanStorage(
 	std::weak_ptr<PersistentStorage> storage,
@@ -43,7 +44,8 @@ Task::TaskState TaskCleanStorage::doUpdate(std::shared_ptr<Blackboard> blackboar
 			storage->clearAllErrors();
 		}
 
-		storage->clearFileElements(m_filePaths, [=](int progress) {
+		storage->clearFileElements(m_filePaths, [=](int progress, const std::wstring& phase) {
+			LOG_INFO(L"Clearing files: " + phase);
 			m_dialogView->showProgressDialog(
 				L"Clearing", std::to_wstring(m_filePaths.size()) + L" Files", progress);
 		});
@@ -32,8 +32,16 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 {
 	TimeStamp start = TimeStamp::now();
 
+	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Validating database");
+	m_storage->validateDeferredForeignKeys();
 	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Optimizing database");
 	m_storage->optimizeMemory();
+	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Building fulltext search index");
+	m_storage->writeFullTextSearchIndex();
+	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Building edge cache");
+	m_storage->writeEdgeCache();
+	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Building symbol caches");
+	m_storage->writeSymbolCaches();
 	m_dialogView->hideUnknownProgressDialog();
 
 	float time = TimeStamp::durationSeconds(start);
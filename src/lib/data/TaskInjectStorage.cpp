@@ -2,10 +2,13 @@
 
 #include "Storage.h"
 #include "StorageProvider.h"
+#include "utilityApp.h"
 
 TaskInjectStorage::TaskInjectStorage(
 	std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<Storage> target)
-	: m_storageProvider(storageProvider), m_target(target)
+	: m_storageProvider(storageProvider)
+	, m_target(target)
+	, m_pipeline(storageProvider, utility::getIdealThreadCount() / 8)
 {
 }
 
@@ -13,20 +16,27 @@ void TaskInjectStorage::doEnter(std::shared_ptr<Blackboard> blackboard) {}
 
 Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> blackboard)
 {
-	if (m_storageProvider->getStorageCount() > 0)
+	std::shared_ptr<Storage> target = m_target.lock();
+	if (!target)
 	{
-		std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeLargestStorage();
-		if (source)
-		{
-			if (std::shared_ptr<Storage> target = m_target.lock())
-			{
-				target->inject(source.get());
-				return STATE_SUCCESS;
-			}
-		}
+		return STATE_FAILURE;
 	}
 
-	return STATE_FAILURE;
+	m_pipeline.start();
+
+	if (m_pipeline.injectNextBatch(target.get(), 25))
+	{
+		return STATE_SUCCESS;
+	}
+
+	if (m_pipeline.isDrained())
+	{
+		m_pipeline.stop();
+		return STATE_FAILURE;
+	}
+
+	// batches are still being prepared
+	return STATE_SUCCESS;
 }
 
 void TaskInjectStorage::doExit(std::shared_ptr<Blackboard> blackboard) {}
@@ -36,4 +46,5 @@ void TaskInjectStorage::doReset(std::shared_ptr<Blackboard> blackboard) {}
 void TaskInjectStorage::handleMessage(MessageIndexingInterrupted* message)
 {
 	m_storageProvider->clear();
+	m_pipeline.clear();
 }
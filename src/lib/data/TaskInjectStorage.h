@@ -5,6 +5,7 @@
 
 #include "MessageIndexingInterrupted.h"
 #include "MessageListener.h"
+#include "StorageInjectionPipeline.h"
 #include "Task.h"
 
 class Storage;
@@ -27,6 +28,7 @@ private:
 
 	std::shared_ptr<StorageProvider> m_storageProvider;
 	std::weak_ptr<Storage> m_target;
+	StorageInjectionPipeline m_pipeline;
 };
 
 #endif	  // TASK_INJECT_STORAGE_H
@@ -1,60 +1,498 @@
 #include "FullTextSearchIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
 #include <limits>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FilePath.h"
+#include "FullTextSearchIndexWriter.h"
 #include "logging.h"
 #include "tracing.h"
 
+namespace
+{
+const SidecarFile fullTextSearchIndexFile(
+	"fulltext search index",
+	FullTextSearchIndexFileHeader::MAGIC,
+	FullTextSearchIndexFileHeader::VERSION);
+
+// compares the lower case prefix of the suffix starting at pos to the (lower case) term, a suffix
+// that ends before the term is considered smaller
+template <typename CharType>
+int compareSuffixToTerm(const CharType* text, size_t length, size_t pos, const std::wstring& term)
+{
+	for (size_t i = 0; i < term.size(); i++)
+	{
+		if (pos + i >= length)
+		{
+			return -1;
+		}
+
+		const wchar_t c = static_cast<wchar_t>(::towlower(static_cast<wchar_t>(text[pos + i])));
+		if (c != term[i])
+		{
+			return c < term[i] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+// returns the sorted positions of the case insensitive occurrences of the term in the text
+template <typename CharType, typename ArrayType>
+std::vector<int> searchForTermInText(
+	const CharType* text, const ArrayType* array, size_t length, const std::wstring& term)
+{
+	std::wstring lowerCaseTerm = term;
+	std::transform(lowerCaseTerm.begin(), lowerCaseTerm.end(), lowerCaseTerm.begin(), ::towlower);
+
+	const ArrayType* first = std::lower_bound(
+		array, array + length, lowerCaseTerm, [&](ArrayType pos, const std::wstring& t) {
+			return compareSuffixToTerm(text, length, pos, t) < 0;
+		});
+	const ArrayType* last = std::upper_bound(
+		first, array + length, lowerCaseTerm, [&](const std::wstring& t, ArrayType pos) {
+			return compareSuffixToTerm(text, length, pos, t) > 0;
+		});
+
+	std::vector<int> matches(first, last);
+	std::sort(matches.begin(), matches.end());
+	return matches;
+}
+
+template <typename CharType, typename LineStartType>
+std::vector<ParseLocation> getLocationsForPositionsInText(
+	Id fileId,
+	const CharType* text,
+	size_t length,
+	const LineStartType* lineStarts,
+	size_t lineCount,
+	const std::vector<int>& positions,
+	const std::wstring& term,
+	bool caseSensitive)
+{
+	std::vector<ParseLocation> locations;
+	if (term.empty() || !lineCount)
+	{
+		return locations;
+	}
+
+	const int termLength = term.size();
+	for (int pos: positions)
+	{
+		if (pos < 0 || size_t(pos) + termLength > length)
+		{
+			continue;
+		}
+
+		if (caseSensitive &&
+			!std::equal(term.begin(), term.end(), text + pos, [](wchar_t a, CharType b) {
+				return a == static_cast<wchar_t>(b);
+			}))
+		{
+			continue;
+		}
+
+		// line starts are sorted and begin with 0, so the index of the first greater line start is
+		// the 1-based number of the line containing the position
+		const size_t startLine = std::upper_bound(lineStarts, lineStarts + lineCount, pos) -
+			lineStarts;
+		const size_t endLine = std::upper_bound(
+								   lineStarts + startLine - 1,
+								   lineStarts + lineCount,
+								   pos + termLength - 1) -
+			lineStarts;
+
+		locations.push_back(ParseLocation(
+			fileId,
+			startLine,
+			pos - lineStarts[startLine - 1] + 1,
+			endLine,
+			pos + termLength - lineStarts[endLine - 1]));
+	}
+	return locations;
+}
+}	 // namespace
+
+std::vector<int> FullTextSearchFile::getLineStarts(const std::wstring& text)
+{
+	std::vector<int> lineStarts = {0};
+	for (size_t i = 0; i + 1 < text.size(); i++)
+	{
+		if (text[i] == L'\n')
+		{
+			lineStarts.push_back(int(i) + 1);
+		}
+	}
+	return lineStarts;
+}
+
+FullTextSearchIndex::FullTextSearchIndex() {}
+
+FullTextSearchIndex::~FullTextSearchIndex() {}
+
 void FullTextSearchIndex::addFile(Id fileId, const std::wstring& fileContent)
 {
 	if (fileContent.empty())
 	{
 		LOG_ERROR("empty file not added to fulltextsearch index");
+		return;
 	}
 
-	if (fileContent.size() >= std::numeric_limits<int>::max())
+	if (fileContent.size() >= size_t(std::numeric_limits<int>::max()))
 	{
 		LOG_ERROR("file too big not added to fulltextsearch index");
+		return;
 	}
 
-	FullTextSearchFile fts_file(fileId, SuffixArray(fileContent));
+	std::shared_ptr<const FullTextSearchFile> fts_file = std::make_shared<FullTextSearchFile>(
+		fileId, fileContent);
 
 	{
 		std::lock_guard<std::mutex> lock(m_filesMutex);
-		m_files.push_back(fts_file);
+
+		auto it = m_fileIndices.find(fileId);
+		if (it != m_fileIndices.end())
+		{
+			m_files[it->second] = std::move(fts_file);
+		}
+		else
+		{
+			m_fileIndices.emplace(fileId, m_files.size());
+			m_files.push_back(std::move(fts_file));
+		}
 	}
 }
 
-std::vector<FullTextSearchResult> FullTextSearchIndex::searchForTerm(const std::wstring& term) const
+void FullTextSearchIndex::updateFile(Id fileId, const std::wstring& fileContent)
+{
+	removeFile(fileId);
+	addFile(fileId, fileContent);
+}
+
+void FullTextSearchIndex::removeFile(Id fileId)
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+
+	auto it = m_fileIndices.find(fileId);
+	if (it != m_fileIndices.end())
+	{
+		// the last file takes the place of the removed one, so no other index changes
+		const size_t index = it->second;
+		m_fileIndices.erase(it);
+		if (index + 1 != m_files.size())
+		{
+			m_files[index] = std::move(m_files.back());
+			m_fileIndices[m_files[index]->fileId] = index;
+		}
+		m_files.pop_back();
+	}
+
+	if (m_mappedFileIndices.find(fileId) != m_mappedFileIndices.end())
+	{
+		m_removedMappedFileIds.insert(fileId);
+	}
+}
+
+bool FullTextSearchIndex::hasFile(Id fileId) const
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+
+	if (m_mappedFileIndices.find(fileId) != m_mappedFileIndices.end() &&
+		m_removedMappedFileIds.find(fileId) == m_removedMappedFileIds.end())
+	{
+		return true;
+	}
+
+	return m_fileIndices.find(fileId) != m_fileIndices.end();
+}
+
+std::vector<Id> FullTextSearchIndex::getFileIds() const
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+
+	std::vector<Id> fileIds;
+	for (size_t i = 0; i < m_mappedFileCount; i++)
+	{
+		if (m_removedMappedFileIds.find(m_mappedFiles[i].fileId) == m_removedMappedFileIds.end())
+		{
+			fileIds.push_back(m_mappedFiles[i].fileId);
+		}
+	}
+
+	for (const std::shared_ptr<const FullTextSearchFile>& file: m_files)
+	{
+		fileIds.push_back(file->fileId);
+	}
+
+	return fileIds;
+}
+
+bool FullTextSearchIndex::load(
+	const FilePath& filePath, const std::string& codecName, const std::string& storageTime)
 {
 	TRACE();
 
-	std::vector<FullTextSearchResult> ret;
+	std::unique_ptr<boost::interprocess::file_mapping> mapping;
+	std::unique_ptr<boost::interprocess::mapped_region> region;
+	if (!fullTextSearchIndexFile.map(
+			filePath, sizeof(FullTextSearchIndexFileHeader), &mapping, &region))
 	{
-		std::lock_guard<std::mutex> lock(m_filesMutex);
-		for (auto& f: m_files)
+		return false;
+	}
+
+	const char* data = static_cast<const char*>(region->get_address());
+	const size_t size = region->get_size();
+
+	FullTextSearchIndexFileHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (!fullTextSearchIndexFile.checkHeader(&header.sidecar, storageTime))
+	{
+		return false;
+	}
+
+	header.codecName[sizeof(header.codecName) - 1] = '\0';
+	if (codecName != header.codecName)
+	{
+		LOG_INFO("Fulltext search index file was written with another text encoding.");
+		return false;
+	}
+
+	if (header.fileTableOffset > size ||
+		header.fileCount > (size - header.fileTableOffset) / sizeof(FullTextSearchIndexFileEntry))
+	{
+		LOG_WARNING("Fulltext search index file is corrupted.");
+		return false;
+	}
+
+	const FullTextSearchIndexFileEntry* entries = reinterpret_cast<const FullTextSearchIndexFileEntry*>(
+		data + header.fileTableOffset);
+	for (size_t i = 0; i < header.fileCount; i++)
+	{
+		const FullTextSearchIndexFileEntry& entry = entries[i];
+		if (entry.textOffset + entry.length * sizeof(uint32_t) > header.fileTableOffset ||
+			entry.arrayOffset + entry.length * sizeof(int32_t) > header.fileTableOffset ||
+			entry.lineStartsOffset + entry.lineCount * sizeof(int32_t) > header.fileTableOffset)
+		{
+			LOG_WARNING("Fulltext search index file is corrupted.");
+			return false;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+	m_mapping = std::move(mapping);
+	m_region = std::move(region);
+	m_mappedFiles = entries;
+	m_mappedFileCount = header.fileCount;
+
+	m_mappedFileIndices.clear();
+	m_removedMappedFileIds.clear();
+	for (size_t i = 0; i < m_mappedFileCount; i++)
+	{
+		m_mappedFileIndices.emplace(m_mappedFiles[i].fileId, i);
+	}
+
+	return true;
+}
+
+bool FullTextSearchIndex::save(FullTextSearchIndexWriter& writer) const
+{
+	TRACE();
+
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+
+	if (m_mappedFileCount)
+	{
+		const char* data = static_cast<const char*>(m_region->get_address());
+		for (size_t i = 0; i < m_mappedFileCount; i++)
 		{
-			FullTextSearchResult hit;
-			hit.fileId = f.fileId;
-			hit.positions = f.array.searchForTerm(term);
-			std::sort(hit.positions.begin(), hit.positions.end());
-			if (!hit.positions.empty())
+			const FullTextSearchIndexFileEntry& entry = m_mappedFiles[i];
+			if (m_removedMappedFileIds.find(entry.fileId) == m_removedMappedFileIds.end())
 			{
-				ret.push_back(hit);
+				writer.addFileData(
+					entry.fileId,
+					reinterpret_cast<const uint32_t*>(data + entry.textOffset),
+					reinterpret_cast<const int32_t*>(data + entry.arrayOffset),
+					entry.length,
+					reinterpret_cast<const int32_t*>(data + entry.lineStartsOffset),
+					entry.lineCount);
 			}
 		}
 	}
 
+	for (const std::shared_ptr<const FullTextSearchFile>& file: m_files)
+	{
+		const std::vector<uint32_t> text(file->text.begin(), file->text.end());
+		writer.addFileData(
+			file->fileId,
+			text.data(),
+			file->array.data(),
+			text.size(),
+			file->lineStarts.data(),
+			file->lineStarts.size());
+	}
+
+	return writer.isOpen();
+}
+
+std::vector<FullTextSearchResult> FullTextSearchIndex::searchForTerm(const std::wstring& term) const
+{
+	TRACE();
+
+	std::vector<FullTextSearchResult> ret;
+	for (const FullTextSearchFileView& fileView: getFileViews())
+	{
+		FullTextSearchResult hit;
+		hit.fileId = fileView.fileId;
+		hit.positions = searchForTerm(fileView, term);
+		if (!hit.positions.empty())
+		{
+			ret.push_back(hit);
+		}
+	}
 	return ret;
 }
 
+std::vector<ParseLocation> FullTextSearchIndex::getLocationsForResult(
+	const FullTextSearchResult& result, const std::wstring& term, bool caseSensitive) const
+{
+	return getLocationsForPositions(
+		getFileView(result.fileId), result.positions, term, caseSensitive);
+}
+
+std::vector<FullTextSearchFileView> FullTextSearchIndex::getFileViews() const
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+
+	std::vector<FullTextSearchFileView> fileViews;
+	fileViews.reserve(m_mappedFileCount - m_removedMappedFileIds.size() + m_files.size());
+	for (size_t i = 0; i < m_mappedFileCount; i++)
+	{
+		if (m_removedMappedFileIds.find(m_mappedFiles[i].fileId) == m_removedMappedFileIds.end())
+		{
+			FullTextSearchFileView fileView;
+			fileView.fileId = m_mappedFiles[i].fileId;
+			fileView.region = m_region;
+			fileView.entry = &m_mappedFiles[i];
+			fileViews.push_back(fileView);
+		}
+	}
+
+	for (const std::shared_ptr<const FullTextSearchFile>& file: m_files)
+	{
+		FullTextSearchFileView fileView;
+		fileView.fileId = file->fileId;
+		fileView.file = file;
+		fileViews.push_back(fileView);
+	}
+
+	return fileViews;
+}
+
+std::vector<int> FullTextSearchIndex::searchForTerm(
+	const FullTextSearchFileView& fileView, const std::wstring& term)
+{
+	if (fileView.file)
+	{
+		const FullTextSearchFile& file = *fileView.file;
+		return searchForTermInText(file.text.data(), file.array.data(), file.text.size(), term);
+	}
+
+	if (fileView.entry)
+	{
+		const FullTextSearchIndexFileEntry& entry = *fileView.entry;
+		const char* data = static_cast<const char*>(fileView.region->get_address());
+		return searchForTermInText(
+			reinterpret_cast<const uint32_t*>(data + entry.textOffset),
+			reinterpret_cast<const int32_t*>(data + entry.arrayOffset),
+			entry.length,
+			term);
+	}
+
+	return std::vector<int>();
+}
+
+std::vector<ParseLocation> FullTextSearchIndex::getLocationsForPositions(
+	const FullTextSearchFileView& fileView,
+	const std::vector<int>& positions,
+	const std::wstring& term,
+	bool caseSensitive)
+{
+	if (fileView.file)
+	{
+		const FullTextSearchFile& file = *fileView.file;
+		return getLocationsForPositionsInText(
+			file.fileId,
+			file.text.data(),
+			file.text.size(),
+			file.lineStarts.data(),
+			file.lineStarts.size(),
+			positions,
+			term,
+			caseSensitive);
+	}
+
+	if (fileView.entry)
+	{
+		const FullTextSearchIndexFileEntry& entry = *fileView.entry;
+		const char* data = static_cast<const char*>(fileView.region->get_address());
+		return getLocationsForPositionsInText(
+			entry.fileId,
+			reinterpret_cast<const uint32_t*>(data + entry.textOffset),
+			entry.length,
+			reinterpret_cast<const int32_t*>(data + entry.lineStartsOffset),
+			entry.lineCount,
+			positions,
+			term,
+			caseSensitive);
+	}
+
+	return std::vector<ParseLocation>();
+}
+
 size_t FullTextSearchIndex::fileCount() const
 {
 	std::lock_guard<std::mutex> lock(m_filesMutex);
-	return m_files.size();
+	return m_mappedFileCount - m_removedMappedFileIds.size() + m_files.size();
 }
 
 void FullTextSearchIndex::clear()
 {
 	std::lock_guard<std::mutex> lock(m_filesMutex);
 	m_files.clear();
+	m_fileIndices.clear();
+
+	m_mappedFiles = nullptr;
+	m_mappedFileCount = 0;
+	m_mappedFileIndices.clear();
+	m_removedMappedFileIds.clear();
+	m_region.reset();
+	m_mapping.reset();
+}
+
+FullTextSearchFileView FullTextSearchIndex::getFileView(Id fileId) const
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+
+	FullTextSearchFileView fileView;
+	fileView.fileId = fileId;
+
+	auto fileIt = m_fileIndices.find(fileId);
+	if (fileIt != m_fileIndices.end())
+	{
+		fileView.file = m_files[fileIt->second];
+		return fileView;
+	}
+
+	auto it = m_mappedFileIndices.find(fileId);
+	if (it != m_mappedFileIndices.end() &&
+		m_removedMappedFileIds.find(fileId) == m_removedMappedFileIds.end())
+	{
+		fileView.region = m_region;
+		fileView.entry = &m_mappedFiles[it->second];
+	}
+	return fileView;
 }
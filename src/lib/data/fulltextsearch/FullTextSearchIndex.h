@@ -1,13 +1,28 @@
 #ifndef FULLTEXTSEARCH_INDEX_H
 #define FULLTEXTSEARCH_INDEX_H
 
+#include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "FullTextSearchIndexFile.h"
+#include "ParseLocation.h"
 #include "SuffixArray.h"
 #include "types.h"
 
+namespace boost
+{
+namespace interprocess
+{
+class file_mapping;
+class mapped_region;
+}	 // namespace interprocess
+}	 // namespace boost
+
+class FilePath;
+class FullTextSearchIndexWriter;
 class StorageAccess;
 
 // contains all fulltextsearch results of one file
@@ -19,24 +34,93 @@ struct FullTextSearchResult
 
 struct FullTextSearchFile
 {
-	FullTextSearchFile(Id fileId, SuffixArray array): fileId(fileId), array(array) {};
+	// returns the character offsets at which the lines of the text start, the first one being 0
+	static std::vector<int> getLineStarts(const std::wstring& text);
+
+	FullTextSearchFile(Id fileId, const std::wstring& text)
+		: fileId(fileId)
+		, text(text)
+		, array(SuffixArray::buildArray(text))
+		, lineStarts(getLineStarts(text))
+	{
+	}
 	Id fileId;
-	SuffixArray array;
+	std::wstring text;
+
+	// case insensitive suffix array of the text, searched like the array of a mapped file
+	std::vector<int> array;
+	std::vector<int> lineStarts;
+};
+
+// A file of the index that can be searched without locking the index. It keeps the data of the file
+// alive while the file gets removed or the index gets cleared.
+struct FullTextSearchFileView
+{
+	Id fileId = 0;
+
+	// set for files added in memory
+	std::shared_ptr<const FullTextSearchFile> file;
+
+	// set for files of a loaded index file
+	std::shared_ptr<const boost::interprocess::mapped_region> region;
+	const FullTextSearchIndexFileEntry* entry = nullptr;
 };
 
 class FullTextSearchIndex
 {
 public:
+	FullTextSearchIndex();
+	~FullTextSearchIndex();
+
 	void addFile(Id fileId, const std::wstring& file);
+	void updateFile(Id fileId, const std::wstring& file);
+	void removeFile(Id fileId);
+	bool hasFile(Id fileId) const;
+	std::vector<Id> getFileIds() const;
+
+	// memory-maps an index file written by FullTextSearchIndexWriter, fails if the file was written
+	// for a different text codec or storage state.
+	bool load(const FilePath& filePath, const std::string& codecName, const std::string& storageTime);
+
+	// writes all files to a new index file, mapped files are copied without rebuilding them
+	bool save(FullTextSearchIndexWriter& writer) const;
+
 	std::vector<FullTextSearchResult> searchForTerm(const std::wstring& term) const;
 
+	// converts the positions of a search result to 1-based line and column locations, positions that
+	// don't match the original case of the term are dropped for case sensitive searches.
+	std::vector<ParseLocation> getLocationsForResult(
+		const FullTextSearchResult& result, const std::wstring& term, bool caseSensitive) const;
+
+	// returns the current files of the index, so each of them can be searched on its own
+	std::vector<FullTextSearchFileView> getFileViews() const;
+
+	// returns the sorted positions of the case insensitive occurrences of the term in the file
+	static std::vector<int> searchForTerm(
+		const FullTextSearchFileView& fileView, const std::wstring& term);
+	static std::vector<ParseLocation> getLocationsForPositions(
+		const FullTextSearchFileView& fileView,
+		const std::vector<int>& positions,
+		const std::wstring& term,
+		bool caseSensitive);
+
 	size_t fileCount() const;
 
 	void clear();
 
 private:
+	FullTextSearchFileView getFileView(Id fileId) const;
+
 	mutable std::mutex m_filesMutex;
-	std::vector<FullTextSearchFile> m_files;
+	std::vector<std::shared_ptr<const FullTextSearchFile>> m_files;
+	std::unordered_map<Id, size_t> m_fileIndices;
+
+	std::unique_ptr<boost::interprocess::file_mapping> m_mapping;
+	std::shared_ptr<const boost::interprocess::mapped_region> m_region;
+	const FullTextSearchIndexFileEntry* m_mappedFiles = nullptr;
+	size_t m_mappedFileCount = 0;
+	std::unordered_map<Id, size_t> m_mappedFileIndices;
+	std::unordered_set<Id> m_removedMappedFileIds;
 };
 
 #endif	  // FULLTEXTSEARCH_INDEX_H
@@ -0,0 +1,38 @@
+#ifndef FULLTEXTSEARCH_INDEX_FILE_H
+#define FULLTEXTSEARCH_INDEX_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SidecarFile.h"
+
+// On-disk layout of the fulltext search index that is stored next to the index database. The
+// header is followed by the data blocks of all files and the file table at the end. Each data block
+// holds the original text of a file as 32 bit characters, followed by the suffix array of the
+// lower case text and the character offsets of all line starts. All offsets are in bytes, relative
+// to the start of the file.
+
+struct FullTextSearchIndexFileHeader
+{
+	static const uint64_t MAGIC = 0x5354465254435253;	// "SRCTRFTS"
+	static const uint32_t VERSION = 3;
+
+	static const size_t MAX_CODEC_NAME_LENGTH = 64;
+
+	SidecarFileHeader sidecar;
+	char codecName[MAX_CODEC_NAME_LENGTH];
+	uint64_t fileCount;
+	uint64_t fileTableOffset;
+};
+
+struct FullTextSearchIndexFileEntry
+{
+	uint64_t fileId;
+	uint64_t textOffset;
+	uint64_t arrayOffset;
+	uint64_t length;
+	uint64_t lineStartsOffset;
+	uint64_t lineCount;
+};
+
+#endif	  // FULLTEXTSEARCH_INDEX_FILE_H
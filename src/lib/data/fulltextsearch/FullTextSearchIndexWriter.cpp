@@ -0,0 +1,171 @@
+#include "FullTextSearchIndexWriter.h"
+
+#include <cstring>
+#include <limits>
+
+#include "FileSystem.h"
+#include "FullTextSearchIndex.h"
+#include "SuffixArray.h"
+#include "logging.h"
+
+namespace
+{
+const SidecarFile fullTextSearchIndexFile(
+	"fulltext search index",
+	FullTextSearchIndexFileHeader::MAGIC,
+	FullTextSearchIndexFileHeader::VERSION);
+}	 // namespace
+
+FullTextSearchIndexWriter::FullTextSearchIndexWriter(
+	const FilePath& filePath, const std::string& codecName, const std::string& storageTime)
+	: m_filePath(filePath)
+	, m_tempFilePath(SidecarFile::getTempFilePath(filePath))
+	, m_codecName(codecName)
+	, m_storageTime(storageTime)
+{
+	if (m_codecName.size() >= FullTextSearchIndexFileHeader::MAX_CODEC_NAME_LENGTH ||
+		m_storageTime.size() >= SidecarFileHeader::MAX_STORAGE_TIME_LENGTH)
+	{
+		LOG_ERROR("Codec name or storage time too long for fulltext search index file.");
+		m_failed = true;
+		return;
+	}
+
+	m_stream.open(m_tempFilePath.getPath(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!m_stream.is_open())
+	{
+		LOG_ERROR(L"Could not open fulltext search index file for writing: " + m_tempFilePath.wstr());
+		m_failed = true;
+		return;
+	}
+
+	// reserve space for the header, it gets written once all files are added
+	FullTextSearchIndexFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+FullTextSearchIndexWriter::~FullTextSearchIndexWriter()
+{
+	if (m_stream.is_open())
+	{
+		m_stream.close();
+		FileSystem::remove(m_tempFilePath);
+	}
+}
+
+bool FullTextSearchIndexWriter::isOpen() const
+{
+	return !m_failed;
+}
+
+void FullTextSearchIndexWriter::addFile(Id fileId, const std::wstring& fileContent)
+{
+	if (fileContent.empty())
+	{
+		LOG_ERROR("empty file not added to fulltextsearch index");
+		return;
+	}
+
+	if (fileContent.size() >= size_t(std::numeric_limits<int>::max()))
+	{
+		LOG_ERROR("file too big not added to fulltextsearch index");
+		return;
+	}
+
+	const std::vector<int> array = SuffixArray::buildArray(fileContent);
+	const std::vector<uint32_t> text(fileContent.begin(), fileContent.end());
+	const std::vector<int> lineStarts = FullTextSearchFile::getLineStarts(fileContent);
+
+	static_assert(sizeof(int) == sizeof(int32_t), "suffix array entries need to be 32 bit");
+	addFileData(
+		fileId,
+		text.data(),
+		array.data(),
+		text.size(),
+		lineStarts.data(),
+		lineStarts.size());
+}
+
+void FullTextSearchIndexWriter::addFileData(
+	Id fileId,
+	const uint32_t* text,
+	const int32_t* array,
+	size_t length,
+	const int32_t* lineStarts,
+	size_t lineCount)
+{
+	std::lock_guard<std::mutex> lock(m_streamMutex);
+	if (m_failed)
+	{
+		return;
+	}
+
+	FullTextSearchIndexFileEntry entry;
+	entry.fileId = fileId;
+	entry.length = length;
+
+	entry.textOffset = m_offset;
+	write(reinterpret_cast<const char*>(text), length * sizeof(uint32_t));
+
+	entry.arrayOffset = m_offset;
+	write(reinterpret_cast<const char*>(array), length * sizeof(int32_t));
+
+	entry.lineCount = lineCount;
+	entry.lineStartsOffset = m_offset;
+	write(reinterpret_cast<const char*>(lineStarts), lineCount * sizeof(int32_t));
+
+	m_entries.push_back(entry);
+}
+
+bool FullTextSearchIndexWriter::finish()
+{
+	std::lock_guard<std::mutex> lock(m_streamMutex);
+	if (m_failed)
+	{
+		return false;
+	}
+
+	writePadding(sizeof(uint64_t));
+
+	FullTextSearchIndexFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	fullTextSearchIndexFile.initHeader(&header.sidecar, m_storageTime);
+	std::strncpy(header.codecName, m_codecName.c_str(), sizeof(header.codecName) - 1);
+	header.fileCount = m_entries.size();
+	header.fileTableOffset = m_offset;
+
+	write(
+		reinterpret_cast<const char*>(m_entries.data()),
+		m_entries.size() * sizeof(FullTextSearchIndexFileEntry));
+
+	m_stream.seekp(0);
+	write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	m_stream.close();
+
+	m_failed = !fullTextSearchIndexFile.replaceWithTempFile(m_filePath, !m_failed);
+	return !m_failed;
+}
+
+void FullTextSearchIndexWriter::write(const char* data, size_t size)
+{
+	m_stream.write(data, size);
+	m_offset += size;
+
+	if (!m_stream.good())
+	{
+		m_failed = true;
+	}
+}
+
+void FullTextSearchIndexWriter::writePadding(size_t alignment)
+{
+	static const char zeros[sizeof(uint64_t)] = {};
+
+	const size_t padding = (alignment - (m_offset % alignment)) % alignment;
+	if (padding)
+	{
+		write(zeros, padding);
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef FULLTEXTSEARCH_INDEX_WRITER_H
+#define FULLTEXTSEARCH_INDEX_WRITER_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "FilePath.h"
+#include "FullTextSearchIndexFile.h"
+#include "types.h"
+
+// Streams the suffix arrays of all added files into a fulltext search index file, so the whole
+// index never needs to be kept in memory. The data is written to a temporary file that replaces
+// the index file on finish, so an index file that is still mapped elsewhere is never overwritten.
+class FullTextSearchIndexWriter
+{
+public:
+	FullTextSearchIndexWriter(
+		const FilePath& filePath, const std::string& codecName, const std::string& storageTime);
+	~FullTextSearchIndexWriter();
+
+	bool isOpen() const;
+
+	// thread safe, the suffix array is built before the file gets locked for writing
+	void addFile(Id fileId, const std::wstring& fileContent);
+	void addFileData(
+		Id fileId,
+		const uint32_t* text,
+		const int32_t* array,
+		size_t length,
+		const int32_t* lineStarts,
+		size_t lineCount);
+
+	bool finish();
+
+private:
+	void write(const char* data, size_t size);
+	void writePadding(size_t alignment);
+
+	const FilePath m_filePath;
+	const FilePath m_tempFilePath;
+	const std::string m_codecName;
+	const std::string m_storageTime;
+
+	std::mutex m_streamMutex;
+	boost::filesystem::ofstream m_stream;
+	uint64_t m_offset = 0;
+	bool m_failed = false;
+
+	std::vector<FullTextSearchIndexFileEntry> m_entries;
+};
+
+#endif	  // FULLTEXTSEARCH_INDEX_WRITER_H
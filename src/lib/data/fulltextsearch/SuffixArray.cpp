@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <unordered_map>
 
 struct suffix
 {
@@ -15,13 +16,207 @@ int SuffixArray::cmp(const struct suffix& a, const struct suffix& b)
 									: (a.rank[0] < b.rank[0] ? 1 : 0);
 }
 
-SuffixArray::SuffixArray(const std::wstring& text): m_text(text)
+namespace
+{
+// SA-IS suffix array construction (Nong, Zhang, Chan 2009) for a text whose last character is a
+// unique sentinel that is smaller than all other characters of the alphabet [0, alphabetSize).
+class InducedSorter
+{
+public:
+	InducedSorter(const int* text, int* array, int n, int alphabetSize)
+		: m_text(text), m_array(array), m_n(n), m_alphabetSize(alphabetSize), m_isSType(n, false)
+	{
+	}
+
+	void sort()
+	{
+		m_isSType[m_n - 1] = true;
+		for (int i = m_n - 2; i >= 0; i--)
+		{
+			m_isSType[i] = m_text[i] < m_text[i + 1] ||
+				(m_text[i] == m_text[i + 1] && m_isSType[i + 1]);
+		}
+
+		// sort all LMS substrings by inducing from their bucket ends
+		std::vector<int> buckets;
+		getBuckets(buckets, true);
+		std::fill(m_array, m_array + m_n, -1);
+		for (int i = 1; i < m_n; i++)
+		{
+			if (isLMS(i))
+			{
+				m_array[--buckets[m_text[i]]] = i;
+			}
+		}
+		induceLType(buckets);
+		induceSType(buckets);
+
+		// compact the sorted LMS substrings and name them
+		int lmsCount = 0;
+		for (int i = 0; i < m_n; i++)
+		{
+			if (isLMS(m_array[i]))
+			{
+				m_array[lmsCount++] = m_array[i];
+			}
+		}
+		std::fill(m_array + lmsCount, m_array + m_n, -1);
+
+		int name = 0;
+		int prev = -1;
+		for (int i = 0; i < lmsCount; i++)
+		{
+			const int pos = m_array[i];
+			bool diff = false;
+			for (int d = 0; d < m_n; d++)
+			{
+				if (prev == -1 || m_text[pos + d] != m_text[prev + d] ||
+					m_isSType[pos + d] != m_isSType[prev + d])
+				{
+					diff = true;
+					break;
+				}
+				else if (d > 0 && (isLMS(pos + d) || isLMS(prev + d)))
+				{
+					break;
+				}
+			}
+
+			if (diff)
+			{
+				name++;
+				prev = pos;
+			}
+			m_array[lmsCount + pos / 2] = name - 1;
+		}
+
+		for (int i = m_n - 1, j = m_n - 1; i >= lmsCount; i--)
+		{
+			if (m_array[i] >= 0)
+			{
+				m_array[j--] = m_array[i];
+			}
+		}
+
+		// sort the reduced problem, recursing only if the names are not unique yet
+		int* reducedText = m_array + m_n - lmsCount;
+		if (name < lmsCount)
+		{
+			InducedSorter(reducedText, m_array, lmsCount, name).sort();
+		}
+		else
+		{
+			for (int i = 0; i < lmsCount; i++)
+			{
+				m_array[reducedText[i]] = i;
+			}
+		}
+
+		// induce the final order from the sorted LMS suffixes
+		for (int i = 1, j = 0; i < m_n; i++)
+		{
+			if (isLMS(i))
+			{
+				reducedText[j++] = i;
+			}
+		}
+		for (int i = 0; i < lmsCount; i++)
+		{
+			m_array[i] = reducedText[m_array[i]];
+		}
+		std::fill(m_array + lmsCount, m_array + m_n, -1);
+
+		getBuckets(buckets, true);
+		for (int i = lmsCount - 1; i >= 0; i--)
+		{
+			const int j = m_array[i];
+			m_array[i] = -1;
+			m_array[--buckets[m_text[j]]] = j;
+		}
+		induceLType(buckets);
+		induceSType(buckets);
+	}
+
+private:
+	bool isLMS(int i) const
+	{
+		return i > 0 && m_isSType[i] && !m_isSType[i - 1];
+	}
+
+	void getBuckets(std::vector<int>& buckets, bool bucketEnds) const
+	{
+		buckets.assign(m_alphabetSize, 0);
+		for (int i = 0; i < m_n; i++)
+		{
+			buckets[m_text[i]]++;
+		}
+
+		int sum = 0;
+		for (int c = 0; c < m_alphabetSize; c++)
+		{
+			sum += buckets[c];
+			buckets[c] = bucketEnds ? sum : sum - buckets[c];
+		}
+	}
+
+	void induceLType(std::vector<int>& buckets) const
+	{
+		getBuckets(buckets, false);
+		for (int i = 0; i < m_n; i++)
+		{
+			const int j = m_array[i] - 1;
+			if (j >= 0 && !m_isSType[j])
+			{
+				m_array[buckets[m_text[j]]++] = j;
+			}
+		}
+	}
+
+	void induceSType(std::vector<int>& buckets) const
+	{
+		getBuckets(buckets, true);
+		for (int i = m_n - 1; i >= 0; i--)
+		{
+			const int j = m_array[i] - 1;
+			if (j >= 0 && m_isSType[j])
+			{
+				m_array[--buckets[m_text[j]]] = j;
+			}
+		}
+	}
+
+	const int* m_text;
+	int* m_array;
+	const int m_n;
+	const int m_alphabetSize;
+	std::vector<bool> m_isSType;
+};
+}	 // namespace
+
+std::vector<int> SuffixArray::buildArray(const std::wstring& text, BuildAlgorithmType algorithm)
+{
+	std::wstring lowerCaseText = text;
+	std::transform(lowerCaseText.begin(), lowerCaseText.end(), lowerCaseText.begin(), ::towlower);
+	return buildLowerCaseArray(lowerCaseText, algorithm);
+}
+
+SuffixArray::SuffixArray(const std::wstring& text, BuildAlgorithmType algorithm): m_text(text)
 {
 	std::transform(m_text.begin(), m_text.end(), m_text.begin(), ::towlower);
-	m_array = buildSuffixArray();
+	m_array = buildLowerCaseArray(m_text, algorithm);
 	m_lcp = buildLCP();
 }
 
+const std::vector<int>& SuffixArray::getArray() const
+{
+	return m_array;
+}
+
+const std::vector<int>& SuffixArray::getLCP() const
+{
+	return m_lcp;
+}
+
 void SuffixArray::printArray() const
 {
 	std::cout << "Suffix Array : \n";
@@ -129,9 +324,64 @@ std::vector<int> SuffixArray::searchForTerm(const std::wstring& searchTerm) cons
 	return matches;
 }
 
-std::vector<int> SuffixArray::buildSuffixArray()
+std::vector<int> SuffixArray::buildLowerCaseArray(
+	const std::wstring& lowerCaseText, BuildAlgorithmType algorithm)
+{
+	switch (algorithm)
+	{
+	case BUILD_ALGORITHM_SAIS:
+		return buildSuffixArraySAIS(lowerCaseText);
+	case BUILD_ALGORITHM_PREFIX_DOUBLING:
+		return buildSuffixArrayPrefixDoubling(lowerCaseText);
+	}
+	return std::vector<int>();
+}
+
+std::vector<int> SuffixArray::buildSuffixArraySAIS(const std::wstring& text)
+{
+	const int n = text.length();
+	if (n == 0)
+	{
+		return std::vector<int>();
+	}
+
+	// map the characters to a dense alphabet that keeps their order, 0 is reserved for the sentinel
+	std::vector<wchar_t> alphabet;
+	{
+		std::unordered_map<wchar_t, int> seen;
+		for (wchar_t c: text)
+		{
+			if (seen.emplace(c, 0).second)
+			{
+				alphabet.push_back(c);
+			}
+		}
+	}
+	std::sort(alphabet.begin(), alphabet.end());
+
+	std::unordered_map<wchar_t, int> ranks;
+	ranks.reserve(alphabet.size());
+	for (size_t i = 0; i < alphabet.size(); i++)
+	{
+		ranks.emplace(alphabet[i], int(i) + 1);
+	}
+
+	std::vector<int> rankedText(n + 1, 0);
+	for (int i = 0; i < n; i++)
+	{
+		rankedText[i] = ranks[text[i]];
+	}
+
+	std::vector<int> array(n + 1, 0);
+	InducedSorter(rankedText.data(), array.data(), n + 1, int(alphabet.size()) + 1).sort();
+
+	// the sentinel suffix is always sorted first
+	return std::vector<int>(array.begin() + 1, array.end());
+}
+
+std::vector<int> SuffixArray::buildSuffixArrayPrefixDoubling(const std::wstring& text)
 {
-	const int n = m_text.length();
+	const int n = text.length();
 	std::vector<suffix> suffixes;
 	suffixes.reserve(n);
 
@@ -139,8 +389,8 @@ std::vector<int> SuffixArray::buildSuffixArray()
 	for (int i = 0; i < n; i++)
 	{
 		s.index = i;
-		s.rank[0] = m_text[i];
-		s.rank[1] = ((i + 1) < n) ? (m_text[i + 1]) : -1;
+		s.rank[0] = text[i];
+		s.rank[1] = ((i + 1) < n) ? (text[i + 1]) : -1;
 		suffixes.push_back(s);
 	}
 
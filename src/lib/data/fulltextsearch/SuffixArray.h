@@ -8,10 +8,23 @@
 class SuffixArray
 {
 public:
-	SuffixArray(const std::wstring& text);
+	enum BuildAlgorithmType
+	{
+		BUILD_ALGORITHM_SAIS,	// linear time induced sorting
+		BUILD_ALGORITHM_PREFIX_DOUBLING	   // O(n log^2 n), kept as reference implementation
+	};
+
+	// builds the case insensitive suffix array only, without keeping a copy of the text or an LCP
+	static std::vector<int> buildArray(
+		const std::wstring& text, BuildAlgorithmType algorithm = BUILD_ALGORITHM_SAIS);
+
+	SuffixArray(const std::wstring& text, BuildAlgorithmType algorithm = BUILD_ALGORITHM_SAIS);
 	std::vector<int> searchForTerm(const std::wstring& searchTerm) const;
 	static int cmp(const struct suffix& a, const struct suffix& b);
 
+	const std::vector<int>& getArray() const;
+	const std::vector<int>& getLCP() const;
+
 	void printArray() const;
 	void printLCP() const;
 
@@ -26,8 +39,12 @@ private:
 		std::cout << std::endl;
 	}
 
+	static std::vector<int> buildLowerCaseArray(
+		const std::wstring& lowerCaseText, BuildAlgorithmType algorithm);
+	static std::vector<int> buildSuffixArraySAIS(const std::wstring& text);
+	static std::vector<int> buildSuffixArrayPrefixDoubling(const std::wstring& text);
+
 	std::vector<int> buildLCP();
-	std::vector<int> buildSuffixArray();
 	std::vector<int> m_array;
 	std::vector<int> m_lcp;
 	std::wstring m_text;
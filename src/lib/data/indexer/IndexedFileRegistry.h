@@ -0,0 +1,20 @@
+#ifndef INDEXED_FILE_REGISTRY_H
+#define INDEXED_FILE_REGISTRY_H
+
+#include <vector>
+
+#include "FilePath.h"
+
+// Files that a translation unit of the current indexing run indexed completely. Other translation
+// units parsed with the same preprocessor context still record these files, but skip their content.
+class IndexedFileRegistry
+{
+public:
+	virtual ~IndexedFileRegistry() = default;
+
+	virtual bool isFileIndexed(const FilePath& filePath, size_t preprocessorContextHash) = 0;
+	virtual void addIndexedFiles(
+		const std::vector<FilePath>& filePaths, size_t preprocessorContextHash) = 0;
+};
+
+#endif	  // INDEXED_FILE_REGISTRY_H
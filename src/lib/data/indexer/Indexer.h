@@ -17,6 +17,7 @@ public:
 	IndexerCommandType getSupportedIndexerCommandType() const override;
 	std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) override;
 	void interrupt() override;
+	void setIndexedFileRegistry(IndexedFileRegistry* indexedFileRegistry) override;
 
 private:
 	virtual void doIndex(
@@ -46,6 +47,12 @@ void Indexer<T>::interrupt()
 	m_indexerStateInfo->indexingInterrupted = true;
 }
 
+template <typename T>
+void Indexer<T>::setIndexedFileRegistry(IndexedFileRegistry* indexedFileRegistry)
+{
+	m_indexerStateInfo->indexedFileRegistry = indexedFileRegistry;
+}
+
 template <typename T>
 std::shared_ptr<IntermediateStorage> Indexer<T>::index(std::shared_ptr<IndexerCommand> indexerCommand)
 {
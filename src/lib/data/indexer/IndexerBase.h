@@ -7,6 +7,7 @@
 #include "IndexerCommandType.h"
 
 class FileRegister;
+class IndexedFileRegistry;
 class IndexerCommand;
 class IntermediateStorage;
 
@@ -20,6 +21,9 @@ public:
 	virtual std::shared_ptr<IntermediateStorage> index(
 		std::shared_ptr<IndexerCommand> indexerCommand) = 0;
 	virtual void interrupt() = 0;
+
+	// the registry has to outlive the indexer
+	virtual void setIndexedFileRegistry(IndexedFileRegistry* indexedFileRegistry) = 0;
 };
 
 #endif	  // INDEXER_BASE_H
@@ -20,6 +20,11 @@ size_t IndexerCommand::getByteSize(size_t stringSize) const
 	return utility::encodeToUtf8(m_sourceFilePath.wstr()).size();
 }
 
+size_t IndexerCommand::getPreprocessorContextHash() const
+{
+	return 0;
+}
+
 const FilePath& IndexerCommand::getSourceFilePath() const
 {
 	return m_sourceFilePath;
@@ -23,6 +23,9 @@ public:
 
 	virtual size_t getByteSize(size_t stringSize) const;
 
+	// commands with the same hash see the same content in files they share
+	virtual size_t getPreprocessorContextHash() const;
+
 	const FilePath& getSourceFilePath() const;
 
 protected:
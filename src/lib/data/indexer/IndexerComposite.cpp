@@ -37,3 +37,11 @@ void IndexerComposite::interrupt()
 		it.second->interrupt();
 	}
 }
+
+void IndexerComposite::setIndexedFileRegistry(IndexedFileRegistry* indexedFileRegistry)
+{
+	for (auto& it: m_indexers)
+	{
+		it.second->setIndexedFileRegistry(indexedFileRegistry);
+	}
+}
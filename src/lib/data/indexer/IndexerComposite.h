@@ -19,6 +19,8 @@ public:
 
 	void interrupt() override;
 
+	void setIndexedFileRegistry(IndexedFileRegistry* indexedFileRegistry) override;
+
 private:
 	std::map<IndexerCommandType, std::shared_ptr<IndexerBase>> m_indexers;
 };
@@ -1,10 +1,15 @@
 #ifndef INDEXER_STATE_INFO_H
 #define INDEXER_STATE_INFO_H
 
+class IndexedFileRegistry;
+
 struct IndexerStateInfo
 {
 public:
 	bool indexingInterrupted;
+
+	// files indexed by other translation units, nullptr if every translation unit indexes all files
+	IndexedFileRegistry* indexedFileRegistry = nullptr;
 };
 
 #endif	  // INDEXER_STATE_INFO_H
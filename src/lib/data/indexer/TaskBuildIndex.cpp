@@ -115,7 +115,8 @@ Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard)
 		updateIndexingDialog(blackboard, std::vector<FilePath>());
 	}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	// wakes up early when an indexer starts or finishes a file
+	m_interprocessIndexingStatusManager.waitForChange(50);
 
 	return STATE_RUNNING;
 }
@@ -49,7 +49,8 @@ Task::TaskState TaskFillIndexerCommandsQueue::doUpdate(std::shared_ptr<Blackboar
 		}
 	}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	// wakes up early when an indexer pops a command
+	m_indexerCommandManager.waitForChange(200);
 
 	return STATE_RUNNING;
 }
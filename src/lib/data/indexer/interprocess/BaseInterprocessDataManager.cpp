@@ -19,3 +19,14 @@ Id BaseInterprocessDataManager::getProcessId() const
 {
 	return m_processId;
 }
+
+void BaseInterprocessDataManager::waitForChange(size_t timeoutMS)
+{
+	m_sharedMemory.waitForChange(timeoutMS);
+}
+
+void BaseInterprocessDataManager::notifyChange()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+	access.notifyAll();
+}
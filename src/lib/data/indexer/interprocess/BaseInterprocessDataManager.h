@@ -20,6 +20,10 @@ public:
 
 	Id getProcessId() const;
 
+	// returns when another process changed the shared data or the timeout passed
+	void waitForChange(size_t timeoutMS);
+	void notifyChange();
+
 protected:
 	SharedMemory m_sharedMemory;
 
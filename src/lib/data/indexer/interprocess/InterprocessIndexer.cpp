@@ -1,8 +1,10 @@
 #include "InterprocessIndexer.h"
 
+#include "ApplicationSettings.h"
 #include "FileRegister.h"
 #include "IndexerCommand.h"
 #include "IndexerComposite.h"
+#include "IntermediateStorage.h"
 #include "LanguagePackageManager.h"
 #include "ScopedFunctor.h"
 #include "logging.h"
@@ -27,10 +29,17 @@ void InterprocessIndexer::work()
 		LOG_INFO_STREAM(<< m_processId << " starting up indexer");
 		indexer = LanguagePackageManager::getInstance()->instantiateSupportedIndexers();
 
+		const bool skipIndexedFiles =
+			ApplicationSettings::getInstance()->getIndexedHeaderSkippingEnabled();
+		if (skipIndexedFiles)
+		{
+			indexer->setIndexedFileRegistry(&m_interprocessIndexingStatusManager);
+		}
+
 		updaterThread = std::make_shared<std::thread>([&]() {
 			while (updaterThreadRunning)
 			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+				m_interprocessIndexingStatusManager.waitForChange(1000);
 
 				if (m_interprocessIndexingStatusManager.getIndexingInterrupted())
 				{
@@ -46,6 +55,7 @@ void InterprocessIndexer::work()
 
 		ScopedFunctor threadStopper([&]() {
 			updaterThreadRunning = false;
+			m_interprocessIndexingStatusManager.notifyChange();
 			if (updaterThread)
 			{
 				updaterThread->join();
@@ -74,7 +84,7 @@ void InterprocessIndexer::work()
 
 				LOG_INFO_STREAM(<< m_processId << " waits, too many intermediate storages: " << storageCount);
 
-				std::this_thread::sleep_for(std::chrono::milliseconds(200));
+				m_interprocessIntermediateStorageManager.waitForChange(200);
 			}
 
 			if (!updaterThreadRunning)
@@ -93,6 +103,21 @@ void InterprocessIndexer::work()
 			{
 				LOG_INFO_STREAM(<< m_processId << " pushing index to shared memory");
 				m_interprocessIntermediateStorageManager.pushIntermediateStorage(result);
+
+				if (skipIndexedFiles)
+				{
+					// only files without errors are registered, others may look different elsewhere
+					std::vector<FilePath> indexedFilePaths;
+					for (const StorageFile& file: result->getStorageFiles())
+					{
+						if (file.indexed && file.complete)
+						{
+							indexedFilePaths.emplace_back(file.filePath);
+						}
+					}
+					m_interprocessIndexingStatusManager.addIndexedFiles(
+						indexedFilePaths, indexerCommand->getPreprocessorContextHash());
+				}
 			}
 
 			LOG_INFO_STREAM(<< m_processId << " finalizing indexer status for current file");
@@ -56,6 +56,7 @@ void InterprocessIndexerCommandManager::pushIndexerCommands(
 		SharedIndexerCommand& sharedCommand = queue->back();
 		sharedCommand.fromLocal(command.get());
 	}
+	access.notifyAll();
 
 	LOG_INFO(access.logString());
 }
@@ -75,6 +76,7 @@ std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIndexerCom
 	std::shared_ptr<IndexerCommand> command = SharedIndexerCommand::fromShared(queue->front());
 
 	queue->pop_front();
+	access.notifyAll();
 
 	return command;
 }
@@ -92,6 +94,7 @@ void InterprocessIndexerCommandManager::clearIndexerCommands()
 	}
 
 	queue->clear();
+	access.notifyAll();
 }
 
 size_t InterprocessIndexerCommandManager::indexerCommandCount()
@@ -11,6 +11,7 @@ const char* InterprocessIndexingStatusManager::s_crashedFilesKeyName = "crashed_
 const char* InterprocessIndexingStatusManager::s_finishedProcessIdsKeyName = "finished_process_ids";
 const char* InterprocessIndexingStatusManager::s_indexingInterruptedKeyName =
 	"indexing_interrupted_flag";
+const char* InterprocessIndexingStatusManager::s_indexedFilesKeyName = "indexed_files";
 
 InterprocessIndexingStatusManager::InterprocessIndexingStatusManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
@@ -85,6 +86,8 @@ void InterprocessIndexingStatusManager::startIndexingSourceFile(const FilePath&
 		it = currentFilesPtr->insert(std::pair<Id, SharedMemory::String>(getProcessId(), str)).first;
 		it->second = str;
 	}
+
+	access.notifyAll();
 }
 
 void InterprocessIndexingStatusManager::finishIndexingSourceFile()
@@ -105,6 +108,8 @@ void InterprocessIndexingStatusManager::finishIndexingSourceFile()
 	{
 		finishedProcessIdsPtr->push_back(m_processId);
 	}
+
+	access.notifyAll();
 }
 
 void InterprocessIndexingStatusManager::setIndexingInterrupted(bool interrupted)
@@ -116,6 +121,8 @@ void InterprocessIndexingStatusManager::setIndexingInterrupted(bool interrupted)
 	{
 		*indexingInterruptedPtr = interrupted;
 	}
+
+	access.notifyAll();
 }
 
 bool InterprocessIndexingStatusManager::getIndexingInterrupted()
@@ -202,3 +209,69 @@ std::vector<FilePath> InterprocessIndexingStatusManager::getCrashedSourceFilePat
 
 	return crashedFiles;
 }
+
+bool InterprocessIndexingStatusManager::isFileIndexed(
+	const FilePath& filePath, size_t preprocessorContextHash)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Set<SharedMemory::String>* indexedFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Set<SharedMemory::String>>(
+			s_indexedFilesKeyName);
+	if (indexedFilesPtr)
+	{
+		SharedMemory::String key(access.getAllocator());
+		key = getIndexedFileKey(filePath, preprocessorContextHash).c_str();
+		return indexedFilesPtr->find(key) != indexedFilesPtr->end();
+	}
+
+	return false;
+}
+
+void InterprocessIndexingStatusManager::addIndexedFiles(
+	const std::vector<FilePath>& filePaths, size_t preprocessorContextHash)
+{
+	if (filePaths.empty())
+	{
+		return;
+	}
+
+	std::vector<std::string> keys;
+	size_t estimatedSize = 262144;
+	for (const FilePath& filePath: filePaths)
+	{
+		keys.push_back(getIndexedFileKey(filePath, preprocessorContextHash));
+		estimatedSize += sizeof(SharedMemory::String) + keys.back().size() + 64;
+	}
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	while (access.getFreeMemorySize() < estimatedSize)
+	{
+		LOG_INFO_STREAM(
+			<< "grow memory - est: " << estimatedSize << " size: " << access.getMemorySize()
+			<< " free: " << access.getFreeMemorySize() << " alloc: " << (access.getMemorySize()));
+		access.growMemory(access.getMemorySize());
+
+		LOG_INFO("growing memory succeeded");
+	}
+
+	SharedMemory::Set<SharedMemory::String>* indexedFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Set<SharedMemory::String>>(
+			s_indexedFilesKeyName);
+	if (indexedFilesPtr)
+	{
+		SharedMemory::String key(access.getAllocator());
+		for (const std::string& keyStr: keys)
+		{
+			key = keyStr.c_str();
+			indexedFilesPtr->insert(key);
+		}
+	}
+}
+
+std::string InterprocessIndexingStatusManager::getIndexedFileKey(
+	const FilePath& filePath, size_t preprocessorContextHash)
+{
+	return std::to_string(preprocessorContextHash) + ":" + utility::encodeToUtf8(filePath.wstr());
+}
@@ -5,8 +5,11 @@
 
 #include "BaseInterprocessDataManager.h"
 #include "FilePath.h"
+#include "IndexedFileRegistry.h"
 
-class InterprocessIndexingStatusManager: public BaseInterprocessDataManager
+class InterprocessIndexingStatusManager
+	: public BaseInterprocessDataManager
+	, public IndexedFileRegistry
 {
 public:
 	InterprocessIndexingStatusManager(const std::string& instanceUuid, Id processId, bool isOwner);
@@ -23,7 +26,13 @@ public:
 	std::vector<FilePath> getCurrentlyIndexedSourceFilePaths();
 	std::vector<FilePath> getCrashedSourceFilePaths();
 
+	bool isFileIndexed(const FilePath& filePath, size_t preprocessorContextHash) override;
+	void addIndexedFiles(
+		const std::vector<FilePath>& filePaths, size_t preprocessorContextHash) override;
+
 private:
+	static std::string getIndexedFileKey(const FilePath& filePath, size_t preprocessorContextHash);
+
 	static const char* s_sharedMemoryNamePrefix;
 
 	static const char* s_indexingFilesKeyName;
@@ -31,6 +40,7 @@ private:
 	static const char* s_crashedFilesKeyName;
 	static const char* s_finishedProcessIdsKeyName;
 	static const char* s_indexingInterruptedKeyName;
+	static const char* s_indexedFilesKeyName;
 };
 
 #endif	  // INTERPROCESS_INDEXING_STATUS_MANAGER_H
@@ -26,11 +26,10 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(
 {
 	const size_t requiredInsertsToShrink = 10;
 
-	const size_t overestimationMultiplier = 2;
-	const size_t requiredSize = (intermediateStorage->getByteSize(sizeof(SharedMemory::String)) +
-								 sizeof(SharedIntermediateStorage)) *
-			overestimationMultiplier +
-		1048576 /* 1 MB */;
+	// the storage is written into a single block of known size, the headroom covers the
+	// bookkeeping of the shared memory and the queue
+	const size_t requiredSize = SharedIntermediateStorage::getByteSize(*intermediateStorage) +
+		65536 /* 64 KB */;
 
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
@@ -62,20 +61,26 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(
 		return;
 	}
 
-	queue->push_back(SharedIntermediateStorage(access.getAllocator()));
-	SharedIntermediateStorage& storage = queue->back();
+	try
+	{
+		queue->emplace_back(*intermediateStorage, access.getAllocator());
+	}
+	catch (boost::interprocess::bad_alloc&)
+	{
+		// the free memory is too fragmented to hold the block
+		LOG_INFO_STREAM(
+			<< "grow fragmented memory - size: " << access.getMemorySize()
+			<< " free: " << access.getFreeMemorySize() << " alloc: " << requiredSize);
 
-	storage.setStorageNodes(intermediateStorage->getStorageNodes());
-	storage.setStorageFiles(intermediateStorage->getStorageFiles());
-	storage.setStorageSymbols(intermediateStorage->getStorageSymbols());
-	storage.setStorageEdges(intermediateStorage->getStorageEdges());
-	storage.setStorageLocalSymbols(intermediateStorage->getStorageLocalSymbols());
-	storage.setStorageSourceLocations(intermediateStorage->getStorageSourceLocations());
-	storage.setStorageOccurrences(intermediateStorage->getStorageOccurrences());
-	storage.setStorageComponentAccesses(intermediateStorage->getComponentAccesses());
-	storage.setStorageErrors(intermediateStorage->getErrors());
+		access.growMemory(requiredSize);
+		m_insertsWithoutGrowth = 0;
 
-	storage.setNextId(intermediateStorage->getNextId());
+		queue = access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
+			s_intermediatStoragesKeyName);
+		queue->emplace_back(*intermediateStorage, access.getAllocator());
+	}
+
+	access.notifyAll();
 
 	if (m_insertsWithoutGrowth >= requiredInsertsToShrink)
 	{
@@ -103,23 +108,10 @@ std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::pop
 		return nullptr;
 	}
 
-	SharedIntermediateStorage& sharedIntermediateStorage = queue->front();
-
-	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
-
-	storage->setStorageNodes(sharedIntermediateStorage.getStorageNodes());
-	storage->setStorageFiles(sharedIntermediateStorage.getStorageFiles());
-	storage->setStorageSymbols(sharedIntermediateStorage.getStorageSymbols());
-	storage->setStorageEdges(sharedIntermediateStorage.getStorageEdges());
-	storage->setStorageLocalSymbols(sharedIntermediateStorage.getStorageLocalSymbols());
-	storage->setStorageSourceLocations(sharedIntermediateStorage.getStorageSourceLocations());
-	storage->setStorageOccurrences(sharedIntermediateStorage.getStorageOccurrences());
-	storage->setComponentAccesses(sharedIntermediateStorage.getStorageComponentAccesses());
-	storage->setErrors(sharedIntermediateStorage.getStorageErrors());
-
-	storage->setNextId(sharedIntermediateStorage.getNextId());
+	std::shared_ptr<IntermediateStorage> storage = queue->front().createIntermediateStorage();
 
 	queue->pop_front();
+	access.notifyAll();
 	LOG_INFO(access.logString());
 
 	return storage;
@@ -1,234 +1,271 @@
 #include "SharedIntermediateStorage.h"
 
-SharedIntermediateStorage::SharedIntermediateStorage(SharedMemory::Allocator* allocator)
-	: m_storageFiles(allocator)
-	, m_storageSymbols(allocator)
-	, m_storageOccurrences(allocator)
-	, m_storageComponentAccesses(allocator)
-	, m_storageNodes(allocator)
-	, m_storageEdges(allocator)
-	, m_storageLocalSymbols(allocator)
-	, m_storageSourceLocations(allocator)
-	, m_storageErrors(allocator)
-	, m_allocator(allocator)
-	, m_nextId(1)
-{
-}
+#include <cstring>
 
-SharedIntermediateStorage::~SharedIntermediateStorage() {}
+#include "IntermediateStorage.h"
 
-std::vector<StorageFile> SharedIntermediateStorage::getStorageFiles() const
+namespace
 {
-	std::vector<StorageFile> result;
-	result.reserve(m_storageFiles.size());
-
-	for (unsigned int i = 0; i < m_storageFiles.size(); i++)
-	{
-		result.emplace_back(fromShared(m_storageFiles[i]));
-	}
+const uint64_t ALIGNMENT = 8;
 
-	return result;
+// places an array of records at the end of the layout, aligned for reading it in place
+template <typename T>
+SharedStorageArray appendArray(uint64_t* byteSize, uint64_t count)
+{
+	SharedStorageArray array;
+	array.offset = (*byteSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	array.count = count;
+	*byteSize = array.offset + count * sizeof(T);
+	return array;
 }
 
-void SharedIntermediateStorage::setStorageFiles(const std::vector<StorageFile>& storageFiles)
+SharedStorageHeader createHeader(const IntermediateStorage& storage, uint64_t* byteSize)
 {
-	m_storageFiles.clear();
-
-	for (unsigned int i = 0; i < storageFiles.size(); i++)
+	uint64_t textLength = 0;
+	for (const StorageNode& node: storage.getStorageNodes())
 	{
-		m_storageFiles.push_back(toShared(storageFiles[i], m_allocator));
+		textLength += node.serializedName.size();
 	}
-}
-
-std::vector<StorageNode> SharedIntermediateStorage::getStorageNodes() const
-{
-	std::vector<StorageNode> result;
-	result.reserve(m_storageNodes.size());
-
-	for (unsigned int i = 0; i < m_storageNodes.size(); i++)
+	for (const StorageFile& file: storage.getStorageFiles())
 	{
-		result.emplace_back(fromShared(m_storageNodes[i]));
+		textLength += file.filePath.size() + file.languageIdentifier.size();
 	}
-
-	return result;
-}
-
-void SharedIntermediateStorage::setStorageNodes(const std::vector<StorageNode>& storageNodes)
-{
-	m_storageNodes.clear();
-
-	for (unsigned int i = 0; i < storageNodes.size(); i++)
+	for (const StorageLocalSymbol& localSymbol: storage.getStorageLocalSymbols())
 	{
-		m_storageNodes.push_back(toShared(storageNodes[i], m_allocator));
+		textLength += localSymbol.name.size();
 	}
-}
-
-std::vector<StorageSymbol> SharedIntermediateStorage::getStorageSymbols() const
-{
-	std::vector<StorageSymbol> result;
-	result.reserve(m_storageSymbols.size());
-
-	for (unsigned int i = 0; i < m_storageSymbols.size(); i++)
+	for (const StorageError& error: storage.getErrors())
 	{
-		result.emplace_back(fromShared(m_storageSymbols[i]));
+		textLength += error.message.size() + error.translationUnit.size();
 	}
 
-	return result;
+	SharedStorageHeader header;
+	header.nextId = storage.getNextId();
+
+	*byteSize = sizeof(SharedStorageHeader);
+	header.nodes = appendArray<SharedStorageNode>(byteSize, storage.getStorageNodes().size());
+	header.files = appendArray<SharedStorageFile>(byteSize, storage.getStorageFiles().size());
+	header.symbols = appendArray<SharedStorageSymbol>(byteSize, storage.getStorageSymbols().size());
+	header.edges = appendArray<SharedStorageEdge>(byteSize, storage.getStorageEdges().size());
+	header.localSymbols = appendArray<SharedStorageLocalSymbol>(
+		byteSize, storage.getStorageLocalSymbols().size());
+	header.sourceLocations = appendArray<SharedStorageSourceLocation>(
+		byteSize, storage.getStorageSourceLocations().size());
+	header.occurrences = appendArray<SharedStorageOccurrence>(
+		byteSize, storage.getStorageOccurrences().size());
+	header.componentAccesses = appendArray<SharedStorageComponentAccess>(
+		byteSize, storage.getComponentAccesses().size());
+	header.errors = appendArray<SharedStorageError>(byteSize, storage.getErrors().size());
+	header.text = appendArray<wchar_t>(byteSize, textLength);
+	return header;
 }
 
-void SharedIntermediateStorage::setStorageSymbols(const std::vector<StorageSymbol>& storageSymbols)
+template <typename T, typename Byte>
+T* getArray(Byte* data, const SharedStorageArray& array)
 {
-	m_storageSymbols.clear();
-
-	for (unsigned int i = 0; i < storageSymbols.size(); i++)
-	{
-		m_storageSymbols.push_back(toShared(storageSymbols[i], m_allocator));
-	}
+	return reinterpret_cast<T*>(data + array.offset);
 }
 
-std::vector<StorageEdge> SharedIntermediateStorage::getStorageEdges() const
+template <typename T>
+void writeArray(char* data, const SharedStorageArray& array, const std::vector<T>& values)
 {
-	std::vector<StorageEdge> result;
-	result.reserve(m_storageEdges.size());
-
-	for (unsigned int i = 0; i < m_storageEdges.size(); i++)
+	if (!values.empty())
 	{
-		result.emplace_back(fromShared(m_storageEdges[i]));
+		std::memcpy(getArray<T>(data, array), values.data(), values.size() * sizeof(T));
 	}
-
-	return result;
 }
 
-void SharedIntermediateStorage::setStorageEdges(const std::vector<StorageEdge>& storageEdges)
+template <typename T>
+std::vector<T> readArray(const char* data, const SharedStorageArray& array)
 {
-	m_storageEdges.clear();
-
-	for (unsigned int i = 0; i < storageEdges.size(); i++)
-	{
-		m_storageEdges.push_back(toShared(storageEdges[i], m_allocator));
-	}
+	const T* begin = getArray<const T>(data, array);
+	return std::vector<T>(begin, begin + array.count);
 }
 
-std::set<StorageLocalSymbol> SharedIntermediateStorage::getStorageLocalSymbols() const
+SharedStorageString writeString(const std::wstring& str, wchar_t* text, uint64_t* textLength)
 {
-	std::set<StorageLocalSymbol> result;
+	SharedStorageString string;
+	string.offset = *textLength;
+	string.length = str.size();
 
-	for (unsigned int i = 0; i < m_storageLocalSymbols.size(); i++)
+	if (!str.empty())
 	{
-		result.emplace(fromShared(m_storageLocalSymbols[i]));
+		std::memcpy(text + string.offset, str.data(), str.size() * sizeof(wchar_t));
 	}
-
-	return result;
+	*textLength += str.size();
+	return string;
 }
 
-void SharedIntermediateStorage::setStorageLocalSymbols(
-	const std::set<StorageLocalSymbol>& storageLocalSymbols)
+std::wstring readString(const wchar_t* text, const SharedStorageString& string)
 {
-	m_storageLocalSymbols.clear();
+	return std::wstring(text + string.offset, string.length);
+}
+}	 // namespace
 
-	for (const StorageLocalSymbol& localSymbol: storageLocalSymbols)
-	{
-		m_storageLocalSymbols.push_back(toShared(localSymbol, m_allocator));
-	}
+size_t SharedIntermediateStorage::getByteSize(const IntermediateStorage& storage)
+{
+	uint64_t byteSize = 0;
+	createHeader(storage, &byteSize);
+	return byteSize;
 }
 
-std::set<StorageSourceLocation> SharedIntermediateStorage::getStorageSourceLocations() const
+SharedIntermediateStorage::SharedIntermediateStorage(
+	const IntermediateStorage& storage, SharedMemory::Allocator* allocator)
+	: m_data(allocator)
 {
-	std::set<StorageSourceLocation> result;
+	uint64_t byteSize = 0;
+	const SharedStorageHeader header = createHeader(storage, &byteSize);
 
-	for (unsigned int i = 0; i < m_storageSourceLocations.size(); i++)
-	{
-		result.emplace(fromShared(m_storageSourceLocations[i]));
-	}
+	m_data.resize(byteSize);
+	char* data = &m_data[0];
 
-	return result;
-}
+	std::memcpy(data, &header, sizeof(SharedStorageHeader));
 
-void SharedIntermediateStorage::setStorageSourceLocations(
-	const std::set<StorageSourceLocation>& storageSourceLocations)
-{
-	m_storageSourceLocations.clear();
+	wchar_t* text = getArray<wchar_t>(data, header.text);
+	uint64_t textLength = 0;
 
-	for (const StorageSourceLocation& sourceLocation: storageSourceLocations)
 	{
-		m_storageSourceLocations.push_back(toShared(sourceLocation, m_allocator));
+		const std::vector<StorageNode>& storageNodes = storage.getStorageNodes();
+		SharedStorageNode* nodes = getArray<SharedStorageNode>(data, header.nodes);
+		for (size_t i = 0; i < storageNodes.size(); i++)
+		{
+			nodes[i].id = storageNodes[i].id;
+			nodes[i].type = storageNodes[i].type;
+			nodes[i].serializedName = writeString(
+				storageNodes[i].serializedName, text, &textLength);
+		}
 	}
-}
-
-std::set<StorageOccurrence> SharedIntermediateStorage::getStorageOccurrences() const
-{
-	std::set<StorageOccurrence> result;
 
-	for (unsigned int i = 0; i < m_storageOccurrences.size(); i++)
 	{
-		result.emplace(fromShared(m_storageOccurrences[i]));
+		const std::vector<StorageFile>& storageFiles = storage.getStorageFiles();
+		SharedStorageFile* files = getArray<SharedStorageFile>(data, header.files);
+		for (size_t i = 0; i < storageFiles.size(); i++)
+		{
+			files[i].id = storageFiles[i].id;
+			files[i].filePath = writeString(storageFiles[i].filePath, text, &textLength);
+			files[i].languageIdentifier = writeString(
+				storageFiles[i].languageIdentifier, text, &textLength);
+			files[i].indexed = storageFiles[i].indexed;
+			files[i].complete = storageFiles[i].complete;
+		}
 	}
 
-	return result;
-}
-
-void SharedIntermediateStorage::setStorageOccurrences(const std::set<StorageOccurrence>& storageOccurences)
-{
-	m_storageOccurrences.clear();
-
-	for (const StorageOccurrence& occurrence: storageOccurences)
 	{
-		m_storageOccurrences.push_back(toShared(occurrence, m_allocator));
+		const std::vector<StorageLocalSymbol>& storageLocalSymbols =
+			storage.getStorageLocalSymbols();
+		SharedStorageLocalSymbol* localSymbols = getArray<SharedStorageLocalSymbol>(
+			data, header.localSymbols);
+		for (size_t i = 0; i < storageLocalSymbols.size(); i++)
+		{
+			localSymbols[i].id = storageLocalSymbols[i].id;
+			localSymbols[i].name = writeString(storageLocalSymbols[i].name, text, &textLength);
+		}
 	}
-}
-
-std::set<StorageComponentAccess> SharedIntermediateStorage::getStorageComponentAccesses() const
-{
-	std::set<StorageComponentAccess> result;
 
-	for (unsigned int i = 0; i < m_storageComponentAccesses.size(); i++)
 	{
-		result.emplace(fromShared(m_storageComponentAccesses[i]));
+		const std::vector<StorageError>& storageErrors = storage.getErrors();
+		SharedStorageError* errors = getArray<SharedStorageError>(data, header.errors);
+		for (size_t i = 0; i < storageErrors.size(); i++)
+		{
+			errors[i].id = storageErrors[i].id;
+			errors[i].message = writeString(storageErrors[i].message, text, &textLength);
+			errors[i].translationUnit = writeString(
+				storageErrors[i].translationUnit, text, &textLength);
+			errors[i].fatal = storageErrors[i].fatal;
+			errors[i].indexed = storageErrors[i].indexed;
+		}
 	}
 
-	return result;
+	writeArray(data, header.symbols, storage.getStorageSymbols());
+	writeArray(data, header.edges, storage.getStorageEdges());
+	writeArray(data, header.sourceLocations, storage.getStorageSourceLocations());
+	writeArray(data, header.occurrences, storage.getStorageOccurrences());
+	writeArray(data, header.componentAccesses, storage.getComponentAccesses());
 }
 
-void SharedIntermediateStorage::setStorageComponentAccesses(
-	const std::set<StorageComponentAccess>& storageComponentAccesses)
+std::shared_ptr<IntermediateStorage> SharedIntermediateStorage::createIntermediateStorage() const
 {
-	m_storageComponentAccesses.clear();
+	const char* data = &m_data[0];
 
-	for (const StorageComponentAccess& componentAccess: storageComponentAccesses)
-	{
-		m_storageComponentAccesses.push_back(toShared(componentAccess, m_allocator));
-	}
-}
+	SharedStorageHeader header;
+	std::memcpy(&header, data, sizeof(SharedStorageHeader));
 
-std::vector<StorageError> SharedIntermediateStorage::getStorageErrors() const
-{
-	std::vector<StorageError> result;
-	result.reserve(m_storageErrors.size());
+	const wchar_t* text = getArray<const wchar_t>(data, header.text);
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
 
-	for (unsigned int i = 0; i < m_storageErrors.size(); i++)
 	{
-		result.emplace_back(fromShared(m_storageErrors[i]));
+		const SharedStorageNode* sharedNodes = getArray<const SharedStorageNode>(
+			data, header.nodes);
+		std::vector<StorageNode> nodes;
+		nodes.reserve(header.nodes.count);
+		for (size_t i = 0; i < header.nodes.count; i++)
+		{
+			nodes.emplace_back(
+				sharedNodes[i].id,
+				sharedNodes[i].type,
+				readString(text, sharedNodes[i].serializedName));
+		}
+		storage->setStorageNodes(std::move(nodes));
 	}
 
-	return result;
-}
+	{
+		const SharedStorageFile* sharedFiles = getArray<const SharedStorageFile>(
+			data, header.files);
+		std::vector<StorageFile> files;
+		files.reserve(header.files.count);
+		for (size_t i = 0; i < header.files.count; i++)
+		{
+			files.emplace_back(
+				sharedFiles[i].id,
+				readString(text, sharedFiles[i].filePath),
+				readString(text, sharedFiles[i].languageIdentifier),
+				"",
+				sharedFiles[i].indexed,
+				sharedFiles[i].complete);
+		}
+		storage->setStorageFiles(std::move(files));
+	}
 
-void SharedIntermediateStorage::setStorageErrors(const std::vector<StorageError>& errors)
-{
-	m_storageErrors.clear();
+	{
+		const SharedStorageLocalSymbol* sharedLocalSymbols =
+			getArray<const SharedStorageLocalSymbol>(data, header.localSymbols);
+		std::vector<StorageLocalSymbol> localSymbols;
+		localSymbols.reserve(header.localSymbols.count);
+		for (size_t i = 0; i < header.localSymbols.count; i++)
+		{
+			localSymbols.emplace_back(
+				sharedLocalSymbols[i].id, readString(text, sharedLocalSymbols[i].name));
+		}
+		storage->setStorageLocalSymbols(std::move(localSymbols));
+	}
 
-	for (unsigned int i = 0; i < errors.size(); i++)
 	{
-		m_storageErrors.push_back(toShared(errors[i], m_allocator));
+		const SharedStorageError* sharedErrors = getArray<const SharedStorageError>(
+			data, header.errors);
+		std::vector<StorageError> errors;
+		errors.reserve(header.errors.count);
+		for (size_t i = 0; i < header.errors.count; i++)
+		{
+			errors.emplace_back(
+				sharedErrors[i].id,
+				readString(text, sharedErrors[i].message),
+				readString(text, sharedErrors[i].translationUnit),
+				sharedErrors[i].fatal,
+				sharedErrors[i].indexed);
+		}
+		storage->setErrors(std::move(errors));
 	}
-}
 
-Id SharedIntermediateStorage::getNextId() const
-{
-	return m_nextId;
-}
+	storage->setStorageSymbols(readArray<SharedStorageSymbol>(data, header.symbols));
+	storage->setStorageEdges(readArray<SharedStorageEdge>(data, header.edges));
+	storage->setStorageSourceLocations(
+		readArray<SharedStorageSourceLocation>(data, header.sourceLocations));
+	storage->setStorageOccurrences(readArray<SharedStorageOccurrence>(data, header.occurrences));
+	storage->setComponentAccesses(
+		readArray<SharedStorageComponentAccess>(data, header.componentAccesses));
 
-void SharedIntermediateStorage::setNextId(const Id nextId)
-{
-	m_nextId = nextId;
+	storage->setNextId(header.nextId);
+
+	return storage;
 }
@@ -20,22 +20,26 @@ std::wstring NameHierarchy::serialize(const NameHierarchy& nameHierarchy)
 
 std::wstring NameHierarchy::serializeRange(const NameHierarchy& nameHierarchy, size_t first, size_t last)
 {
-	std::wstringstream ss;
-	ss << nameHierarchy.getDelimiter();
-	ss << META_DELIMITER;
+	std::wstring serializedName = nameHierarchy.getDelimiter() + META_DELIMITER;
 	for (size_t i = first; i < last && i < nameHierarchy.size(); i++)
 	{
-		if (i > 0)
-		{
-			ss << NAME_DELIMITER;
-		}
+		serializeElement(nameHierarchy, i, &serializedName);
+	}
+	return serializedName;
+}
 
-		ss << nameHierarchy[i].getName() << PART_DELIMITER;
-		ss << nameHierarchy[i].getSignature().getPrefix();
-		ss << SIGNATURE_DELIMITER;
-		ss << nameHierarchy[i].getSignature().getPostfix();
+void NameHierarchy::serializeElement(
+	const NameHierarchy& nameHierarchy, size_t index, std::wstring* serializedName)
+{
+	if (index > 0)
+	{
+		serializedName->append(NAME_DELIMITER);
 	}
-	return ss.str();
+
+	const NameElement& element = nameHierarchy[index];
+	serializedName->append(element.getName()).append(PART_DELIMITER);
+	serializedName->append(element.getSignature().getPrefix()).append(SIGNATURE_DELIMITER);
+	serializedName->append(element.getSignature().getPostfix());
 }
 
 NameHierarchy NameHierarchy::deserialize(const std::wstring& serializedName)
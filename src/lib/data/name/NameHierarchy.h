@@ -12,6 +12,9 @@ class NameHierarchy
 public:
 	static std::wstring serialize(const NameHierarchy& nameHierarchy);
 	static std::wstring serializeRange(const NameHierarchy& nameHierarchy, size_t first, size_t last);
+	// appends the element at index to the serialized range of the elements before it
+	static void serializeElement(
+		const NameHierarchy& nameHierarchy, size_t index, std::wstring* serializedName);
 	static NameHierarchy deserialize(const std::wstring& serializedName);
 
 	NameHierarchy(std::wstring delimiter);
@@ -1,9 +1,29 @@
 #include "ParserClientImpl.h"
 
+#include <functional>
+
 #include "Edge.h"
 #include "Node.h"
 #include "ParseLocation.h"
 
+namespace
+{
+const std::wstring NO_DELIMITER;
+
+size_t getInternedNameHash(const std::wstring& delimiter, const NameElement& element)
+{
+	size_t hash = std::hash<std::wstring>()(delimiter);
+	hash = HashIndex::combine(hash, std::hash<std::wstring>()(element.getName()));
+	hash = HashIndex::combine(hash, std::hash<std::wstring>()(element.getSignature().getPrefix()));
+	return HashIndex::combine(hash, std::hash<std::wstring>()(element.getSignature().getPostfix()));
+}
+
+size_t getNameNodeHash(Id parentNodeId, size_t nameId)
+{
+	return HashIndex::combine(std::hash<Id>()(parentNodeId), std::hash<size_t>()(nameId));
+}
+}	 // namespace
+
 ParserClientImpl::ParserClientImpl(IntermediateStorage* const storage): m_storage(storage) {}
 
 Id ParserClientImpl::recordFile(const FilePath& filePath, bool indexed)
@@ -201,18 +221,47 @@ LocationType ParserClientImpl::parseLocationTypeToLocationType(ParseLocationType
 
 Id ParserClientImpl::addNodeHierarchy(const NameHierarchy& nameHierarchy)
 {
+	const size_t size = nameHierarchy.size();
+
+	// the longest prefix of the name that was added before is looked up without serializing it
+	Id knownNodeId = 0;
+	size_t knownCount = 0;
+	size_t nameId = 0;
+	while (knownCount < size)
+	{
+		nameId = internName(nameHierarchy, knownCount);
+		const Id nodeId = findNameNode(knownNodeId, nameId);
+		if (!nodeId)
+		{
+			break;
+		}
+
+		knownNodeId = nodeId;
+		knownCount++;
+	}
+
+	if (knownCount == size)
+	{
+		return knownNodeId;
+	}
+
+	std::vector<std::wstring> serializedNames;
+	serializedNames.reserve(size - knownCount);
+	std::wstring serializedName = NameHierarchy::serializeRange(nameHierarchy, 0, knownCount);
+	for (size_t i = knownCount; i < size; i++)
+	{
+		NameHierarchy::serializeElement(nameHierarchy, i, &serializedName);
+		serializedNames.push_back(serializedName);
+	}
+
+	// the nodes are added starting with the full name, so they keep their ids
+	std::vector<Id> nodeIds(size - knownCount, 0);
 	Id childNodeId = 0;
-	Id firstNodeId = 0;
-	for (size_t i = nameHierarchy.size(); i > 0; i--)
+	for (size_t i = size; i > knownCount; i--)
 	{
 		std::pair<Id, bool> ret = m_storage->addNode(StorageNodeData(
 			NodeType::typeToInt(NodeType::NODE_SYMBOL),
-			NameHierarchy::serializeRange(nameHierarchy, 0, i)));
-
-		if (!firstNodeId)
-		{
-			firstNodeId = ret.first;
-		}
+			std::move(serializedNames[i - knownCount - 1])));
 
 		if (childNodeId != 0)
 		{
@@ -221,12 +270,74 @@ Id ParserClientImpl::addNodeHierarchy(const NameHierarchy& nameHierarchy)
 
 		if (!ret.second)
 		{
-			return firstNodeId;
+			// the node was added to the storage by someone else, so are its parents
+			return nodeIds.back() ? nodeIds.back() : ret.first;
 		}
 
+		nodeIds[i - knownCount - 1] = ret.first;
 		childNodeId = ret.first;
 	}
-	return firstNodeId;
+
+	if (knownNodeId != 0)
+	{
+		addEdge(Edge::EDGE_MEMBER, knownNodeId, childNodeId);
+	}
+
+	Id parentNodeId = knownNodeId;
+	for (size_t i = knownCount; i < size; i++)
+	{
+		if (i > knownCount)
+		{
+			nameId = internName(nameHierarchy, i);
+		}
+		addNameNode(parentNodeId, nameId, nodeIds[i - knownCount]);
+		parentNodeId = nodeIds[i - knownCount];
+	}
+
+	return nodeIds.back();
+}
+
+size_t ParserClientImpl::internName(const NameHierarchy& nameHierarchy, size_t index)
+{
+	const std::wstring& delimiter = index == 0 ? nameHierarchy.getDelimiter() : NO_DELIMITER;
+	const NameElement& element = nameHierarchy[index];
+
+	const size_t hash = getInternedNameHash(delimiter, element);
+	const size_t position = m_internedNamesIndex.find(hash, [&](size_t position) {
+		const InternedName& name = m_internedNames[position];
+		return name.name == element.getName() &&
+			name.signaturePrefix == element.getSignature().getPrefix() &&
+			name.signaturePostfix == element.getSignature().getPostfix() &&
+			name.delimiter == delimiter;
+	});
+	if (position != HashIndex::NOT_FOUND)
+	{
+		return position;
+	}
+
+	m_internedNames.push_back(
+		{delimiter,
+		 element.getName(),
+		 element.getSignature().getPrefix(),
+		 element.getSignature().getPostfix()});
+	m_internedNamesIndex.insert(hash, m_internedNames.size() - 1);
+	return m_internedNames.size() - 1;
+}
+
+Id ParserClientImpl::findNameNode(Id parentNodeId, size_t nameId) const
+{
+	const size_t position = m_nameNodesIndex.find(
+		getNameNodeHash(parentNodeId, nameId), [&](size_t position) {
+			return m_nameNodes[position].parentNodeId == parentNodeId &&
+				m_nameNodes[position].nameId == nameId;
+		});
+	return position != HashIndex::NOT_FOUND ? m_nameNodes[position].nodeId : 0;
+}
+
+void ParserClientImpl::addNameNode(Id parentNodeId, size_t nameId, Id nodeId)
+{
+	m_nameNodes.push_back({parentNodeId, nameId, nodeId});
+	m_nameNodesIndex.insert(getNameNodeHash(parentNodeId, nameId), m_nameNodes.size() - 1);
 }
 
 Id ParserClientImpl::addFileName(const FilePath& filePath)
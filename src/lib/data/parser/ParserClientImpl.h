@@ -4,6 +4,7 @@
 #include <set>
 
 #include "DefinitionKind.h"
+#include "HashIndex.h"
 #include "IntermediateStorage.h"
 #include "LocationType.h"
 #include "Node.h"
@@ -42,6 +43,23 @@ public:
 	bool hasContent() const override;
 
 private:
+	// last element of a symbol name, the delimiter is only set for the first element
+	struct InternedName
+	{
+		std::wstring delimiter;
+		std::wstring name;
+		std::wstring signaturePrefix;
+		std::wstring signaturePostfix;
+	};
+
+	// symbol node known by its parent node and the last element of its name
+	struct NameNode
+	{
+		Id parentNodeId;
+		size_t nameId;
+		Id nodeId;
+	};
+
 	NodeType symbolKindToNodeType(SymbolKind symbolType) const;
 	Edge::EdgeType referenceKindToEdgeType(ReferenceKind referenceKind) const;
 	LocationType parseLocationTypeToLocationType(ParseLocationType type) const;
@@ -49,6 +67,9 @@ private:
 	void addAccess(Id nodeId, AccessKind access);
 
 	Id addNodeHierarchy(const NameHierarchy& nameHierarchy);
+	size_t internName(const NameHierarchy& nameHierarchy, size_t index);
+	Id findNameNode(Id parentNodeId, size_t nameId) const;
+	void addNameNode(Id parentNodeId, size_t nameId, Id nodeId);
 	Id addFileName(const FilePath& filePath);
 	Id addEdge(int type, Id sourceId, Id targetId);
 
@@ -56,6 +77,13 @@ private:
 
 	IntermediateStorage* const m_storage;
 	std::map<std::wstring, Id> m_fileIdMap;
+
+	// names of the symbol nodes of this translation unit, the serialized name of a symbol node is
+	// only built once when the node is added to the storage
+	HashIndex m_internedNamesIndex;
+	std::vector<InternedName> m_internedNames;
+	HashIndex m_nameNodesIndex;
+	std::vector<NameNode> m_nameNodes;
 };
 
 #endif	  // PARSER_CLIENT_IMPL_H
@@ -1,12 +1,68 @@
 #include "SearchIndex.h"
 
 #include <algorithm>
+#include <cstring>
 #include <ctype.h>
 #include <iterator>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FilePath.h"
+#include "logging.h"
+#include "tracing.h"
 #include "utility.h"
 #include "utilityString.h"
 
+namespace
+{
+const SidecarFile searchIndexFile(
+	"search index", SearchIndexFileHeader::MAGIC, SearchIndexFileHeader::VERSION);
+
+void addToGate(SearchIndexFileGate& gate, wchar_t c)
+{
+	// the bloom mask may give false positives, this only keeps a subtree from being skipped
+	if (uint32_t(c) < 128)
+	{
+		gate.asciiMask[c / 64] |= uint64_t(1) << (c % 64);
+	}
+	else
+	{
+		gate.otherMask |= uint64_t(1) << ((uint32_t(c) * 2654435761u) >> 26);
+	}
+}
+
+void addToGate(SearchIndexFileGate& gate, const SearchIndexFileGate& other)
+{
+	gate.asciiMask[0] |= other.asciiMask[0];
+	gate.asciiMask[1] |= other.asciiMask[1];
+	gate.otherMask |= other.otherMask;
+}
+
+bool gateContains(const SearchIndexFileGate& gate, const SearchIndexFileGate& other)
+{
+	return (gate.asciiMask[0] & other.asciiMask[0]) == other.asciiMask[0] &&
+		(gate.asciiMask[1] & other.asciiMask[1]) == other.asciiMask[1] &&
+		(gate.otherMask & other.otherMask) == other.otherMask;
+}
+
+uint64_t appendData(std::vector<char>& buffer, const void* data, size_t size)
+{
+	// keep all arrays 8 byte aligned, so they can be accessed in place when the file is mapped
+	buffer.resize((buffer.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t));
+
+	const uint64_t offset = buffer.size();
+	const char* begin = static_cast<const char*>(data);
+	buffer.insert(buffer.end(), begin, begin + size);
+	return offset;
+}
+
+bool isInBounds(uint64_t offset, uint64_t count, size_t elementSize, size_t size)
+{
+	return offset <= size && count <= (size - offset) / elementSize;
+}
+}	 // namespace
+
 SearchIndex::SearchIndex()
 {
 	clear();
@@ -16,81 +72,95 @@ SearchIndex::~SearchIndex() {}
 
 void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
 {
-	SearchNode* currentNode = m_root;
+	m_addedNodes.push_back({std::move(name), id, type.getType()});
+}
 
-	while (name.size() > 0)
-	{
-		currentNode->containedTypes.add(type);
+void SearchIndex::finishSetup()
+{
+	// sorting puts names with common prefixes next to each other, so each node of the trie covers
+	// a consecutive range. Equal names keep their order, so the first type added for an id wins.
+	std::stable_sort(
+		m_addedNodes.begin(), m_addedNodes.end(), [](const AddedNode& a, const AddedNode& b) {
+			return a.name < b.name;
+		});
 
-		auto it = currentNode->edges.find(name[0]);
-		if (it != currentNode->edges.end())
-		{
-			SearchEdge* currentEdge = it->second;
-			const std::wstring& edgeString = currentEdge->s;
+	BuildData data;
+	data.nodes.push_back(SearchIndexFileNode());
+	buildNode(data, 0, 0, m_addedNodes.size(), 0);
 
-			size_t matchCount = 1;
-			for (size_t j = 1; j < edgeString.size() && j < name.size(); j++)
-			{
-				if (edgeString[j] != name[j])
-				{
-					break;
-				}
-				matchCount++;
-			}
+	m_addedNodes.clear();
+	m_addedNodes.shrink_to_fit();
 
-			if (matchCount < edgeString.size())
-			{
-				// split current edge
-				m_nodes.push_back(std::make_unique<SearchNode>(currentNode->containedTypes));
-				SearchNode* n = m_nodes.back().get();
+	pack(data);
+}
 
-				m_edges.push_back(std::make_unique<SearchEdge>(
-					currentEdge->target, edgeString.substr(matchCount)));
-				SearchEdge* e = m_edges.back().get();
+void SearchIndex::clear()
+{
+	m_addedNodes.clear();
 
-				n->edges.emplace(e->s[0], e);
+	BuildData data;
+	data.nodes.push_back(SearchIndexFileNode());
+	pack(data);
+}
 
-				currentEdge->s = edgeString.substr(0, matchCount);
-				currentEdge->target = n;
-			}
+bool SearchIndex::load(const FilePath& filePath, const std::string& storageTime)
+{
+	TRACE();
 
-			name = name.substr(matchCount);
-			currentNode = currentEdge->target;
-		}
-		else
-		{
-			m_nodes.push_back(std::make_unique<SearchNode>(currentNode->containedTypes));
-			SearchNode* n = m_nodes.back().get();
+	clear();
 
-			m_edges.push_back(std::make_unique<SearchEdge>(n, std::move(name)));
-			SearchEdge* e = m_edges.back().get();
+	std::unique_ptr<boost::interprocess::file_mapping> mapping;
+	std::unique_ptr<boost::interprocess::mapped_region> region;
+	if (!searchIndexFile.map(filePath, sizeof(SearchIndexFileHeader), &mapping, &region))
+	{
+		return false;
+	}
 
-			currentNode->edges.emplace(e->s[0], e);
-			currentNode = n;
+	const char* data = static_cast<const char*>(region->get_address());
+	const size_t size = region->get_size();
 
-			name.clear();
-		}
+	SearchIndexFileHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (!searchIndexFile.checkHeader(&header.sidecar, storageTime))
+	{
+		return false;
 	}
 
-	currentNode->elementIds.emplace(id, type);
-}
-
-void SearchIndex::finishSetup()
-{
-	for (auto& p: m_root->edges)
+	if (!attach(data, size))
 	{
-		populateEdgeGate(p.second);
+		LOG_WARNING("Search index file is corrupted.");
+		clear();
+		return false;
 	}
+
+	m_buffer.clear();
+	m_buffer.shrink_to_fit();
+	m_mapping = std::move(mapping);
+	m_region = std::move(region);
+	return true;
 }
 
-void SearchIndex::clear()
+bool SearchIndex::save(const FilePath& filePath, const std::string& storageTime) const
 {
-	m_nodes.clear();
-	m_edges.clear();
+	TRACE();
+
+	if (!m_data)
+	{
+		return false;
+	}
 
-	m_nodes.push_back(std::make_unique<SearchNode>(NodeTypeSet()));
+	SearchIndexFileHeader header;
+	std::memcpy(&header, m_data, sizeof(header));
+	if (!searchIndexFile.initHeader(&header.sidecar, storageTime))
+	{
+		return false;
+	}
 
-	m_root = m_nodes.back().get();
+	return searchIndexFile.write(filePath, [&](std::ostream& stream) {
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(m_data + sizeof(header), m_size - sizeof(header));
+		return true;
+	});
 }
 
 std::vector<SearchResult> SearchIndex::search(
@@ -99,14 +169,19 @@ std::vector<SearchResult> SearchIndex::search(
 	size_t maxResultCount,
 	size_t maxBestScoredResultsLength) const
 {
+	NodeType::TypeMask acceptedTypes = 0;
+	for (const NodeType& type: acceptedNodeTypes.getNodeTypes())
+	{
+		acceptedTypes |= type.getType();
+	}
+
 	// find paths containing query
 	std::vector<SearchPath> paths;
-	searchRecursive(
-		SearchPath(L"", {}, m_root), utility::toLowerCase(query), acceptedNodeTypes, &paths);
+	searchRecursive(SearchPath(L"", {}, 0), utility::toLowerCase(query), acceptedTypes, &paths);
 
 	// create scored search results
 	std::multiset<SearchResult> searchResults = createScoredResults(
-		paths, acceptedNodeTypes, maxResultCount * 3);
+		paths, acceptedTypes, maxResultCount * 3);
 
 	// find maximum length for best scores
 	std::multiset<size_t> resultLengths;
@@ -144,62 +219,259 @@ std::vector<SearchResult> SearchIndex::search(
 	return std::vector<SearchResult>(bestResults.begin(), it);
 }
 
-void SearchIndex::populateEdgeGate(SearchEdge* e)
+size_t SearchIndex::getNodeCount() const
 {
-	for (auto& p: e->target->edges)
+	return m_nodeCount;
+}
+
+size_t SearchIndex::getEdgeCount() const
+{
+	return m_edgeCount;
+}
+
+SearchIndexFileGate SearchIndex::buildNode(
+	BuildData& data, uint32_t nodeIndex, size_t begin, size_t end, size_t depth) const
+{
+	// names that end at this node come first in the sorted range
+	size_t childBegin = begin;
+	while (childBegin < end && m_addedNodes[childBegin].name.size() == depth)
+	{
+		childBegin++;
+	}
+
+	std::vector<SearchIndexFileElement> elements;
+	for (size_t i = begin; i < childBegin; i++)
+	{
+		SearchIndexFileElement element;
+		element.id = m_addedNodes[i].id;
+		element.type = m_addedNodes[i].type;
+		element.reserved = 0;
+		elements.push_back(element);
+	}
+	std::stable_sort(
+		elements.begin(),
+		elements.end(),
+		[](const SearchIndexFileElement& a, const SearchIndexFileElement& b) {
+			return a.id < b.id;
+		});
+	elements.erase(
+		std::unique(
+			elements.begin(),
+			elements.end(),
+			[](const SearchIndexFileElement& a, const SearchIndexFileElement& b) {
+				return a.id == b.id;
+			}),
+		elements.end());
+
+	NodeType::TypeMask containedTypes = 0;
+	for (const SearchIndexFileElement& element: elements)
+	{
+		containedTypes |= element.type;
+	}
+
+	data.nodes[nodeIndex].firstElementIndex = uint32_t(data.elements.size());
+	data.nodes[nodeIndex].elementCount = uint32_t(elements.size());
+	data.elements.insert(data.elements.end(), elements.begin(), elements.end());
+
+	// all edges of a node are added before any of its children, so they stay adjacent
+	struct ChildRange
+	{
+		size_t begin;
+		size_t end;
+		size_t depth;
+	};
+	std::vector<ChildRange> childRanges;
+
+	data.nodes[nodeIndex].firstEdgeIndex = uint32_t(data.edges.size());
+	for (size_t i = childBegin; i < end;)
+	{
+		const std::wstring& firstName = m_addedNodes[i].name;
+
+		size_t j = i + 1;
+		while (j < end && m_addedNodes[j].name[depth] == firstName[depth])
+		{
+			j++;
+		}
+
+		// the common prefix of a sorted range is the one of its first and last name
+		const std::wstring& lastName = m_addedNodes[j - 1].name;
+		size_t childDepth = depth + 1;
+		while (childDepth < firstName.size() && childDepth < lastName.size() &&
+			   firstName[childDepth] == lastName[childDepth])
+		{
+			childDepth++;
+		}
+
+		SearchIndexFileEdge edge = SearchIndexFileEdge();
+		edge.targetIndex = uint32_t(data.nodes.size());
+		edge.textOffset = uint32_t(data.text.size());
+		edge.textLength = uint32_t(childDepth - depth);
+		data.text.insert(
+			data.text.end(), firstName.begin() + depth, firstName.begin() + childDepth);
+
+		data.edges.push_back(edge);
+		data.nodes.push_back(SearchIndexFileNode());
+		childRanges.push_back({i, j, childDepth});
+
+		i = j;
+	}
+	data.nodes[nodeIndex].edgeCount = uint32_t(childRanges.size());
+
+	SearchIndexFileGate nodeGate = SearchIndexFileGate();
+	for (size_t i = 0; i < childRanges.size(); i++)
+	{
+		const size_t edgeIndex = data.nodes[nodeIndex].firstEdgeIndex + i;
+		const uint32_t targetIndex = data.edges[edgeIndex].targetIndex;
+
+		SearchIndexFileGate gate = buildNode(
+			data, targetIndex, childRanges[i].begin, childRanges[i].end, childRanges[i].depth);
+
+		SearchIndexFileEdge& edge = data.edges[edgeIndex];
+		for (size_t k = 0; k < edge.textLength; k++)
+		{
+			addToGate(gate, wchar_t(towlower(data.text[edge.textOffset + k])));
+		}
+		edge.gate = gate;
+
+		addToGate(nodeGate, gate);
+		containedTypes |= data.nodes[targetIndex].containedTypes;
+	}
+
+	data.nodes[nodeIndex].containedTypes = containedTypes;
+	return nodeGate;
+}
+
+void SearchIndex::pack(const BuildData& data)
+{
+	SearchIndexFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	searchIndexFile.initHeader(&header.sidecar, "");
+	header.nodeCount = data.nodes.size();
+	header.edgeCount = data.edges.size();
+	header.elementCount = data.elements.size();
+	header.textLength = data.text.size();
+
+	std::vector<char> buffer(sizeof(header));
+	header.nodesOffset = appendData(
+		buffer, data.nodes.data(), data.nodes.size() * sizeof(SearchIndexFileNode));
+	header.edgesOffset = appendData(
+		buffer, data.edges.data(), data.edges.size() * sizeof(SearchIndexFileEdge));
+	header.elementsOffset = appendData(
+		buffer, data.elements.data(), data.elements.size() * sizeof(SearchIndexFileElement));
+	header.textOffset = appendData(buffer, data.text.data(), data.text.size() * sizeof(uint32_t));
+	std::memcpy(buffer.data(), &header, sizeof(header));
+
+	m_region.reset();
+	m_mapping.reset();
+	m_buffer = std::move(buffer);
+	attach(m_buffer.data(), m_buffer.size());
+}
+
+bool SearchIndex::attach(const char* data, size_t size)
+{
+	if (size < sizeof(SearchIndexFileHeader))
 	{
-		SearchEdge* targetEdge = p.second;
-		populateEdgeGate(targetEdge);
-		utility::append(e->gate, targetEdge->gate);
+		return false;
 	}
 
-	for (const wchar_t& c: e->s)
+	SearchIndexFileHeader header;
+	std::memcpy(&header, data, sizeof(header));
+
+	if (header.sidecar.magic != SearchIndexFileHeader::MAGIC ||
+		header.sidecar.version != SearchIndexFileHeader::VERSION || header.nodeCount == 0 ||
+		!isInBounds(header.nodesOffset, header.nodeCount, sizeof(SearchIndexFileNode), size) ||
+		!isInBounds(header.edgesOffset, header.edgeCount, sizeof(SearchIndexFileEdge), size) ||
+		!isInBounds(
+			header.elementsOffset, header.elementCount, sizeof(SearchIndexFileElement), size) ||
+		!isInBounds(header.textOffset, header.textLength, sizeof(uint32_t), size))
 	{
-		e->gate.insert(towlower(c));
+		return false;
+	}
+
+	const SearchIndexFileNode* nodes = reinterpret_cast<const SearchIndexFileNode*>(
+		data + header.nodesOffset);
+	const SearchIndexFileEdge* edges = reinterpret_cast<const SearchIndexFileEdge*>(
+		data + header.edgesOffset);
+
+	// edges only point to nodes further back, so a search always ends even for a broken file
+	for (size_t i = 0; i < header.nodeCount; i++)
+	{
+		const SearchIndexFileNode& node = nodes[i];
+		if (uint64_t(node.firstEdgeIndex) + node.edgeCount > header.edgeCount ||
+			uint64_t(node.firstElementIndex) + node.elementCount > header.elementCount)
+		{
+			return false;
+		}
+
+		for (uint32_t j = node.firstEdgeIndex; j < node.firstEdgeIndex + node.edgeCount; j++)
+		{
+			if (edges[j].targetIndex <= i || edges[j].targetIndex >= header.nodeCount ||
+				uint64_t(edges[j].textOffset) + edges[j].textLength > header.textLength)
+			{
+				return false;
+			}
+		}
+	}
+
+	m_data = data;
+	m_size = size;
+	m_nodes = nodes;
+	m_nodeCount = header.nodeCount;
+	m_edges = edges;
+	m_edgeCount = header.edgeCount;
+	m_elements = reinterpret_cast<const SearchIndexFileElement*>(data + header.elementsOffset);
+	m_elementCount = header.elementCount;
+	m_text = reinterpret_cast<const uint32_t*>(data + header.textOffset);
+	m_textLength = header.textLength;
+	return true;
+}
+
+void SearchIndex::appendEdgeText(const SearchIndexFileEdge& edge, std::wstring* text) const
+{
+	for (size_t i = edge.textOffset; i < edge.textOffset + edge.textLength; i++)
+	{
+		text->push_back(wchar_t(m_text[i]));
 	}
 }
 
 void SearchIndex::searchRecursive(
 	const SearchPath& path,
 	const std::wstring& remainingQuery,
-	NodeTypeSet acceptedNodeTypes,
+	NodeType::TypeMask acceptedTypes,
 	std::vector<SearchIndex::SearchPath>* results) const
 {
-	for (const auto& p: path.node->edges)
+	SearchIndexFileGate queryGate = SearchIndexFileGate();
+	for (const wchar_t& c: remainingQuery)
+	{
+		addToGate(queryGate, c);
+	}
+
+	const SearchIndexFileNode& node = m_nodes[path.nodeIndex];
+	for (uint32_t i = node.firstEdgeIndex; i < node.firstEdgeIndex + node.edgeCount; i++)
 	{
-		const SearchEdge* currentEdge = p.second;
+		const SearchIndexFileEdge& currentEdge = m_edges[i];
 
-		if (!acceptedNodeTypes.intersectsWith(currentEdge->target->containedTypes))
+		if (!(acceptedTypes & m_nodes[currentEdge.targetIndex].containedTypes))
 		{
 			continue;
 		}
 
 		// test if s passes the edge's gate.
-		bool passesGate = true;
-		for (const wchar_t& c: remainingQuery)
-		{
-			if (currentEdge->gate.find(c) == currentEdge->gate.end())
-			{
-				passesGate = false;
-				break;
-			}
-		}
-
-		if (!passesGate)
+		if (!gateContains(currentEdge.gate, queryGate))
 		{
 			continue;
 		}
 
 		// consume characters for edge
-		const std::wstring& edgeString = currentEdge->s;
-		SearchPath currentPath {path.text + edgeString, path.indices, currentEdge->target};
+		SearchPath currentPath {path.text, path.indices, currentEdge.targetIndex};
+		appendEdgeText(currentEdge, &currentPath.text);
 
 		size_t j = 0;
-		for (size_t i = 0; i < edgeString.size() && j < remainingQuery.size(); i++)
+		for (size_t k = 0; k < currentEdge.textLength && j < remainingQuery.size(); k++)
 		{
-			if (towlower(edgeString[i]) == remainingQuery[j])
+			if (towlower(currentPath.text[path.text.size() + k]) == remainingQuery[j])
 			{
-				currentPath.indices.push_back(path.text.size() + i);
+				currentPath.indices.push_back(path.text.size() + k);
 				j++;
 			}
 		}
@@ -210,13 +482,15 @@ void SearchIndex::searchRecursive(
 		}
 		else
 		{
-			searchRecursive(currentPath, remainingQuery.substr(j), acceptedNodeTypes, results);
+			searchRecursive(currentPath, remainingQuery.substr(j), acceptedTypes, results);
 		}
 	}
 }
 
 std::multiset<SearchResult> SearchIndex::createScoredResults(
-	const std::vector<SearchPath>& paths, NodeTypeSet acceptedNodeTypes, size_t maxResultCount) const
+	const std::vector<SearchPath>& paths,
+	NodeType::TypeMask acceptedTypes,
+	size_t maxResultCount) const
 {
 	// score and order initial paths
 	std::multimap<int, SearchPath, std::greater<int>> scoredPaths;
@@ -238,15 +512,17 @@ std::multiset<SearchResult> SearchIndex::createScoredResults(
 
 			for (const SearchPath& path: currentPaths)
 			{
-				if (!path.node->elementIds.empty() &&
-					(acceptedNodeTypes.intersectsWith(path.node->containedTypes)))
+				const SearchIndexFileNode& node = m_nodes[path.nodeIndex];
+				if (node.elementCount && (acceptedTypes & node.containedTypes))
 				{
 					std::vector<Id> elementIds;
-					for (const auto& p: path.node->elementIds)
+					for (uint32_t i = node.firstElementIndex;
+						 i < node.firstElementIndex + node.elementCount;
+						 i++)
 					{
-						if (acceptedNodeTypes.contains(p.second))
+						if (acceptedTypes & m_elements[i].type)
 						{
-							elementIds.push_back(p.first);
+							elementIds.push_back(m_elements[i].id);
 						}
 					}
 
@@ -265,10 +541,12 @@ std::multiset<SearchResult> SearchIndex::createScoredResults(
 					}
 				}
 
-				for (auto p: path.node->edges)
+				for (uint32_t i = node.firstEdgeIndex; i < node.firstEdgeIndex + node.edgeCount;
+					 i++)
 				{
-					const SearchEdge* edge = p.second;
-					nextPaths.emplace_back(path.text + edge->s, path.indices, edge->target);
+					const SearchIndexFileEdge& edge = m_edges[i];
+					nextPaths.emplace_back(path.text, path.indices, edge.targetIndex);
+					appendEdgeText(edge, &nextPaths.back().text);
 				}
 			}
 
@@ -1,6 +1,7 @@
 #ifndef SEARCH_INDEX_H
 #define SEARCH_INDEX_H
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <set>
@@ -9,6 +10,7 @@
 
 #include "Node.h"
 #include "NodeTypeSet.h"
+#include "SearchIndexFile.h"
 #include "types.h"
 
 // SearchResult is only used as an internal type in the SearchIndex and the PersistentStorage
@@ -33,16 +35,38 @@ struct SearchResult
 	int score;
 };
 
+namespace boost
+{
+namespace interprocess
+{
+class file_mapping;
+class mapped_region;
+}	 // namespace interprocess
+}	 // namespace boost
+
+class FilePath;
+
+// Trie of all added names, built once in finishSetup. The nodes, edges and elements are stored in
+// contiguous arrays that reference each other by index. The edges of a node are adjacent and sorted
+// by their first character, the edge texts share a single buffer. Each edge carries a gate mask of
+// all lower case characters on and below it, so a query can skip a whole subtree with one check.
+// The arrays use the layout of the search index file, so a saved index is searched in place after
+// memory-mapping it with load.
 class SearchIndex
 {
 public:
 	SearchIndex();
 	virtual ~SearchIndex();
 
+	// the added names are collected until finishSetup builds the trie from all of them
 	void addNode(Id id, std::wstring name, NodeType type = NodeType::NODE_SYMBOL);
 	void finishSetup();
 	void clear();
 
+	// memory-maps an index file, fails if the file was written for a different storage state
+	bool load(const FilePath& filePath, const std::string& storageTime);
+	bool save(const FilePath& filePath, const std::string& storageTime) const;
+
 	// maxResultCount == 0 means "no restriction".
 	std::vector<SearchResult> search(
 		const std::wstring& query,
@@ -50,49 +74,53 @@ public:
 		size_t maxResultCount,
 		size_t maxBestScoredResultsLength = 0) const;
 
-private:
-	struct SearchEdge;
+	size_t getNodeCount() const;
+	size_t getEdgeCount() const;
 
-	struct SearchNode
+private:
+	struct AddedNode
 	{
-		SearchNode(NodeTypeSet containedTypes): containedTypes(containedTypes) {}
-
-		std::map<Id, NodeType> elementIds;
-		NodeTypeSet containedTypes;
-		std::map<wchar_t, SearchEdge*> edges;
+		std::wstring name;
+		Id id;
+		NodeType::Type type;
 	};
 
-	struct SearchEdge
+	struct BuildData
 	{
-		SearchEdge(SearchNode* target, std::wstring s): target(target), s(std::move(s)) {}
-
-		SearchNode* target;
-		std::wstring s;
-		std::set<wchar_t> gate;
+		std::vector<SearchIndexFileNode> nodes;
+		std::vector<SearchIndexFileEdge> edges;
+		std::vector<SearchIndexFileElement> elements;
+		std::vector<uint32_t> text;
 	};
 
 	struct SearchPath
 	{
-		SearchPath(std::wstring text, std::vector<size_t> indices, SearchNode* node)
-			: text(std::move(text)), indices(std::move(indices)), node(node)
+		SearchPath(std::wstring text, std::vector<size_t> indices, uint32_t nodeIndex)
+			: text(std::move(text)), indices(std::move(indices)), nodeIndex(nodeIndex)
 		{
 		}
 
 		std::wstring text;
 		std::vector<size_t> indices;
-		SearchNode* node;
+		uint32_t nodeIndex;
 	};
 
-	void populateEdgeGate(SearchEdge* e);
+	SearchIndexFileGate buildNode(
+		BuildData& data, uint32_t nodeIndex, size_t begin, size_t end, size_t depth) const;
+	void pack(const BuildData& data);
+	bool attach(const char* data, size_t size);
+
+	void appendEdgeText(const SearchIndexFileEdge& edge, std::wstring* text) const;
+
 	void searchRecursive(
 		const SearchPath& path,
 		const std::wstring& remainingQuery,
-		NodeTypeSet acceptedNodeTypes,
+		NodeType::TypeMask acceptedTypes,
 		std::vector<SearchIndex::SearchPath>* results) const;
 
 	std::multiset<SearchResult> createScoredResults(
 		const std::vector<SearchPath>& paths,
-		NodeTypeSet acceptedNodeTypes,
+		NodeType::TypeMask acceptedTypes,
 		size_t maxResultCount) const;
 
 	static SearchResult bestScoredResult(
@@ -119,9 +147,23 @@ public:
 	static bool isNoLetter(const wchar_t c);
 
 private:
-	std::vector<std::unique_ptr<SearchNode>> m_nodes;
-	std::vector<std::unique_ptr<SearchEdge>> m_edges;
-	SearchNode* m_root;
+	std::vector<AddedNode> m_addedNodes;
+
+	std::vector<char> m_buffer;
+	std::unique_ptr<boost::interprocess::file_mapping> m_mapping;
+	std::unique_ptr<boost::interprocess::mapped_region> m_region;
+
+	const char* m_data = nullptr;
+	size_t m_size = 0;
+
+	const SearchIndexFileNode* m_nodes = nullptr;
+	size_t m_nodeCount = 0;
+	const SearchIndexFileEdge* m_edges = nullptr;
+	size_t m_edgeCount = 0;
+	const SearchIndexFileElement* m_elements = nullptr;
+	size_t m_elementCount = 0;
+	const uint32_t* m_text = nullptr;
+	size_t m_textLength = 0;
 };
 
 #endif	  // SEARCH_INDEX_H
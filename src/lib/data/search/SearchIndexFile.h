@@ -0,0 +1,64 @@
+#ifndef SEARCH_INDEX_FILE_H
+#define SEARCH_INDEX_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SidecarFile.h"
+
+// On-disk layout of a search index trie that is stored next to the index database. The same layout
+// is used in memory, so a mapped file can be searched in place. The header is followed by the node,
+// edge and element arrays and the edge texts as 32 bit characters. The edges of each node are
+// adjacent and every edge points to a node with a higher index than its own node. All offsets are
+// in bytes, relative to the start of the file.
+
+struct SearchIndexFileHeader
+{
+	static const uint64_t MAGIC = 0x5849535254435253;	// "SRCTRSIX"
+	static const uint32_t VERSION = 1;
+
+	SidecarFileHeader sidecar;
+	uint64_t nodeCount;
+	uint64_t nodesOffset;
+	uint64_t edgeCount;
+	uint64_t edgesOffset;
+	uint64_t elementCount;
+	uint64_t elementsOffset;
+	uint64_t textLength;
+	uint64_t textOffset;
+};
+
+struct SearchIndexFileNode
+{
+	uint32_t firstEdgeIndex;
+	uint32_t edgeCount;
+	uint32_t firstElementIndex;
+	uint32_t elementCount;
+	int32_t containedTypes;	   // NodeType::Type flags of all elements at and below the node
+	uint32_t reserved;
+};
+
+// lower case characters on and below an edge, exact below 128 and as bloom mask above
+struct SearchIndexFileGate
+{
+	uint64_t asciiMask[2];
+	uint64_t otherMask;
+};
+
+struct SearchIndexFileEdge
+{
+	uint32_t targetIndex;
+	uint32_t textOffset;
+	uint32_t textLength;
+	uint32_t reserved;
+	SearchIndexFileGate gate;
+};
+
+struct SearchIndexFileElement
+{
+	uint64_t id;
+	int32_t type;
+	uint32_t reserved;
+};
+
+#endif	  // SEARCH_INDEX_FILE_H
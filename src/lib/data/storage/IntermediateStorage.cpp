@@ -1,9 +1,111 @@
 #include "IntermediateStorage.h"
 
+#include <algorithm>
+#include <functional>
+#include <set>
+
 #include "LocationType.h"
 #include "utility.h"
 
-IntermediateStorage::IntermediateStorage(): m_nextId(1) {}
+namespace
+{
+size_t getHash(const StorageNodeData& node)
+{
+	return std::hash<std::wstring>()(node.serializedName);
+}
+
+size_t getHash(const StorageFile& file)
+{
+	return std::hash<std::wstring>()(file.filePath);
+}
+
+size_t getHash(const StorageEdgeData& edge)
+{
+	size_t hash = std::hash<int>()(edge.type);
+	hash = HashIndex::combine(hash, std::hash<Id>()(edge.sourceNodeId));
+	return HashIndex::combine(hash, std::hash<Id>()(edge.targetNodeId));
+}
+
+size_t getHash(const StorageLocalSymbolData& localSymbol)
+{
+	return std::hash<std::wstring>()(localSymbol.name);
+}
+
+size_t getHash(const StorageSourceLocationData& location)
+{
+	size_t hash = std::hash<Id>()(location.fileNodeId);
+	hash = HashIndex::combine(hash, std::hash<size_t>()(location.startLine));
+	hash = HashIndex::combine(hash, std::hash<size_t>()(location.startCol));
+	hash = HashIndex::combine(hash, std::hash<size_t>()(location.endLine));
+	hash = HashIndex::combine(hash, std::hash<size_t>()(location.endCol));
+	return HashIndex::combine(hash, std::hash<int>()(location.type));
+}
+
+size_t getHash(const StorageErrorData& error)
+{
+	size_t hash = std::hash<std::wstring>()(error.message);
+	hash = HashIndex::combine(hash, std::hash<std::wstring>()(error.translationUnit));
+	return HashIndex::combine(hash, (error.fatal ? 2 : 0) + (error.indexed ? 1 : 0));
+}
+
+// elements are treated as duplicates if neither is ordered before the other, like in a std::set
+template <typename FirstType, typename SecondType>
+bool isEquivalent(const FirstType& first, const SecondType& second)
+{
+	return !(first < second) && !(second < first);
+}
+
+template <typename ElementType, typename DataType>
+size_t findElement(
+	const HashIndex& index,
+	const std::vector<ElementType>& elements,
+	const DataType& data,
+	size_t hash)
+{
+	return index.find(hash, [&](size_t position) { return isEquivalent(elements[position], data); });
+}
+
+template <typename ElementType>
+void buildIndex(HashIndex& index, const std::vector<ElementType>& elements)
+{
+	index.clear();
+	index.reserve(elements.size());
+	for (size_t i = 0; i < elements.size(); i++)
+	{
+		// only the first of equivalent elements is found, like with std::map::emplace
+		const size_t hash = getHash(elements[i]);
+		if (findElement(index, elements, elements[i], hash) == HashIndex::NOT_FOUND)
+		{
+			index.insert(hash, i);
+		}
+	}
+}
+
+template <typename ElementType>
+void sortUnique(std::vector<ElementType>& elements)
+{
+	// the stable sort keeps the first inserted of equivalent elements, like std::set::insert
+	std::stable_sort(elements.begin(), elements.end());
+	elements.erase(
+		std::unique(
+			elements.begin(),
+			elements.end(),
+			[](const ElementType& first, const ElementType& second) {
+				return isEquivalent(first, second);
+			}),
+		elements.end());
+}
+}	 // namespace
+
+IntermediateStorage::IntermediateStorage()
+	: m_localSymbolsSorted(true)
+	, m_sourceLocationsSorted(true)
+	, m_occurrencesUnique(true)
+	, m_componentAccessesUnique(true)
+	, m_elementComponentsUnique(true)
+	, m_nextId(1)
+{
+}
 
 void IntermediateStorage::clear()
 {
@@ -20,10 +122,22 @@ void IntermediateStorage::clear()
 	m_edgesIndex.clear();
 	m_edges.clear();
 
+	m_localSymbolsIndex.clear();
 	m_localSymbols.clear();
+	m_localSymbolsSorted = true;
+
+	m_sourceLocationsIndex.clear();
 	m_sourceLocations.clear();
+	m_sourceLocationsSorted = true;
+
 	m_occurrences.clear();
+	m_occurrencesUnique = true;
+
 	m_componentAccesses.clear();
+	m_componentAccessesUnique = true;
+
+	m_elementComponents.clear();
+	m_elementComponentsUnique = true;
 
 	m_errorsIndex.clear();
 	m_errors.clear();
@@ -118,10 +232,11 @@ void IntermediateStorage::setFilesWithErrorsIncomplete()
 
 std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData)
 {
-	auto it = m_nodesIndex.find(nodeData);
-	if (it != m_nodesIndex.end())
+	const size_t hash = getHash(nodeData);
+	const size_t position = findElement(m_nodesIndex, m_nodes, nodeData, hash);
+	if (position != HashIndex::NOT_FOUND)
 	{
-		StorageNode& storedNode = m_nodes[it->second];
+		StorageNode& storedNode = m_nodes[position];
 		if (storedNode.type < nodeData.type)
 		{
 			storedNode.type = nodeData.type;
@@ -131,7 +246,7 @@ std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData
 
 	Id nodeId = m_nextId++;
 	m_nodes.emplace_back(nodeId, nodeData);
-	m_nodesIndex.emplace(nodeData, m_nodes.size() - 1);
+	m_nodesIndex.insert(hash, m_nodes.size() - 1);
 	m_nodeIdIndex.emplace(nodeId, m_nodes.size() - 1);
 	return std::make_pair(nodeId, true);
 }
@@ -168,10 +283,11 @@ void IntermediateStorage::addSymbols(const std::vector<StorageSymbol>& symbols)
 
 void IntermediateStorage::addFile(const StorageFile& file)
 {
-	auto it = m_filesIndex.find(file);
-	if (it != m_filesIndex.end())
+	const size_t hash = getHash(file);
+	const size_t position = findElement(m_filesIndex, m_files, file, hash);
+	if (position != HashIndex::NOT_FOUND)
 	{
-		StorageFile& storedFile = m_files[it->second];
+		StorageFile& storedFile = m_files[position];
 
 		if (file.indexed)
 		{
@@ -190,7 +306,7 @@ void IntermediateStorage::addFile(const StorageFile& file)
 	}
 	else
 	{
-		m_filesIndex.emplace(file, m_files.size());
+		m_filesIndex.insert(hash, m_files.size());
 		m_filesIdIndex.emplace(file.id, m_files.size());
 		m_files.emplace_back(file);
 	}
@@ -207,15 +323,16 @@ void IntermediateStorage::setFileLanguage(Id fileId, const std::wstring& languag
 
 Id IntermediateStorage::addEdge(const StorageEdgeData& edgeData)
 {
-	auto it = m_edgesIndex.find(edgeData);
-	if (it != m_edgesIndex.end())
+	const size_t hash = getHash(edgeData);
+	const size_t position = findElement(m_edgesIndex, m_edges, edgeData, hash);
+	if (position != HashIndex::NOT_FOUND)
 	{
-		return m_edges[it->second].id;
+		return m_edges[position].id;
 	}
 
 	Id edgeId = m_nextId++;
 	m_edges.emplace_back(edgeId, edgeData);
-	m_edgesIndex.emplace(edgeData, m_edges.size() - 1);
+	m_edgesIndex.insert(hash, m_edges.size() - 1);
 	return edgeId;
 }
 
@@ -232,18 +349,21 @@ std::vector<Id> IntermediateStorage::addEdges(const std::vector<StorageEdge>& ed
 
 Id IntermediateStorage::addLocalSymbol(const StorageLocalSymbolData& localSymbolData)
 {
-	auto it = m_localSymbols.find(StorageLocalSymbol(0, localSymbolData));
-	if (it != m_localSymbols.end())
+	const size_t hash = getHash(localSymbolData);
+	const size_t position = findElement(m_localSymbolsIndex, m_localSymbols, localSymbolData, hash);
+	if (position != HashIndex::NOT_FOUND)
 	{
-		return it->id;
+		return m_localSymbols[position].id;
 	}
 
 	Id localSymbolId = m_nextId++;
-	m_localSymbols.emplace(localSymbolId, localSymbolData);
+	m_localSymbols.emplace_back(localSymbolId, localSymbolData);
+	m_localSymbolsIndex.insert(hash, m_localSymbols.size() - 1);
+	m_localSymbolsSorted = false;
 	return localSymbolId;
 }
 
-std::vector<Id> IntermediateStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> IntermediateStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	std::vector<Id> symbolIds;
 	symbolIds.reserve(symbols.size());
@@ -256,14 +376,18 @@ std::vector<Id> IntermediateStorage::addLocalSymbols(const std::set<StorageLocal
 
 Id IntermediateStorage::addSourceLocation(const StorageSourceLocationData& sourceLocationData)
 {
-	auto it = m_sourceLocations.find(StorageSourceLocation(0, sourceLocationData));
-	if (it != m_sourceLocations.end())
+	const size_t hash = getHash(sourceLocationData);
+	const size_t position = findElement(
+		m_sourceLocationsIndex, m_sourceLocations, sourceLocationData, hash);
+	if (position != HashIndex::NOT_FOUND)
 	{
-		return it->id;
+		return m_sourceLocations[position].id;
 	}
 
 	Id sourceLocationId = m_nextId++;
-	m_sourceLocations.emplace(sourceLocationId, sourceLocationData);
+	m_sourceLocations.emplace_back(sourceLocationId, sourceLocationData);
+	m_sourceLocationsIndex.insert(hash, m_sourceLocations.size() - 1);
+	m_sourceLocationsSorted = false;
 	return sourceLocationId;
 }
 
@@ -280,45 +404,53 @@ std::vector<Id> IntermediateStorage::addSourceLocations(const std::vector<Storag
 
 void IntermediateStorage::addOccurrence(const StorageOccurrence& occurrence)
 {
-	m_occurrences.emplace(occurrence);
+	m_occurrences.push_back(occurrence);
+	m_occurrencesUnique = false;
 }
 
 void IntermediateStorage::addOccurrences(const std::vector<StorageOccurrence>& occurrences)
 {
-	m_occurrences.insert(occurrences.begin(), occurrences.end());
+	m_occurrences.insert(m_occurrences.end(), occurrences.begin(), occurrences.end());
+	m_occurrencesUnique = false;
 }
 
 void IntermediateStorage::addComponentAccess(const StorageComponentAccess& componentAccess)
 {
-	m_componentAccesses.emplace(componentAccess);
+	m_componentAccesses.push_back(componentAccess);
+	m_componentAccessesUnique = false;
 }
 
 void IntermediateStorage::addComponentAccesses(const std::vector<StorageComponentAccess>& componentAccesses)
 {
-	m_componentAccesses.insert(componentAccesses.begin(), componentAccesses.end());
+	m_componentAccesses.insert(
+		m_componentAccesses.end(), componentAccesses.begin(), componentAccesses.end());
+	m_componentAccessesUnique = false;
 }
 
 void IntermediateStorage::addElementComponent(const StorageElementComponent& component)
 {
-	m_elementComponents.emplace(component);
+	m_elementComponents.push_back(component);
+	m_elementComponentsUnique = false;
 }
 
 void IntermediateStorage::addElementComponents(const std::vector<StorageElementComponent>& components)
 {
-	m_elementComponents.insert(components.begin(), components.end());
+	m_elementComponents.insert(m_elementComponents.end(), components.begin(), components.end());
+	m_elementComponentsUnique = false;
 }
 
 Id IntermediateStorage::addError(const StorageErrorData& errorData)
 {
-	auto it = m_errorsIndex.find(errorData);
-	if (it != m_errorsIndex.end())
+	const size_t hash = getHash(errorData);
+	const size_t position = findElement(m_errorsIndex, m_errors, errorData, hash);
+	if (position != HashIndex::NOT_FOUND)
 	{
-		return m_errors[it->second].id;
+		return m_errors[position].id;
 	}
 
 	Id errorId = m_nextId++;
 	m_errors.emplace_back(errorId, errorData);
-	m_errorsIndex.emplace(errorData, m_errors.size() - 1);
+	m_errorsIndex.insert(hash, m_errors.size() - 1);
 	return errorId;
 }
 
@@ -342,28 +474,45 @@ const std::vector<StorageEdge>& IntermediateStorage::getStorageEdges() const
 	return m_edges;
 }
 
-const std::set<StorageLocalSymbol>& IntermediateStorage::getStorageLocalSymbols() const
+const std::vector<StorageLocalSymbol>& IntermediateStorage::getStorageLocalSymbols() const
 {
+	sortLocalSymbols();
 	return m_localSymbols;
 }
 
-const std::set<StorageSourceLocation>& IntermediateStorage::getStorageSourceLocations() const
+const std::vector<StorageSourceLocation>& IntermediateStorage::getStorageSourceLocations() const
 {
+	sortSourceLocations();
 	return m_sourceLocations;
 }
 
-const std::set<StorageOccurrence>& IntermediateStorage::getStorageOccurrences() const
+const std::vector<StorageOccurrence>& IntermediateStorage::getStorageOccurrences() const
 {
+	if (!m_occurrencesUnique)
+	{
+		sortUnique(m_occurrences);
+		m_occurrencesUnique = true;
+	}
 	return m_occurrences;
 }
 
-const std::set<StorageComponentAccess>& IntermediateStorage::getComponentAccesses() const
+const std::vector<StorageComponentAccess>& IntermediateStorage::getComponentAccesses() const
 {
+	if (!m_componentAccessesUnique)
+	{
+		sortUnique(m_componentAccesses);
+		m_componentAccessesUnique = true;
+	}
 	return m_componentAccesses;
 }
 
-const std::set<StorageElementComponent>& IntermediateStorage::getElementComponents() const
+const std::vector<StorageElementComponent>& IntermediateStorage::getElementComponents() const
 {
+	if (!m_elementComponentsUnique)
+	{
+		sortUnique(m_elementComponents);
+		m_elementComponentsUnique = true;
+	}
 	return m_elementComponents;
 }
 
@@ -376,11 +525,10 @@ void IntermediateStorage::setStorageNodes(std::vector<StorageNode> storageNodes)
 {
 	m_nodes = std::move(storageNodes);
 
-	m_nodesIndex.clear();
+	buildIndex(m_nodesIndex, m_nodes);
 	m_nodeIdIndex.clear();
 	for (size_t i = 0; i < m_nodes.size(); i++)
 	{
-		m_nodesIndex.emplace(m_nodes[i], i);
 		m_nodeIdIndex.emplace(m_nodes[i].id, i);
 	}
 }
@@ -389,11 +537,10 @@ void IntermediateStorage::setStorageFiles(std::vector<StorageFile> storageFiles)
 {
 	m_files = std::move(storageFiles);
 
-	m_filesIndex.clear();
+	buildIndex(m_filesIndex, m_files);
 	m_filesIdIndex.clear();
 	for (size_t i = 0; i < m_files.size(); i++)
 	{
-		m_filesIndex.emplace(m_files[i], i);
 		m_filesIdIndex.emplace(m_files[i].id, i);
 	}
 }
@@ -407,47 +554,47 @@ void IntermediateStorage::setStorageEdges(std::vector<StorageEdge> storageEdges)
 {
 	m_edges = std::move(storageEdges);
 
-	m_edgesIndex.clear();
-	for (size_t i = 0; i < m_edges.size(); i++)
-	{
-		m_edgesIndex.emplace(m_edges[i], i);
-	}
+	buildIndex(m_edgesIndex, m_edges);
 }
 
-void IntermediateStorage::setStorageLocalSymbols(std::set<StorageLocalSymbol> storageLocalSymbols)
+void IntermediateStorage::setStorageLocalSymbols(std::vector<StorageLocalSymbol> storageLocalSymbols)
 {
 	m_localSymbols = std::move(storageLocalSymbols);
+	m_localSymbolsSorted = false;
+	sortLocalSymbols();
 }
 
-void IntermediateStorage::setStorageSourceLocations(std::set<StorageSourceLocation> storageSourceLocations)
+void IntermediateStorage::setStorageSourceLocations(
+	std::vector<StorageSourceLocation> storageSourceLocations)
 {
 	m_sourceLocations = std::move(storageSourceLocations);
+	m_sourceLocationsSorted = false;
+	sortSourceLocations();
 }
 
-void IntermediateStorage::setStorageOccurrences(std::set<StorageOccurrence> storageOccurrences)
+void IntermediateStorage::setStorageOccurrences(std::vector<StorageOccurrence> storageOccurrences)
 {
 	m_occurrences = std::move(storageOccurrences);
+	m_occurrencesUnique = false;
 }
 
-void IntermediateStorage::setComponentAccesses(std::set<StorageComponentAccess> componentAccesses)
+void IntermediateStorage::setComponentAccesses(std::vector<StorageComponentAccess> componentAccesses)
 {
 	m_componentAccesses = std::move(componentAccesses);
+	m_componentAccessesUnique = false;
 }
 
-void IntermediateStorage::setElementComponents(std::set<StorageElementComponent> components)
+void IntermediateStorage::setElementComponents(std::vector<StorageElementComponent> components)
 {
 	m_elementComponents = std::move(components);
+	m_elementComponentsUnique = false;
 }
 
 void IntermediateStorage::setErrors(std::vector<StorageError> errors)
 {
 	m_errors = std::move(errors);
 
-	m_errorsIndex.clear();
-	for (size_t i = 0; i < m_errors.size(); i++)
-	{
-		m_errorsIndex.emplace(m_errors[i], i);
-	}
+	buildIndex(m_errorsIndex, m_errors);
 }
 
 Id IntermediateStorage::getNextId() const
@@ -459,3 +606,24 @@ void IntermediateStorage::setNextId(const Id nextId)
 {
 	m_nextId = nextId;
 }
+
+void IntermediateStorage::sortLocalSymbols() const
+{
+	if (!m_localSymbolsSorted)
+	{
+		// sorting moves the elements, so their positions need to be indexed again
+		sortUnique(m_localSymbols);
+		buildIndex(m_localSymbolsIndex, m_localSymbols);
+		m_localSymbolsSorted = true;
+	}
+}
+
+void IntermediateStorage::sortSourceLocations() const
+{
+	if (!m_sourceLocationsSorted)
+	{
+		sortUnique(m_sourceLocations);
+		buildIndex(m_sourceLocationsIndex, m_sourceLocations);
+		m_sourceLocationsSorted = true;
+	}
+}
@@ -1,10 +1,11 @@
 #ifndef INTERMEDIATE_STORAGE_H
 #define INTERMEDIATE_STORAGE_H
 
-#include <map>
 #include <memory>
-#include <set>
+#include <unordered_map>
+#include <vector>
 
+#include "HashIndex.h"
 #include "Storage.h"
 
 class IntermediateStorage: public Storage
@@ -31,7 +32,7 @@ public:
 	Id addEdge(const StorageEdgeData& edgeData) override;
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
 	Id addLocalSymbol(const StorageLocalSymbolData& localSymbolData) override;
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) override;
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) override;
 	Id addSourceLocation(const StorageSourceLocationData& sourceLocationData) override;
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) override;
 	void addOccurrence(const StorageOccurrence& occurrence) override;
@@ -46,51 +47,64 @@ public:
 	const std::vector<StorageFile>& getStorageFiles() const override;
 	const std::vector<StorageSymbol>& getStorageSymbols() const override;
 	const std::vector<StorageEdge>& getStorageEdges() const override;
-	const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const override;
-	const std::set<StorageSourceLocation>& getStorageSourceLocations() const override;
-	const std::set<StorageOccurrence>& getStorageOccurrences() const override;
-	const std::set<StorageComponentAccess>& getComponentAccesses() const override;
-	const std::set<StorageElementComponent>& getElementComponents() const override;
+	const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const override;
+	const std::vector<StorageSourceLocation>& getStorageSourceLocations() const override;
+	const std::vector<StorageOccurrence>& getStorageOccurrences() const override;
+	const std::vector<StorageComponentAccess>& getComponentAccesses() const override;
+	const std::vector<StorageElementComponent>& getElementComponents() const override;
 	const std::vector<StorageError>& getErrors() const override;
 
 	void setStorageNodes(std::vector<StorageNode> storageNodes);
 	void setStorageFiles(std::vector<StorageFile> storageFiles);
 	void setStorageSymbols(std::vector<StorageSymbol> storageSymbols);
 	void setStorageEdges(std::vector<StorageEdge> storageEdges);
-	void setStorageLocalSymbols(std::set<StorageLocalSymbol> storageLocalSymbols);
-	void setStorageSourceLocations(std::set<StorageSourceLocation> storageSourceLocations);
-	void setStorageOccurrences(std::set<StorageOccurrence> storageOccurrences);
-	void setComponentAccesses(std::set<StorageComponentAccess> componentAccesses);
-	void setElementComponents(std::set<StorageElementComponent> components);
+	void setStorageLocalSymbols(std::vector<StorageLocalSymbol> storageLocalSymbols);
+	void setStorageSourceLocations(std::vector<StorageSourceLocation> storageSourceLocations);
+	void setStorageOccurrences(std::vector<StorageOccurrence> storageOccurrences);
+	void setComponentAccesses(std::vector<StorageComponentAccess> componentAccesses);
+	void setElementComponents(std::vector<StorageElementComponent> components);
 	void setErrors(std::vector<StorageError> errors);
 
 	Id getNextId() const;
 	void setNextId(const Id nextId);
 
 private:
-	std::map<StorageNodeData, size_t> m_nodesIndex;
-	std::map<Id, size_t> m_nodeIdIndex;
+	void sortLocalSymbols() const;
+	void sortSourceLocations() const;
+
+	HashIndex m_nodesIndex;
+	std::unordered_map<Id, size_t> m_nodeIdIndex;
 	std::vector<StorageNode> m_nodes;
 
-	std::map<StorageFile, size_t> m_filesIndex;	   // this is used to prevent duplicates (unique)
-	std::map<Id, size_t> m_filesIdIndex;
+	HashIndex m_filesIndex;	   // this is used to prevent duplicates (unique)
+	std::unordered_map<Id, size_t> m_filesIdIndex;
 	std::vector<StorageFile> m_files;
 
 	std::vector<StorageSymbol> m_symbols;
 
-	std::map<StorageEdgeData, size_t> m_edgesIndex;
+	HashIndex m_edgesIndex;
 	std::vector<StorageEdge> m_edges;
 
-	std::set<StorageLocalSymbol> m_localSymbols;
+	// local symbols and source locations are handed out sorted, the sorting is deferred until then
+	mutable HashIndex m_localSymbolsIndex;
+	mutable std::vector<StorageLocalSymbol> m_localSymbols;
+	mutable bool m_localSymbolsSorted;
+
+	mutable HashIndex m_sourceLocationsIndex;
+	mutable std::vector<StorageSourceLocation> m_sourceLocations;
+	mutable bool m_sourceLocationsSorted;
 
-	std::set<StorageSourceLocation> m_sourceLocations;
+	// duplicates are only removed when these are requested
+	mutable std::vector<StorageOccurrence> m_occurrences;
+	mutable bool m_occurrencesUnique;
 
-	std::set<StorageOccurrence> m_occurrences;
+	mutable std::vector<StorageComponentAccess> m_componentAccesses;
+	mutable bool m_componentAccessesUnique;
 
-	std::set<StorageComponentAccess> m_componentAccesses;
-	std::set<StorageElementComponent> m_elementComponents;
+	mutable std::vector<StorageElementComponent> m_elementComponents;
+	mutable bool m_elementComponentsUnique;
 
-	std::map<StorageErrorData, size_t> m_errorsIndex;	 // this is used to prevent duplicates (unique)
+	HashIndex m_errorsIndex;	// this is used to prevent duplicates (unique)
 	std::vector<StorageError> m_errors;
 
 	Id m_nextId;
@@ -1,13 +1,18 @@
 #include "PersistentStorage.h"
 
+#include <deque>
+#include <fstream>
 #include <queue>
 #include <sstream>
+#include <unordered_set>
 
 #include "AccessKind.h"
 #include "ApplicationSettings.h"
 #include "ElementComponentKind.h"
 #include "FileInfo.h"
 #include "FilePath.h"
+#include "FileSystem.h"
+#include "FullTextSearchIndexWriter.h"
 #include "Graph.h"
 #include "MessageErrorCountUpdate.h"
 #include "MessageStatus.h"
@@ -24,10 +29,86 @@
 #include "TokenComponentInheritanceChain.h"
 #include "TokenComponentIsAmbiguous.h"
 #include "UnorderedCache.h"
+#include "WorkStealingExecutor.h"
 #include "logging.h"
 #include "tracing.h"
 #include "utility.h"
-#include "utilityApp.h"
+
+namespace
+{
+// runs independent steps of building the caches on the shared executor, the calling thread takes
+// part in running them
+void runInParallel(const std::vector<std::function<void()>>& steps)
+{
+	WorkStealingExecutor::getInstance()->parallelFor(
+		steps.size(), 1, [&steps](size_t i) { steps[i](); });
+}
+
+bool isInvisibleParentNode(const StorageNode& node)
+{
+	return !NodeType(NodeType::intToType(node.type)).isVisibleAsParentInGraph();
+}
+}	 // namespace
+
+FilePath PersistentStorage::getFullTextSearchIndexFilePath(const FilePath& indexDbFilePath)
+{
+	return FilePath(indexDbFilePath.wstr() + L"_fts");
+}
+
+FilePath PersistentStorage::getEdgeCacheFilePath(const FilePath& indexDbFilePath)
+{
+	return FilePath(indexDbFilePath.wstr() + L"_edges");
+}
+
+FilePath PersistentStorage::getSymbolIndexFilePath(const FilePath& indexDbFilePath)
+{
+	return FilePath(indexDbFilePath.wstr() + L"_symbols");
+}
+
+FilePath PersistentStorage::getHierarchyCacheFilePath(const FilePath& indexDbFilePath)
+{
+	return FilePath(indexDbFilePath.wstr() + L"_hierarchy");
+}
+
+std::vector<FilePath> PersistentStorage::getCacheFilePaths(const FilePath& indexDbFilePath)
+{
+	return {
+		getFullTextSearchIndexFilePath(indexDbFilePath),
+		getEdgeCacheFilePath(indexDbFilePath),
+		getSymbolIndexFilePath(indexDbFilePath),
+		getHierarchyCacheFilePath(indexDbFilePath)};
+}
+
+std::vector<FilePath> PersistentStorage::getJournalFilePaths(const FilePath& indexDbFilePath)
+{
+	return {
+		FilePath(indexDbFilePath.wstr() + L"-wal"),
+		FilePath(indexDbFilePath.wstr() + L"-shm"),
+		FilePath(indexDbFilePath.wstr() + L"-journal")};
+}
+
+FilePath PersistentStorage::getUnsafeWriteMarkerFilePath(const FilePath& indexDbFilePath)
+{
+	return FilePath(indexDbFilePath.wstr() + L"_unsafe_write");
+}
+
+FilePath PersistentStorage::getDeferredForeignKeysMarkerFilePath(const FilePath& indexDbFilePath)
+{
+	return FilePath(indexDbFilePath.wstr() + L"_deferred_foreign_keys");
+}
+
+SqliteStorage::PerformanceProfile PersistentStorage::getBulkPerformanceProfile()
+{
+	ApplicationSettings* appSettings = ApplicationSettings::getInstance().get();
+
+	SqliteStorage::PerformanceProfile profile;
+	profile.journalMode = appSettings->getStorageBulkJournalMode();
+	profile.synchronous = appSettings->getStorageBulkSynchronous();
+	profile.cacheSizeKb = std::max(0, appSettings->getStorageBulkCacheSizeMb()) * 1024;
+	profile.tempStoreInMemory = true;
+	profile.mmapSizeMb = std::max(0, appSettings->getStorageBulkMmapSizeMb());
+	return profile;
+}
 
 PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& bookmarkPath)
 	: m_sqliteIndexStorage(dbPath), m_sqliteBookmarkStorage(bookmarkPath)
@@ -47,6 +128,12 @@ PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& boo
 	m_commandIndex.finishSetup();
 }
 
+PersistentStorage::~PersistentStorage()
+{
+	// all transactions are committed, so the database is consistent unless the process crashes
+	setUnsafeWriteMarker(false);
+}
+
 std::pair<Id, bool> PersistentStorage::addNode(const StorageNodeData& data)
 {
 	return std::make_pair(m_sqliteIndexStorage.addNode(data), true);
@@ -92,11 +179,13 @@ void PersistentStorage::addFile(const StorageFile& data)
 
 Id PersistentStorage::addEdge(const StorageEdgeData& data)
 {
+	m_edgeCache.clear();
 	return m_sqliteIndexStorage.addEdge(data);
 }
 
 std::vector<Id> PersistentStorage::addEdges(const std::vector<StorageEdge>& edges)
 {
+	m_edgeCache.clear();
 	return m_sqliteIndexStorage.addEdges(edges);
 }
 
@@ -105,7 +194,7 @@ Id PersistentStorage::addLocalSymbol(const StorageLocalSymbolData& data)
 	return m_sqliteIndexStorage.addLocalSymbol(data);
 }
 
-std::vector<Id> PersistentStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> PersistentStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	return m_sqliteIndexStorage.addLocalSymbols(symbols);
 }
@@ -157,11 +246,13 @@ Id PersistentStorage::addError(const StorageErrorData& data)
 
 void PersistentStorage::removeElement(const Id id)
 {
+	m_edgeCache.clear();
 	m_sqliteIndexStorage.removeElement(id);
 }
 
 void PersistentStorage::removeElements(const std::vector<Id>& ids)
 {
+	m_edgeCache.clear();
 	m_sqliteIndexStorage.removeElements(ids);
 }
 
@@ -177,6 +268,7 @@ void PersistentStorage::removeOccurrences(const std::vector<StorageOccurrence>&
 
 void PersistentStorage::removeElementsWithoutOccurrences(const std::vector<Id>& elementIds)
 {
+	m_edgeCache.clear();
 	m_sqliteIndexStorage.removeElementsWithoutOccurrences(elementIds);
 }
 
@@ -200,33 +292,29 @@ const std::vector<StorageEdge>& PersistentStorage::getStorageEdges() const
 	return m_storageData.edges = m_sqliteIndexStorage.getAll<StorageEdge>();
 }
 
-const std::set<StorageLocalSymbol>& PersistentStorage::getStorageLocalSymbols() const
+const std::vector<StorageLocalSymbol>& PersistentStorage::getStorageLocalSymbols() const
 {
-	return m_storageData.locals = utility::toSet(m_sqliteIndexStorage.getAll<StorageLocalSymbol>());
+	return m_storageData.locals = m_sqliteIndexStorage.getAll<StorageLocalSymbol>();
 }
 
-const std::set<StorageSourceLocation>& PersistentStorage::getStorageSourceLocations() const
+const std::vector<StorageSourceLocation>& PersistentStorage::getStorageSourceLocations() const
 {
-	return m_storageData.locations = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageSourceLocation>());
+	return m_storageData.locations = m_sqliteIndexStorage.getAll<StorageSourceLocation>();
 }
 
-const std::set<StorageOccurrence>& PersistentStorage::getStorageOccurrences() const
+const std::vector<StorageOccurrence>& PersistentStorage::getStorageOccurrences() const
 {
-	return m_storageData.occurrences = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageOccurrence>());
+	return m_storageData.occurrences = m_sqliteIndexStorage.getAll<StorageOccurrence>();
 }
 
-const std::set<StorageComponentAccess>& PersistentStorage::getComponentAccesses() const
+const std::vector<StorageComponentAccess>& PersistentStorage::getComponentAccesses() const
 {
-	return m_storageData.accesses = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageComponentAccess>());
+	return m_storageData.accesses = m_sqliteIndexStorage.getAll<StorageComponentAccess>();
 }
 
-const std::set<StorageElementComponent>& PersistentStorage::getElementComponents() const
+const std::vector<StorageElementComponent>& PersistentStorage::getElementComponents() const
 {
-	return m_storageData.components = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageElementComponent>());
+	return m_storageData.components = m_sqliteIndexStorage.getAll<StorageElementComponent>();
 }
 
 const std::vector<StorageError>& PersistentStorage::getErrors() const
@@ -287,6 +375,105 @@ void PersistentStorage::afterErrorRecording()
 void PersistentStorage::setMode(const SqliteIndexStorage::StorageModeType mode)
 {
 	m_sqliteIndexStorage.setMode(mode);
+	m_sqliteIndexStorage.setFileContentCompressed(
+		ApplicationSettings::getInstance()->getStorageCompressFileContent());
+
+	// writing and clearing only happen on the temporary database while indexing, which is kept
+	// after a crash if the user chooses so, unless the bulk profile is not crash safe
+	const bool useBulkProfile = (mode != SqliteIndexStorage::STORAGE_MODE_READ);
+	if (!m_performanceProfileSet || m_bulkPerformanceProfile != useBulkProfile)
+	{
+		SqliteStorage::PerformanceProfile profile;
+		if (useBulkProfile)
+		{
+			profile = getBulkPerformanceProfile();
+		}
+		else
+		{
+			ApplicationSettings* appSettings = ApplicationSettings::getInstance().get();
+			profile.tempStoreInMemory = true;
+			profile.journalMode = appSettings->getStorageBrowsingJournalMode();
+			profile.synchronous = appSettings->getStorageBrowsingSynchronous();
+			profile.cacheSizeKb = std::max(0, appSettings->getStorageBrowsingCacheSizeMb()) * 1024;
+			profile.mmapSizeMb = std::max(0, appSettings->getStorageBrowsingMmapSizeMb());
+		}
+
+		m_sqliteIndexStorage.setPerformanceProfile(profile);
+		m_performanceProfileSet = true;
+		m_bulkPerformanceProfile = useBulkProfile;
+
+		setUnsafeWriteMarker(useBulkProfile && !profile.isCrashSafe());
+	}
+}
+
+void PersistentStorage::setUnsafeWriteMarker(bool unsafe)
+{
+	if (m_unsafeWriteMarkerSet == unsafe)
+	{
+		return;
+	}
+
+	const FilePath markerFilePath = getUnsafeWriteMarkerFilePath(getIndexDbFilePath());
+	if (unsafe)
+	{
+		std::ofstream markerFile(markerFilePath.str());
+	}
+	else if (markerFilePath.exists())
+	{
+		FileSystem::remove(markerFilePath);
+	}
+	m_unsafeWriteMarkerSet = unsafe;
+}
+
+void PersistentStorage::deferForeignKeyChecks()
+{
+	std::ofstream markerFile(getDeferredForeignKeysMarkerFilePath(getIndexDbFilePath()).str());
+	m_sqliteIndexStorage.setForeignKeysEnabled(false);
+	m_foreignKeyChecksDeferred = true;
+}
+
+bool PersistentStorage::validateDeferredForeignKeys()
+{
+	const FilePath markerFilePath = getDeferredForeignKeysMarkerFilePath(getIndexDbFilePath());
+	if (!m_foreignKeyChecksDeferred && !markerFilePath.exists())
+	{
+		return true;
+	}
+
+	TRACE();
+
+	m_sqliteIndexStorage.setForeignKeysEnabled(true);
+	m_foreignKeyChecksDeferred = false;
+
+	if (!m_sqliteIndexStorage.getForeignKeysEnabled())
+	{
+		LOG_ERROR("Foreign key enforcement could not be enabled again.");
+	}
+
+	// remove the rows that enforced foreign keys would have rejected on insertion
+	size_t violationCount = 0;
+	m_sqliteIndexStorage.beginTransaction();
+	try
+	{
+		violationCount = m_sqliteIndexStorage.removeForeignKeyViolations();
+	}
+	catch (CppSQLite3Exception e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+		m_sqliteIndexStorage.rollbackTransaction();
+		return false;
+	}
+	m_sqliteIndexStorage.commitTransaction();
+
+	if (violationCount)
+	{
+		LOG_ERROR(
+			"Removed " + std::to_string(violationCount) +
+			" rows violating foreign key constraints from the index database.");
+	}
+
+	FileSystem::remove(markerFilePath);
+	return true;
 }
 
 FilePath PersistentStorage::getIndexDbFilePath() const
@@ -357,6 +544,7 @@ void PersistentStorage::clearCaches()
 	m_symbolDefinitionKinds.clear();
 
 	m_hierarchyCache.clear();
+	m_edgeCache.clear();
 	m_fullTextSearchIndex.clear();
 	m_fullTextSearchCodec = "";
 }
@@ -391,7 +579,8 @@ void PersistentStorage::clearAllErrors()
 }
 
 void PersistentStorage::clearFileElements(
-	const std::vector<FilePath>& filePaths, std::function<void(int)> updateStatusCallback)
+	const std::vector<FilePath>& filePaths,
+	std::function<void(int, const std::wstring&)> updateStatusCallback)
 {
 	TRACE();
 
@@ -403,11 +592,13 @@ void PersistentStorage::clearFileElements(
 
 	if (!fileNodeIds.empty())
 	{
+		m_edgeCache.clear();
+
 		m_sqliteIndexStorage.beginTransaction();
 		m_sqliteIndexStorage.removeElementsWithLocationInFiles(fileNodeIds, updateStatusCallback);
 		m_sqliteIndexStorage.removeElements(fileNodeIds);
 		m_sqliteIndexStorage.commitTransaction();
-		updateStatusCallback(100);
+		updateStatusCallback(100, L"Deleted files");
 	}
 }
 
@@ -463,10 +654,279 @@ void PersistentStorage::buildCaches()
 
 	clearCaches();
 
+	const FilePath dbPath = getIndexDbFilePath();
+	const std::string storageTime = m_sqliteIndexStorage.getTime().toString();
+
+	// the cache files are written after indexing, caches of databases from older versions are built
+	// from the database instead
+	bool symbolIndexLoaded = false;
+	bool hierarchyCacheLoaded = false;
+	bool edgeCacheLoaded = false;
+
+	runInParallel(
+		{[this]() { buildFilePathMaps(); },
+		 [&]() {
+			 symbolIndexLoaded = m_symbolIndex.load(getSymbolIndexFilePath(dbPath), storageTime);
+		 },
+		 [&]() {
+			 hierarchyCacheLoaded =
+				 m_hierarchyCache.load(getHierarchyCacheFilePath(dbPath), storageTime);
+		 },
+		 [&]() {
+			 edgeCacheLoaded = m_edgeCache.load(getEdgeCacheFilePath(dbPath), storageTime);
+		 },
+		 [&]() {
+			 std::lock_guard<std::mutex> lock(m_fullTextSearchMutex);
+			 loadFullTextSearchIndex(storageTime);
+		 }});
+
+	// the missing caches share a single scan of the node and the edge table, each scan runs on its
+	// own read only connection
+	std::vector<StorageEdge> memberEdges;
+	std::vector<StorageEdge> inheritanceEdges;
+	std::set<Id> invisibleParentNodeIds;
+
+	runInParallel(
+		{[this]() { buildFileSearchIndex(); },
+		 [&]() {
+			 if (symbolIndexLoaded)
+			 {
+				 return;
+			 }
+
+			 SqliteIndexStorage storage(dbPath);
+			 storage.setQueryOnly(true);
+			 storage.forEach<StorageNode>([&](StorageNode&& node) {
+				 addSymbolToSearchIndex(m_symbolIndex, node);
+
+				 if (!hierarchyCacheLoaded && isInvisibleParentNode(node))
+				 {
+					 invisibleParentNodeIds.insert(node.id);
+				 }
+			 });
+		 },
+		 [&]() {
+			 if (edgeCacheLoaded)
+			 {
+				 return;
+			 }
+
+			 SqliteIndexStorage storage(dbPath);
+			 storage.setQueryOnly(true);
+			 std::vector<StorageEdge> edges = storage.getAll<StorageEdge>();
+
+			 if (!hierarchyCacheLoaded)
+			 {
+				 for (const StorageEdge& edge: edges)
+				 {
+					 if (edge.type == Edge::typeToInt(Edge::EDGE_MEMBER))
+					 {
+						 memberEdges.push_back(edge);
+					 }
+					 else if (edge.type == Edge::typeToInt(Edge::EDGE_INHERITANCE))
+					 {
+						 inheritanceEdges.push_back(edge);
+					 }
+				 }
+			 }
+
+			 m_edgeCache.build(std::move(edges));
+		 }});
+
+	runInParallel(
+		{[&]() {
+			 if (!symbolIndexLoaded)
+			 {
+				 m_symbolIndex.finishSetup();
+			 }
+		 },
+		 [&]() {
+			 if (hierarchyCacheLoaded)
+			 {
+				 return;
+			 }
+
+			 SqliteIndexStorage storage(dbPath);
+			 storage.setQueryOnly(true);
+
+			 if (edgeCacheLoaded)
+			 {
+				 collectHierarchyEdges(storage, &memberEdges, &inheritanceEdges);
+			 }
+
+			 if (symbolIndexLoaded)
+			 {
+				 collectInvisibleParentNodeIds(storage, memberEdges, &invisibleParentNodeIds);
+			 }
+
+			 std::vector<HierarchyCacheFileConnection> connections;
+			 std::vector<HierarchyCacheFileInheritance> inheritances;
+			 std::vector<HierarchyCacheFileMemberEdgeOrder> memberEdgeOrders;
+			 collectHierarchyCacheData(
+				 storage,
+				 memberEdges,
+				 inheritanceEdges,
+				 invisibleParentNodeIds,
+				 &connections,
+				 &inheritances,
+				 &memberEdgeOrders);
+			 m_hierarchyCache.build(connections, inheritances, memberEdgeOrders);
+		 }});
+}
+
+void PersistentStorage::prepareFullTextSearchIndexRefresh(
+	const FilePath& previousIndexDbFilePath, const std::vector<FilePath>& changedFilePaths)
+{
+	TRACE();
+
+	std::lock_guard<std::mutex> lock(m_fullTextSearchMutex);
+
+	const TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
+
+	m_fullTextSearchIndex.clear();
+	m_fullTextSearchCodec = "";
+
+	// the storage was copied from the previous one, so its index file is valid for this storage
+	if (!m_fullTextSearchIndex.load(
+			getFullTextSearchIndexFilePath(previousIndexDbFilePath),
+			codec.getName(),
+			m_sqliteIndexStorage.getTime().toString()))
+	{
+		return;
+	}
+
+	m_fullTextSearchCodec = codec.getName();
+
+	for (const StorageFile& file: m_sqliteIndexStorage.getFilesByPaths(changedFilePaths))
+	{
+		m_fullTextSearchIndex.removeFile(file.id);
+	}
+}
+
+void PersistentStorage::writeFullTextSearchIndex() const
+{
+	TRACE();
+
+	const TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
+
+	const std::vector<Id> indexedFileIds = getIndexedFileIds();
+
+	std::vector<Id> addedFileIds;
+	if (m_fullTextSearchCodec == codec.getName())
+	{
+		// only build suffix arrays for files that were indexed since preparing the refresh
+		const std::set<Id> indexedFileIdSet(indexedFileIds.begin(), indexedFileIds.end());
+		for (Id fileId: m_fullTextSearchIndex.getFileIds())
+		{
+			if (indexedFileIdSet.find(fileId) == indexedFileIdSet.end())
+			{
+				m_fullTextSearchIndex.removeFile(fileId);
+			}
+		}
+
+		for (Id fileId: indexedFileIds)
+		{
+			if (!m_fullTextSearchIndex.hasFile(fileId))
+			{
+				addedFileIds.push_back(fileId);
+			}
+		}
+
+		forEachFileContent(addedFileIds, codec, [this](Id fileId, const std::wstring& content) {
+			m_fullTextSearchIndex.updateFile(fileId, content);
+		});
+	}
+
+	FullTextSearchIndexWriter writer(
+		getFullTextSearchIndexFilePath(getIndexDbFilePath()),
+		codec.getName(),
+		m_sqliteIndexStorage.getTime().toString());
+
+	if (writer.isOpen())
+	{
+		if (m_fullTextSearchCodec == codec.getName())
+		{
+			LOG_INFO(
+				"Updating fulltext search index for " + std::to_string(addedFileIds.size()) +
+				" of " + std::to_string(indexedFileIds.size()) + " files");
+			m_fullTextSearchIndex.save(writer);
+		}
+		else
+		{
+			forEachFileContent(
+				indexedFileIds, codec, [&writer](Id fileId, const std::wstring& content) {
+					writer.addFile(fileId, content);
+				});
+		}
+		writer.finish();
+	}
+
+	// release the index file of the previous storage
+	m_fullTextSearchIndex.clear();
+	m_fullTextSearchCodec = "";
+}
+
+void PersistentStorage::writeEdgeCache() const
+{
+	TRACE();
+
+	EdgeCache edgeCache;
+	edgeCache.build(m_sqliteIndexStorage.getAll<StorageEdge>());
+	edgeCache.save(
+		getEdgeCacheFilePath(getIndexDbFilePath()), m_sqliteIndexStorage.getTime().toString());
+}
+
+void PersistentStorage::writeSymbolCaches()
+{
+	TRACE();
+
+	// the symbol index and hierarchy cache depend on the file and definition kind maps
+	clearCaches();
 	buildFilePathMaps();
-	buildSearchIndex();
-	buildMemberEdgeIdOrderMap();
-	buildHierarchyCache();
+
+	const FilePath indexDbFilePath = getIndexDbFilePath();
+	const std::string storageTime = m_sqliteIndexStorage.getTime().toString();
+
+	// a single scan of the node table serves both caches
+	SearchIndex symbolIndex;
+	std::set<Id> invisibleParentNodeIds;
+	m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& node) {
+		addSymbolToSearchIndex(symbolIndex, node);
+
+		if (isInvisibleParentNode(node))
+		{
+			invisibleParentNodeIds.insert(node.id);
+		}
+	});
+
+	symbolIndex.finishSetup();
+	symbolIndex.save(getSymbolIndexFilePath(indexDbFilePath), storageTime);
+
+	{
+		std::vector<StorageEdge> memberEdges;
+		std::vector<StorageEdge> inheritanceEdges;
+		collectHierarchyEdges(m_sqliteIndexStorage, &memberEdges, &inheritanceEdges);
+
+		std::vector<HierarchyCacheFileConnection> connections;
+		std::vector<HierarchyCacheFileInheritance> inheritances;
+		std::vector<HierarchyCacheFileMemberEdgeOrder> memberEdgeOrders;
+		collectHierarchyCacheData(
+			m_sqliteIndexStorage,
+			memberEdges,
+			inheritanceEdges,
+			invisibleParentNodeIds,
+			&connections,
+			&inheritances,
+			&memberEdgeOrders);
+		HierarchyCache::save(
+			getHierarchyCacheFilePath(indexDbFilePath),
+			storageTime,
+			connections,
+			inheritances,
+			memberEdgeOrders);
+	}
+
+	clearCaches();
 }
 
 void PersistentStorage::optimizeMemory()
@@ -578,11 +1038,18 @@ NodeType PersistentStorage::getNodeTypeForNodeWithId(Id nodeId) const
 
 StorageEdge PersistentStorage::getEdgeById(Id edgeId) const
 {
+	if (m_edgeCache.isBuilt())
+	{
+		return m_edgeCache.getEdgeById(edgeId);
+	}
 	return m_sqliteIndexStorage.getEdgeById(edgeId);
 }
 
 std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLocations(
-	const std::wstring& searchTerm, bool caseSensitive) const
+	const std::wstring& searchTerm,
+	bool caseSensitive,
+	size_t maxResultCount,
+	std::function<bool(std::shared_ptr<SourceLocationFile>)> onFileLocations) const
 {
 	TRACE();
 
@@ -611,94 +1078,99 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLo
 		true)
 		.dispatch();
 
-	{
-		std::vector<std::shared_ptr<std::thread>> threads;
-		std::mutex collectionMutex;
-		for (std::vector<FullTextSearchResult> fileResults: utility::splitToEqualySizedParts(
-				 m_fullTextSearchIndex.searchForTerm(searchTerm), utility::getIdealThreadCount()))
-		{
-			std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-				[this,
-				 &searchTerm,
-				 &caseSensitive,
-				 &codec,
-				 /*no ref here!*/ fileResults,
-				 &collection,
-				 &collectionMutex]() {
-					const int termLength = searchTerm.length();
-					for (const FullTextSearchResult& fileResult: fileResults)
-					{
-						const FilePath filePath = getFileNodePath(fileResult.fileId);
-						std::shared_ptr<TextAccess> fileContent = getFileContent(filePath, false);
+	// each file is searched on the executor and its locations are handed over to this thread file
+	// by file, so they can be shown while the remaining files are still searched
+	const std::vector<FullTextSearchFileView> fileViews = m_fullTextSearchIndex.getFileViews();
+	const std::thread::id callingThreadId = std::this_thread::get_id();
+	std::atomic<size_t> locationCount(0);
+	std::atomic<bool> stopped(false);
 
-						int charsTotal = 0;
-						int lineNumber = 1;
-						std::wstring line = codec.decode(fileContent->getLine(lineNumber));
+	std::mutex finishedFilesMutex;
+	std::deque<std::shared_ptr<SourceLocationFile>> finishedFiles;
 
-						for (int pos: fileResult.positions)
-						{
-							while (charsTotal + (int)line.length() <= pos)
-							{
-								charsTotal += line.length();
-								lineNumber++;
-								line = codec.decode(fileContent->getLine(lineNumber));
-							}
+	bool interrupted = false;
+	auto handOverFinishedFiles = [&]() {
+		while (true)
+		{
+			std::shared_ptr<SourceLocationFile> file;
+			{
+				std::lock_guard<std::mutex> lock(finishedFilesMutex);
+				if (finishedFiles.empty())
+				{
+					break;
+				}
 
-							ParseLocation location;
-							location.startLineNumber = lineNumber;
-							location.startColumnNumber = pos - charsTotal + 1;
+				file = finishedFiles.front();
+				finishedFiles.pop_front();
+			}
 
-							if (caseSensitive &&
-								line.substr(location.startColumnNumber - 1, termLength) != searchTerm)
-							{
-								continue;
-							}
-							while ((charsTotal + (int)line.length()) < pos + termLength)
-							{
-								charsTotal += line.length();
-								lineNumber++;
-								line = codec.decode(fileContent->getLine(lineNumber));
-							}
-							location.endLineNumber = lineNumber;
-							location.endColumnNumber = pos + termLength - charsTotal;
+			if (interrupted)
+			{
+				continue;
+			}
 
-							{
-								std::lock_guard<std::mutex> lock(collectionMutex);
-								// Set first bit to 1 to avoid collisions
-								const Id locationId = ~(~Id(0) >> 1) +
-									collection->getSourceLocationCount() + 1;
-								collection->addSourceLocation(
-									LOCATION_FULLTEXT_SEARCH,
-									locationId,
-									std::vector<Id>(),
-									filePath,
-									location.startLineNumber,
-									location.startColumnNumber,
-									location.endLineNumber,
-									location.endColumnNumber);
-							}
-						}
-					}
-				});
-			threads.push_back(thread);
-		}
+			addCompleteFlagsToSourceLocationFile(file.get());
+			collection->addSourceLocationFile(file);
 
-		for (std::shared_ptr<std::thread> thread: threads)
-		{
-			thread->join();
+			if (onFileLocations && !onFileLocations(file))
+			{
+				interrupted = true;
+				stopped = true;
+			}
 		}
-	}
+	};
 
-	addCompleteFlagsToSourceLocationCollection(collection.get());
+	WorkStealingExecutor::getInstance()->parallelFor(
+		fileViews.size(),
+		1,
+		[&](size_t fileIndex) {
+			if (stopped || (maxResultCount && locationCount >= maxResultCount))
+			{
+				stopped = true;
+				return;
+			}
 
-	MessageStatus(
-		std::to_wstring(collection->getSourceLocationCount()) + L" results in " +
-			std::to_wstring(collection->getSourceLocationFileCount()) +
-			L" files for fulltext search (case-" + (caseSensitive ? L"sensitive" : L"insensitive") +
-			L"): " + searchTerm,
-		false,
-		false)
-		.dispatch();
+			std::shared_ptr<SourceLocationFile> file = getFullTextSearchLocationsForFile(
+				fileViews[fileIndex],
+				searchTerm,
+				caseSensitive,
+				maxResultCount,
+				&locationCount);
+
+			if (maxResultCount && locationCount >= maxResultCount)
+			{
+				stopped = true;
+			}
+
+			if (file)
+			{
+				std::lock_guard<std::mutex> lock(finishedFilesMutex);
+				finishedFiles.push_back(file);
+			}
+
+			// the calling thread takes part in the loop and passes on results in between
+			if (std::this_thread::get_id() == callingThreadId)
+			{
+				handOverFinishedFiles();
+			}
+		},
+		[&stopped]() { return bool(stopped); });
+
+	handOverFinishedFiles();
+
+	std::wstring status = std::to_wstring(collection->getSourceLocationCount()) + L" results in " +
+		std::to_wstring(collection->getSourceLocationFileCount()) +
+		L" files for fulltext search (case-" + (caseSensitive ? L"sensitive" : L"insensitive") +
+		L"): " + searchTerm;
+	if (interrupted)
+	{
+		status += L" (interrupted)";
+	}
+	else if (maxResultCount && collection->getSourceLocationCount() >= maxResultCount)
+	{
+		status += L" (limited to " + std::to_wstring(maxResultCount) + L" results)";
+	}
+	MessageStatus(status, false, false).dispatch();
 
 	return collection;
 }
@@ -1132,8 +1604,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 				nodeIds.push_back(elementId);
 				edgeIds.clear();
 
-				for (const StorageEdge& edge:
-					 m_sqliteIndexStorage.getEdgesBySourceOrTargetId(elementId))
+				for (const StorageEdge& edge: getEdgesBySourceOrTargetId(elementId))
 				{
 					Edge::EdgeType edgeType = Edge::intToType(edge.type);
 					if (edgeType == Edge::EDGE_MEMBER)
@@ -1164,7 +1635,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 				}
 			}
 		}
-		else if (m_sqliteIndexStorage.isEdge(elementId))
+		else if (isEdge(elementId))
 		{
 			edgeIds.push_back(elementId);
 		}
@@ -1194,7 +1665,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 		{
 			if (nodeIds.size() != ids.size())
 			{
-				for (const StorageEdge& edge: m_sqliteIndexStorage.getAllByIds<StorageEdge>(ids))
+				for (const StorageEdge& edge: getEdgesByIds(ids))
 				{
 					if (edge.id > 0)
 					{
@@ -1285,125 +1756,139 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(
 	Edge::TypeMask edgeTypes,
 	bool nodeNonIndexed,
 	size_t depth,
-	bool directed) const
+	bool directed,
+	bool shortestPathsOnly,
+	size_t maxNodeCount,
+	std::function<bool()> isInterrupted) const
 {
 	TRACE();
 
 	std::set<Id> nodeIds;
 	std::set<Id> edgeIds;
 
-	nodeIds.insert(originId ? originId : targetId);
-	bool forward = originId;
-	size_t currentDepth = 0;
+	bool isTerminatedTrail = originId && targetId;
 
-	std::vector<Id> nodeIdsToProcess = {*nodeIds.begin()};
+	if (isTerminatedTrail && shortestPathsOnly)
+	{
+		if (!addTerminatedTrail(
+				originId,
+				targetId,
+				nodeTypes,
+				edgeTypes,
+				nodeNonIndexed,
+				depth,
+				directed,
+				maxNodeCount,
+				isInterrupted,
+				&nodeIds,
+				&edgeIds))
+		{
+			if (isInterrupted && isInterrupted())
+			{
+				return std::make_shared<Graph>();
+			}
 
-	struct TrailNode
+			nodeIds = {originId};
+			edgeIds.clear();
+		}
+	}
+	else
 	{
-		Id id = 0;
-		std::set<TrailNode*> parents;
-		std::set<Id> edgeIds;
-	};
+		nodeIds.insert(originId ? originId : targetId);
+		bool forward = originId;
+		size_t currentDepth = 0;
 
-	bool isTerminatedTrail = originId && targetId;
-	std::map<Id, TrailNode> trailNodes;
+		std::vector<Id> nodeIdsToProcess = {*nodeIds.begin()};
 
-	if (isTerminatedTrail)
-	{
-		TrailNode root;
-		root.id = originId;
-		trailNodes.emplace(originId, root);
-	}
+		struct TrailNode
+		{
+			Id id = 0;
+			std::set<TrailNode*> parents;
+			std::set<Id> edgeIds;
+		};
 
-	while (nodeIdsToProcess.size() && (!depth || currentDepth < depth))
-	{
-		std::vector<StorageEdge> edges = forward
-			? m_sqliteIndexStorage.getEdgesBySourceIds(nodeIdsToProcess)
-			: m_sqliteIndexStorage.getEdgesByTargetIds(nodeIdsToProcess);
+		std::map<Id, TrailNode> trailNodes;
 
-		if (!directed || edgeTypes & Edge::LAYOUT_VERTICAL)
+		if (isTerminatedTrail)
 		{
-			utility::append(
-				edges,
-				forward ? m_sqliteIndexStorage.getEdgesByTargetIds(nodeIdsToProcess)
-						: m_sqliteIndexStorage.getEdgesBySourceIds(nodeIdsToProcess));
+			TrailNode root;
+			root.id = originId;
+			trailNodes.emplace(originId, root);
 		}
 
-		std::vector<Id> nodeIdsToCheck;
-		std::map<Id, std::vector<StorageEdge>> edgesToInsert;
-
-		for (const StorageEdge& edge: edges)
+		while (nodeIdsToProcess.size() && (!depth || currentDepth < depth))
 		{
-			if (Edge::intToType(edge.type) & edgeTypes && edgeIds.find(edge.id) == edgeIds.end())
+			if (isInterrupted && isInterrupted())
 			{
-				bool isForward = forward == !(Edge::intToType(edge.type) & Edge::LAYOUT_VERTICAL);
+				return std::make_shared<Graph>();
+			}
 
-				const Id targetNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
-				const Id sourceNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
+			if (maxNodeCount && nodeIds.size() >= maxNodeCount)
+			{
+				LOG_WARNING(
+					"Trail search stopped after reaching " + std::to_string(maxNodeCount) +
+					" nodes.");
+				break;
+			}
 
-				if (nodeIds.find(targetNodeId) == nodeIds.end())
-				{
-					nodeIdsToCheck.push_back(targetNodeId);
-					edgesToInsert[targetNodeId].push_back(edge);
-				}
-				else if (nodeIds.find(sourceNodeId) == nodeIds.end())
+			std::vector<Id> nodeIdsToCheck;
+			std::map<Id, std::vector<StorageEdge>> edgesToInsert;
+
+			for (const StorageEdge& edge:
+				 getTrailEdges(nodeIdsToProcess, forward, edgeTypes, directed))
+			{
+				if (Edge::intToType(edge.type) & edgeTypes && edgeIds.find(edge.id) == edgeIds.end())
 				{
-					if (!directed)
+					bool isForward = forward == !(Edge::intToType(edge.type) & Edge::LAYOUT_VERTICAL);
+
+					const Id targetNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
+					const Id sourceNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
+
+					if (nodeIds.find(targetNodeId) == nodeIds.end())
 					{
-						nodeIdsToCheck.push_back(sourceNodeId);
-						edgesToInsert[sourceNodeId].push_back(edge);
+						nodeIdsToCheck.push_back(targetNodeId);
+						edgesToInsert[targetNodeId].push_back(edge);
 					}
-				}
-				else
-				{
-					edgeIds.insert(edge.id);
-
-					if (isTerminatedTrail)
+					else if (nodeIds.find(sourceNodeId) == nodeIds.end())
+					{
+						if (!directed)
+						{
+							nodeIdsToCheck.push_back(sourceNodeId);
+							edgesToInsert[sourceNodeId].push_back(edge);
+						}
+					}
+					else
 					{
-						TrailNode& target = trailNodes[targetNodeId];
-						TrailNode& origin = trailNodes[sourceNodeId];
-						target.id = targetNodeId;
-						origin.id = sourceNodeId;
-						target.parents.insert(&origin);
-						target.edgeIds.insert(edge.id);
+						edgeIds.insert(edge.id);
+
+						if (isTerminatedTrail)
+						{
+							TrailNode& target = trailNodes[targetNodeId];
+							TrailNode& origin = trailNodes[sourceNodeId];
+							target.id = targetNodeId;
+							origin.id = sourceNodeId;
+							target.parents.insert(&origin);
+							target.edgeIds.insert(edge.id);
+						}
 					}
 				}
 			}
-		}
 
-		nodeIdsToProcess.clear();
+			nodeIdsToProcess.clear();
 
-		if (nodeTypes != 0)
-		{
-			for (const StorageNode& node:
-				 m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIdsToCheck))
+			if (nodeTypes != 0)
 			{
-				NodeType::Type type = NodeType::intToType(node.type);
-				if (type & nodeTypes || (type == NodeType::NODE_SYMBOL && nodeNonIndexed))
+				for (const StorageNode& node:
+					 m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIdsToCheck))
 				{
-					if (!nodeNonIndexed)
+					if (!isTrailNode(node, nodeTypes, nodeNonIndexed))
 					{
-						if (type == NodeType::NODE_FILE)
-						{
-							auto it = m_fileNodeIndexed.find(node.id);
-							if (it == m_fileNodeIndexed.end() || !it->second)
-							{
-								continue;
-							}
-						}
-						else
-						{
-							auto it = m_symbolDefinitionKinds.find(node.id);
-							if (it == m_symbolDefinitionKinds.end() || it->second == DEFINITION_NONE)
-							{
-								continue;
-							}
-						}
+						continue;
 					}
 
 					// FIXME: don't add namespace nodes to the graph, because it destroys trail
 					// layouting Remove when namespaces are proper nodes with children
-					if ((type &
+					if ((NodeType::intToType(node.type) &
 						 (NodeType::NODE_MODULE | NodeType::NODE_NAMESPACE |
 						  NodeType::NODE_PACKAGE)) == 0)
 					{
@@ -1436,58 +1921,58 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(
 					}
 				}
 			}
-		}
-		else
-		{
-			for (const Id nodeId: nodeIdsToCheck)
+			else
 			{
-				nodeIds.insert(nodeId);
-				nodeIdsToProcess.push_back(nodeId);
-
-				for (const StorageEdge& edge: edgesToInsert[nodeId])
+				for (const Id nodeId: nodeIdsToCheck)
 				{
-					edgeIds.insert(edge.id);
+					nodeIds.insert(nodeId);
+					nodeIdsToProcess.push_back(nodeId);
+
+					for (const StorageEdge& edge: edgesToInsert[nodeId])
+					{
+						edgeIds.insert(edge.id);
+					}
 				}
 			}
-		}
 
-		edgesToInsert.clear();
+			edgesToInsert.clear();
 
-		currentDepth++;
-	}
-
-	if (isTerminatedTrail)
-	{
-		nodeIds.clear();
-		edgeIds.clear();
+			currentDepth++;
+		}
 
-		if (trailNodes.find(targetId) != trailNodes.end())
+		if (isTerminatedTrail)
 		{
-			std::queue<TrailNode*> nodesToProcess;
-			nodesToProcess.push(&trailNodes[targetId]);
+			nodeIds.clear();
+			edgeIds.clear();
 
-			while (nodesToProcess.size())
+			if (trailNodes.find(targetId) != trailNodes.end())
 			{
-				TrailNode* currentNode = nodesToProcess.front();
-				nodesToProcess.pop();
+				std::queue<TrailNode*> nodesToProcess;
+				nodesToProcess.push(&trailNodes[targetId]);
 
-				if (nodeIds.find(currentNode->id) != nodeIds.end())
+				while (nodesToProcess.size())
 				{
-					continue;
-				}
+					TrailNode* currentNode = nodesToProcess.front();
+					nodesToProcess.pop();
 
-				nodeIds.insert(currentNode->id);
-				edgeIds.insert(currentNode->edgeIds.begin(), currentNode->edgeIds.end());
+					if (nodeIds.find(currentNode->id) != nodeIds.end())
+					{
+						continue;
+					}
 
-				for (TrailNode* parent: currentNode->parents)
-				{
-					nodesToProcess.push(parent);
+					nodeIds.insert(currentNode->id);
+					edgeIds.insert(currentNode->edgeIds.begin(), currentNode->edgeIds.end());
+
+					for (TrailNode* parent: currentNode->parents)
+					{
+						nodesToProcess.push(parent);
+					}
 				}
 			}
-		}
-		else
-		{
-			nodeIds.insert(originId);
+			else
+			{
+				nodeIds.insert(originId);
+			}
 		}
 	}
 
@@ -1533,7 +2018,7 @@ std::vector<Id> PersistentStorage::getActiveTokenIdsForId(Id tokenId, Id* declar
 	std::vector<Id> activeTokenIds;
 
 	bool isNode = m_sqliteIndexStorage.isNode(tokenId);
-	bool isEdge = m_sqliteIndexStorage.isEdge(tokenId);
+	bool isEdge = this->isEdge(tokenId);
 
 	if (!isEdge && !isNode)
 	{
@@ -1546,7 +2031,7 @@ std::vector<Id> PersistentStorage::getActiveTokenIdsForId(Id tokenId, Id* declar
 	{
 		*declarationId = tokenId;
 
-		for (const StorageEdge& edge: m_sqliteIndexStorage.getEdgesByTargetId(tokenId))
+		for (const StorageEdge& edge: getEdgesByTargetId(tokenId))
 		{
 			activeTokenIds.push_back(edge.id);
 		}
@@ -1567,7 +2052,7 @@ std::vector<Id> PersistentStorage::getNodeIdsForLocationIds(const std::vector<Id
 	{
 		Id elementId = occurrence.elementId;
 
-		const StorageEdge edge = m_sqliteIndexStorage.getFirstById<StorageEdge>(elementId);
+		const StorageEdge edge = getEdgeById(elementId);
 		if (edge.id != 0)
 		{
 			elementId = edge.targetNodeId;
@@ -1786,15 +2271,10 @@ std::shared_ptr<TextAccess> PersistentStorage::getFileContent(
 	return TextAccess::createFromFile(FilePath(filePath));
 }
 
-bool PersistentStorage::hasContentForFile(const FilePath& filePath) const
+bool PersistentStorage::getFileContentHash(
+	const FilePath& filePath, std::string& contentHash, uint64_t& byteSize) const
 {
-	std::shared_ptr<TextAccess> fileContent = m_sqliteIndexStorage.getFileContentByPath(
-		filePath.wstr());
-	if (fileContent->getLineCount() > 0)
-	{
-		return true;
-	}
-	return false;
+	return m_sqliteIndexStorage.getFileContentHash(filePath.wstr(), contentHash, byteSize);
 }
 
 FileInfo PersistentStorage::getFileInfoForFileId(Id id) const
@@ -1977,7 +2457,7 @@ Id PersistentStorage::addEdgeBookmark(const EdgeBookmark& bookmark)
 					  .id;
 	for (const Id& edgeId: bookmark.getEdgeIds())
 	{
-		const StorageEdge storageEdge = m_sqliteIndexStorage.getEdgeById(edgeId);
+		const StorageEdge storageEdge = getEdgeById(edgeId);
 
 		bool sourceNodeActive = storageEdge.sourceNodeId == bookmark.getActiveNodeId();
 		m_sqliteBookmarkStorage.addBookmarkedEdge(StorageBookmarkedEdgeData(
@@ -2154,7 +2634,7 @@ TooltipInfo PersistentStorage::getTooltipInfoForTokenIds(
 	StorageNode node = m_sqliteIndexStorage.getFirstById<StorageNode>(tokenIds[0]);
 	if (node.id == 0 && origin == TOOLTIP_ORIGIN_CODE)
 	{
-		const StorageEdge edge = m_sqliteIndexStorage.getFirstById<StorageEdge>(tokenIds[0]);
+		const StorageEdge edge = getEdgeById(tokenIds[0]);
 
 		if (edge.id > 0)
 		{
@@ -2209,7 +2689,7 @@ TooltipInfo PersistentStorage::getTooltipInfoForTokenIds(
 
 	info.count = 0;
 	info.countText = "reference";
-	for (const auto& edge: m_sqliteIndexStorage.getEdgesByTargetId(node.id))
+	for (const auto& edge: getEdgesByTargetId(node.id))
 	{
 		if (Edge::intToType(edge.type) != Edge::EDGE_MEMBER)
 		{
@@ -2407,7 +2887,7 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 			ApplicationSettings::getInstance()->getCodeTabWidth());
 
 		std::vector<Id> typeNodeIds;
-		for (const auto& edge: m_sqliteIndexStorage.getEdgesBySourceId(node.id))
+		for (const auto& edge: getEdgesBySourceId(node.id))
 		{
 			if (Edge::intToType(edge.type) == Edge::EDGE_TYPE_USAGE)
 			{
@@ -2897,7 +3377,7 @@ void PersistentStorage::addEdgesToGraph(const std::vector<Id>& newEdgeIds, Graph
 		return;
 	}
 
-	for (const StorageEdge& storageEdge: m_sqliteIndexStorage.getAllByIds<StorageEdge>(edgeIds))
+	for (const StorageEdge& storageEdge: getEdgesByIds(edgeIds))
 	{
 		Node* sourceNode = graph->getNodeById(storageEdge.sourceNodeId);
 		Node* targetNode = graph->getNodeById(storageEdge.targetNodeId);
@@ -2906,13 +3386,9 @@ void PersistentStorage::addEdgesToGraph(const std::vector<Id>& newEdgeIds, Graph
 		{
 			Edge::EdgeType type = Edge::intToType(storageEdge.type);
 			Id edgeId = storageEdge.id;
-			if (type & Edge::EDGE_MEMBER && m_memberEdgeIdOrderMap.size())
+			if (type & Edge::EDGE_MEMBER)
 			{
-				auto it = m_memberEdgeIdOrderMap.find(edgeId);
-				if (it != m_memberEdgeIdOrderMap.end())
-				{
-					edgeId = it->second;
-				}
+				edgeId = m_hierarchyCache.getMemberEdgeOrderId(edgeId);
 			}
 
 			graph->createEdge(edgeId, type, sourceNode, targetNode);
@@ -2934,7 +3410,7 @@ void PersistentStorage::addNodesWithParentsAndEdgesToGraph(
 
 	if (edgeIds.size() > 0)
 	{
-		for (const StorageEdge& storageEdge: m_sqliteIndexStorage.getAllByIds<StorageEdge>(edgeIds))
+		for (const StorageEdge& storageEdge: getEdgesByIds(edgeIds))
 		{
 			allNodeIds.insert(storageEdge.sourceNodeId);
 			allNodeIds.insert(storageEdge.targetNodeId);
@@ -2985,8 +3461,7 @@ void PersistentStorage::addAggregationEdgesToGraph(
 		connectedNodeIds[isSource ? edge.targetNodeId : edge.sourceNodeId].push_back(edgeInfo);
 	}
 
-	const std::vector<StorageEdge> outgoingEdges = m_sqliteIndexStorage.getEdgesBySourceIds(
-		childNodeIds);
+	const std::vector<StorageEdge> outgoingEdges = getEdgesBySourceIds(childNodeIds);
 	for (const StorageEdge& outEdge: outgoingEdges)
 	{
 		EdgeInfo edgeInfo;
@@ -2995,8 +3470,7 @@ void PersistentStorage::addAggregationEdgesToGraph(
 		connectedNodeIds[outEdge.targetNodeId].push_back(edgeInfo);
 	}
 
-	const std::vector<StorageEdge> incomingEdges = m_sqliteIndexStorage.getEdgesByTargetIds(
-		childNodeIds);
+	const std::vector<StorageEdge> incomingEdges = getEdgesByTargetIds(childNodeIds);
 	for (const StorageEdge& inEdge: incomingEdges)
 	{
 		EdgeInfo edgeInfo;
@@ -3152,13 +3626,18 @@ void PersistentStorage::addCompleteFlagsToSourceLocationCollection(
 	TRACE();
 
 	collection->forEachSourceLocationFile([this](std::shared_ptr<SourceLocationFile> file) {
-		Id fileId = getFileNodeId(file->getFilePath());
-		file->setIsComplete(getFileNodeComplete(fileId));
-		file->setIsIndexed(getFileNodeIndexed(fileId));
-		file->setLanguage(getFileNodeLanguage(fileId));
+		addCompleteFlagsToSourceLocationFile(file.get());
 	});
 }
 
+void PersistentStorage::addCompleteFlagsToSourceLocationFile(SourceLocationFile* file) const
+{
+	Id fileId = getFileNodeId(file->getFilePath());
+	file->setIsComplete(getFileNodeComplete(fileId));
+	file->setIsIndexed(getFileNodeIndexed(fileId));
+	file->setLanguage(getFileNodeLanguage(fileId));
+}
+
 void PersistentStorage::addInheritanceChainsToGraph(const std::vector<Id>& activeNodeIds, Graph* graph) const
 {
 	TRACE();
@@ -3227,6 +3706,244 @@ void PersistentStorage::addInheritanceChainsToGraph(const std::vector<Id>& activ
 	}
 }
 
+bool PersistentStorage::addTerminatedTrail(
+	Id originId,
+	Id targetId,
+	NodeType::TypeMask nodeTypes,
+	Edge::TypeMask edgeTypes,
+	bool nodeNonIndexed,
+	size_t depth,
+	bool directed,
+	size_t maxNodeCount,
+	std::function<bool()> isInterrupted,
+	std::set<Id>* nodeIds,
+	std::set<Id>* edgeIds) const
+{
+	TRACE();
+
+	// Searches from both ends of the trail at once and always expands the side with the smaller
+	// frontier by a whole level. The search stops at the first level where both sides meet, so the
+	// trail consists of all shortest paths from origin to target.
+	struct TrailSearchNode
+	{
+		size_t level;
+		std::vector<std::pair<Id, Id>> parents;	   // parent node id and edge id
+	};
+
+	struct TrailSearchSide
+	{
+		bool forward;
+		size_t level;
+		std::vector<Id> frontier;
+		std::unordered_map<Id, TrailSearchNode> nodes;
+	};
+
+	TrailSearchSide sides[2];
+	sides[0].forward = true;
+	sides[1].forward = false;
+	sides[0].frontier = {originId};
+	sides[1].frontier = {targetId};
+
+	for (TrailSearchSide& side: sides)
+	{
+		side.level = 0;
+		side.nodes.emplace(side.frontier.front(), TrailSearchNode {0, {}});
+	}
+
+	std::unordered_set<Id> rejectedNodeIds;
+	std::vector<Id> meetingNodeIds;
+	if (originId == targetId)
+	{
+		meetingNodeIds.push_back(originId);
+	}
+
+	while (meetingNodeIds.empty() && !sides[0].frontier.empty() && !sides[1].frontier.empty() &&
+		   (!depth || sides[0].level + sides[1].level < depth))
+	{
+		if (isInterrupted && isInterrupted())
+		{
+			return false;
+		}
+
+		if (maxNodeCount && sides[0].nodes.size() + sides[1].nodes.size() >= maxNodeCount)
+		{
+			LOG_WARNING(
+				"Trail search stopped after reaching " + std::to_string(maxNodeCount) + " nodes.");
+			return false;
+		}
+
+		TrailSearchSide& side = sides[0].frontier.size() <= sides[1].frontier.size() ? sides[0]
+																					 : sides[1];
+		const TrailSearchSide& otherSide = &side == &sides[0] ? sides[1] : sides[0];
+
+		const std::unordered_set<Id> frontierIds(side.frontier.begin(), side.frontier.end());
+		std::vector<Id> nextNodeIds;
+		std::unordered_map<Id, std::vector<std::pair<Id, Id>>> nextNodeParents;
+
+		for (const StorageEdge& edge: getTrailEdges(side.frontier, side.forward, edgeTypes, directed))
+		{
+			const Edge::EdgeType edgeType = Edge::intToType(edge.type);
+			if ((edgeType & edgeTypes) == 0)
+			{
+				continue;
+			}
+
+			const bool isForward = side.forward == !(edgeType & Edge::LAYOUT_VERTICAL);
+			Id fromNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
+			Id toNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
+
+			if (frontierIds.find(fromNodeId) == frontierIds.end())
+			{
+				if (directed || frontierIds.find(toNodeId) == frontierIds.end())
+				{
+					continue;
+				}
+				std::swap(fromNodeId, toNodeId);
+			}
+
+			// only edges that lead to the next level are part of a shortest path
+			if (side.nodes.find(toNodeId) != side.nodes.end() ||
+				rejectedNodeIds.find(toNodeId) != rejectedNodeIds.end())
+			{
+				continue;
+			}
+
+			std::vector<std::pair<Id, Id>>& parents = nextNodeParents[toNodeId];
+			if (parents.empty())
+			{
+				nextNodeIds.push_back(toNodeId);
+			}
+			parents.emplace_back(fromNodeId, edge.id);
+		}
+
+		if (nodeTypes != 0)
+		{
+			std::unordered_set<Id> acceptedNodeIds = {originId, targetId};
+			for (const StorageNode& node: m_sqliteIndexStorage.getAllByIds<StorageNode>(nextNodeIds))
+			{
+				if (isTrailNode(node, nodeTypes, nodeNonIndexed))
+				{
+					acceptedNodeIds.insert(node.id);
+				}
+			}
+
+			std::vector<Id> filteredNodeIds;
+			for (const Id nodeId: nextNodeIds)
+			{
+				if (acceptedNodeIds.find(nodeId) != acceptedNodeIds.end())
+				{
+					filteredNodeIds.push_back(nodeId);
+				}
+				else
+				{
+					rejectedNodeIds.insert(nodeId);
+				}
+			}
+			nextNodeIds = std::move(filteredNodeIds);
+		}
+
+		side.level++;
+		side.frontier = nextNodeIds;
+
+		size_t meetingLevel = 0;
+		for (const Id nodeId: nextNodeIds)
+		{
+			side.nodes.emplace(nodeId, TrailSearchNode {side.level, std::move(nextNodeParents[nodeId])});
+
+			auto it = otherSide.nodes.find(nodeId);
+			if (it != otherSide.nodes.end())
+			{
+				if (meetingNodeIds.empty() || it->second.level < meetingLevel)
+				{
+					meetingNodeIds.clear();
+					meetingLevel = it->second.level;
+				}
+				if (it->second.level == meetingLevel)
+				{
+					meetingNodeIds.push_back(nodeId);
+				}
+			}
+		}
+	}
+
+	if (meetingNodeIds.empty())
+	{
+		return false;
+	}
+
+	// collect the paths from the meeting nodes back to the origin and to the target
+	for (const TrailSearchSide& side: sides)
+	{
+		std::vector<Id> nodeIdsToProcess = meetingNodeIds;
+		std::unordered_set<Id> processedNodeIds(meetingNodeIds.begin(), meetingNodeIds.end());
+
+		while (nodeIdsToProcess.size())
+		{
+			const Id nodeId = nodeIdsToProcess.back();
+			nodeIdsToProcess.pop_back();
+			nodeIds->insert(nodeId);
+
+			for (const std::pair<Id, Id>& parent: side.nodes.find(nodeId)->second.parents)
+			{
+				edgeIds->insert(parent.second);
+				if (processedNodeIds.insert(parent.first).second)
+				{
+					nodeIdsToProcess.push_back(parent.first);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+std::vector<StorageEdge> PersistentStorage::getTrailEdges(
+	const std::vector<Id>& nodeIds, bool forward, Edge::TypeMask edgeTypes, bool directed) const
+{
+	std::vector<StorageEdge> edges = forward ? getEdgesBySourceIds(nodeIds)
+											 : getEdgesByTargetIds(nodeIds);
+
+	// edges with vertical layout point against the trail direction
+	if (!directed || edgeTypes & Edge::LAYOUT_VERTICAL)
+	{
+		utility::append(edges, forward ? getEdgesByTargetIds(nodeIds) : getEdgesBySourceIds(nodeIds));
+	}
+
+	return edges;
+}
+
+bool PersistentStorage::isTrailNode(
+	const StorageNode& node, NodeType::TypeMask nodeTypes, bool nodeNonIndexed) const
+{
+	const NodeType::Type type = NodeType::intToType(node.type);
+	if (!(type & nodeTypes || (type == NodeType::NODE_SYMBOL && nodeNonIndexed)))
+	{
+		return false;
+	}
+
+	if (!nodeNonIndexed)
+	{
+		if (type == NodeType::NODE_FILE)
+		{
+			auto it = m_fileNodeIndexed.find(node.id);
+			if (it == m_fileNodeIndexed.end() || !it->second)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			auto it = m_symbolDefinitionKinds.find(node.id);
+			if (it == m_symbolDefinitionKinds.end() || it->second == DEFINITION_NONE)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 void PersistentStorage::buildFilePathMaps()
 {
 	TRACE();
@@ -3252,63 +3969,58 @@ void PersistentStorage::buildFilePathMaps()
 	});
 }
 
-void PersistentStorage::buildSearchIndex()
+void PersistentStorage::buildFileSearchIndex()
 {
 	TRACE();
 
 	const FilePath dbPath = getIndexDbFilePath();
 
-	m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& node) {
-		const NodeType type = NodeType::intToType(node.type);
-		if (type.isFile())
+	for (const auto& p: m_fileNodePaths)
+	{
+		if (getFileNodeIndexed(p.first))
 		{
-			bool indexed = getFileNodeIndexed(node.id);
-			if (!indexed)
-			{
-				return;
-			}
+			FilePath filePath(p.second);
 
-			auto it = m_fileNodePaths.find(node.id);
-			if (it != m_fileNodePaths.end())
+			if (filePath.exists())
 			{
-				FilePath filePath(it->second);
-
-				if (filePath.exists())
-				{
-					filePath.makeRelativeTo(dbPath);
-				}
-
-				m_fileIndex.addNode(node.id, filePath.wstr(), type);
+				filePath.makeRelativeTo(dbPath);
 			}
+
+			m_fileIndex.addNode(p.first, filePath.wstr(), NodeType::NODE_FILE);
 		}
-		else
-		{
-			auto it = m_symbolDefinitionKinds.find(node.id);
-			const DefinitionKind defKind =
-				(it != m_symbolDefinitionKinds.end() ? it->second : DEFINITION_NONE);
-			if (defKind != DEFINITION_IMPLICIT)
-			{
-				const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+	}
+	m_fileIndex.finishSetup();
+}
+
+void PersistentStorage::addSymbolToSearchIndex(SearchIndex& index, const StorageNode& node) const
+{
+	const NodeType type = NodeType::intToType(node.type);
+	if (type.isFile())
+	{
+		return;
+	}
 
-				// we don't use the signature here, so elements with the same signature share the
-				// same node.
-				std::wstring name = nameHierarchy.getQualifiedName();
+	auto it = m_symbolDefinitionKinds.find(node.id);
+	const DefinitionKind defKind =
+		(it != m_symbolDefinitionKinds.end() ? it->second : DEFINITION_NONE);
+	if (defKind != DEFINITION_IMPLICIT)
+	{
+		const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
 
-				// replace template arguments with .. to avoid clutter in search results and have
-				// different template specializations share the same node.
-				if (defKind == DEFINITION_NONE &&
-					nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_CXX))
-				{
-					name = utility::replaceBetween(name, L'<', L'>', L"..");
-				}
+		// we don't use the signature here, so elements with the same signature share the
+		// same node.
+		std::wstring name = nameHierarchy.getQualifiedName();
 
-				m_symbolIndex.addNode(node.id, std::move(name), type);
-			}
+		// replace template arguments with .. to avoid clutter in search results and have
+		// different template specializations share the same node.
+		if (defKind == DEFINITION_NONE &&
+			nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_CXX))
+		{
+			name = utility::replaceBetween(name, L'<', L'>', L"..");
 		}
-	});
 
-	m_symbolIndex.finishSetup();
-	m_fileIndex.finishSetup();
+		index.addNode(node.id, std::move(name), type);
+	}
 }
 
 void PersistentStorage::buildFullTextSearchIndex() const
@@ -3317,46 +4029,197 @@ void PersistentStorage::buildFullTextSearchIndex() const
 
 	TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
 
+	m_fullTextSearchIndex.clear();
+	m_fullTextSearchCodec = "";
+
+	writeFullTextSearchIndex();
+	if (loadFullTextSearchIndex(m_sqliteIndexStorage.getTime().toString()))
+	{
+		return;
+	}
+
+	LOG_WARNING("Fulltext search index file could not be written, keeping the index in memory.");
+
 	m_fullTextSearchCodec = codec.getName();
 
+	forEachFileContent(getIndexedFileIds(), codec, [this](Id fileId, const std::wstring& content) {
+		m_fullTextSearchIndex.addFile(fileId, content);
+	});
+}
+
+bool PersistentStorage::loadFullTextSearchIndex(const std::string& storageTime) const
+{
+	TRACE();
+
+	const TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
+
 	m_fullTextSearchIndex.clear();
+	m_fullTextSearchCodec = "";
+
+	if (m_fullTextSearchIndex.load(
+			getFullTextSearchIndexFilePath(getIndexDbFilePath()),
+			codec.getName(),
+			storageTime))
+	{
+		m_fullTextSearchCodec = codec.getName();
+		return true;
+	}
+
+	return false;
+}
 
-	std::vector<std::shared_ptr<std::thread>> threads;
+std::shared_ptr<SourceLocationFile> PersistentStorage::getFullTextSearchLocationsForFile(
+	const FullTextSearchFileView& fileView,
+	const std::wstring& searchTerm,
+	bool caseSensitive,
+	size_t maxResultCount,
+	std::atomic<size_t>* locationCount) const
+{
+	const std::vector<int> positions = FullTextSearchIndex::searchForTerm(fileView, searchTerm);
+	if (positions.empty())
 	{
-		std::vector<StorageFile> indexedFiles;
-		for (const StorageFile& file: m_sqliteIndexStorage.getAll<StorageFile>())
+		return nullptr;
+	}
+
+	std::shared_ptr<SourceLocationFile> file = std::make_shared<SourceLocationFile>(
+		getFileNodePath(fileView.fileId), L"", false, false, false);
+
+	for (const ParseLocation& location: FullTextSearchIndex::getLocationsForPositions(
+			 fileView, positions, searchTerm, caseSensitive))
+	{
+		const size_t locationIndex = (*locationCount)++;
+		if (maxResultCount && locationIndex >= maxResultCount)
 		{
-			if (file.indexed)
-			{
-				indexedFiles.push_back(file);
-			}
+			break;
 		}
-		for (std::vector<StorageFile> part:
-			 utility::splitToEqualySizedParts(indexedFiles, utility::getIdealThreadCount()))
+
+		// Set first bit to 1 to avoid collisions
+		const Id locationId = ~(~Id(0) >> 1) + locationIndex + 1;
+		file->addSourceLocation(
+			LOCATION_FULLTEXT_SEARCH,
+			locationId,
+			std::vector<Id>(),
+			location.startLineNumber,
+			location.startColumnNumber,
+			location.endLineNumber,
+			location.endColumnNumber);
+	}
+
+	if (!file->getSourceLocationCount())
+	{
+		return nullptr;
+	}
+	return file;
+}
+
+std::vector<Id> PersistentStorage::getIndexedFileIds() const
+{
+	std::vector<Id> fileIds;
+	m_sqliteIndexStorage.forEach<StorageFile>([&fileIds](StorageFile&& file) {
+		if (file.indexed)
 		{
-			std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-				[&](const std::vector<StorageFile>& files) {
-					for (const StorageFile& file: files)
-					{
-						m_fullTextSearchIndex.addFile(
-							file.id,
-							codec.decode(m_sqliteIndexStorage.getFileContentById(file.id)->getText()));
-					}
-				},
-				part);
-			threads.push_back(thread);
+			fileIds.push_back(file.id);
 		}
-	}
-	for (std::shared_ptr<std::thread> thread: threads)
+	});
+	return fileIds;
+}
+
+void PersistentStorage::forEachFileContent(
+	const std::vector<Id>& fileIds,
+	const TextCodec& codec,
+	std::function<void(Id, const std::wstring&)> func) const
+{
+	WorkStealingExecutor::getInstance()->parallelFor(fileIds.size(), 1, [&](size_t i) {
+		func(
+			fileIds[i],
+			codec.decode(m_sqliteIndexStorage.getFileContentById(fileIds[i])->getText()));
+	});
+}
+
+void PersistentStorage::collectHierarchyEdges(
+	const SqliteIndexStorage& storage,
+	std::vector<StorageEdge>* memberEdges,
+	std::vector<StorageEdge>* inheritanceEdges) const
+{
+	storage.forEachOfType<StorageEdge>(
+		Edge::typeToInt(Edge::EDGE_MEMBER),
+		[memberEdges](StorageEdge&& edge) { memberEdges->push_back(edge); });
+
+	storage.forEachOfType<StorageEdge>(
+		Edge::typeToInt(Edge::EDGE_INHERITANCE),
+		[inheritanceEdges](StorageEdge&& edge) { inheritanceEdges->push_back(edge); });
+}
+
+void PersistentStorage::collectInvisibleParentNodeIds(
+	const SqliteIndexStorage& storage,
+	const std::vector<StorageEdge>& memberEdges,
+	std::set<Id>* nodeIds) const
+{
+	std::vector<Id> sourceNodeIds;
+	for (const StorageEdge& edge: memberEdges)
 	{
-		thread->join();
+		sourceNodeIds.push_back(edge.sourceNodeId);
 	}
+
+	storage.forEachByIds<StorageNode>(sourceNodeIds, [nodeIds](StorageNode&& node) {
+		if (isInvisibleParentNode(node))
+		{
+			nodeIds->insert(node.id);
+		}
+	});
 }
 
-void PersistentStorage::buildMemberEdgeIdOrderMap()
+void PersistentStorage::collectHierarchyCacheData(
+	const SqliteIndexStorage& storage,
+	const std::vector<StorageEdge>& memberEdges,
+	const std::vector<StorageEdge>& inheritanceEdges,
+	const std::set<Id>& invisibleParentNodeIds,
+	std::vector<HierarchyCacheFileConnection>* connections,
+	std::vector<HierarchyCacheFileInheritance>* inheritances,
+	std::vector<HierarchyCacheFileMemberEdgeOrder>* memberEdgeOrders) const
 {
 	TRACE();
 
+	connections->reserve(memberEdges.size());
+	for (const StorageEdge& edge: memberEdges)
+	{
+		bool sourceIsVisible = true;
+		if (invisibleParentNodeIds.find(edge.sourceNodeId) != invisibleParentNodeIds.end())
+		{
+			sourceIsVisible = false;
+		}
+
+		bool sourceIsImplicit = false;
+		auto it = m_symbolDefinitionKinds.find(edge.sourceNodeId);
+		if (it != m_symbolDefinitionKinds.end())
+		{
+			sourceIsImplicit = (it->second == DEFINITION_IMPLICIT);
+		}
+
+		bool targetIsImplicit = false;
+		it = m_symbolDefinitionKinds.find(edge.targetNodeId);
+		if (it != m_symbolDefinitionKinds.end())
+		{
+			targetIsImplicit = (it->second == DEFINITION_IMPLICIT);
+		}
+
+		HierarchyCacheFileConnection connection = HierarchyCacheFileConnection();
+		connection.edgeId = edge.id;
+		connection.fromId = edge.sourceNodeId;
+		connection.toId = edge.targetNodeId;
+		connection.sourceVisible = sourceIsVisible;
+		connection.sourceImplicit = sourceIsImplicit;
+		connection.targetImplicit = targetIsImplicit;
+		connections->push_back(connection);
+	}
+
+	inheritances->reserve(inheritanceEdges.size());
+	for (const StorageEdge& edge: inheritanceEdges)
+	{
+		inheritances->push_back({edge.id, edge.sourceNodeId, edge.targetNodeId});
+	}
+
+	// members of Java types are ordered by their location in the file
 	if (!m_hasJavaFiles)
 	{
 		return;
@@ -3364,18 +4227,16 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 
 	std::vector<Id> childNodeIds;
 	std::unordered_map<Id, Id> childIdToMemberEdgeIdMap;
-
-	m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-		Edge::typeToInt(Edge::EDGE_MEMBER),
-		[&childNodeIds, &childIdToMemberEdgeIdMap](StorageEdge&& edge) {
-			childNodeIds.push_back(edge.targetNodeId);
-			childIdToMemberEdgeIdMap.emplace(edge.targetNodeId, edge.id);
-		});
+	for (const StorageEdge& edge: memberEdges)
+	{
+		childNodeIds.push_back(edge.targetNodeId);
+		childIdToMemberEdgeIdMap.emplace(edge.targetNodeId, edge.id);
+	}
 
 	std::vector<Id> locationIds;
 	std::unordered_map<Id, Id> locationIdToElementIdMap;
 	for (const StorageOccurrence& occurrence:
-		 m_sqliteIndexStorage.getOccurrencesForElementIds(childNodeIds))
+		 storage.getOccurrencesForElementIds(childNodeIds))
 	{
 		locationIds.push_back(occurrence.sourceLocationId);
 		locationIdToElementIdMap.emplace(occurrence.sourceLocationId, occurrence.elementId);
@@ -3383,7 +4244,7 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 
 	SourceLocationCollection collection;
 	for (const StorageSourceLocation& location:
-		 m_sqliteIndexStorage.getAllByIds<StorageSourceLocation>(locationIds))
+		 storage.getAllByIds<StorageSourceLocation>(locationIds))
 	{
 		const LocationType locType = intToLocationType(location.type);
 		if (locType != LOCATION_TOKEN)
@@ -3391,8 +4252,8 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 			continue;
 		}
 
-		const FilePath path(m_fileNodePaths[location.fileNodeId]);
-		if (path.extension() == L".java")
+		auto it = m_fileNodePaths.find(location.fileNodeId);
+		if (it != m_fileNodePaths.end() && it->second.extension() == L".java")
 		{
 			collection.addSourceLocation(
 				intToLocationType(location.type),
@@ -3409,6 +4270,7 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 	// Set first 3 bits to 1 to avoid collisions
 	Id baseId = ~(~Id(0) >> 3) + 1;
 
+	std::set<Id> orderedMemberEdgeIds;
 	collection.forEachSourceLocation([&](SourceLocation* location) {
 		auto it = locationIdToElementIdMap.find(location->getLocationId());
 		if (it != locationIdToElementIdMap.end())
@@ -3416,8 +4278,9 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 			auto it2 = childIdToMemberEdgeIdMap.find(it->second);
 			if (it2 != childIdToMemberEdgeIdMap.end())
 			{
-				if (m_memberEdgeIdOrderMap.emplace(it2->second, baseId).second)
+				if (orderedMemberEdgeIds.insert(it2->second).second)
 				{
+					memberEdgeOrders->push_back({it2->second, baseId});
 					baseId++;
 				}
 			}
@@ -3425,62 +4288,65 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 	});
 }
 
-void PersistentStorage::buildHierarchyCache()
+bool PersistentStorage::isEdge(Id elementId) const
 {
-	TRACE();
-
-	std::vector<Id> sourceNodeIds;
-	std::vector<StorageEdge> memberEdges;
-
-	m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-		Edge::typeToInt(Edge::EDGE_MEMBER), [&sourceNodeIds, &memberEdges](StorageEdge&& edge) {
-			sourceNodeIds.push_back(edge.sourceNodeId);
-			memberEdges.emplace_back(edge);
-		});
-
-	std::set<Id> invisibleParentSourceNodeIds;
+	if (m_edgeCache.isBuilt())
+	{
+		return m_edgeCache.isEdge(elementId);
+	}
+	return m_sqliteIndexStorage.isEdge(elementId);
+}
 
-	m_sqliteIndexStorage.forEachByIds<StorageNode>(
-		sourceNodeIds, [&invisibleParentSourceNodeIds](StorageNode&& node) {
-			if (!NodeType(NodeType::intToType(node.type)).isVisibleAsParentInGraph())
-			{
-				invisibleParentSourceNodeIds.insert(node.id);
-			}
-		});
+std::vector<StorageEdge> PersistentStorage::getEdgesByIds(const std::vector<Id>& edgeIds) const
+{
+	if (m_edgeCache.isBuilt())
+	{
+		return m_edgeCache.getEdgesByIds(edgeIds);
+	}
+	return m_sqliteIndexStorage.getAllByIds<StorageEdge>(edgeIds);
+}
 
-	for (const StorageEdge& edge: memberEdges)
+std::vector<StorageEdge> PersistentStorage::getEdgesBySourceId(Id sourceId) const
+{
+	if (m_edgeCache.isBuilt())
 	{
-		bool sourceIsVisible = true;
-		if (invisibleParentSourceNodeIds.find(edge.sourceNodeId) != invisibleParentSourceNodeIds.end())
-		{
-			sourceIsVisible = false;
-		}
+		return m_edgeCache.getEdgesBySourceId(sourceId);
+	}
+	return m_sqliteIndexStorage.getEdgesBySourceId(sourceId);
+}
 
-		bool sourceIsImplicit = false;
-		auto it = m_symbolDefinitionKinds.find(edge.sourceNodeId);
-		if (it != m_symbolDefinitionKinds.end())
-		{
-			sourceIsImplicit = (it->second == DEFINITION_IMPLICIT);
-		}
+std::vector<StorageEdge> PersistentStorage::getEdgesBySourceIds(const std::vector<Id>& sourceIds) const
+{
+	if (m_edgeCache.isBuilt())
+	{
+		return m_edgeCache.getEdgesBySourceIds(sourceIds);
+	}
+	return m_sqliteIndexStorage.getEdgesBySourceIds(sourceIds);
+}
 
-		bool targetIsImplicit = false;
-		it = m_symbolDefinitionKinds.find(edge.targetNodeId);
-		if (it != m_symbolDefinitionKinds.end())
-		{
-			targetIsImplicit = (it->second == DEFINITION_IMPLICIT);
-		}
+std::vector<StorageEdge> PersistentStorage::getEdgesByTargetId(Id targetId) const
+{
+	if (m_edgeCache.isBuilt())
+	{
+		return m_edgeCache.getEdgesByTargetId(targetId);
+	}
+	return m_sqliteIndexStorage.getEdgesByTargetId(targetId);
+}
 
-		m_hierarchyCache.createConnection(
-			edge.id,
-			edge.sourceNodeId,
-			edge.targetNodeId,
-			sourceIsVisible,
-			sourceIsImplicit,
-			targetIsImplicit);
+std::vector<StorageEdge> PersistentStorage::getEdgesByTargetIds(const std::vector<Id>& targetIds) const
+{
+	if (m_edgeCache.isBuilt())
+	{
+		return m_edgeCache.getEdgesByTargetIds(targetIds);
 	}
+	return m_sqliteIndexStorage.getEdgesByTargetIds(targetIds);
+}
 
-	m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-		Edge::typeToInt(Edge::EDGE_INHERITANCE), [this](StorageEdge&& edge) {
-			m_hierarchyCache.createInheritance(edge.id, edge.sourceNodeId, edge.targetNodeId);
-		});
+std::vector<StorageEdge> PersistentStorage::getEdgesBySourceOrTargetId(Id id) const
+{
+	if (m_edgeCache.isBuilt())
+	{
+		return m_edgeCache.getEdgesBySourceOrTargetId(id);
+	}
+	return m_sqliteIndexStorage.getEdgesBySourceOrTargetId(id);
 }
@@ -1,9 +1,11 @@
 #ifndef PERSISTENT_STORAGE_H
 #define PERSISTENT_STORAGE_H
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
+#include "EdgeCache.h"
 #include "FullTextSearchIndex.h"
 #include "HierarchyCache.h"
 #include "SearchIndex.h"
@@ -12,12 +14,37 @@
 #include "Storage.h"
 #include "StorageAccess.h"
 
+class TextCodec;
+
 class PersistentStorage
 	: public Storage
 	, public StorageAccess
 {
 public:
+	static FilePath getFullTextSearchIndexFilePath(const FilePath& indexDbFilePath);
+	static FilePath getEdgeCacheFilePath(const FilePath& indexDbFilePath);
+	static FilePath getSymbolIndexFilePath(const FilePath& indexDbFilePath);
+	static FilePath getHierarchyCacheFilePath(const FilePath& indexDbFilePath);
+
+	// all files stored next to the index database that need to be moved or removed along with it
+	static std::vector<FilePath> getCacheFilePaths(const FilePath& indexDbFilePath);
+
+	// sqlite journal files of an index database that hold committed data after a crash in WAL mode
+	static std::vector<FilePath> getJournalFilePaths(const FilePath& indexDbFilePath);
+
+	// the profile used while indexing, see ApplicationSettings
+	static SqliteStorage::PerformanceProfile getBulkPerformanceProfile();
+
+	// exists while the database is written with a bulk profile that is not crash safe, so a database
+	// left behind by a crash can be recognized as possibly corrupt
+	static FilePath getUnsafeWriteMarkerFilePath(const FilePath& indexDbFilePath);
+
+	// exists while foreign key checks of the database are deferred, so a database left behind by a
+	// crash can be recognized as possibly holding rows that violate foreign key constraints
+	static FilePath getDeferredForeignKeysMarkerFilePath(const FilePath& indexDbFilePath);
+
 	PersistentStorage(const FilePath& dbPath, const FilePath& bookmarkPath);
+	~PersistentStorage() override;
 
 	std::pair<Id, bool> addNode(const StorageNodeData& data) override;
 	std::vector<Id> addNodes(const std::vector<StorageNode>& nodes) override;
@@ -27,7 +54,7 @@ public:
 	Id addEdge(const StorageEdgeData& data) override;
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
 	Id addLocalSymbol(const StorageLocalSymbolData& data) override;
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) override;
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) override;
 	Id addSourceLocation(const StorageSourceLocationData& data) override;
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) override;
 	void addOccurrence(const StorageOccurrence& data) override;
@@ -48,11 +75,11 @@ public:
 	const std::vector<StorageFile>& getStorageFiles() const override;
 	const std::vector<StorageSymbol>& getStorageSymbols() const override;
 	const std::vector<StorageEdge>& getStorageEdges() const override;
-	const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const override;
-	const std::set<StorageSourceLocation>& getStorageSourceLocations() const override;
-	const std::set<StorageOccurrence>& getStorageOccurrences() const override;
-	const std::set<StorageComponentAccess>& getComponentAccesses() const override;
-	const std::set<StorageElementComponent>& getElementComponents() const override;
+	const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const override;
+	const std::vector<StorageSourceLocation>& getStorageSourceLocations() const override;
+	const std::vector<StorageOccurrence>& getStorageOccurrences() const override;
+	const std::vector<StorageComponentAccess>& getComponentAccesses() const override;
+	const std::vector<StorageElementComponent>& getElementComponents() const override;
 	const std::vector<StorageError>& getErrors() const override;
 
 	void startInjection() override;
@@ -64,6 +91,12 @@ public:
 
 	void setMode(const SqliteIndexStorage::StorageModeType mode);
 
+	// turns off foreign key enforcement while a fresh database gets filled, the constraints are
+	// checked once for all rows by validateDeferredForeignKeys. That also validates a database left
+	// with deferred checks by a crash and returns false if the constraints could not be checked.
+	void deferForeignKeyChecks();
+	bool validateDeferredForeignKeys();
+
 	FilePath getIndexDbFilePath() const;
 	FilePath getBookmarkDbFilePath() const;
 
@@ -82,7 +115,8 @@ public:
 
 	void clearAllErrors();
 	void clearFileElements(
-		const std::vector<FilePath>& filePaths, std::function<void(int)> updateStatusCallback);
+		const std::vector<FilePath>& filePaths,
+		std::function<void(int, const std::wstring&)> updateStatusCallback);
 
 	std::vector<FileInfo> getFileInfoForAllFiles() const;
 	std::set<FilePath> getIncompleteFiles() const;
@@ -90,6 +124,12 @@ public:
 
 	void buildCaches();
 
+	void prepareFullTextSearchIndexRefresh(
+		const FilePath& previousIndexDbFilePath, const std::vector<FilePath>& changedFilePaths);
+	void writeFullTextSearchIndex() const;
+	void writeEdgeCache() const;
+	void writeSymbolCaches();
+
 	void optimizeMemory();
 
 	// StorageAccess implementation
@@ -108,7 +148,10 @@ public:
 	StorageEdge getEdgeById(Id edgeId) const override;
 
 	std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const override;
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		size_t maxResultCount,
+		std::function<bool(std::shared_ptr<SourceLocationFile>)> onFileLocations) const override;
 
 	std::vector<SearchMatch> getAutocompletionMatches(
 		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const override;
@@ -137,7 +180,10 @@ public:
 		Edge::TypeMask trailType,
 		bool nodeNonIndexed,
 		size_t depth,
-		bool directed) const override;
+		bool directed,
+		bool shortestPathsOnly,
+		size_t maxNodeCount,
+		std::function<bool()> isInterrupted) const override;
 
 	NodeType::TypeMask getAvailableNodeTypes() const override;
 	Edge::TypeMask getAvailableEdgeTypes() const override;
@@ -157,7 +203,8 @@ public:
 		const FilePath& filePath, LocationType type) const override;
 
 	std::shared_ptr<TextAccess> getFileContent(const FilePath& filePath, bool showsErrors) const override;
-	bool hasContentForFile(const FilePath& filePath) const;
+	bool getFileContentHash(
+		const FilePath& filePath, std::string& contentHash, uint64_t& byteSize) const;
 
 	FileInfo getFileInfoForFileId(Id id) const override;
 
@@ -202,11 +249,11 @@ private:
 		std::vector<StorageFile> files;
 		std::vector<StorageSymbol> symbols;
 		std::vector<StorageEdge> edges;
-		std::set<StorageLocalSymbol> locals;
-		std::set<StorageSourceLocation> locations;
-		std::set<StorageOccurrence> occurrences;
-		std::set<StorageComponentAccess> accesses;
-		std::set<StorageElementComponent> components;
+		std::vector<StorageLocalSymbol> locals;
+		std::vector<StorageSourceLocation> locations;
+		std::vector<StorageOccurrence> occurrences;
+		std::vector<StorageComponentAccess> accesses;
+		std::vector<StorageElementComponent> components;
 		std::vector<StorageError> errors;
 	} m_storageData;
 
@@ -249,13 +296,73 @@ private:
 	void addComponentIsAmbiguousToGraph(Graph* graph) const;
 
 	void addCompleteFlagsToSourceLocationCollection(SourceLocationCollection* collection) const;
+	void addCompleteFlagsToSourceLocationFile(SourceLocationFile* file) const;
 	void addInheritanceChainsToGraph(const std::vector<Id>& nodeIds, Graph* graph) const;
 
+	bool addTerminatedTrail(
+		Id originId,
+		Id targetId,
+		NodeType::TypeMask nodeTypes,
+		Edge::TypeMask edgeTypes,
+		bool nodeNonIndexed,
+		size_t depth,
+		bool directed,
+		size_t maxNodeCount,
+		std::function<bool()> isInterrupted,
+		std::set<Id>* nodeIds,
+		std::set<Id>* edgeIds) const;
+	std::vector<StorageEdge> getTrailEdges(
+		const std::vector<Id>& nodeIds, bool forward, Edge::TypeMask edgeTypes, bool directed) const;
+	bool isTrailNode(const StorageNode& node, NodeType::TypeMask nodeTypes, bool nodeNonIndexed) const;
+
 	void buildFilePathMaps();
-	void buildSearchIndex();
+	void buildFileSearchIndex();
+	void addSymbolToSearchIndex(SearchIndex& index, const StorageNode& node) const;
 	void buildFullTextSearchIndex() const;
-	void buildMemberEdgeIdOrderMap();
-	void buildHierarchyCache();
+	bool loadFullTextSearchIndex(const std::string& storageTime) const;
+	std::vector<Id> getIndexedFileIds() const;
+	std::shared_ptr<SourceLocationFile> getFullTextSearchLocationsForFile(
+		const FullTextSearchFileView& fileView,
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		size_t maxResultCount,
+		std::atomic<size_t>* locationCount) const;
+	void forEachFileContent(
+		const std::vector<Id>& fileIds,
+		const TextCodec& codec,
+		std::function<void(Id, const std::wstring&)> func) const;
+	void collectHierarchyEdges(
+		const SqliteIndexStorage& storage,
+		std::vector<StorageEdge>* memberEdges,
+		std::vector<StorageEdge>* inheritanceEdges) const;
+	void collectInvisibleParentNodeIds(
+		const SqliteIndexStorage& storage,
+		const std::vector<StorageEdge>& memberEdges,
+		std::set<Id>* nodeIds) const;
+	void collectHierarchyCacheData(
+		const SqliteIndexStorage& storage,
+		const std::vector<StorageEdge>& memberEdges,
+		const std::vector<StorageEdge>& inheritanceEdges,
+		const std::set<Id>& invisibleParentNodeIds,
+		std::vector<HierarchyCacheFileConnection>* connections,
+		std::vector<HierarchyCacheFileInheritance>* inheritances,
+		std::vector<HierarchyCacheFileMemberEdgeOrder>* memberEdgeOrders) const;
+
+	// served by the edge cache once it is built, the cache is dropped when edges are modified
+	bool isEdge(Id elementId) const;
+	std::vector<StorageEdge> getEdgesByIds(const std::vector<Id>& edgeIds) const;
+	std::vector<StorageEdge> getEdgesBySourceId(Id sourceId) const;
+	std::vector<StorageEdge> getEdgesBySourceIds(const std::vector<Id>& sourceIds) const;
+	std::vector<StorageEdge> getEdgesByTargetId(Id targetId) const;
+	std::vector<StorageEdge> getEdgesByTargetIds(const std::vector<Id>& targetIds) const;
+	std::vector<StorageEdge> getEdgesBySourceOrTargetId(Id id) const;
+
+	void setUnsafeWriteMarker(bool unsafe);
+
+	bool m_performanceProfileSet = false;
+	bool m_bulkPerformanceProfile = false;
+	bool m_unsafeWriteMarkerSet = false;
+	bool m_foreignKeyChecksDeferred = false;
 
 	bool m_preIndexingErrorCountSet = false;
 	size_t m_preIndexingErrorCount = 0;
@@ -280,9 +387,9 @@ private:
 	std::map<Id, std::wstring> m_fileNodeLanguage;
 
 	std::map<Id, DefinitionKind> m_symbolDefinitionKinds;
-	std::map<Id, Id> m_memberEdgeIdOrderMap;
 
 	HierarchyCache m_hierarchyCache;
+	EdgeCache m_edgeCache;
 
 	bool m_hasJavaFiles = false;
 };
@@ -1,5 +1,7 @@
 #include "Storage.h"
 
+#include <unordered_map>
+
 #include "logging.h"
 #include "tracing.h"
 
@@ -9,8 +11,8 @@ void Storage::inject(Storage* injected)
 {
 	std::lock_guard<std::mutex> lock(m_dataMutex);
 
-	std::map<Id, Id> injectedIdToOwnElementId;
-	std::map<Id, Id> injectedIdToOwnSourceLocationId;
+	std::unordered_map<Id, Id> injectedIdToOwnElementId;
+	std::unordered_map<Id, Id> injectedIdToOwnSourceLocationId;
 
 	TRACE();
 	startInjection();
@@ -29,6 +31,7 @@ void Storage::inject(Storage* injected)
 		// TRACE("inject nodes");
 
 		const std::vector<StorageNode>& nodes = injected->getStorageNodes();
+		injectedIdToOwnElementId.reserve(nodes.size());
 
 		std::vector<Id> nodeIds = addNodes(nodes);
 
@@ -134,24 +137,22 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject local symbols");
 
-		const std::set<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
+		const std::vector<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
 		std::vector<Id> symbolIds = addLocalSymbols(symbols);
 
-		auto it = symbols.begin();
 		for (size_t i = 0; i < symbols.size(); i++)
 		{
 			if (symbolIds[i])
 			{
-				injectedIdToOwnElementId.emplace(it->id, symbolIds[i]);
+				injectedIdToOwnElementId.emplace(symbols[i].id, symbolIds[i]);
 			}
-			it++;
 		}
 	}
 
 	{
 		// TRACE("inject locations");
 
-		const std::set<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
+		const std::vector<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
 		std::vector<StorageSourceLocation> locations;
 		locations.reserve(oldLocations.size());
 
@@ -173,6 +174,7 @@ void Storage::inject(Storage* injected)
 		}
 
 		std::vector<Id> locationIds = addSourceLocations(locations);
+		injectedIdToOwnSourceLocationId.reserve(locationIds.size());
 
 		if (locations.size() == locationIds.size())
 		{
@@ -193,7 +195,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject occurrences");
 
-		const std::set<StorageOccurrence>& oldOccurences = injected->getStorageOccurrences();
+		const std::vector<StorageOccurrence>& oldOccurences = injected->getStorageOccurrences();
 
 		std::vector<StorageOccurrence> occurrences;
 		occurrences.reserve(oldOccurences.size());
@@ -235,7 +237,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject element components");
 
-		const std::set<StorageElementComponent>& oldComponents = injected->getElementComponents();
+		const std::vector<StorageElementComponent>& oldComponents = injected->getElementComponents();
 		std::vector<StorageElementComponent> components;
 		components.reserve(oldComponents.size());
 
@@ -254,7 +256,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject accesses");
 
-		const std::set<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
+		const std::vector<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
 		std::vector<StorageComponentAccess> accesses;
 		accesses.reserve(oldAccesses.size());
 
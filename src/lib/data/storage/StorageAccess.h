@@ -1,6 +1,7 @@
 #ifndef STORAGE_ACCESS_H
 #define STORAGE_ACCESS_H
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,8 +51,13 @@ public:
 
 	virtual StorageEdge getEdgeById(Id edgeId) const = 0;
 
+	// onFileLocations is called with the locations of each file as soon as they are found, the search
+	// stops early if it returns false or if maxResultCount locations were found (0 for no limit).
 	virtual std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const = 0;
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		size_t maxResultCount,
+		std::function<bool(std::shared_ptr<SourceLocationFile>)> onFileLocations) const = 0;
 	virtual std::vector<SearchMatch> getAutocompletionMatches(
 		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const = 0;
 	virtual std::vector<SearchMatch> getSearchMatchesForTokenIds(
@@ -64,6 +70,9 @@ public:
 		const std::vector<Id>& expandedNodeIds,
 		bool* isActiveNamespace = nullptr) const = 0;
 	virtual std::shared_ptr<Graph> getGraphForChildrenOfNodeId(Id nodeId) const = 0;
+	// a terminated trail contains every path within depth, or only the shortest paths if
+	// shortestPathsOnly is set. the search visits at most maxNodeCount nodes (0 means no limit) and
+	// returns an empty graph if isInterrupted returns true
 	virtual std::shared_ptr<Graph> getGraphForTrail(
 		Id originId,
 		Id targetId,
@@ -71,7 +80,10 @@ public:
 		Edge::TypeMask edgeTypes,
 		bool nodeNonIndexed,
 		size_t depth,
-		bool directed) const = 0;
+		bool directed,
+		bool shortestPathsOnly,
+		size_t maxNodeCount,
+		std::function<bool()> isInterrupted) const = 0;
 
 	virtual NodeType::TypeMask getAvailableNodeTypes() const = 0;
 	virtual Edge::TypeMask getAvailableEdgeTypes() const = 0;
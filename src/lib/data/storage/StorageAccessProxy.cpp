@@ -125,7 +125,7 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 		return _DEFAULT_VALUE_;                                                                    \
 	}
 
-#define DEF_GETTER_7(                                                                              \
+#define DEF_GETTER_10(                                                                             \
 	_METHOD_NAME_,                                                                                 \
 	_PARAM_1_TYPE_,                                                                                \
 	_PARAM_2_TYPE_,                                                                                \
@@ -134,6 +134,9 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 	_PARAM_5_TYPE_,                                                                                \
 	_PARAM_6_TYPE_,                                                                                \
 	_PARAM_7_TYPE_,                                                                                \
+	_PARAM_8_TYPE_,                                                                                \
+	_PARAM_9_TYPE_,                                                                                \
+	_PARAM_10_TYPE_,                                                                               \
 	_RETURN_TYPE_,                                                                                 \
 	_DEFAULT_VALUE_)                                                                               \
 	UNWRAP(_RETURN_TYPE_)                                                                          \
@@ -144,11 +147,14 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 		_PARAM_4_TYPE_ p4,                                                                         \
 		_PARAM_5_TYPE_ p5,                                                                         \
 		_PARAM_6_TYPE_ p6,                                                                         \
-		_PARAM_7_TYPE_ p7) const                                                                   \
+		_PARAM_7_TYPE_ p7,                                                                         \
+		_PARAM_8_TYPE_ p8,                                                                         \
+		_PARAM_9_TYPE_ p9,                                                                         \
+		_PARAM_10_TYPE_ p10) const                                                                 \
 	{                                                                                              \
 		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                             \
 		{                                                                                          \
-			return subject->_METHOD_NAME_(p1, p2, p3, p4, p5, p6, p7);                             \
+			return subject->_METHOD_NAME_(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10);                \
 		}                                                                                          \
 		return _DEFAULT_VALUE_;                                                                    \
 	}
@@ -164,10 +170,12 @@ DEF_GETTER_1(getNodeIdToParentFileMap, const std::vector<Id>&, NodeIdToParentFil
 
 DEF_GETTER_1(getNodeTypeForNodeWithId, Id, NodeType, NodeType(NodeType::NODE_SYMBOL))
 DEF_GETTER_1(getEdgeById, Id, StorageEdge, StorageEdge())
-DEF_GETTER_2(
+DEF_GETTER_4(
 	getFullTextSearchLocations,
 	const std::wstring&,
 	bool,
+	size_t,
+	std::function<bool(std::shared_ptr<SourceLocationFile>)>,
 	std::shared_ptr<SourceLocationCollection>,
 	std::make_shared<SourceLocationCollection>())
 DEF_GETTER_3(
@@ -192,7 +200,7 @@ DEF_GETTER_3(
 	std::shared_ptr<Graph>,
 	std::make_shared<Graph>())
 DEF_GETTER_1(getGraphForChildrenOfNodeId, Id, std::shared_ptr<Graph>, std::make_shared<Graph>())
-DEF_GETTER_7(
+DEF_GETTER_10(
 	getGraphForTrail,
 	Id,
 	Id,
@@ -201,6 +209,9 @@ DEF_GETTER_7(
 	bool,
 	size_t,
 	bool,
+	bool,
+	size_t,
+	std::function<bool()>,
 	std::shared_ptr<Graph>,
 	std::make_shared<Graph>())
 DEF_GETTER_0(getAvailableNodeTypes, NodeType::TypeMask, 0);
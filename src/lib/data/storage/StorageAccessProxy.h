@@ -28,7 +28,10 @@ public:
 	StorageEdge getEdgeById(Id edgeId) const override;
 
 	std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const override;
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		size_t maxResultCount,
+		std::function<bool(std::shared_ptr<SourceLocationFile>)> onFileLocations) const override;
 	std::vector<SearchMatch> getAutocompletionMatches(
 		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const override;
 	std::vector<SearchMatch> getSearchMatchesForTokenIds(const std::vector<Id>& tokenIds) const override;
@@ -47,7 +50,10 @@ public:
 		Edge::TypeMask edgeTypes,
 		bool nodeNonIndexed,
 		size_t depth,
-		bool directed) const override;
+		bool directed,
+		bool shortestPathsOnly,
+		size_t maxNodeCount,
+		std::function<bool()> isInterrupted) const override;
 
 	NodeType::TypeMask getAvailableNodeTypes() const override;
 	Edge::TypeMask getAvailableEdgeTypes() const override;
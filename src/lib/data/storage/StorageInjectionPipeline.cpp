@@ -0,0 +1,221 @@
+#include "StorageInjectionPipeline.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "IntermediateStorage.h"
+#include "StorageProvider.h"
+#include "TimeStamp.h"
+#include "logging.h"
+
+const size_t StorageInjectionPipeline::s_maxQueuedBatchCount = 2;
+const size_t StorageInjectionPipeline::s_batchSourceLocationCount = 100000;
+
+StorageInjectionPipeline::StorageInjectionPipeline(
+	std::shared_ptr<StorageProvider> storageProvider, size_t preparationThreadCount)
+	: m_storageProvider(storageProvider)
+	, m_preparationThreadCount(std::max<size_t>(1, preparationThreadCount))
+{
+}
+
+StorageInjectionPipeline::~StorageInjectionPipeline()
+{
+	stop();
+}
+
+void StorageInjectionPipeline::start()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_runningThreadCount > 0 || m_stopping || m_storageProvider->getStorageCount() == 0)
+	{
+		return;
+	}
+
+	// threads leave when there is nothing left to prepare
+	joinThreads();
+
+	m_runningThreadCount = m_preparationThreadCount;
+	for (size_t i = 0; i < m_preparationThreadCount; i++)
+	{
+		m_threads.emplace_back(&StorageInjectionPipeline::runPreparation, this);
+	}
+}
+
+void StorageInjectionPipeline::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_all();
+
+	joinThreads();
+
+	std::deque<std::shared_ptr<IntermediateStorage>> batches;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = false;
+		batches.swap(m_batches);
+	}
+
+	for (std::shared_ptr<IntermediateStorage>& batch: batches)
+	{
+		m_storageProvider->insert(batch);
+	}
+
+	logStats();
+}
+
+void StorageInjectionPipeline::clear()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_batches.clear();
+		m_clearCount++;
+	}
+	m_condition.notify_all();
+}
+
+bool StorageInjectionPipeline::injectNextBatch(Storage* target, size_t waitMS)
+{
+	std::shared_ptr<IntermediateStorage> batch;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait_for(lock, std::chrono::milliseconds(waitMS), [this]() {
+			return !m_batches.empty() || m_runningThreadCount == 0;
+		});
+
+		if (m_batches.empty())
+		{
+			return false;
+		}
+
+		batch = m_batches.front();
+		m_batches.pop_front();
+	}
+	m_condition.notify_all();
+
+	TimeStamp start = TimeStamp::now();
+	target->inject(batch.get());
+	const double seconds = TimeStamp::durationSeconds(start);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.injectedBatchCount++;
+	m_stats.injectedSourceLocationCount += batch->getSourceLocationCount();
+	m_stats.injectionSeconds += seconds;
+	return true;
+}
+
+bool StorageInjectionPipeline::isDrained() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_runningThreadCount == 0 && m_batches.empty() &&
+		m_storageProvider->getStorageCount() == 0;
+}
+
+StorageInjectionStats StorageInjectionPipeline::getStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void StorageInjectionPipeline::runPreparation()
+{
+	while (true)
+	{
+		size_t clearCount = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() {
+				return m_stopping || m_batches.size() < s_maxQueuedBatchCount;
+			});
+
+			if (m_stopping)
+			{
+				break;
+			}
+			clearCount = m_clearCount;
+		}
+
+		size_t storageCount = 0;
+		TimeStamp start = TimeStamp::now();
+		std::shared_ptr<IntermediateStorage> batch = prepareBatch(storageCount);
+		const double seconds = TimeStamp::durationSeconds(start);
+
+		if (!batch)
+		{
+			break;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (clearCount == m_clearCount)
+			{
+				m_batches.push_back(batch);
+			}
+			m_stats.preparedStorageCount += storageCount;
+			m_stats.preparedBatchCount++;
+			m_stats.preparationSeconds += seconds;
+		}
+		m_condition.notify_all();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_runningThreadCount--;
+	}
+	m_condition.notify_all();
+}
+
+std::shared_ptr<IntermediateStorage> StorageInjectionPipeline::prepareBatch(size_t& storageCount)
+{
+	std::shared_ptr<IntermediateStorage> batch = m_storageProvider->consumeLargestStorage();
+	if (!batch)
+	{
+		return batch;
+	}
+	storageCount = 1;
+
+	while (batch->getSourceLocationCount() < s_batchSourceLocationCount)
+	{
+		std::shared_ptr<IntermediateStorage> storage = m_storageProvider->consumeLargestStorage();
+		if (!storage)
+		{
+			break;
+		}
+
+		batch->inject(storage.get());
+		storageCount++;
+	}
+
+	return batch;
+}
+
+void StorageInjectionPipeline::joinThreads()
+{
+	for (std::thread& thread: m_threads)
+	{
+		thread.join();
+	}
+	m_threads.clear();
+}
+
+void StorageInjectionPipeline::logStats()
+{
+	StorageInjectionStats stats = getStats();
+	if (stats.injectedBatchCount == m_loggedBatchCount)
+	{
+		return;
+	}
+	m_loggedBatchCount = stats.injectedBatchCount;
+
+	LOG_INFO_STREAM(
+		<< "injection pipeline - preparation: " << stats.preparedStorageCount << " storages in "
+		<< stats.preparedBatchCount << " batches, "
+		<< (stats.preparationSeconds > 0 ? stats.preparedStorageCount / stats.preparationSeconds : 0)
+		<< " storages/s; writer: " << stats.injectedBatchCount << " batches, "
+		<< stats.injectedSourceLocationCount << " locations, "
+		<< (stats.injectionSeconds > 0 ? stats.injectedSourceLocationCount / stats.injectionSeconds
+									   : 0)
+		<< " locations/s");
+}
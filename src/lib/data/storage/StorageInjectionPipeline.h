@@ -0,0 +1,80 @@
+#ifndef STORAGE_INJECTION_PIPELINE_H
+#define STORAGE_INJECTION_PIPELINE_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class IntermediateStorage;
+class Storage;
+class StorageProvider;
+
+struct StorageInjectionStats
+{
+	size_t preparedStorageCount = 0;
+	size_t preparedBatchCount = 0;
+	double preparationSeconds = 0.0;	// summed over all preparation threads
+
+	size_t injectedBatchCount = 0;
+	size_t injectedSourceLocationCount = 0;
+	double injectionSeconds = 0.0;
+};
+
+// Injects the intermediate storages of the indexers in two stages. The preparation threads take
+// storages from the provider and merge them into batches, which remaps and deduplicates their ids
+// in memory. The batches are handed over through a bounded queue to the single writer, which
+// injects each batch into the target storage in one transaction. This way the writer does not
+// wait for the remapping of the next storage.
+class StorageInjectionPipeline
+{
+public:
+	StorageInjectionPipeline(
+		std::shared_ptr<StorageProvider> storageProvider, size_t preparationThreadCount);
+	~StorageInjectionPipeline();
+
+	// starts the preparation threads if there are storages to prepare and none are running
+	void start();
+
+	// joins the preparation threads, batches that were not injected yet go back to the provider
+	void stop();
+
+	// drops all batches waiting for injection
+	void clear();
+
+	// waits up to waitMS for a prepared batch and injects it into the target
+	bool injectNextBatch(Storage* target, size_t waitMS);
+
+	// true if the provider is empty and no batch is being prepared or waiting for injection
+	bool isDrained() const;
+
+	StorageInjectionStats getStats() const;
+
+private:
+	static const size_t s_maxQueuedBatchCount;
+	static const size_t s_batchSourceLocationCount;
+
+	void runPreparation();
+	std::shared_ptr<IntermediateStorage> prepareBatch(size_t& storageCount);
+	void joinThreads();
+	void logStats();
+
+	std::shared_ptr<StorageProvider> m_storageProvider;
+	const size_t m_preparationThreadCount;
+
+	std::vector<std::thread> m_threads;
+	size_t m_runningThreadCount = 0;
+	bool m_stopping = false;
+	size_t m_clearCount = 0;
+
+	std::deque<std::shared_ptr<IntermediateStorage>> m_batches;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+
+	StorageInjectionStats m_stats;
+	size_t m_loggedBatchCount = 0;
+};
+
+#endif	  // STORAGE_INJECTION_PIPELINE_H
@@ -3,15 +3,18 @@
 #include <sstream>
 #include <unordered_map>
 
+#include "ContentHasher.h"
 #include "FileSystem.h"
 #include "LocationType.h"
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
 #include "TextAccess.h"
+#include "TimeStamp.h"
 #include "logging.h"
+#include "utilityCompression.h"
 #include "utilityString.h"
 
-const size_t SqliteIndexStorage::s_storageVersion = 25;
+const size_t SqliteIndexStorage::s_storageVersion = 27;
 
 namespace
 {
@@ -42,6 +45,11 @@ size_t SqliteIndexStorage::getStaticVersion() const
 	return s_storageVersion;
 }
 
+void SqliteIndexStorage::setFileContentCompressed(bool compressed)
+{
+	m_fileContentCompressed = compressed;
+}
+
 void SqliteIndexStorage::setMode(const StorageModeType mode)
 {
 	m_tempNodeNameIndex.clear();
@@ -184,10 +192,18 @@ bool SqliteIndexStorage::addFile(const StorageFile& data)
 
 	std::shared_ptr<TextAccess> content;
 	int lineCount = 0;
+	std::string contentHash;
+	uint64_t byteSize = 0;
 	if (data.indexed)
 	{
 		content = TextAccess::createFromFile(filePath);
 		lineCount = content->getLineCount();
+
+		// the hash is taken from the raw file, the stored content has normalized line endings
+		if (!ContentHasher::hashFile(filePath, contentHash, byteSize))
+		{
+			contentHash.clear();
+		}
 	}
 
 	bool success = false;
@@ -199,13 +215,44 @@ bool SqliteIndexStorage::addFile(const StorageFile& data)
 		m_insertFileStmt.bind(5, data.indexed);
 		m_insertFileStmt.bind(6, data.complete);
 		m_insertFileStmt.bind(7, lineCount);
+		if (contentHash.empty())
+		{
+			m_insertFileStmt.bindNull(8);
+			m_insertFileStmt.bindNull(9);
+		}
+		else
+		{
+			m_insertFileStmt.bind(8, sqlite_int64(byteSize));
+			m_insertFileStmt.bind(9, contentHash.c_str());
+		}
 		success = executeStatement(m_insertFileStmt);
 	}
 
 	if (success && content)
 	{
+		const std::string text = content->getText();
+
+		std::string compressedText;
+		if (m_fileContentCompressed)
+		{
+			compressedText = utility::compressLz4Block(text);
+		}
+
 		m_insertFileContentStmt.bind(1, int(data.id));
-		m_insertFileContentStmt.bind(2, content->getText().c_str());
+		m_insertFileContentStmt.bind(3, int(text.size()));
+		if (!compressedText.empty() && compressedText.size() < text.size())
+		{
+			m_insertFileContentStmt.bind(2, FILE_CONTENT_CODEC_LZ4);
+			m_insertFileContentStmt.bind(
+				4,
+				reinterpret_cast<const unsigned char*>(compressedText.data()),
+				int(compressedText.size()));
+		}
+		else
+		{
+			m_insertFileContentStmt.bind(2, FILE_CONTENT_CODEC_NONE);
+			m_insertFileContentStmt.bind(4, text.c_str());
+		}
 		success = executeStatement(m_insertFileContentStmt);
 	}
 
@@ -264,7 +311,7 @@ Id SqliteIndexStorage::addLocalSymbol(const StorageLocalSymbolData& data)
 	return ids.size() ? ids[0] : 0;
 }
 
-std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	if (m_tempLocalSymbolIndex.empty())
 	{
@@ -279,10 +326,9 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 
 	std::vector<Id> symbolIds(symbols.size(), 0);
 	std::vector<StorageLocalSymbol> symbolsToInsert;
-	auto it = symbols.begin();
 	for (size_t i = 0; i < symbols.size(); i++)
 	{
-		const StorageLocalSymbol& data = *it;
+		const StorageLocalSymbol& data = symbols[i];
 		std::pair<std::wstring, std::wstring> name = splitLocalSymbolName(data.name);
 		if (name.second.size())
 		{
@@ -309,8 +355,6 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 				m_tempLocalSymbolIndex[name.first].emplace(name.second, id);
 			}
 		}
-
-		it++;
 	}
 
 	if (symbolsToInsert.size())
@@ -488,144 +532,101 @@ void SqliteIndexStorage::removeElementsWithoutOccurrences(const std::vector<Id>&
 }
 
 void SqliteIndexStorage::removeElementsWithLocationInFiles(
-	const std::vector<Id>& fileIds, std::function<void(int)> updateStatusCallback)
+	const std::vector<Id>& fileIds,
+	std::function<void(int, const std::wstring&)> updateStatusCallback)
 {
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(1);
-	}
-
-	// preparing
-	executeStatement("DROP TABLE IF EXISTS main.element_id_to_clear;");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(2);
-	}
+	TimeStamp phaseStart = TimeStamp::now();
+	auto finishPhase = [&](int progress, const std::wstring& phase) {
+		if (updateStatusCallback != nullptr)
+		{
+			const std::string duration = TimeStamp::secondsToString(
+				TimeStamp::durationSeconds(phaseStart));
+			updateStatusCallback(progress, phase + L" (" + utility::decodeFromUtf8(duration) + L")");
+		}
+		phaseStart = TimeStamp::now();
+	};
 
+	// preparing, the ids are bound to a statement instead of being joined into the sql text
+	executeStatement("DROP TABLE IF EXISTS temp.file_id_to_clear;");
+	executeStatement("DROP TABLE IF EXISTS temp.element_id_to_clear;");
+	executeStatement("CREATE TEMP TABLE file_id_to_clear(id INTEGER NOT NULL, PRIMARY KEY(id));");
 	executeStatement(
-		"CREATE TABLE IF NOT EXISTS element_id_to_clear("
-		"id INTEGER NOT NULL, "
-		"PRIMARY KEY(id));");
-
-	if (updateStatusCallback != nullptr)
+		"CREATE TEMP TABLE element_id_to_clear(id INTEGER NOT NULL, PRIMARY KEY(id));");
 	{
-		updateStatusCallback(3);
+		CppSQLite3Statement stmt = m_database.compileStatement(
+			"INSERT OR IGNORE INTO temp.file_id_to_clear(id) VALUES(?);");
+		for (Id fileId: fileIds)
+		{
+			stmt.bind(1, int(fileId));
+			executeStatement(stmt);
+		}
 	}
 
-	// store ids of all elements located in fileIds into element_id_to_clear
+	// store ids of all elements located in the files into element_id_to_clear
 	executeStatement(
-		"INSERT INTO element_id_to_clear "
+		"INSERT OR IGNORE INTO temp.element_id_to_clear "
 		"	SELECT occurrence.element_id "
-		"	FROM occurrence "
-		"	INNER JOIN source_location ON ("
-		"		occurrence.source_location_id = source_location.id"
-		"	) "
-		"	WHERE source_location.file_node_id IN (" +
-		utility::join(utility::toStrings(fileIds), ',') +
-		")"
-		"	GROUP BY (occurrence.element_id)");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(4);
-	}
-
-	// delete all edges in element_id_to_clear
-	executeStatement(
-		"DELETE FROM element WHERE element.id IN "
-		"	(SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN edge ON "
-		"(element_id_to_clear.id = edge.id))");
+		"	FROM temp.file_id_to_clear "
+		"	INNER JOIN source_location ON (source_location.file_node_id = file_id_to_clear.id) "
+		"	INNER JOIN occurrence ON (occurrence.source_location_id = source_location.id);");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(30);
-	}
-
-	// delete all edges originating from element_id_to_clear
-	executeStatement(
-		"DELETE FROM element WHERE element.id IN (SELECT id FROM edge WHERE source_node_id IN "
-		"(SELECT id FROM element_id_to_clear))");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(31);
-	}
+	finishPhase(10, L"Collected elements");
 
-	// remove all non existing ids from element_id_to_clear (they have been cleared by now and we
-	// can disregard them)
+	// delete all edges in element_id_to_clear and all edges originating from element_id_to_clear
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id NOT IN ("
-		"	SELECT id FROM element"
-		")");
+		"DELETE FROM element WHERE id IN ("
+		"	SELECT edge.id FROM temp.element_id_to_clear "
+		"	INNER JOIN edge ON (edge.id = element_id_to_clear.id) "
+		"	UNION "
+		"	SELECT edge.id FROM temp.element_id_to_clear "
+		"	INNER JOIN edge ON (edge.source_node_id = element_id_to_clear.id)"
+		");");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(33);
-	}
+	finishPhase(30, L"Deleted edges");
 
-	// remove all files from element_id_to_clear (they will be cleared later)
+	// remove all cleared ids and all files from element_id_to_clear (files are cleared later)
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT id FROM file"
-		")");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(34);
-	}
+		"DELETE FROM temp.element_id_to_clear WHERE "
+		"	NOT EXISTS (SELECT 1 FROM element WHERE element.id = element_id_to_clear.id) OR "
+		"	EXISTS (SELECT 1 FROM file WHERE file.id = element_id_to_clear.id);");
 
-	// delete source locations from fileIds (this also deletes the respective occurrences)
+	// delete occurrences and source locations of the files
 	executeStatement(
-		"DELETE FROM source_location WHERE file_node_id IN (" +
-		utility::join(utility::toStrings(fileIds), ',') + ");");
+		"DELETE FROM occurrence WHERE source_location_id IN ("
+		"	SELECT source_location.id FROM temp.file_id_to_clear "
+		"	INNER JOIN source_location ON (source_location.file_node_id = file_id_to_clear.id)"
+		");");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(45);
-	}
+	finishPhase(45, L"Deleted occurrences");
 
-	// remove all ids from element_id_to_clear that still have occurrences
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN occurrence ON "
-		"		element_id_to_clear.id = occurrence.element_id"
-		")");
+		"DELETE FROM source_location WHERE file_node_id IN ("
+		"	SELECT id FROM temp.file_id_to_clear"
+		");");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(59);
-	}
+	finishPhase(60, L"Deleted source locations");
 
-	// remove all ids from element_id_to_clear that still have an edge pointing to them
+	// keep all elements that still have occurrences or an edge pointing to them
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT target_node_id FROM edge"
-		")");
+		"DELETE FROM temp.element_id_to_clear WHERE "
+		"	EXISTS (SELECT 1 FROM occurrence WHERE occurrence.element_id = element_id_to_clear.id) OR "
+		"	EXISTS (SELECT 1 FROM edge WHERE edge.target_node_id = element_id_to_clear.id);");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(74);
-	}
+	finishPhase(75, L"Collected unreferenced elements");
 
 	// delete all elements that are still listed in element_id_to_clear
 	executeStatement(
-		"DELETE FROM element WHERE EXISTS ("
-		"	SELECT * FROM element_id_to_clear WHERE element.id = element_id_to_clear.id"
-		")");
+		"DELETE FROM element WHERE id IN ("
+		"	SELECT id FROM temp.element_id_to_clear"
+		");");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(87);
-	}
+	finishPhase(87, L"Deleted unreferenced elements");
 
 	// cleaning up
-	executeStatement("DROP TABLE IF EXISTS main.element_id_to_clear;");
+	executeStatement("DROP TABLE IF EXISTS temp.file_id_to_clear;");
+	executeStatement("DROP TABLE IF EXISTS temp.element_id_to_clear;");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(89);
-	}
+	finishPhase(89, L"Cleaned up");
 }
 
 void SqliteIndexStorage::removeAllErrors()
@@ -840,10 +841,11 @@ std::vector<StorageFile> SqliteIndexStorage::getFilesByPaths(const std::vector<F
 std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentById(Id fileId) const
 {
 	CppSQLite3Query q = executeQuery(
-		"SELECT content FROM filecontent WHERE id = '" + std::to_string(fileId) + "';");
+		"SELECT codec, size, content FROM filecontent WHERE id = '" + std::to_string(fileId) +
+		"';");
 	if (!q.eof())
 	{
-		return TextAccess::createFromString(q.getStringField(0, ""));
+		return getFileContent(q);
 	}
 
 	return TextAccess::createFromString("");
@@ -854,7 +856,7 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::
 	try
 	{
 		CppSQLite3Query q = executeQuery(
-			"SELECT filecontent.content "
+			"SELECT filecontent.codec, filecontent.size, filecontent.content "
 			"FROM filecontent "
 			"INNER JOIN file ON filecontent.id = file.id "
 			"WHERE file.path = '" +
@@ -862,7 +864,7 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::
 
 		if (!q.eof())
 		{
-			return TextAccess::createFromString(q.getStringField(0, ""));
+			return getFileContent(q);
 		}
 	}
 	catch (CppSQLite3Exception& e)
@@ -873,6 +875,31 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::
 	return TextAccess::createFromString("");
 }
 
+bool SqliteIndexStorage::getFileContentHash(
+	const std::wstring& filePath, std::string& contentHash, uint64_t& byteSize) const
+{
+	try
+	{
+		CppSQLite3Query q = executeQuery(
+			"SELECT byte_size, content_hash FROM file "
+			"WHERE path = '" +
+			utility::encodeToUtf8(filePath) + "' AND content_hash IS NOT NULL;");
+
+		if (!q.eof())
+		{
+			byteSize = uint64_t(q.getInt64Field(0, 0));
+			contentHash = q.getStringField(1, "");
+			return true;
+		}
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
+
+	return false;
+}
+
 void SqliteIndexStorage::setFileIndexed(Id fileId, bool indexed)
 {
 	executeStatement(
@@ -1199,6 +1226,37 @@ std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices(
 	return indices;
 }
 
+std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContent(CppSQLite3Query& query) const
+{
+	const int codec = query.getIntField(0, FILE_CONTENT_CODEC_NONE);
+	if (codec == FILE_CONTENT_CODEC_NONE)
+	{
+		return TextAccess::createFromString(query.getStringField(2, ""));
+	}
+	else if (codec == FILE_CONTENT_CODEC_LZ4)
+	{
+		int length = 0;
+		const unsigned char* blob = query.getBlobField(2, length);
+
+		std::string text;
+		if (blob &&
+			utility::decompressLz4Block(
+				std::string(reinterpret_cast<const char*>(blob), length),
+				query.getIntField(1, 0),
+				text))
+		{
+			return TextAccess::createFromString(text);
+		}
+		LOG_ERROR("Unable to decompress file content.");
+	}
+	else
+	{
+		LOG_ERROR("Unknown file content codec: " + std::to_string(codec));
+	}
+
+	return TextAccess::createFromString("");
+}
+
 void SqliteIndexStorage::clearTables()
 {
 	try
@@ -1277,13 +1335,17 @@ void SqliteIndexStorage::setupTables()
 			"indexed INTEGER, "
 			"complete INTEGER, "
 			"line_count INTEGER, "
+			"byte_size INTEGER, "
+			"content_hash TEXT, "
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES node(id) ON DELETE CASCADE);");
 
 		m_database.execDML(
 			"CREATE TABLE IF NOT EXISTS filecontent("
 			"id INTERGER, "
-			"content TEXT, "
+			"codec INTEGER, "
+			"size INTEGER, "
+			"content BLOB, "
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES file(id)"
 			"ON DELETE CASCADE "
@@ -1415,9 +1477,9 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 			"INSERT INTO element_component(id, element_id, type, data) VALUES(NULL, ?, ?, ?);");
 		m_insertFileStmt = m_database.compileStatement(
 			"INSERT INTO file(id, path, language, modification_time, indexed, complete, "
-			"line_count) VALUES(?, ?, ?, ?, ?, ?, ?);");
+			"line_count, byte_size, content_hash) VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?);");
 		m_insertFileContentStmt = m_database.compileStatement(
-			"INSERT INTO filecontent(id, content) VALUES(?, ?);");
+			"INSERT INTO filecontent(id, codec, size, content) VALUES(?, ?, ?, ?);");
 		m_checkErrorExistsStmt = m_database.compileStatement(
 			"SELECT id FROM error WHERE "
 			"message = ? AND "
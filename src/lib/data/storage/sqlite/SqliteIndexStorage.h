@@ -41,12 +41,22 @@ public:
 		STORAGE_MODE_CLEAR = 4
 	};
 
+	// stored with each file content to allow mixing compressed and uncompressed rows
+	enum FileContentCodecType
+	{
+		FILE_CONTENT_CODEC_NONE = 0,
+		FILE_CONTENT_CODEC_LZ4 = 1
+	};
+
 	SqliteIndexStorage(const FilePath& dbFilePath);
 
 	virtual size_t getStaticVersion() const;
 
 	void setMode(const StorageModeType mode);
 
+	// compresses the content of files added afterwards, reading handles both kinds of content
+	void setFileContentCompressed(bool compressed);
+
 	std::string getProjectSettingsText() const;
 	void setProjectSettingsText(std::string text);
 
@@ -58,7 +68,7 @@ public:
 	Id addEdge(const StorageEdgeData& data);
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges);
 	Id addLocalSymbol(const StorageLocalSymbolData& data);
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols);
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols);
 	Id addSourceLocation(const StorageSourceLocationData& data);
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations);
 	bool addOccurrence(const StorageOccurrence& data);
@@ -74,8 +84,10 @@ public:
 	void removeOccurrence(const StorageOccurrence& occurrence);
 	void removeOccurrences(const std::vector<StorageOccurrence>& occurrences);
 	void removeElementsWithoutOccurrences(const std::vector<Id>& elementIds);
+	// reports the progress and the duration of each finished phase
 	void removeElementsWithLocationInFiles(
-		const std::vector<Id>& fileIds, std::function<void(int)> updateStatusCallback);
+		const std::vector<Id>& fileIds,
+		std::function<void(int, const std::wstring&)> updateStatusCallback);
 
 	void removeAllErrors();
 
@@ -110,6 +122,10 @@ public:
 	std::shared_ptr<TextAccess> getFileContentByPath(const std::wstring& filePath) const;
 	std::shared_ptr<TextAccess> getFileContentById(Id fileId) const;
 
+	// returns false if no hash was stored for the file, e.g. because it was not indexed
+	bool getFileContentHash(
+		const std::wstring& filePath, std::string& contentHash, uint64_t& byteSize) const;
+
 	void setFileIndexed(Id fileId, bool indexed);
 	void setFileCompleteIfNoError(Id fileId, const std::wstring& filePath, bool complete);
 	void setNodeType(int type, Id nodeId);
@@ -237,6 +253,8 @@ private:
 
 	std::vector<std::pair<int, SqliteDatabaseIndex>> getIndices() const;
 
+	std::shared_ptr<TextAccess> getFileContent(CppSQLite3Query& query) const;
+
 	virtual void clearTables();
 	virtual void setupTables();
 	virtual void setupPrecompiledStatements();
@@ -271,6 +289,8 @@ private:
 	std::map<std::wstring, std::map<std::wstring, uint32_t>> m_tempLocalSymbolIndex;
 	std::map<uint32_t, std::map<TempSourceLocation, uint32_t>> m_tempSourceLocationIndices;
 
+	bool m_fileContentCompressed = false;
+
 	template <typename StorageType>
 	class InsertBatchStatement
 	{
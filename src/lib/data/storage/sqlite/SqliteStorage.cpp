@@ -3,6 +3,7 @@
 #include "FileSystem.h"
 #include "TimeStamp.h"
 #include "logging.h"
+#include "utility.h"
 #include "utilityString.h"
 
 SqliteStorage::SqliteStorage(const FilePath& dbFilePath): m_dbFilePath(dbFilePath.getCanonical())
@@ -92,6 +93,87 @@ void SqliteStorage::optimizeMemory() const
 	executeStatement("VACUUM;");
 }
 
+bool SqliteStorage::PerformanceProfile::isCrashSafe() const
+{
+	const std::string mode = utility::toUpperCase(journalMode);
+	return mode != "MEMORY" && mode != "OFF" && utility::toUpperCase(synchronous) != "OFF";
+}
+
+void SqliteStorage::setPerformanceProfile(const PerformanceProfile& profile)
+{
+	const std::vector<std::string> journalModes = {
+		"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+	const std::vector<std::string> synchronousModes = {"OFF", "NORMAL", "FULL", "EXTRA"};
+
+	const std::string journalMode = utility::toUpperCase(profile.journalMode);
+	if (utility::containsElement(journalModes, journalMode))
+	{
+		// the journal mode can't be changed within a transaction, the query returns the mode in use
+		CppSQLite3Query query = executeQuery("PRAGMA journal_mode=" + journalMode + ";");
+		if (query.eof() || utility::toUpperCase(query.getStringField(0, "")) != journalMode)
+		{
+			LOG_WARNING("Unable to set journal mode \"" + journalMode + "\".");
+		}
+		query.finalize();
+	}
+	else
+	{
+		LOG_WARNING("Unknown journal mode \"" + profile.journalMode + "\" is not applied.");
+	}
+
+	const std::string synchronous = utility::toUpperCase(profile.synchronous);
+	if (utility::containsElement(synchronousModes, synchronous))
+	{
+		executeStatement("PRAGMA synchronous=" + synchronous + ";");
+	}
+	else
+	{
+		LOG_WARNING("Unknown synchronous mode \"" + profile.synchronous + "\" is not applied.");
+	}
+
+	executeStatement("PRAGMA cache_size=-" + std::to_string(profile.cacheSizeKb) + ";");
+	executeStatement(
+		std::string("PRAGMA temp_store=") + (profile.tempStoreInMemory ? "MEMORY" : "DEFAULT") + ";");
+	executeStatement("PRAGMA mmap_size=" + std::to_string(profile.mmapSizeMb * 1024 * 1024) + ";");
+}
+
+void SqliteStorage::setForeignKeysEnabled(bool enabled)
+{
+	executeStatement(std::string("PRAGMA foreign_keys=") + (enabled ? "ON" : "OFF") + ";");
+}
+
+bool SqliteStorage::getForeignKeysEnabled() const
+{
+	return executeStatementScalar("PRAGMA foreign_keys;", 0) == 1;
+}
+
+void SqliteStorage::setQueryOnly(bool queryOnly)
+{
+	executeStatement(std::string("PRAGMA query_only=") + (queryOnly ? "ON" : "OFF") + ";");
+}
+
+size_t SqliteStorage::removeForeignKeyViolations()
+{
+	std::vector<std::pair<std::string, long long>> violations;
+	{
+		CppSQLite3Query query = executeQuery("PRAGMA foreign_key_check;");
+		while (!query.eof())
+		{
+			violations.emplace_back(query.getStringField(0, ""), query.getInt64Field(1, -1));
+			query.nextRow();
+		}
+	}
+
+	for (const std::pair<std::string, long long>& violation: violations)
+	{
+		executeStatement(
+			"DELETE FROM " + violation.first + " WHERE rowid = " + std::to_string(violation.second) +
+			";");
+	}
+
+	return violations.size();
+}
+
 FilePath SqliteStorage::getDbFilePath() const
 {
 	return m_dbFilePath;
@@ -12,6 +12,19 @@ class TimeStamp;
 class SqliteStorage
 {
 public:
+	// connection settings that trade durability for speed, see the sqlite PRAGMA documentation
+	struct PerformanceProfile
+	{
+		std::string journalMode = "DELETE";
+		std::string synchronous = "FULL";
+		size_t cacheSizeKb = 2000;
+		bool tempStoreInMemory = false;
+		size_t mmapSizeMb = 0;
+
+		// whether the database is still consistent after a crash of the process
+		bool isCrashSafe() const;
+	};
+
 	SqliteStorage(const FilePath& dbFilePath);
 	virtual ~SqliteStorage();
 
@@ -27,6 +40,18 @@ public:
 
 	void optimizeMemory() const;
 
+	void setPerformanceProfile(const PerformanceProfile& profile);
+
+	// foreign key enforcement can't be changed within a transaction
+	void setForeignKeysEnabled(bool enabled);
+	bool getForeignKeysEnabled() const;
+
+	// rejects all changes to the database, for connections that only read in parallel
+	void setQueryOnly(bool queryOnly);
+
+	// deletes all rows that violate a foreign key constraint and returns their number
+	size_t removeForeignKeyViolations();
+
 	FilePath getDbFilePath() const;
 
 	bool isEmpty() const;
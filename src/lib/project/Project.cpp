@@ -132,7 +132,24 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 	{
 		if (tempDbPath.exists())
 		{
-			if (dbPath.exists())
+			if (PersistentStorage::getUnsafeWriteMarkerFilePath(tempDbPath).exists())
+			{
+				LOG_WARNING(
+					"Discarding temporary indexing data because it was written with a storage "
+					"profile that is not crash safe");
+				discardTempStorage();
+			}
+			else if (
+				PersistentStorage::getDeferredForeignKeysMarkerFilePath(tempDbPath).exists() &&
+				!PersistentStorage(tempDbPath, bookmarkDbPath).validateDeferredForeignKeys())
+			{
+				// rows were inserted without foreign key enforcement and cannot be checked
+				LOG_WARNING(
+					"Discarding temporary indexing data because its foreign key constraints could "
+					"not be validated");
+				discardTempStorage();
+			}
+			else if (dbPath.exists())
 			{
 				if (dialogView->confirm(
 						L"Sourcetrail has been closed unexpectedly while indexing this project. "
@@ -153,7 +170,7 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 				else
 				{
 					LOG_INFO("Discarding temporary indexing data on user's decision");
-					FileSystem::remove(tempDbPath);
+					discardTempStorage();
 				}
 			}
 			else
@@ -161,7 +178,12 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 				LOG_INFO(
 					"Switching to temporary indexing data because no other persistent data was "
 					"found");
-				FileSystem::rename(tempDbPath, dbPath);
+				if (!swapToTempStorageFile(dbPath, tempDbPath, dialogView))
+				{
+					m_state = PROJECT_STATE_NOT_LOADED;
+					MessageStatus(L"Unable to load project", true, false).dispatch();
+					return;
+				}
 			}
 		}
 	}
@@ -553,6 +575,21 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		tempIndexDbFilePath, m_storage->getBookmarkDbFilePath());
 	tempStorage->setup();
 
+	if (info.mode == REFRESH_ALL_FILES && tempStorage->isEmpty())
+	{
+		// nothing can be referenced that isn't injected in this run, so all constraints get checked
+		// at once when parsing finishes
+		tempStorage->deferForeignKeyChecks();
+	}
+
+	if (info.mode != REFRESH_ALL_FILES)
+	{
+		// keep the fulltext search index of all files that are not going to be cleared
+		tempStorage->prepareFullTextSearchIndexRefresh(
+			indexDbFilePath,
+			utility::toVector(utility::concat(info.filesToClear, info.nonIndexedFilesToClear)));
+	}
+
 	std::shared_ptr<TaskGroupSequence> taskSequential = std::make_shared<TaskGroupSequence>();
 
 	if (info.mode != REFRESH_ALL_FILES &&
@@ -636,7 +673,8 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		{
 			if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
 			{
-				preIndexTasks->addTask(sourceGroup->getPreIndexTask(storageProvider, dialogView));
+				preIndexTasks->addTask(
+					sourceGroup->getPreIndexTask(info, storageProvider, dialogView));
 			}
 		}
 
@@ -812,6 +850,21 @@ bool Project::swapToTempStorageFile(
 	{
 		FileSystem::remove(indexDbFilePath);
 		FileSystem::rename(tempIndexDbFilePath, indexDbFilePath);
+
+		// a missing or outdated fulltext search index is rebuilt on the first search, missing edge,
+		// symbol and hierarchy caches are built in memory when loading the storage. Journal files
+		// left by a crash hold committed data of the temporary database and move along with it.
+		const std::vector<FilePath> cacheFilePaths = utility::concat(
+			PersistentStorage::getCacheFilePaths(indexDbFilePath),
+			PersistentStorage::getJournalFilePaths(indexDbFilePath));
+		const std::vector<FilePath> tempCacheFilePaths = utility::concat(
+			PersistentStorage::getCacheFilePaths(tempIndexDbFilePath),
+			PersistentStorage::getJournalFilePaths(tempIndexDbFilePath));
+		for (size_t i = 0; i < cacheFilePaths.size(); i++)
+		{
+			FileSystem::remove(cacheFilePaths[i]);
+			FileSystem::rename(tempCacheFilePaths[i], cacheFilePaths[i]);
+		}
 	}
 	catch (std::exception& e)
 	{
@@ -836,6 +889,15 @@ void Project::discardTempStorage()
 	{
 		LOG_INFO("Discarding temporary indexing data");
 		FileSystem::remove(tempIndexDbPath);
+		for (const FilePath& filePath: utility::concat(
+				 PersistentStorage::getCacheFilePaths(tempIndexDbPath),
+				 PersistentStorage::getJournalFilePaths(tempIndexDbPath)))
+		{
+			FileSystem::remove(filePath);
+		}
+		FileSystem::remove(PersistentStorage::getUnsafeWriteMarkerFilePath(tempIndexDbPath));
+		FileSystem::remove(
+			PersistentStorage::getDeferredForeignKeysMarkerFilePath(tempIndexDbPath));
 	}
 }
 
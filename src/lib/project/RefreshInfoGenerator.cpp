@@ -1,12 +1,12 @@
 #include "RefreshInfoGenerator.h"
 
+#include "ContentHasher.h"
 #include "FileInfo.h"
-#include "FileSystem.h"
+#include "FileSystemSnapshot.h"
 #include "PersistentStorage.h"
 #include "RefreshInfo.h"
 #include "SourceGroup.h"
 #include "SourceGroupStatusType.h"
-#include "TextAccess.h"
 #include "utility.h"
 
 RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
@@ -21,12 +21,16 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 
 	{
 		const std::vector<FileInfo> fileInfosFromStorage = storage->getFileInfoForAllFiles();
+		const std::vector<FilePath> filePathsFromStorage = utility::convert<FileInfo, FilePath>(
+			fileInfosFromStorage, [](const FileInfo& info) { return info.path; });
+
+		// stat all known files at once instead of one by one in the checks below
+		const FileSystemSnapshot diskSnapshot = FileSystemSnapshot::createForFilePaths(
+			filePathsFromStorage);
 
 		std::set<FilePath> alreadyKnownPaths;
 		{
-			const std::set<FilePath> filePathsFromStorage = utility::toSet(
-				utility::convert<FileInfo, FilePath>(
-					fileInfosFromStorage, [](const FileInfo& info) { return info.path; }));
+			const std::set<FilePath> filePathSetFromStorage = utility::toSet(filePathsFromStorage);
 
 			for (std::shared_ptr<SourceGroup> sourceGroup: sourceGroups)
 			{
@@ -34,7 +38,7 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 				{
 					utility::append(
 						alreadyKnownPaths,
-						sourceGroup->filterToContainedFilePaths(filePathsFromStorage));
+						sourceGroup->filterToContainedFilePaths(filePathSetFromStorage));
 				}
 			}
 		}
@@ -42,11 +46,12 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 		// checking source and header files
 		for (const FileInfo& info: fileInfosFromStorage)
 		{
-			if (alreadyKnownPaths.find(info.path) != alreadyKnownPaths.end() && info.path.exists())
+			if (alreadyKnownPaths.find(info.path) != alreadyKnownPaths.end() &&
+				diskSnapshot.exists(info.path))
 			{
 				if (storage->getFilePathIndexed(info.path))
 				{
-					if (didFileChange(info, storage))
+					if (didFileChange(info, diskSnapshot, storage))
 					{
 						changedFilePaths.insert(info.path);
 					}
@@ -60,7 +65,9 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 					changedFilePaths.insert(info.path);
 				}
 			}
-			else if (!storage->getFilePathIndexed(info.path) && !didFileChange(info, storage))
+			else if (
+				!storage->getFilePathIndexed(info.path) &&
+				!didFileChange(info, diskSnapshot, storage))
 			{
 				unchangedNonindexedFilePaths.insert(info.path);
 			}
@@ -217,9 +224,14 @@ std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(
 	{
 		if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
 		{
-			for (const FilePath& sourceFilePath: sourceGroup->getAllSourceFilePaths())
+			const std::vector<FilePath> sourceFilePaths = utility::toVector(
+				sourceGroup->getAllSourceFilePaths());
+			const FileSystemSnapshot diskSnapshot = FileSystemSnapshot::createForFilePaths(
+				sourceFilePaths);
+
+			for (const FilePath& sourceFilePath: sourceFilePaths)
 			{
-				if (sourceFilePath.exists())
+				if (diskSnapshot.exists(sourceFilePath))
 				{
 					allSourceFilePaths.insert(sourceFilePath);
 				}
@@ -231,35 +243,31 @@ std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(
 }
 
 bool RefreshInfoGenerator::didFileChange(
-	const FileInfo& info, std::shared_ptr<const PersistentStorage> storage)
+	const FileInfo& info,
+	const FileSystemSnapshot& diskSnapshot,
+	std::shared_ptr<const PersistentStorage> storage)
 {
-	FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
+	FileInfo diskFileInfo = diskSnapshot.getFileInfo(info.path);
 	if (diskFileInfo.lastWriteTime > info.lastWriteTime)
 	{
-		if (!storage->hasContentForFile(info.path))
+		std::string storedHash;
+		uint64_t storedByteSize = 0;
+		if (!storage->getFileContentHash(info.path, storedHash, storedByteSize))
 		{
 			return true;
 		}
 
-		std::shared_ptr<TextAccess> storedFileContent = storage->getFileContent(info.path, false);
-		std::shared_ptr<TextAccess> diskFileContent = TextAccess::createFromFile(diskFileInfo.path);
-
-		const std::vector<std::string>& diskFileLines = diskFileContent->getAllLines();
-		const std::vector<std::string>& storedFileLines = storedFileContent->getAllLines();
-
-		if (diskFileLines.size() != storedFileLines.size())
+		// a checkout touches the modification time of unchanged files, so compare the content. A
+		// different size already tells that it changed without reading the file.
+		if (diskSnapshot.getFileByteSize(info.path) != storedByteSize)
 		{
 			return true;
 		}
 
-		for (size_t i = 0; i < diskFileLines.size(); i++)
-		{
-			if (diskFileLines[i] != storedFileLines[i])
-			{
-				return true;
-			}
-		}
-		return false;
+		std::string diskHash;
+		uint64_t diskByteSize = 0;
+		return !ContentHasher::hashFile(diskFileInfo.path, diskHash, diskByteSize) ||
+			diskHash != storedHash;
 	}
 	return false;
 }
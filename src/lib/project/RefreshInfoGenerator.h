@@ -7,6 +7,7 @@
 
 struct FileInfo;
 class FilePath;
+class FileSystemSnapshot;
 class PersistentStorage;
 struct RefreshInfo;
 class SourceGroup;
@@ -29,7 +30,10 @@ private:
 	static std::set<FilePath> getAllSourceFilePaths(
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
 
-	static bool didFileChange(const FileInfo& info, std::shared_ptr<const PersistentStorage> storage);
+	static bool didFileChange(
+		const FileInfo& info,
+		const FileSystemSnapshot& diskSnapshot,
+		std::shared_ptr<const PersistentStorage> storage);
 };
 
 #endif	  // REFRESH_INFO_GENERATOR_H
@@ -36,6 +36,7 @@ public:
 	virtual std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommands(
 		const RefreshInfo& info) const = 0;
 	virtual std::shared_ptr<Task> getPreIndexTask(
+		const RefreshInfo& info,
 		std::shared_ptr<StorageProvider> storageProvider,
 		std::shared_ptr<DialogView> dialogView) const;
 
@@ -297,6 +297,27 @@ void ApplicationSettings::setGraphGrouping(GroupType type)
 	setValue<std::wstring>("application/graph_grouping", groupTypeToString(type));
 }
 
+int ApplicationSettings::getGraphTrailMaxNodeCount() const
+{
+	// 0 means no limit
+	return getValue<int>("application/graph_trail_max_node_count", 1000000);
+}
+
+void ApplicationSettings::setGraphTrailMaxNodeCount(int count)
+{
+	setValue<int>("application/graph_trail_max_node_count", count);
+}
+
+bool ApplicationSettings::getGraphTrailShortestPathsOnly() const
+{
+	return getValue<bool>("application/graph_trail_shortest_paths_only", false);
+}
+
+void ApplicationSettings::setGraphTrailShortestPathsOnly(bool shortestPathsOnly)
+{
+	setValue<bool>("application/graph_trail_shortest_paths_only", shortestPathsOnly);
+}
+
 int ApplicationSettings::getScreenAutoScaling() const
 {
 	return getValue<int>("screen/auto_scaling", 1);
@@ -378,6 +399,26 @@ void ApplicationSettings::setMultiProcessIndexingEnabled(bool enabled)
 	setValue<bool>("indexing/multi_process_indexing", enabled);
 }
 
+bool ApplicationSettings::getIndexedHeaderSkippingEnabled() const
+{
+	return getValue<bool>("indexing/skip_indexed_headers", false);
+}
+
+void ApplicationSettings::setIndexedHeaderSkippingEnabled(bool enabled)
+{
+	setValue<bool>("indexing/skip_indexed_headers", enabled);
+}
+
+bool ApplicationSettings::getAutomaticPchEnabled() const
+{
+	return getValue<bool>("indexing/automatic_pch", false);
+}
+
+void ApplicationSettings::setAutomaticPchEnabled(bool enabled)
+{
+	setValue<bool>("indexing/automatic_pch", enabled);
+}
+
 FilePath ApplicationSettings::getJavaPath() const
 {
 	return FilePath(getValue<std::wstring>("indexing/java/java_path", L""));
@@ -505,6 +546,96 @@ void ApplicationSettings::setHasPrefilledFrameworkSearchPaths(bool v)
 	setValue<bool>("indexing/cxx/has_prefilled_framework_search_paths", v);
 }
 
+std::string ApplicationSettings::getStorageBulkJournalMode() const
+{
+	return getValue<std::string>("storage/bulk/journal_mode", "WAL");
+}
+
+void ApplicationSettings::setStorageBulkJournalMode(const std::string& mode)
+{
+	setValue<std::string>("storage/bulk/journal_mode", mode);
+}
+
+std::string ApplicationSettings::getStorageBulkSynchronous() const
+{
+	return getValue<std::string>("storage/bulk/synchronous", "NORMAL");
+}
+
+void ApplicationSettings::setStorageBulkSynchronous(const std::string& synchronous)
+{
+	setValue<std::string>("storage/bulk/synchronous", synchronous);
+}
+
+int ApplicationSettings::getStorageBulkCacheSizeMb() const
+{
+	return getValue<int>("storage/bulk/cache_size_mb", 256);
+}
+
+void ApplicationSettings::setStorageBulkCacheSizeMb(int size)
+{
+	setValue<int>("storage/bulk/cache_size_mb", size);
+}
+
+int ApplicationSettings::getStorageBulkMmapSizeMb() const
+{
+	return getValue<int>("storage/bulk/mmap_size_mb", 256);
+}
+
+void ApplicationSettings::setStorageBulkMmapSizeMb(int size)
+{
+	setValue<int>("storage/bulk/mmap_size_mb", size);
+}
+
+std::string ApplicationSettings::getStorageBrowsingJournalMode() const
+{
+	return getValue<std::string>("storage/browsing/journal_mode", "DELETE");
+}
+
+void ApplicationSettings::setStorageBrowsingJournalMode(const std::string& mode)
+{
+	setValue<std::string>("storage/browsing/journal_mode", mode);
+}
+
+std::string ApplicationSettings::getStorageBrowsingSynchronous() const
+{
+	return getValue<std::string>("storage/browsing/synchronous", "NORMAL");
+}
+
+void ApplicationSettings::setStorageBrowsingSynchronous(const std::string& synchronous)
+{
+	setValue<std::string>("storage/browsing/synchronous", synchronous);
+}
+
+int ApplicationSettings::getStorageBrowsingCacheSizeMb() const
+{
+	return getValue<int>("storage/browsing/cache_size_mb", 64);
+}
+
+void ApplicationSettings::setStorageBrowsingCacheSizeMb(int size)
+{
+	setValue<int>("storage/browsing/cache_size_mb", size);
+}
+
+int ApplicationSettings::getStorageBrowsingMmapSizeMb() const
+{
+	return getValue<int>("storage/browsing/mmap_size_mb", 256);
+}
+
+void ApplicationSettings::setStorageBrowsingMmapSizeMb(int size)
+{
+	setValue<int>("storage/browsing/mmap_size_mb", size);
+}
+
+bool ApplicationSettings::getStorageCompressFileContent() const
+{
+	return getValue<bool>("storage/compress_file_content", true);
+}
+
+void ApplicationSettings::setStorageCompressFileContent(bool compress)
+{
+	setValue<bool>("storage/compress_file_content", compress);
+}
+
 int ApplicationSettings::getCodeTabWidth() const
 {
 	return getValue<int>("code/tab_width", 4);
@@ -545,6 +676,17 @@ void ApplicationSettings::setCodeViewModeSingle(bool enabled)
 	setValue<bool>("code/view_mode_single", enabled);
 }
 
+int ApplicationSettings::getCodeFullTextSearchMaxResultCount() const
+{
+	// 0 means no limit
+	return getValue<int>("code/fulltext_search/max_result_count", 0);
+}
+
+void ApplicationSettings::setCodeFullTextSearchMaxResultCount(int count)
+{
+	setValue<int>("code/fulltext_search/max_result_count", count);
+}
+
 std::vector<FilePath> ApplicationSettings::getRecentProjects() const
 {
 	std::vector<FilePath> recentProjects;
@@ -68,6 +68,13 @@ public:
 	GroupType getGraphGrouping() const;
 	void setGraphGrouping(GroupType type);
 
+	int getGraphTrailMaxNodeCount() const;
+	void setGraphTrailMaxNodeCount(int count);
+
+	// a trail between two symbols only shows the shortest paths instead of all paths within depth
+	bool getGraphTrailShortestPathsOnly() const;
+	void setGraphTrailShortestPathsOnly(bool shortestPathsOnly);
+
 	// screen
 	int getScreenAutoScaling() const;
 	void setScreenAutoScaling(int autoScaling);
@@ -95,6 +102,15 @@ public:
 	bool getMultiProcessIndexingEnabled() const;
 	void setMultiProcessIndexingEnabled(bool enabled);
 
+	// files indexed completely by one translation unit are skipped by the others with equal flags
+	bool getIndexedHeaderSkippingEnabled() const;
+	void setIndexedHeaderSkippingEnabled(bool enabled);
+
+	// translation units of a compilation database starting with the same includes share a
+	// precompiled header of these includes
+	bool getAutomaticPchEnabled() const;
+	void setAutomaticPchEnabled(bool enabled);
+
 	FilePath getJavaPath() const;
 	void setJavaPath(const FilePath& path);
 
@@ -134,6 +150,36 @@ public:
 	bool getHasPrefilledFrameworkSearchPaths() const;
 	void setHasPrefilledFrameworkSearchPaths(bool v);
 
+	// storage, the bulk profile is used while indexing and the browsing profile afterwards. The bulk
+	// journal modes MEMORY and OFF and the synchronous mode OFF are faster, but the temporary
+	// indexing database is discarded after a crash instead of offered for keeping
+	std::string getStorageBulkJournalMode() const;
+	void setStorageBulkJournalMode(const std::string& mode);
+
+	std::string getStorageBulkSynchronous() const;
+	void setStorageBulkSynchronous(const std::string& synchronous);
+
+	int getStorageBulkCacheSizeMb() const;
+	void setStorageBulkCacheSizeMb(int size);
+
+	int getStorageBulkMmapSizeMb() const;
+	void setStorageBulkMmapSizeMb(int size);
+
+	std::string getStorageBrowsingJournalMode() const;
+	void setStorageBrowsingJournalMode(const std::string& mode);
+
+	std::string getStorageBrowsingSynchronous() const;
+	void setStorageBrowsingSynchronous(const std::string& synchronous);
+
+	int getStorageBrowsingCacheSizeMb() const;
+	void setStorageBrowsingCacheSizeMb(int size);
+
+	int getStorageBrowsingMmapSizeMb() const;
+	void setStorageBrowsingMmapSizeMb(int size);
+
+	bool getStorageCompressFileContent() const;
+	void setStorageCompressFileContent(bool compress);
+
 	// code
 	int getCodeTabWidth() const;
 	void setCodeTabWidth(int codeTabWidth);
@@ -147,6 +193,9 @@ public:
 	bool getCodeViewModeSingle() const;
 	void setCodeViewModeSingle(bool enabled);
 
+	int getCodeFullTextSearchMaxResultCount() const;
+	void setCodeFullTextSearchMaxResultCount(int count);
+
 	// user
 	std::vector<FilePath> getRecentProjects() const;
 	bool setRecentProjects(const std::vector<FilePath>& recentProjects);
@@ -0,0 +1,188 @@
+#include "ContentHasher.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "FilePath.h"
+
+namespace
+{
+const uint64_t PRIME_1 = 11400714785074694791ull;
+const uint64_t PRIME_2 = 14029467366897019727ull;
+const uint64_t PRIME_3 = 1609587929392839161ull;
+const uint64_t PRIME_4 = 9650029242287828579ull;
+const uint64_t PRIME_5 = 2870177450012600261ull;
+
+uint64_t rotateLeft(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t read64(const char* data)
+{
+	uint64_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint32_t read32(const char* data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint64_t processLane(uint64_t lane, uint64_t input)
+{
+	lane += input * PRIME_2;
+	lane = rotateLeft(lane, 31);
+	return lane * PRIME_1;
+}
+
+uint64_t mergeRound(uint64_t hash, uint64_t lane)
+{
+	hash ^= processLane(0, lane);
+	return hash * PRIME_1 + PRIME_4;
+}
+}	 // namespace
+
+bool ContentHasher::hashFile(const FilePath& filePath, std::string& hash, uint64_t& byteSize)
+{
+	std::ifstream file(filePath.str(), std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	ContentHasher hasher;
+	std::vector<char> buffer(64 * 1024);
+	while (file)
+	{
+		file.read(buffer.data(), buffer.size());
+		hasher.update(buffer.data(), size_t(file.gcount()));
+	}
+
+	if (file.bad())
+	{
+		return false;
+	}
+
+	hash = hasher.getHexDigest();
+	byteSize = hasher.m_byteSize;
+	return true;
+}
+
+std::string ContentHasher::hashString(const std::string& data)
+{
+	ContentHasher hasher;
+	hasher.update(data.data(), data.size());
+	return hasher.getHexDigest();
+}
+
+ContentHasher::ContentHasher(uint64_t seed): m_seed(seed), m_byteSize(0), m_bufferSize(0)
+{
+	m_lanes[0] = seed + PRIME_1 + PRIME_2;
+	m_lanes[1] = seed + PRIME_2;
+	m_lanes[2] = seed;
+	m_lanes[3] = seed - PRIME_1;
+}
+
+void ContentHasher::update(const char* data, size_t size)
+{
+	m_byteSize += size;
+
+	if (m_bufferSize + size < STRIPE_SIZE)
+	{
+		std::memcpy(m_buffer + m_bufferSize, data, size);
+		m_bufferSize += size;
+		return;
+	}
+
+	const char* end = data + size;
+
+	if (m_bufferSize)
+	{
+		const size_t fill = STRIPE_SIZE - m_bufferSize;
+		std::memcpy(m_buffer + m_bufferSize, data, fill);
+		data += fill;
+		m_bufferSize = 0;
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			m_lanes[i] = processLane(m_lanes[i], read64(m_buffer + i * 8));
+		}
+	}
+
+	while (data + STRIPE_SIZE <= end)
+	{
+		for (size_t i = 0; i < 4; i++)
+		{
+			m_lanes[i] = processLane(m_lanes[i], read64(data + i * 8));
+		}
+		data += STRIPE_SIZE;
+	}
+
+	m_bufferSize = end - data;
+	std::memcpy(m_buffer, data, m_bufferSize);
+}
+
+uint64_t ContentHasher::getDigest() const
+{
+	uint64_t hash;
+	if (m_byteSize >= STRIPE_SIZE)
+	{
+		hash = rotateLeft(m_lanes[0], 1) + rotateLeft(m_lanes[1], 7) + rotateLeft(m_lanes[2], 12) +
+			rotateLeft(m_lanes[3], 18);
+		for (size_t i = 0; i < 4; i++)
+		{
+			hash = mergeRound(hash, m_lanes[i]);
+		}
+	}
+	else
+	{
+		hash = m_seed + PRIME_5;
+	}
+
+	hash += m_byteSize;
+
+	// consume the remaining bytes that don't fill a whole stripe
+	const char* data = m_buffer;
+	const char* end = m_buffer + m_bufferSize;
+	for (; data + 8 <= end; data += 8)
+	{
+		hash ^= processLane(0, read64(data));
+		hash = rotateLeft(hash, 27) * PRIME_1 + PRIME_4;
+	}
+	if (data + 4 <= end)
+	{
+		hash ^= uint64_t(read32(data)) * PRIME_1;
+		hash = rotateLeft(hash, 23) * PRIME_2 + PRIME_3;
+		data += 4;
+	}
+	for (; data < end; data++)
+	{
+		hash ^= uint64_t(static_cast<unsigned char>(*data)) * PRIME_5;
+		hash = rotateLeft(hash, 11) * PRIME_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= PRIME_2;
+	hash ^= hash >> 29;
+	hash *= PRIME_3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+std::string ContentHasher::getHexDigest() const
+{
+	static const char* digits = "0123456789abcdef";
+
+	const uint64_t digest = getDigest();
+	std::string hex(16, '0');
+	for (size_t i = 0; i < 16; i++)
+	{
+		hex[i] = digits[(digest >> (60 - i * 4)) & 0xF];
+	}
+	return hex;
+}
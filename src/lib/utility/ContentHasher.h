@@ -0,0 +1,37 @@
+#ifndef CONTENT_HASHER_H
+#define CONTENT_HASHER_H
+
+#include <cstdint>
+#include <string>
+
+class FilePath;
+
+// Streaming implementation of the 64 bit xxHash algorithm (XXH64). It hashes at memory speed and
+// is used to find out whether the content of a file changed since it was indexed.
+class ContentHasher
+{
+public:
+	// hashes the raw bytes of the file without loading it as a whole, returns false if the file
+	// cannot be read.
+	static bool hashFile(const FilePath& filePath, std::string& hash, uint64_t& byteSize);
+	static std::string hashString(const std::string& data);
+
+	ContentHasher(uint64_t seed = 0);
+
+	void update(const char* data, size_t size);
+
+	uint64_t getDigest() const;
+	std::string getHexDigest() const;
+
+private:
+	static const size_t STRIPE_SIZE = 32;
+
+	uint64_t m_seed;
+	uint64_t m_lanes[4];
+	uint64_t m_byteSize;
+
+	char m_buffer[STRIPE_SIZE];
+	size_t m_bufferSize;
+};
+
+#endif	  // CONTENT_HASHER_H
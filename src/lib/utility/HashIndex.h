@@ -0,0 +1,123 @@
+#ifndef HASH_INDEX_H
+#define HASH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Open addressing hash table that maps precomputed hashes to the positions of elements stored in
+// a separate container. The elements are only compared when their hashes match, so looking up
+// elements with long names mostly compares integers.
+class HashIndex
+{
+public:
+	static const size_t NOT_FOUND = size_t(-1);
+
+	static size_t combine(size_t seed, size_t hash)
+	{
+		return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+	}
+
+	// returns the position of the first element with the hash that isEqual accepts
+	template <typename EqualFunc>
+	size_t find(size_t hash, EqualFunc isEqual) const
+	{
+		if (m_slots.empty())
+		{
+			return NOT_FOUND;
+		}
+
+		for (size_t i = getSlot(hash); m_slots[i].position != NOT_FOUND; i = (i + 1) & m_mask)
+		{
+			if (m_slots[i].hash == hash && isEqual(m_slots[i].position))
+			{
+				return m_slots[i].position;
+			}
+		}
+		return NOT_FOUND;
+	}
+
+	void insert(size_t hash, size_t position)
+	{
+		reserve(m_size + 1);
+		insertSlot(hash, position);
+		m_size++;
+	}
+
+	void reserve(size_t count)
+	{
+		// keep the load factor at 0.5 at most, probing sequences stay short that way
+		if (count * 2 <= m_slots.size())
+		{
+			return;
+		}
+
+		size_t slotCount = 16;
+		while (slotCount < count * 2)
+		{
+			slotCount *= 2;
+		}
+
+		std::vector<Slot> slots(slotCount);
+		m_slots.swap(slots);
+		m_mask = slotCount - 1;
+		m_shift = 64;
+		while (slotCount > 1)
+		{
+			slotCount /= 2;
+			m_shift--;
+		}
+
+		for (const Slot& slot: slots)
+		{
+			if (slot.position != NOT_FOUND)
+			{
+				insertSlot(slot.hash, slot.position);
+			}
+		}
+	}
+
+	size_t size() const
+	{
+		return m_size;
+	}
+
+	void clear()
+	{
+		m_slots.clear();
+		m_mask = 0;
+		m_shift = 64;
+		m_size = 0;
+	}
+
+private:
+	struct Slot
+	{
+		size_t hash = 0;
+		size_t position = NOT_FOUND;
+	};
+
+	size_t getSlot(size_t hash) const
+	{
+		// fibonacci hashing spreads hashes of consecutive ids over the whole table
+		return size_t((uint64_t(hash) * 11400714819323198485ull) >> m_shift);
+	}
+
+	void insertSlot(size_t hash, size_t position)
+	{
+		size_t i = getSlot(hash);
+		while (m_slots[i].position != NOT_FOUND)
+		{
+			i = (i + 1) & m_mask;
+		}
+		m_slots[i].hash = hash;
+		m_slots[i].position = position;
+	}
+
+	std::vector<Slot> m_slots;
+	size_t m_mask = 0;
+	int m_shift = 64;
+	size_t m_size = 0;
+};
+
+#endif	  // HASH_INDEX_H
@@ -87,6 +87,14 @@ void CommandlineCommandConfig::setup()
 		"use-processes,p",
 		po::value<bool>(),
 		"Enable C/C++ Indexer threads to run in different processes. <true/false>")(
+		"skip-indexed-headers",
+		po::value<bool>(),
+		"Skip the content of C/C++ headers already indexed by another translation unit with the "
+		"same flags. <true/false>")(
+		"automatic-pch",
+		po::value<bool>(),
+		"Build precompiled headers for the includes shared by C/C++ translation units of a "
+		"compilation database. <true/false>")(
 		"logging-enabled,l", po::value<bool>(), "Enable file/console logging <true/false>")(
 		"verbose-indexer-logging-enabled,L",
 		po::value<bool>(),
@@ -148,6 +156,8 @@ CommandlineCommand::ReturnStatus CommandlineCommandConfig::parse(std::vector<std
 		std::cout << "Sourcetrail Settings:\n"
 				  << "\n  indexer-threads: " << settings->getIndexerThreadCount()
 				  << "\n  use-processes: " << settings->getMultiProcessIndexingEnabled()
+				  << "\n  skip-indexed-headers: " << settings->getIndexedHeaderSkippingEnabled()
+				  << "\n  automatic-pch: " << settings->getAutomaticPchEnabled()
 				  << "\n  logging-enabled: " << settings->getLoggingEnabled()
 				  << "\n  verbose-indexer-logging-enabled: "
 				  << settings->getVerboseIndexerLoggingEnabled()
@@ -161,6 +171,12 @@ CommandlineCommand::ReturnStatus CommandlineCommandConfig::parse(std::vector<std
 
 	parseAndSetValue(
 		&ApplicationSettings::setMultiProcessIndexingEnabled, "use-processes", settings, vm);
+	parseAndSetValue(
+		&ApplicationSettings::setIndexedHeaderSkippingEnabled,
+		"skip-indexed-headers",
+		settings,
+		vm);
+	parseAndSetValue(&ApplicationSettings::setAutomaticPchEnabled, "automatic-pch", settings, vm);
 	parseAndSetValue(&ApplicationSettings::setLoggingEnabled, "logging-enabled", settings, vm);
 	parseAndSetValue(
 		&ApplicationSettings::setVerboseIndexerLoggingEnabled,
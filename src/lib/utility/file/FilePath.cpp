@@ -478,5 +478,5 @@ bool FilePath::operator!=(const FilePath& other) const
 
 bool FilePath::operator<(const FilePath& other) const
 {
-	return m_path->compare(other.getPath()) < 0;
+	return m_path->compare(*other.m_path) < 0;
 }
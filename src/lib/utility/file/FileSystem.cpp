@@ -6,7 +6,7 @@
 #include <boost/date_time/c_local_time_adjustor.hpp>
 #include <boost/filesystem.hpp>
 
-#include "utilityString.h"
+#include "FileSystemSnapshot.h"
 
 std::vector<FilePath> FileSystem::getFilePathsFromDirectory(
 	const FilePath& path, const std::vector<std::wstring>& extensions)
@@ -56,86 +56,7 @@ std::vector<FileInfo> FileSystem::getFileInfosFromPaths(
 	const std::vector<std::wstring>& fileExtensions,
 	bool followSymLinks)
 {
-	std::set<std::wstring> ext;
-	for (const std::wstring& e: fileExtensions)
-	{
-		ext.insert(utility::toLowerCase(e));
-	}
-
-	std::set<boost::filesystem::path> symlinkDirs;
-	std::set<boost::filesystem::path> filePaths;
-
-	std::vector<FileInfo> files;
-
-	for (const FilePath& path: paths)
-	{
-		if (path.isDirectory())
-		{
-			boost::filesystem::recursive_directory_iterator it(
-				path.getPath(), boost::filesystem::symlink_option::recurse);
-			boost::filesystem::recursive_directory_iterator endit;
-			boost::system::error_code ec;
-			for (; it != endit; it.increment(ec))
-			{
-				if (boost::filesystem::is_symlink(*it))
-				{
-					if (!followSymLinks)
-					{
-						it.no_push();
-						continue;
-					}
-
-					// check for self-referencing symlinks
-					boost::filesystem::path p = boost::filesystem::read_symlink(*it);
-					if (p.filename() == p.string() && p.filename() == it->path().filename())
-					{
-						continue;
-					}
-
-					// check for duplicates when following directory symlinks
-					if (boost::filesystem::is_directory(*it))
-					{
-						boost::filesystem::path absDir = boost::filesystem::canonical(
-							p, it->path().parent_path());
-
-						if (symlinkDirs.find(absDir) != symlinkDirs.end())
-						{
-							it.no_push();
-							continue;
-						}
-
-						symlinkDirs.insert(absDir);
-					}
-				}
-
-				if (boost::filesystem::is_regular_file(*it) &&
-					(ext.empty() ||
-					 ext.find(utility::toLowerCase(it->path().extension().wstring())) != ext.end()))
-				{
-					boost::filesystem::path p = boost::filesystem::canonical(it->path());
-					if (filePaths.find(p) != filePaths.end())
-					{
-						continue;
-					}
-					filePaths.insert(p);
-					files.push_back(getFileInfoForPath(FilePath(it->path().wstring())));
-				}
-			}
-		}
-		else if (path.exists() && (ext.empty() || ext.find(utility::toLowerCase(path.extension())) != ext.end()))
-		{
-			const FilePath canonicalPath = path.getCanonical();
-			boost::filesystem::path p = canonicalPath.getPath();
-			if (filePaths.find(p) != filePaths.end())
-			{
-				continue;
-			}
-			filePaths.insert(p);
-			files.push_back(getFileInfoForPath(canonicalPath));
-		}
-	}
-
-	return files;
+	return FileSystemSnapshot::createFromPaths(paths, fileExtensions, followSymLinks).getFileInfos();
 }
 
 std::set<FilePath> FileSystem::getSymLinkedDirectories(const FilePath& path)
@@ -0,0 +1,327 @@
+#include "FileSystemSnapshot.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <boost/date_time.hpp>
+#include <boost/date_time/c_local_time_adjustor.hpp>
+#include <boost/filesystem.hpp>
+
+#if !defined(_WIN32)
+#	include <sys/stat.h>
+#endif
+
+#include "WorkStealingExecutor.h"
+#include "utilityString.h"
+
+namespace
+{
+const size_t MAX_THREAD_COUNT = 16;
+const size_t FILE_BATCH_SIZE = 64;
+
+struct FileStatus
+{
+	boost::filesystem::path path;
+	boost::filesystem::path canonicalPath;
+	std::time_t lastWriteTime = 0;
+	unsigned long long byteSize = 0;
+};
+
+size_t getThreadCount(size_t workCount)
+{
+	// stat calls mostly wait for the file system, so it pays off to use more threads than cores
+	const size_t threadCount = std::min<size_t>(
+		std::max<size_t>(std::thread::hardware_concurrency(), 1) * 2, MAX_THREAD_COUNT);
+	return std::max<size_t>(std::min(threadCount, workCount), 1);
+}
+
+// returns false if the file does not exist, uses a single stat call where available
+bool statFile(FileStatus& file)
+{
+#if defined(_WIN32)
+	boost::system::error_code ec;
+	const boost::filesystem::file_status status = boost::filesystem::status(file.path, ec);
+	if (ec || !boost::filesystem::exists(status))
+	{
+		return false;
+	}
+
+	file.lastWriteTime = boost::filesystem::last_write_time(file.path, ec);
+	file.byteSize = boost::filesystem::is_regular_file(status)
+		? boost::filesystem::file_size(file.path, ec)
+		: 0;
+	return !ec;
+#else
+	struct stat status;
+	if (::stat(file.path.c_str(), &status) != 0)
+	{
+		return false;
+	}
+
+	file.lastWriteTime = status.st_mtime;
+	file.byteSize = S_ISREG(status.st_mode) ? static_cast<unsigned long long>(status.st_size) : 0;
+	return true;
+#endif
+}
+
+TimeStamp toLocalTimeStamp(std::time_t time)
+{
+	return TimeStamp(boost::date_time::c_local_adjustor<boost::posix_time::ptime>::utc_to_local(
+		boost::posix_time::from_time_t(time)));
+}
+}	 // namespace
+
+FileSystemSnapshot FileSystemSnapshot::createFromPaths(
+	const std::vector<FilePath>& paths,
+	const std::vector<std::wstring>& fileExtensions,
+	bool followSymLinks)
+{
+	std::set<std::wstring> extensions;
+	for (const std::wstring& extension: fileExtensions)
+	{
+		extensions.insert(utility::toLowerCase(extension));
+	}
+
+	auto hasExtension = [&extensions](const boost::filesystem::path& path) {
+		return extensions.empty() ||
+			extensions.find(utility::toLowerCase(path.extension().wstring())) != extensions.end();
+	};
+
+	std::vector<FileStatus> files;
+	std::deque<boost::filesystem::path> directories;
+	for (const FilePath& path: paths)
+	{
+		if (path.isDirectory())
+		{
+			directories.push_back(path.getPath());
+		}
+		else if (path.exists() && hasExtension(path.getPath()))
+		{
+			FileStatus file;
+			file.path = path.getCanonical().getPath();
+			file.canonicalPath = file.path;
+			if (statFile(file))
+			{
+				files.push_back(file);
+			}
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	size_t busyThreadCount = 0;
+	std::set<boost::filesystem::path> symLinkedDirectories;
+
+	// each thread takes the next directory from the shared queue and adds the subdirectories it
+	// finds, the walk is done when the queue is empty and no thread is listing a directory anymore
+	auto walkDirectories = [&]() {
+		std::vector<FileStatus> foundFiles;
+		std::vector<boost::filesystem::path> foundDirectories;
+
+		while (true)
+		{
+			boost::filesystem::path directory;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(
+					lock, [&]() { return !directories.empty() || busyThreadCount == 0; });
+
+				if (directories.empty())
+				{
+					break;
+				}
+
+				directory = std::move(directories.front());
+				directories.pop_front();
+				busyThreadCount++;
+			}
+
+			boost::system::error_code iteratorError;
+			for (boost::filesystem::directory_iterator it(directory, iteratorError), end;
+				 !iteratorError && it != end;
+				 it.increment(iteratorError))
+			{
+				const boost::filesystem::path& path = it->path();
+				boost::system::error_code ec;
+
+				if (boost::filesystem::is_symlink(it->symlink_status(ec)))
+				{
+					if (!followSymLinks)
+					{
+						continue;
+					}
+
+					// check for self-referencing symlinks
+					const boost::filesystem::path target = boost::filesystem::read_symlink(
+						path, ec);
+					if (target.filename() == target.string() &&
+						target.filename() == path.filename())
+					{
+						continue;
+					}
+
+					// check for duplicates when following directory symlinks
+					if (boost::filesystem::is_directory(it->status(ec)))
+					{
+						const boost::filesystem::path absoluteDirectory =
+							boost::filesystem::canonical(target, directory, ec);
+						if (ec)
+						{
+							continue;
+						}
+
+						std::lock_guard<std::mutex> lock(mutex);
+						if (symLinkedDirectories.insert(absoluteDirectory).second)
+						{
+							foundDirectories.push_back(path);
+						}
+						continue;
+					}
+				}
+				else if (boost::filesystem::is_directory(it->status(ec)))
+				{
+					foundDirectories.push_back(path);
+					continue;
+				}
+
+				if (boost::filesystem::is_regular_file(it->status(ec)) && hasExtension(path))
+				{
+					FileStatus file;
+					file.path = path;
+					file.canonicalPath = boost::filesystem::canonical(path, ec);
+					if (!ec && statFile(file))
+					{
+						foundFiles.push_back(std::move(file));
+					}
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				directories.insert(
+					directories.end(), foundDirectories.begin(), foundDirectories.end());
+				busyThreadCount--;
+			}
+			foundDirectories.clear();
+			condition.notify_all();
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		std::move(foundFiles.begin(), foundFiles.end(), std::back_inserter(files));
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t i = directories.empty() ? 0 : getThreadCount(MAX_THREAD_COUNT); i > 0; i--)
+	{
+		threads.emplace_back(walkDirectories);
+	}
+	for (std::thread& thread: threads)
+	{
+		thread.join();
+	}
+
+	// the threads find the files in any order, sorting them keeps the chosen path of files that
+	// are reachable through several symlinks stable
+	std::stable_sort(files.begin(), files.end(), [](const FileStatus& a, const FileStatus& b) {
+		return a.path.native() < b.path.native();
+	});
+
+	FileSystemSnapshot snapshot;
+	std::set<boost::filesystem::path> canonicalPaths;
+	for (const FileStatus& file: files)
+	{
+		if (canonicalPaths.insert(file.canonicalPath).second)
+		{
+			snapshot.addEntry(
+				FilePath(file.path.wstring()), toLocalTimeStamp(file.lastWriteTime), file.byteSize);
+		}
+	}
+	return snapshot;
+}
+
+FileSystemSnapshot FileSystemSnapshot::createForFilePaths(const std::vector<FilePath>& filePaths)
+{
+	std::vector<FileStatus> files(filePaths.size());
+	std::vector<char> existing(filePaths.size(), 0);
+
+	// the files are taken in batches to keep the threads from contending for the ranges
+	WorkStealingExecutor::getInstance()->parallelFor(
+		filePaths.size(), FILE_BATCH_SIZE, [&](size_t i) {
+			files[i].path = filePaths[i].getPath();
+			existing[i] = statFile(files[i]);
+		});
+
+	FileSystemSnapshot snapshot;
+	for (size_t i = 0; i < filePaths.size(); i++)
+	{
+		if (existing[i])
+		{
+			snapshot.addEntry(
+				filePaths[i], toLocalTimeStamp(files[i].lastWriteTime), files[i].byteSize);
+		}
+	}
+	return snapshot;
+}
+
+size_t FileSystemSnapshot::getFileCount() const
+{
+	return m_entries.size();
+}
+
+bool FileSystemSnapshot::exists(const FilePath& filePath) const
+{
+	return findEntry(filePath) != nullptr;
+}
+
+FileInfo FileSystemSnapshot::getFileInfo(const FilePath& filePath) const
+{
+	if (const Entry* entry = findEntry(filePath))
+	{
+		return FileInfo(entry->path, entry->lastWriteTime);
+	}
+	return FileInfo();
+}
+
+unsigned long long FileSystemSnapshot::getFileByteSize(const FilePath& filePath) const
+{
+	if (const Entry* entry = findEntry(filePath))
+	{
+		return entry->byteSize;
+	}
+	return 0;
+}
+
+std::vector<FileInfo> FileSystemSnapshot::getFileInfos() const
+{
+	std::vector<FileInfo> fileInfos;
+	fileInfos.reserve(m_entries.size());
+	for (const Entry& entry: m_entries)
+	{
+		fileInfos.emplace_back(entry.path, entry.lastWriteTime);
+	}
+	return fileInfos;
+}
+
+void FileSystemSnapshot::addEntry(
+	const FilePath& filePath, const TimeStamp& lastWriteTime, unsigned long long byteSize)
+{
+	if (m_entryIndices.emplace(filePath.str(), m_entries.size()).second)
+	{
+		m_entries.push_back({filePath, lastWriteTime, byteSize});
+	}
+}
+
+const FileSystemSnapshot::Entry* FileSystemSnapshot::findEntry(const FilePath& filePath) const
+{
+	auto it = m_entryIndices.find(filePath.str());
+	if (it != m_entryIndices.end())
+	{
+		return &m_entries[it->second];
+	}
+	return nullptr;
+}
@@ -0,0 +1,53 @@
+#ifndef FILE_SYSTEM_SNAPSHOT_H
+#define FILE_SYSTEM_SNAPSHOT_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FileInfo.h"
+#include "FilePath.h"
+#include "TimeStamp.h"
+
+// Holds the stat data of many files that was gathered by several threads at once. Refresh planning
+// and the source groups consume the snapshot instead of checking every path on their own, which
+// takes long on network mounted file systems where each stat call has a high latency.
+class FileSystemSnapshot
+{
+public:
+	// walks the directories in parallel, files in paths are added directly if they exist
+	static FileSystemSnapshot createFromPaths(
+		const std::vector<FilePath>& paths,
+		const std::vector<std::wstring>& fileExtensions,
+		bool followSymLinks = true);
+
+	// stats the files in parallel, files that don't exist are not part of the snapshot
+	static FileSystemSnapshot createForFilePaths(const std::vector<FilePath>& filePaths);
+
+	size_t getFileCount() const;
+	bool exists(const FilePath& filePath) const;
+
+	// returns an empty FileInfo for files that don't exist, like FileSystem::getFileInfoForPath
+	FileInfo getFileInfo(const FilePath& filePath) const;
+	unsigned long long getFileByteSize(const FilePath& filePath) const;
+
+	std::vector<FileInfo> getFileInfos() const;
+
+private:
+	struct Entry
+	{
+		FilePath path;
+		TimeStamp lastWriteTime;
+		unsigned long long byteSize;
+	};
+
+	void addEntry(
+		const FilePath& filePath, const TimeStamp& lastWriteTime, unsigned long long byteSize);
+	const Entry* findEntry(const FilePath& filePath) const;
+
+	// comparing FilePaths is slow, so the entries are found by the path string instead
+	std::vector<Entry> m_entries;
+	std::unordered_map<std::string, size_t> m_entryIndices;
+};
+
+#endif	  // FILE_SYSTEM_SNAPSHOT_H
@@ -0,0 +1,130 @@
+#include "SidecarFile.h"
+
+#include <cctype>
+#include <cstring>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "logging.h"
+#include "utilityString.h"
+
+SidecarFile::SidecarFile(const std::string& name, uint64_t magic, uint32_t version)
+	: m_name(name), m_magic(magic), m_version(version)
+{
+}
+
+bool SidecarFile::initHeader(SidecarFileHeader* header, const std::string& storageTime) const
+{
+	if (storageTime.size() >= SidecarFileHeader::MAX_STORAGE_TIME_LENGTH)
+	{
+		LOG_ERROR("Storage time too long for " + m_name + " file.");
+		return false;
+	}
+
+	std::memset(header, 0, sizeof(SidecarFileHeader));
+	header->magic = m_magic;
+	header->version = m_version;
+	std::strncpy(header->storageTime, storageTime.c_str(), sizeof(header->storageTime) - 1);
+	return true;
+}
+
+bool SidecarFile::checkHeader(SidecarFileHeader* header, const std::string& storageTime) const
+{
+	header->storageTime[sizeof(header->storageTime) - 1] = '\0';
+
+	if (header->magic != m_magic || header->version != m_version ||
+		storageTime != header->storageTime)
+	{
+		std::string name = m_name;
+		name[0] = char(std::toupper(name[0]));
+		LOG_INFO(name + " file is outdated.");
+		return false;
+	}
+	return true;
+}
+
+bool SidecarFile::map(
+	const FilePath& filePath,
+	size_t minSize,
+	std::unique_ptr<boost::interprocess::file_mapping>* mapping,
+	std::unique_ptr<boost::interprocess::mapped_region>* region) const
+{
+	if (!filePath.recheckExists())
+	{
+		return false;
+	}
+
+	try
+	{
+		*mapping = std::make_unique<boost::interprocess::file_mapping>(
+			filePath.str().c_str(), boost::interprocess::read_only);
+		*region = std::make_unique<boost::interprocess::mapped_region>(
+			**mapping, boost::interprocess::read_only);
+	}
+	catch (boost::interprocess::interprocess_exception& e)
+	{
+		LOG_WARNING("Unable to map " + m_name + " file: " + e.what());
+		mapping->reset();
+		region->reset();
+		return false;
+	}
+
+	if ((*region)->get_size() < minSize)
+	{
+		mapping->reset();
+		region->reset();
+		return false;
+	}
+	return true;
+}
+
+bool SidecarFile::write(
+	const FilePath& filePath, const std::function<bool(std::ostream&)>& writeData) const
+{
+	const FilePath tempFilePath = getTempFilePath(filePath);
+	bool success = false;
+	{
+		boost::filesystem::ofstream stream(
+			tempFilePath.getPath(), std::ios::out | std::ios::binary | std::ios::trunc);
+		success = stream.is_open() && writeData(stream) && stream.good();
+	}
+
+	return replaceWithTempFile(filePath, success);
+}
+
+FilePath SidecarFile::getTempFilePath(const FilePath& filePath)
+{
+	return FilePath(filePath.wstr() + L"_tmp");
+}
+
+bool SidecarFile::replaceWithTempFile(const FilePath& filePath, bool tempFileWritten) const
+{
+	const FilePath tempFilePath = getTempFilePath(filePath);
+	bool success = tempFileWritten;
+
+	if (success)
+	{
+		try
+		{
+			FileSystem::remove(filePath);
+			success = FileSystem::rename(tempFilePath, filePath);
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR(e.what());
+			success = false;
+		}
+	}
+
+	if (!success)
+	{
+		LOG_ERROR(
+			L"Failed to write " + utility::decodeFromUtf8(m_name) + L" file: " + filePath.wstr());
+		FileSystem::remove(tempFilePath);
+	}
+	return success;
+}
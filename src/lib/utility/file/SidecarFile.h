@@ -0,0 +1,71 @@
+#ifndef SIDECAR_FILE_H
+#define SIDECAR_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace boost
+{
+namespace interprocess
+{
+class file_mapping;
+class mapped_region;
+}	 // namespace interprocess
+}	 // namespace boost
+
+class FilePath;
+
+// Common start of the cache files that are stored next to the index database. The magic number and
+// the version identify the file type and layout, the storage time ties the file to the state of the
+// database it was written for.
+struct SidecarFileHeader
+{
+	static const size_t MAX_STORAGE_TIME_LENGTH = 64;
+
+	uint64_t magic;
+	uint32_t version;
+	uint32_t reserved;
+	char storageTime[MAX_STORAGE_TIME_LENGTH];
+};
+
+// Validates, maps and writes the files of one sidecar file type.
+class SidecarFile
+{
+public:
+	// the name is used in log messages, e.g. "edge cache"
+	SidecarFile(const std::string& name, uint64_t magic, uint32_t version);
+
+	// clears the header and sets the file type and the storage time, fails if the storage time does
+	// not fit into the header
+	bool initHeader(SidecarFileHeader* header, const std::string& storageTime) const;
+
+	// fails if the header was read from a file of another type, version or storage state
+	bool checkHeader(SidecarFileHeader* header, const std::string& storageTime) const;
+
+	// memory-maps an existing file read only, fails if the file is smaller than minSize
+	bool map(
+		const FilePath& filePath,
+		size_t minSize,
+		std::unique_ptr<boost::interprocess::file_mapping>* mapping,
+		std::unique_ptr<boost::interprocess::mapped_region>* region) const;
+
+	// the data is written to a temporary file first, which replaces the file once it is complete.
+	// So an existing file is never replaced by a partial one and a file that is still mapped
+	// elsewhere is never overwritten.
+	bool write(const FilePath& filePath, const std::function<bool(std::ostream&)>& writeData) const;
+
+	static FilePath getTempFilePath(const FilePath& filePath);
+	// moves the written temporary file to filePath or removes it if writing failed
+	bool replaceWithTempFile(const FilePath& filePath, bool tempFileWritten) const;
+
+private:
+	const std::string m_name;
+	const uint64_t m_magic;
+	const uint32_t m_version;
+};
+
+#endif	  // SIDECAR_FILE_H
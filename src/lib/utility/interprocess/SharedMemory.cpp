@@ -1,14 +1,18 @@
 #include "SharedMemory.h"
 
+#include <boost/date_time/posix_time/posix_time.hpp>
+
 #include "SharedMemoryGarbageCollector.h"
 #include "logging.h"
 
 const char* SharedMemory::s_memoryNamePrefix = "srctrlmem_";
 const char* SharedMemory::s_mutexNamePrefix = "srctrlmtx_";
+const char* SharedMemory::s_conditionNamePrefix = "srctrlcnd_";
 
 SharedMemory::ScopedAccess::ScopedAccess(SharedMemory* memory)
 	: boost::interprocess::scoped_lock<boost::interprocess::named_mutex>(memory->getMutex())
 	, m_memory(boost::interprocess::open_only, memory->getMemoryName().c_str())
+	, m_condition(memory->getCondition())
 	, m_memoryName(memory->getMemoryName())
 	, m_minimumMemorySize(memory->getInitialMemorySize())
 {
@@ -61,6 +65,11 @@ void SharedMemory::ScopedAccess::shrinkToFitMemory()
 		boost::interprocess::open_only, m_memoryName.c_str());
 }
 
+void SharedMemory::ScopedAccess::notifyAll()
+{
+	m_condition.notify_all();
+}
+
 std::string SharedMemory::ScopedAccess::logString() const
 {
 	std::string log = m_memoryName + " -";
@@ -99,6 +108,7 @@ void SharedMemory::deleteSharedMemory(const std::string& name)
 {
 	boost::interprocess::shared_memory_object::remove((s_memoryNamePrefix + name).c_str());
 	boost::interprocess::named_mutex::remove((s_mutexNamePrefix + name).c_str());
+	boost::interprocess::named_condition::remove((s_conditionNamePrefix + name).c_str());
 }
 
 SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, AccessMode mode)
@@ -131,6 +141,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 				permissions);
 			boost::interprocess::named_mutex(
 				boost::interprocess::create_only, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::create_only, getConditionName().c_str(), permissions);
 		}
 		break;
 
@@ -138,6 +150,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 			boost::interprocess::managed_shared_memory(
 				boost::interprocess::open_only, getMemoryName().c_str());
 			boost::interprocess::named_mutex(boost::interprocess::open_only, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::open_only, getConditionName().c_str());
 			unlockMutex = false;
 			break;
 
@@ -154,6 +168,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 				permissions);
 			boost::interprocess::named_mutex(
 				boost::interprocess::open_or_create, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::open_or_create, getConditionName().c_str(), permissions);
 		}
 		break;
 		}
@@ -233,6 +249,15 @@ bool SharedMemory::checkSharedMutex()
 	return false;
 }
 
+void SharedMemory::waitForChange(size_t timeoutMS)
+{
+	boost::interprocess::scoped_lock<boost::interprocess::named_mutex> lock(getMutex());
+	getCondition().timed_wait(
+		lock,
+		boost::posix_time::microsec_clock::universal_time() +
+			boost::posix_time::milliseconds(timeoutMS));
+}
+
 std::string SharedMemory::getMemoryName() const
 {
 	return s_memoryNamePrefix + m_name;
@@ -243,6 +268,11 @@ std::string SharedMemory::getMutexName() const
 	return s_mutexNamePrefix + m_name;
 }
 
+std::string SharedMemory::getConditionName() const
+{
+	return s_conditionNamePrefix + m_name;
+}
+
 boost::interprocess::named_mutex& SharedMemory::getMutex()
 {
 	if (!m_mutex)
@@ -254,6 +284,17 @@ boost::interprocess::named_mutex& SharedMemory::getMutex()
 	return *m_mutex.get();
 }
 
+boost::interprocess::named_condition& SharedMemory::getCondition()
+{
+	if (!m_condition)
+	{
+		m_condition = std::make_shared<boost::interprocess::named_condition>(
+			boost::interprocess::open_only, getConditionName().c_str());
+	}
+
+	return *m_condition.get();
+}
+
 size_t SharedMemory::getInitialMemorySize() const
 {
 	return m_initialMemorySize;
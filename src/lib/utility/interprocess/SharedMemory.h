@@ -9,6 +9,7 @@
 #include <boost/interprocess/containers/string.hpp>
 #include <boost/interprocess/containers/vector.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/sync/named_condition.hpp>
 #include <boost/interprocess/sync/named_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
@@ -64,6 +65,9 @@ public:
 		void growMemory(size_t size);
 		void shrinkToFitMemory();
 
+		// wakes up all processes waiting in waitForChange, call after modifying the memory
+		void notifyAll();
+
 		template <typename T>
 		T* accessValue(const std::string& key)
 		{
@@ -98,24 +102,34 @@ public:
 
 	private:
 		boost::interprocess::managed_shared_memory m_memory;
+		boost::interprocess::named_condition& m_condition;
 		std::string m_memoryName;
 		size_t m_minimumMemorySize;
 	};
 
 	bool checkSharedMutex();
 
+	// Blocks until another access calls notifyAll or the timeout passes. The memory is not mapped
+	// while waiting, so a change between a previous access and this call is only noticed after the
+	// timeout.
+	void waitForChange(size_t timeoutMS);
+
 private:
 	static const char* s_memoryNamePrefix;
 	static const char* s_mutexNamePrefix;
+	static const char* s_conditionNamePrefix;
 
 	std::string getMemoryName() const;
 	std::string getMutexName() const;
+	std::string getConditionName() const;
 
 	boost::interprocess::named_mutex& getMutex();
+	boost::interprocess::named_condition& getCondition();
 
 	size_t getInitialMemorySize() const;
 
 	std::shared_ptr<boost::interprocess::named_mutex> m_mutex;
+	std::shared_ptr<boost::interprocess::named_condition> m_condition;
 	std::string m_name;
 	AccessMode m_mode;
 
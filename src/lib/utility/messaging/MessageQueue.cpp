@@ -1,6 +1,5 @@
 #include "MessageQueue.h"
 
-#include <chrono>
 #include <thread>
 
 #include "MessageBase.h"
@@ -85,8 +84,12 @@ void MessageQueue::addMessageFilter(std::shared_ptr<MessageFilter> filter)
 
 void MessageQueue::pushMessage(std::shared_ptr<MessageBase> message)
 {
-	std::lock_guard<std::mutex> lock(m_messageBufferMutex);
-	m_messageBuffer.push_back(message);
+	{
+		std::lock_guard<std::mutex> lock(m_messageBufferMutex);
+		m_messageBuffer.push_back(message);
+	}
+
+	m_messageBufferCondition.notify_all();
 }
 
 void MessageQueue::processMessage(std::shared_ptr<MessageBase> message, bool asNextTask)
@@ -108,10 +111,12 @@ void MessageQueue::processMessage(std::shared_ptr<MessageBase> message, bool asN
 
 void MessageQueue::startMessageLoopThreaded()
 {
-	std::thread(&MessageQueue::startMessageLoop, this).detach();
+	{
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		m_threadIsRunning = true;
+	}
 
-	std::lock_guard<std::mutex> lock(m_threadMutex);
-	m_threadIsRunning = true;
+	std::thread(&MessageQueue::startMessageLoop, this).detach();
 }
 
 void MessageQueue::startMessageLoop()
@@ -132,16 +137,14 @@ void MessageQueue::startMessageLoop()
 	{
 		processMessages();
 
-		{
-			std::lock_guard<std::mutex> lock(m_loopMutex);
+		std::unique_lock<std::mutex> lock(m_messageBufferMutex);
+		m_messageBufferCondition.wait(
+			lock, [this]() { return m_messageBuffer.size() || !loopIsRunning(); });
 
-			if (!m_loopIsRunning)
-			{
-				break;
-			}
+		if (!loopIsRunning())
+		{
+			break;
 		}
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
 	}
 
 	{
@@ -151,6 +154,7 @@ void MessageQueue::startMessageLoop()
 			m_threadIsRunning = false;
 		}
 	}
+	m_threadCondition.notify_all();
 }
 
 void MessageQueue::stopMessageLoop()
@@ -166,18 +170,14 @@ void MessageQueue::stopMessageLoop()
 		m_loopIsRunning = false;
 	}
 
-	while (true)
 	{
-		{
-			std::lock_guard<std::mutex> lock(m_threadMutex);
-			if (!m_threadIsRunning)
-			{
-				break;
-			}
-		}
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
+		// taking the lock makes sure the loop is either waiting or has not checked the buffer yet
+		std::lock_guard<std::mutex> lock(m_messageBufferMutex);
 	}
+	m_messageBufferCondition.notify_all();
+
+	std::unique_lock<std::mutex> lock(m_threadMutex);
+	m_threadCondition.wait(lock, [this]() { return !m_threadIsRunning; });
 }
 
 bool MessageQueue::loopIsRunning() const
@@ -1,6 +1,7 @@
 #ifndef MESSAGE_QUEUE_H
 #define MESSAGE_QUEUE_H
 
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -66,6 +67,9 @@ private:
 	mutable std::mutex m_loopMutex;
 	mutable std::mutex m_threadMutex;
 
+	std::condition_variable m_messageBufferCondition;
+	std::condition_variable m_threadCondition;
+
 	bool m_sendMessagesAsTasks;
 };
 
@@ -0,0 +1,23 @@
+#ifndef MESSAGE_INTERRUPT_TRAIL_H
+#define MESSAGE_INTERRUPT_TRAIL_H
+
+#include "Message.h"
+#include "TabId.h"
+
+// stops a running trail search, is not sent as task so it does not wait for the search to finish
+class MessageInterruptTrail: public Message<MessageInterruptTrail>
+{
+public:
+	static const std::string getStaticType()
+	{
+		return "MessageInterruptTrail";
+	}
+
+	MessageInterruptTrail()
+	{
+		setSendAsTask(false);
+		setSchedulerId(TabId::currentTab());
+	}
+};
+
+#endif	  // MESSAGE_INTERRUPT_TRAIL_H
@@ -0,0 +1,23 @@
+#ifndef MESSAGE_INTERRUPT_FULLTEXT_SEARCH_H
+#define MESSAGE_INTERRUPT_FULLTEXT_SEARCH_H
+
+#include "Message.h"
+#include "TabId.h"
+
+// stops a running fulltext search, is not sent as task so it does not wait for the search to finish
+class MessageInterruptFullTextSearch: public Message<MessageInterruptFullTextSearch>
+{
+public:
+	static const std::string getStaticType()
+	{
+		return "MessageInterruptFullTextSearch";
+	}
+
+	MessageInterruptFullTextSearch()
+	{
+		setSendAsTask(false);
+		setSchedulerId(TabId::currentTab());
+	}
+};
+
+#endif	  // MESSAGE_INTERRUPT_FULLTEXT_SEARCH_H
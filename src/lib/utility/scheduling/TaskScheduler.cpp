@@ -1,6 +1,5 @@
 #include "TaskScheduler.h"
 
-#include <chrono>
 #include <thread>
 
 #include "ScopedFunctor.h"
@@ -21,30 +20,50 @@ TaskScheduler::~TaskScheduler()
 
 void TaskScheduler::pushTask(std::shared_ptr<Task> task)
 {
-	std::lock_guard<std::mutex> lock(m_tasksMutex);
-	m_taskRunners.push_back(std::make_shared<TaskRunner>(task));
+	{
+		std::lock_guard<std::mutex> lock(m_tasksMutex);
+		m_taskRunners.push_back(std::make_shared<TaskRunner>(task));
+	}
+
+	m_tasksCondition.notify_all();
 }
 
 void TaskScheduler::pushNextTask(std::shared_ptr<Task> task)
 {
-	std::lock_guard<std::mutex> lock(m_tasksMutex);
-
-	if (m_taskRunners.size() == 0)
 	{
-		m_taskRunners.push_front(std::make_shared<TaskRunner>(task));
+		std::lock_guard<std::mutex> lock(m_tasksMutex);
+
+		if (m_taskRunners.size() == 0)
+		{
+			m_taskRunners.push_front(std::make_shared<TaskRunner>(task));
+		}
+		else
+		{
+			m_taskRunners.insert(m_taskRunners.begin() + 1, std::make_shared<TaskRunner>(task));
+		}
 	}
-	else
+
+	m_tasksCondition.notify_all();
+}
+
+void TaskScheduler::notifyTaskReady()
+{
 	{
-		m_taskRunners.insert(m_taskRunners.begin() + 1, std::make_shared<TaskRunner>(task));
+		// taking the lock makes sure the loop is either waiting or has not checked for tasks yet
+		std::lock_guard<std::mutex> lock(m_tasksMutex);
 	}
+
+	m_tasksCondition.notify_all();
 }
 
 void TaskScheduler::startSchedulerLoopThreaded()
 {
-	std::thread(&TaskScheduler::startSchedulerLoop, this).detach();
+	{
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		m_threadIsRunning = true;
+	}
 
-	std::lock_guard<std::mutex> lock(m_threadMutex);
-	m_threadIsRunning = true;
+	std::thread(&TaskScheduler::startSchedulerLoop, this).detach();
 }
 
 void TaskScheduler::startSchedulerLoop()
@@ -65,16 +84,14 @@ void TaskScheduler::startSchedulerLoop()
 	{
 		processTasks();
 
-		{
-			std::lock_guard<std::mutex> lock(m_loopMutex);
+		std::unique_lock<std::mutex> lock(m_tasksMutex);
+		m_tasksCondition.wait(
+			lock, [this]() { return m_taskRunners.size() || !loopIsRunning(); });
 
-			if (!m_loopIsRunning)
-			{
-				break;
-			}
+		if (!loopIsRunning())
+		{
+			break;
 		}
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
 	}
 
 	{
@@ -84,6 +101,7 @@ void TaskScheduler::startSchedulerLoop()
 			m_threadIsRunning = false;
 		}
 	}
+	m_threadCondition.notify_all();
 }
 
 void TaskScheduler::stopSchedulerLoop()
@@ -99,18 +117,10 @@ void TaskScheduler::stopSchedulerLoop()
 		m_loopIsRunning = false;
 	}
 
-	while (true)
-	{
-		{
-			std::lock_guard<std::mutex> lock(m_threadMutex);
-			if (!m_threadIsRunning)
-			{
-				break;
-			}
-		}
+	notifyTaskReady();
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
-	}
+	std::unique_lock<std::mutex> lock(m_threadMutex);
+	m_threadCondition.wait(lock, [this]() { return !m_threadIsRunning; });
 }
 
 bool TaskScheduler::loopIsRunning() const
@@ -1,6 +1,7 @@
 #ifndef TASK_SCHEDULER_H
 #define TASK_SCHEDULER_H
 
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -18,6 +19,9 @@ public:
 	void pushTask(std::shared_ptr<Task> task);
 	void pushNextTask(std::shared_ptr<Task> task);
 
+	// wakes up the scheduler loop, which sleeps while there are no tasks queued
+	void notifyTaskReady();
+
 	void startSchedulerLoopThreaded();
 	void startSchedulerLoop();
 	void stopSchedulerLoop();
@@ -41,6 +45,9 @@ private:
 	mutable std::mutex m_tasksMutex;
 	mutable std::mutex m_loopMutex;
 	mutable std::mutex m_threadMutex;
+
+	std::condition_variable m_tasksCondition;
+	std::condition_variable m_threadCondition;
 };
 
 #endif	  // TASK_SCHEDULER_H
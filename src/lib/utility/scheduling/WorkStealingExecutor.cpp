@@ -0,0 +1,251 @@
+#include "WorkStealingExecutor.h"
+
+#include <algorithm>
+
+std::shared_ptr<WorkStealingExecutor> WorkStealingExecutor::getInstance()
+{
+	// the calling thread of a loop also does work, so one thread less than the cores is enough
+	static std::shared_ptr<WorkStealingExecutor> s_instance =
+		std::make_shared<WorkStealingExecutor>(
+			std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1);
+	return s_instance;
+}
+
+WorkStealingExecutor::WorkStealingExecutor(size_t threadCount)
+{
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		m_threads.emplace_back(&WorkStealingExecutor::runWorker, this);
+	}
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_stopping = true;
+	}
+	m_jobsCondition.notify_all();
+
+	for (std::thread& thread: m_threads)
+	{
+		thread.join();
+	}
+}
+
+size_t WorkStealingExecutor::getThreadCount() const
+{
+	return m_threads.size();
+}
+
+bool WorkStealingExecutor::parallelFor(
+	size_t count,
+	size_t grainSize,
+	std::function<void(size_t)> func,
+	std::function<bool()> isCancelled)
+{
+	if (!count)
+	{
+		return true;
+	}
+
+	grainSize = std::max<size_t>(grainSize, 1);
+
+	// small loops are not worth waking up the workers
+	if (count <= grainSize || m_threads.empty())
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (isCancelled && i % grainSize == 0 && isCancelled())
+			{
+				return false;
+			}
+			func(i);
+		}
+		return true;
+	}
+
+	std::shared_ptr<Job> job = std::make_shared<Job>(count, grainSize, m_threads.size() + 1);
+	job->func = func;
+	job->isCancelled = isCancelled;
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_jobs.push_back(job);
+	}
+	m_jobsCondition.notify_all();
+
+	// slot 0 is reserved for the calling thread
+	job->run(0);
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), job));
+	}
+
+	// no worker can join anymore, wait for the ones still running a chunk
+	std::unique_lock<std::mutex> lock(job->activeMutex);
+	job->activeCondition.wait(lock, [&job]() { return job->activeCount == 0; });
+
+	return !job->cancelled;
+}
+
+WorkStealingExecutor::Job::Job(size_t count, size_t grainSize, size_t slotCount)
+	: grainSize(grainSize)
+	, ranges(slotCount)
+	, unclaimedCount(count)
+	, nextSlot(1)
+	, cancelled(false)
+{
+	const size_t rangeSize = count / slotCount;
+	const size_t remainder = count % slotCount;
+
+	size_t begin = 0;
+	for (size_t i = 0; i < slotCount; i++)
+	{
+		ranges[i].begin = begin;
+		begin += rangeSize + (i < remainder ? 1 : 0);
+		ranges[i].end = begin;
+	}
+}
+
+bool WorkStealingExecutor::Job::isJoinable() const
+{
+	return unclaimedCount > 0 && !cancelled && nextSlot < ranges.size();
+}
+
+void WorkStealingExecutor::Job::run(size_t slot)
+{
+	while (!cancelled)
+	{
+		size_t begin = 0;
+		size_t end = 0;
+		if (!claimChunk(slot, begin, end) && !(steal(slot) && claimChunk(slot, begin, end)))
+		{
+			break;
+		}
+
+		if (isCancelled && isCancelled())
+		{
+			cancelled = true;
+			break;
+		}
+
+		for (size_t i = begin; i < end; i++)
+		{
+			func(i);
+		}
+	}
+}
+
+bool WorkStealingExecutor::Job::claimChunk(size_t slot, size_t& begin, size_t& end)
+{
+	Range& range = ranges[slot];
+	std::lock_guard<std::mutex> lock(range.mutex);
+
+	if (range.begin >= range.end)
+	{
+		return false;
+	}
+
+	begin = range.begin;
+	end = std::min(range.begin + grainSize, range.end);
+	range.begin = end;
+
+	unclaimedCount -= end - begin;
+	return true;
+}
+
+bool WorkStealingExecutor::Job::steal(size_t slot)
+{
+	while (unclaimedCount > 0 && !cancelled)
+	{
+		size_t victim = slot;
+		size_t victimSize = 0;
+		for (size_t i = 0; i < ranges.size(); i++)
+		{
+			std::lock_guard<std::mutex> lock(ranges[i].mutex);
+			const size_t size = ranges[i].end - std::min(ranges[i].begin, ranges[i].end);
+			if (i != slot && size > victimSize)
+			{
+				victim = i;
+				victimSize = size;
+			}
+		}
+
+		if (victim == slot)
+		{
+			return false;
+		}
+
+		size_t begin = 0;
+		size_t end = 0;
+		{
+			Range& range = ranges[victim];
+			std::lock_guard<std::mutex> lock(range.mutex);
+			if (range.begin >= range.end)
+			{
+				// another thread was faster, look for the next victim
+				continue;
+			}
+
+			const size_t size = range.end - range.begin;
+			end = range.end;
+			begin = size > grainSize ? range.end - size / 2 : range.begin;
+			range.end = begin;
+		}
+
+		Range& range = ranges[slot];
+		std::lock_guard<std::mutex> lock(range.mutex);
+		range.begin = begin;
+		range.end = end;
+		return true;
+	}
+
+	return false;
+}
+
+void WorkStealingExecutor::runWorker()
+{
+	while (true)
+	{
+		std::shared_ptr<Job> job;
+		size_t slot = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_jobsMutex);
+			m_jobsCondition.wait(lock, [this]() { return m_stopping || findJoinableJob(); });
+
+			if (m_stopping)
+			{
+				break;
+			}
+
+			job = findJoinableJob();
+			slot = job->nextSlot++;
+
+			// registered while holding the jobs lock, so the caller waits for this worker
+			std::lock_guard<std::mutex> activeLock(job->activeMutex);
+			job->activeCount++;
+		}
+
+		job->run(slot);
+
+		{
+			std::lock_guard<std::mutex> lock(job->activeMutex);
+			job->activeCount--;
+		}
+		job->activeCondition.notify_all();
+	}
+}
+
+std::shared_ptr<WorkStealingExecutor::Job> WorkStealingExecutor::findJoinableJob() const
+{
+	for (const std::shared_ptr<Job>& job: m_jobs)
+	{
+		if (job->isJoinable())
+		{
+			return job;
+		}
+	}
+	return nullptr;
+}
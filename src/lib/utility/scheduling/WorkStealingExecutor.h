@@ -0,0 +1,80 @@
+#ifndef WORK_STEALING_EXECUTOR_H
+#define WORK_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Shared pool of worker threads for parallel loops. The index range of a loop is split evenly
+// between the pool threads and the calling thread. Each of them takes chunks of grainSize indices
+// from the front of its own range and, once that is empty, steals the back half of the largest
+// remaining range. This keeps all threads busy when single items take much longer than others,
+// like a large file among many small ones.
+class WorkStealingExecutor
+{
+public:
+	static std::shared_ptr<WorkStealingExecutor> getInstance();
+
+	WorkStealingExecutor(size_t threadCount);
+	~WorkStealingExecutor();
+
+	size_t getThreadCount() const;
+
+	// Calls func for each index in [0, count) and returns once all calls have finished. The calling
+	// thread takes part, so loops can be nested. isCancelled is checked before each chunk; once it
+	// returns true no further chunks are started and false is returned.
+	bool parallelFor(
+		size_t count,
+		size_t grainSize,
+		std::function<void(size_t)> func,
+		std::function<bool()> isCancelled = std::function<bool()>());
+
+private:
+	struct Range
+	{
+		std::mutex mutex;
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	struct Job
+	{
+		Job(size_t count, size_t grainSize, size_t slotCount);
+
+		bool isJoinable() const;
+
+		void run(size_t slot);
+		bool claimChunk(size_t slot, size_t& begin, size_t& end);
+		bool steal(size_t slot);
+
+		const size_t grainSize;
+		std::function<void(size_t)> func;
+		std::function<bool()> isCancelled;
+
+		std::vector<Range> ranges;
+		std::atomic<size_t> unclaimedCount;
+		std::atomic<size_t> nextSlot;
+		std::atomic<bool> cancelled;
+
+		std::mutex activeMutex;
+		std::condition_variable activeCondition;
+		size_t activeCount = 0;
+	};
+
+	void runWorker();
+	std::shared_ptr<Job> findJoinableJob() const;
+
+	std::vector<std::thread> m_threads;
+	std::deque<std::shared_ptr<Job>> m_jobs;
+	bool m_stopping = false;
+
+	mutable std::mutex m_jobsMutex;
+	std::condition_variable m_jobsCondition;
+};
+
+#endif	  // WORK_STEALING_EXECUTOR_H
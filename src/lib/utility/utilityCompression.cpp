@@ -0,0 +1,207 @@
+#include "utilityCompression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const size_t MIN_MATCH_LENGTH = 4;
+const size_t LAST_LITERALS_LENGTH = 5;	  // the block has to end with at least 5 literals
+const size_t MATCH_START_LIMIT = 12;	  // the last match has to start 12 bytes before the end
+const size_t MAX_OFFSET = 65535;
+const int HASH_TABLE_BITS = 16;
+
+uint32_t read32(const char* data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint32_t hash32(uint32_t value)
+{
+	return (value * 2654435761u) >> (32 - HASH_TABLE_BITS);
+}
+
+void writeLength(std::string& block, size_t length)
+{
+	while (length >= 255)
+	{
+		block.push_back(char(255));
+		length -= 255;
+	}
+	block.push_back(char(length));
+}
+
+void writeSequence(
+	std::string& block, const char* literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+	const size_t matchCode = matchLength ? matchLength - MIN_MATCH_LENGTH : 0;
+	block.push_back(
+		char((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+
+	if (literalLength >= 15)
+	{
+		writeLength(block, literalLength - 15);
+	}
+	block.append(literals, literalLength);
+
+	// the last sequence has no match
+	if (matchLength)
+	{
+		block.push_back(char(offset & 0xFF));
+		block.push_back(char(offset >> 8));
+
+		if (matchCode >= 15)
+		{
+			writeLength(block, matchCode - 15);
+		}
+	}
+}
+}	 // namespace
+
+namespace utility
+{
+std::string compressLz4Block(const std::string& data)
+{
+	const char* input = data.data();
+	const size_t size = data.size();
+
+	std::string block;
+	block.reserve(size / 2 + 16);
+
+	size_t anchor = 0;
+	if (size > MATCH_START_LIMIT)
+	{
+		// holds the last position + 1 of each hashed 4 byte sequence
+		std::vector<uint32_t> table(size_t(1) << HASH_TABLE_BITS, 0);
+		const size_t matchEndLimit = size - LAST_LITERALS_LENGTH;
+
+		size_t pos = 0;
+		while (pos + MATCH_START_LIMIT <= size)
+		{
+			const uint32_t sequence = read32(input + pos);
+			uint32_t& entry = table[hash32(sequence)];
+			const size_t candidate = entry;
+			entry = uint32_t(pos + 1);
+
+			if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET ||
+				read32(input + candidate - 1) != sequence)
+			{
+				pos++;
+				continue;
+			}
+
+			size_t matchPos = candidate - 1;
+			size_t matchLength = MIN_MATCH_LENGTH;
+			while (pos + matchLength < matchEndLimit &&
+				   input[matchPos + matchLength] == input[pos + matchLength])
+			{
+				matchLength++;
+			}
+
+			while (pos > anchor && matchPos > 0 && input[pos - 1] == input[matchPos - 1])
+			{
+				pos--;
+				matchPos--;
+				matchLength++;
+			}
+
+			writeSequence(block, input + anchor, pos - anchor, pos - matchPos, matchLength);
+
+			pos += matchLength;
+			anchor = pos;
+
+			if (pos + MATCH_START_LIMIT <= size)
+			{
+				table[hash32(read32(input + pos - 2))] = uint32_t(pos - 1);
+			}
+		}
+	}
+
+	writeSequence(block, input + anchor, size - anchor, 0, 0);
+	return block;
+}
+
+bool decompressLz4Block(const std::string& block, size_t originalSize, std::string& data)
+{
+	const unsigned char* input = reinterpret_cast<const unsigned char*>(block.data());
+	const size_t size = block.size();
+	size_t pos = 0;
+
+	auto readLength = [&](size_t& length) {
+		unsigned char byte = 255;
+		while (byte == 255)
+		{
+			if (pos >= size)
+			{
+				return false;
+			}
+			byte = input[pos++];
+			length += byte;
+		}
+		return true;
+	};
+
+	data.clear();
+	data.reserve(originalSize);
+
+	while (pos < size)
+	{
+		const unsigned char token = input[pos++];
+
+		size_t literalLength = token >> 4;
+		if ((literalLength == 15 && !readLength(literalLength)) || literalLength > size - pos ||
+			literalLength > originalSize - data.size())
+		{
+			return false;
+		}
+		data.append(block, pos, literalLength);
+		pos += literalLength;
+
+		if (pos == size)
+		{
+			break;
+		}
+
+		if (size - pos < 2)
+		{
+			return false;
+		}
+		const size_t offset = size_t(input[pos]) | (size_t(input[pos + 1]) << 8);
+		pos += 2;
+
+		size_t matchLength = token & 0x0F;
+		if (matchLength == 15 && !readLength(matchLength))
+		{
+			return false;
+		}
+		matchLength += MIN_MATCH_LENGTH;
+
+		if (offset == 0 || offset > data.size() || matchLength > originalSize - data.size())
+		{
+			return false;
+		}
+
+		const size_t from = data.size() - offset;
+		const size_t to = data.size();
+		data.resize(to + matchLength);
+		if (offset >= matchLength)
+		{
+			std::memcpy(&data[to], &data[from], matchLength);
+		}
+		else
+		{
+			// overlapping matches repeat the last offset bytes
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				data[to + i] = data[from + i];
+			}
+		}
+	}
+
+	return data.size() == originalSize;
+}
+}	 // namespace utility
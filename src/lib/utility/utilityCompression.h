@@ -0,0 +1,16 @@
+#ifndef UTILITY_COMPRESSION_H
+#define UTILITY_COMPRESSION_H
+
+#include <string>
+
+namespace utility
+{
+// compresses the data into a single block of the LZ4 block format, the original size is not part
+// of the block and needs to be stored alongside.
+std::string compressLz4Block(const std::string& data);
+
+// returns false if the block is malformed or doesn't decompress to exactly originalSize bytes.
+bool decompressLz4Block(const std::string& block, size_t originalSize, std::string& data);
+}	 // namespace utility
+
+#endif	  // UTILITY_COMPRESSION_H
@@ -1,5 +1,7 @@
 #include "IndexerCommandCxx.h"
 
+#include <functional>
+
 #include <QJsonArray>
 #include <QJsonObject>
 
@@ -158,6 +160,28 @@ size_t IndexerCommandCxx::getByteSize(size_t stringSize) const
 	return size;
 }
 
+size_t IndexerCommandCxx::getPreprocessorContextHash() const
+{
+	// the source file and the output files differ between commands of the same target
+	const std::wstring sourceFileName = getSourceFilePath().fileName();
+	const std::set<std::wstring> outputFlags = {L"-o", L"-MF", L"-MT", L"-MQ"};
+
+	size_t hash = std::hash<std::wstring>()(m_workingDirectory.wstr());
+	for (size_t i = 0; i < m_compilerFlags.size(); i++)
+	{
+		const std::wstring& flag = m_compilerFlags[i];
+		if (outputFlags.find(flag) != outputFlags.end())
+		{
+			i++;
+		}
+		else if (!utility::isPostfix(sourceFileName, flag))
+		{
+			hash = hash * 31 + std::hash<std::wstring>()(flag);
+		}
+	}
+	return hash;
+}
+
 const std::set<FilePath>& IndexerCommandCxx::getIndexedPaths() const
 {
 	return m_indexedPaths;
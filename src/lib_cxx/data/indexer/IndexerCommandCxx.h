@@ -40,6 +40,7 @@ public:
 
 	IndexerCommandType getIndexerCommandType() const override;
 	size_t getByteSize(size_t stringSize) const override;
+	size_t getPreprocessorContextHash() const override;
 
 	const std::set<FilePath>& getIndexedPaths() const;
 	const std::set<FilePathFilter>& getExcludeFilters() const;
@@ -2,11 +2,16 @@
 
 #include <clang/AST/ASTContext.h>
 
+#include "IndexedFileRegistry.h"
 #include "utilityClang.h"
 #include "utilityString.h"
 
 CanonicalFilePathCache::CanonicalFilePathCache(std::shared_ptr<FileRegister> fileRegister)
 	: m_fileRegister(fileRegister)
+	, m_indexedFileRegistry(nullptr)
+	, m_preprocessorContextHash(0)
+	, m_fileIdCacheHits(0)
+	, m_fileIdCacheMisses(0)
 {
 }
 
@@ -26,16 +31,19 @@ FilePath CanonicalFilePathCache::getCanonicalFilePath(
 	auto it = m_fileIdMap.find(fileId);
 	if (it != m_fileIdMap.end())
 	{
+		m_fileIdCacheHits++;
 		return it->second;
 	}
 
+	m_fileIdCacheMisses++;
+
 	FilePath filePath;
 
 	const clang::FileEntry* fileEntry = sourceManager.getFileEntryForID(fileId);
 	if (fileEntry != nullptr && fileEntry->isValid())
 	{
 		filePath = getCanonicalFilePath(fileEntry);
-		m_fileIdMap.emplace(fileId, filePath);
+		m_fileIdMap.insert(std::make_pair(fileId, filePath));
 	}
 
 	return filePath;
@@ -82,8 +90,8 @@ FilePath CanonicalFilePathCache::getCanonicalFilePath(const Id symbolId)
 
 void CanonicalFilePathCache::addFileSymbolId(const clang::FileID& fileId, const FilePath& path, Id symbolId)
 {
-	m_fileIdSymbolIdMap.emplace(fileId, symbolId);
-	m_symbolIdFileIdMap.emplace(symbolId, fileId);
+	m_fileIdSymbolIdMap.insert(std::make_pair(fileId, symbolId));
+	m_symbolIdFileIdMap.insert(std::make_pair(symbolId, fileId));
 	m_fileStringSymbolIdMap.emplace(utility::toLowerCase(path.wstr()), symbolId);
 }
 
@@ -147,10 +155,52 @@ bool CanonicalFilePathCache::isProjectFile(
 	auto it = m_isProjectFileMap.find(fileId);
 	if (it != m_isProjectFileMap.end())
 	{
+		m_fileIdCacheHits++;
 		return it->second;
 	}
 
+	m_fileIdCacheMisses++;
+
 	bool ret = m_fileRegister->hasFilePath(getCanonicalFilePath(fileId, sourceManager));
-	m_isProjectFileMap.emplace(fileId, ret);
+	m_isProjectFileMap.insert(std::make_pair(fileId, ret));
+	return ret;
+}
+
+void CanonicalFilePathCache::setIndexedFileRegistry(
+	IndexedFileRegistry* indexedFileRegistry, size_t preprocessorContextHash)
+{
+	m_indexedFileRegistry = indexedFileRegistry;
+	m_preprocessorContextHash = preprocessorContextHash;
+	m_isSkippedFileMap.clear();
+}
+
+bool CanonicalFilePathCache::isSkippedFile(
+	const clang::FileID& fileId, const clang::SourceManager& sourceManager)
+{
+	if (!m_indexedFileRegistry || !fileId.isValid() || fileId == sourceManager.getMainFileID())
+	{
+		return false;
+	}
+
+	auto it = m_isSkippedFileMap.find(fileId);
+	if (it != m_isSkippedFileMap.end())
+	{
+		m_fileIdCacheHits++;
+		return it->second;
+	}
+
+	m_fileIdCacheMisses++;
+
+	// the answer is kept for the whole translation unit, so a file is never indexed partially
+	const bool ret = isProjectFile(fileId, sourceManager) &&
+		m_indexedFileRegistry->isFileIndexed(
+			getCanonicalFilePath(fileId, sourceManager), m_preprocessorContextHash);
+	m_isSkippedFileMap.insert(std::make_pair(fileId, ret));
 	return ret;
 }
+
+std::string CanonicalFilePathCache::getCacheStatsString() const
+{
+	return "file ids: " + std::to_string(m_fileIdCacheHits) + " hits, " +
+		std::to_string(m_fileIdCacheMisses) + " misses";
+}
@@ -1,17 +1,19 @@
 #ifndef CANONICAL_FILE_PATH_CACHE_H
 #define CANONICAL_FILE_PATH_CACHE_H
 
-#include <map>
 #include <string>
 #include <unordered_map>
 
 #include <clang/AST/Decl.h>
 #include <clang/Basic/SourceManager.h>
+#include <llvm/ADT/DenseMap.h>
 
 #include "FilePath.h"
 #include "FileRegister.h"
 #include "types.h"
 
+class IndexedFileRegistry;
+
 class CanonicalFilePathCache
 {
 public:
@@ -33,17 +35,32 @@ public:
 
 	bool isProjectFile(const clang::FileID& fileId, const clang::SourceManager& sourceManager);
 
+	// project files indexed completely by another translation unit are recorded, but their content
+	// is skipped, the main file is never skipped
+	void setIndexedFileRegistry(
+		IndexedFileRegistry* indexedFileRegistry, size_t preprocessorContextHash);
+	bool isSkippedFile(const clang::FileID& fileId, const clang::SourceManager& sourceManager);
+
+	std::string getCacheStatsString() const;
+
 private:
 	std::shared_ptr<FileRegister> m_fileRegister;
 
-	std::map<clang::FileID, FilePath> m_fileIdMap;
+	llvm::DenseMap<clang::FileID, FilePath> m_fileIdMap;
 	std::unordered_map<std::wstring, FilePath> m_fileStringMap;
 
-	std::map<clang::FileID, Id> m_fileIdSymbolIdMap;
-	std::map<Id, clang::FileID> m_symbolIdFileIdMap;
+	llvm::DenseMap<clang::FileID, Id> m_fileIdSymbolIdMap;
+	llvm::DenseMap<Id, clang::FileID> m_symbolIdFileIdMap;
 	std::unordered_map<std::wstring, Id> m_fileStringSymbolIdMap;
 
-	std::map<clang::FileID, bool> m_isProjectFileMap;
+	llvm::DenseMap<clang::FileID, bool> m_isProjectFileMap;
+
+	IndexedFileRegistry* m_indexedFileRegistry;
+	size_t m_preprocessorContextHash;
+	llvm::DenseMap<clang::FileID, bool> m_isSkippedFileMap;
+
+	size_t m_fileIdCacheHits;
+	size_t m_fileIdCacheMisses;
 };
 
 #endif	  // CANONICAL_FILE_PATH_CACHE_H
@@ -711,5 +711,7 @@ bool CxxAstVisitor::isLocatedInProjectFile(clang::SourceLocation loc) const
 	}
 
 	const clang::SourceManager& sourceManager = m_astContext->getSourceManager();
-	return m_canonicalFilePathCache->isProjectFile(sourceManager.getFileID(loc), sourceManager);
+	const clang::FileID fileId = sourceManager.getFileID(loc);
+	return m_canonicalFilePathCache->isProjectFile(fileId, sourceManager) &&
+		!m_canonicalFilePathCache->isSkippedFile(fileId, sourceManager);
 }
@@ -48,7 +48,7 @@ public:
 	CanonicalFilePathCache* getCanonicalFilePathCache() const;
 
 	// Indexing entry point
-	void indexDecl(clang::Decl* d);
+	virtual void indexDecl(clang::Decl* d);
 
 	// Visitor options
 	virtual bool shouldVisitTemplateInstantiations() const;
@@ -18,7 +18,14 @@
 
 CxxAstVisitorComponentIndexer::CxxAstVisitorComponentIndexer(
 	CxxAstVisitor* astVisitor, clang::ASTContext* astContext, std::shared_ptr<ParserClient> client)
-	: CxxAstVisitorComponent(astVisitor), m_astContext(astContext), m_client(client)
+	: CxxAstVisitorComponent(astVisitor)
+	, m_astContext(astContext)
+	, m_client(client)
+	, m_declCacheHits(0)
+	, m_firstDeclCacheHits(0)
+	, m_declCacheMisses(0)
+	, m_typeCacheHits(0)
+	, m_typeCacheMisses(0)
 {
 }
 
@@ -854,6 +861,15 @@ void CxxAstVisitorComponentIndexer::visitConstructorInitializer(clang::CXXCtorIn
 	}
 }
 
+std::string CxxAstVisitorComponentIndexer::getCacheStatsString() const
+{
+	return "decl symbols: " + std::to_string(m_declCacheHits) + " hits, " +
+		std::to_string(m_firstDeclCacheHits) + " redeclaration hits, " +
+		std::to_string(m_declCacheMisses) + " misses; type symbols: " +
+		std::to_string(m_typeCacheHits) + " hits, " + std::to_string(m_typeCacheMisses) +
+		" misses";
+}
+
 void CxxAstVisitorComponentIndexer::recordTemplateMemberSpecialization(
 	const clang::MemberSpecializationInfo* memberSpecializationInfo,
 	Id contextId,
@@ -972,9 +988,23 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::NamedDecl* de
 	auto it = m_declSymbolIds.find(decl);
 	if (it != m_declSymbolIds.end())
 	{
+		m_declCacheHits++;
 		return it->second;
 	}
 
+	const clang::NamedDecl* firstDecl = decl ? utility::getFirstDecl(decl) : nullptr;
+	auto firstDeclIt = m_firstDeclSymbolIds.find(firstDecl);
+	if (firstDeclIt != m_firstDeclSymbolIds.end())
+	{
+		m_firstDeclCacheHits++;
+		const Id symbolId = firstDeclIt->second;
+		m_declSymbolIds.insert(std::make_pair(decl, symbolId));
+		return symbolId;
+	}
+
+	m_declCacheMisses++;
+
+	bool isFileSpecificName = false;
 	NameHierarchy symbolName(L"global", NAME_DELIMITER_UNKNOWN);
 	if (decl)
 	{
@@ -995,12 +1025,17 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::NamedDecl* de
 						getAstVisitor()->getCanonicalFilePathCache()->getDeclarationFileName(decl),
 					sig.getPrefix(),
 					sig.getPostfix()));
+				isFileSpecificName = true;
 			}
 		}
 	}
 
 	Id symbolId = m_client->recordSymbol(symbolName);
-	m_declSymbolIds.emplace(decl, symbolId);
+	m_declSymbolIds.insert(std::make_pair(decl, symbolId));
+	if (!isFileSpecificName)
+	{
+		m_firstDeclSymbolIds.insert(std::make_pair(firstDecl, symbolId));
+	}
 	return symbolId;
 }
 
@@ -1009,9 +1044,12 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::Type* type)
 	auto it = m_typeSymbolIds.find(type);
 	if (it != m_typeSymbolIds.end())
 	{
+		m_typeCacheHits++;
 		return it->second;
 	}
 
+	m_typeCacheMisses++;
+
 	NameHierarchy symbolName(L"global", NAME_DELIMITER_UNKNOWN);
 	if (type)
 	{
@@ -1024,7 +1062,7 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::Type* type)
 	}
 
 	Id symbolId = m_client->recordSymbol(symbolName);
-	m_typeSymbolIds.emplace(type, symbolId);
+	m_typeSymbolIds.insert(std::make_pair(type, symbolId));
 	return symbolId;
 }
 
@@ -1,7 +1,9 @@
 #ifndef CXX_AST_VISITOR_COMPONENT_INDEXER_H
 #define CXX_AST_VISITOR_COMPONENT_INDEXER_H
 
-#include <unordered_map>
+#include <string>
+
+#include <llvm/ADT/DenseMap.h>
 
 #include "CxxAstVisitorComponent.h"
 #include "ParseLocation.h"
@@ -52,6 +54,8 @@ public:
 
 	void visitConstructorInitializer(clang::CXXCtorInitializer* init);
 
+	std::string getCacheStatsString() const;
+
 private:
 	void recordTemplateMemberSpecialization(
 		const clang::MemberSpecializationInfo* memberSpecializationInfo,
@@ -78,8 +82,17 @@ private:
 	clang::ASTContext* m_astContext;
 	std::shared_ptr<ParserClient> m_client;
 
-	std::map<const clang::NamedDecl*, Id> m_declSymbolIds;
-	std::map<const clang::Type*, Id> m_typeSymbolIds;
+	llvm::DenseMap<const clang::NamedDecl*, Id> m_declSymbolIds;
+	llvm::DenseMap<const clang::Type*, Id> m_typeSymbolIds;
+
+	// redeclarations share the name resolved for their first declaration
+	llvm::DenseMap<const clang::NamedDecl*, Id> m_firstDeclSymbolIds;
+
+	size_t m_declCacheHits;
+	size_t m_firstDeclCacheHits;
+	size_t m_declCacheMisses;
+	size_t m_typeCacheHits;
+	size_t m_typeCacheMisses;
 };
 
 #endif	  // CXX_AST_VISITOR_COMPONENT_INDEXER_H
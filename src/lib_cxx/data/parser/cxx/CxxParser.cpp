@@ -18,12 +18,14 @@
 #include "FilePath.h"
 #include "FileRegister.h"
 #include "IndexerCommandCxx.h"
+#include "IndexerStateInfo.h"
 #include "ParserClient.h"
 #include "ResourcePaths.h"
 #include "SingleFrontendActionFactory.h"
 #include "TextAccess.h"
 #include "logging.h"
 #include "utility.h"
+#include "utilitySourceGroupCxx.h"
 #include "utilityString.h"
 
 namespace
@@ -138,11 +140,27 @@ void CxxParser::buildIndex(std::shared_ptr<IndexerCommandCxx> indexerCommand)
 	{
 		args.erase(args.begin());
 	}
+	for (size_t i = 0; i + 1 < args.size(); i++)
+	{
+		// an automatic precompiled header that failed to build is skipped instead of failing the
+		// whole file, a missing precompiled header configured by the user is still reported
+		if (args[i] == L"-include-pch" && utility::isAutomaticPchFilePath(FilePath(args[i + 1])) &&
+			!FilePath(args[i + 1]).exists())
+		{
+			LOG_WARNING(
+				L"Precompiled header \"" + args[i + 1] + L"\" does not exist, ignoring it.");
+			args.erase(args.begin() + i, args.begin() + i + 2);
+			i--;
+		}
+	}
 	compileCommand.CommandLine = getCommandlineArgumentsEssential(args);
 	compileCommand.CommandLine = prependSyntaxOnlyToolArgs(compileCommand.CommandLine);
 
 	CxxCompilationDatabaseSingle compilationDatabase(compileCommand);
-	runTool(&compilationDatabase, indexerCommand->getSourceFilePath());
+	runTool(
+		&compilationDatabase,
+		indexerCommand->getSourceFilePath(),
+		indexerCommand->getPreprocessorContextHash());
 }
 
 void CxxParser::buildIndex(
@@ -165,7 +183,9 @@ void CxxParser::buildIndex(
 }
 
 void CxxParser::runTool(
-	clang::tooling::CompilationDatabase* compilationDatabase, const FilePath& sourceFilePath)
+	clang::tooling::CompilationDatabase* compilationDatabase,
+	const FilePath& sourceFilePath,
+	size_t preprocessorContextHash)
 {
 	initializeLLVM();
 
@@ -175,6 +195,11 @@ void CxxParser::runTool(
 
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache =
 		std::make_shared<CanonicalFilePathCache>(m_fileRegister);
+	if (m_indexerStateInfo && m_indexerStateInfo->indexedFileRegistry)
+	{
+		canonicalFilePathCache->setIndexedFileRegistry(
+			m_indexerStateInfo->indexedFileRegistry, preprocessorContextHash);
+	}
 
 	std::shared_ptr<CxxDiagnosticConsumer> diagnostics = getDiagnostics(
 		sourceFilePath, canonicalFilePathCache, true);
@@ -45,7 +45,9 @@ public:
 
 private:
 	void runTool(
-		clang::tooling::CompilationDatabase* compilationDatabase, const FilePath& sourceFilePath);
+		clang::tooling::CompilationDatabase* compilationDatabase,
+		const FilePath& sourceFilePath,
+		size_t preprocessorContextHash);
 
 	std::shared_ptr<CxxDiagnosticConsumer> getDiagnostics(
 		const FilePath& sourceFilePath,
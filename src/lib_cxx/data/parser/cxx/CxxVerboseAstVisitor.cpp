@@ -6,6 +6,7 @@
 #include <clang/Basic/SourceManager.h>
 
 #include "CanonicalFilePathCache.h"
+#include "CxxAstVisitorComponentIndexer.h"
 #include "ParseLocation.h"
 #include "ParserClient.h"
 #include "ScopedSwitcher.h"
@@ -21,6 +22,16 @@ CxxVerboseAstVisitor::CxxVerboseAstVisitor(
 {
 }
 
+void CxxVerboseAstVisitor::indexDecl(clang::Decl* d)
+{
+	base::indexDecl(d);
+
+	LOG_INFO(
+		"Indexer - Cache stats: " +
+		getComponent<CxxAstVisitorComponentIndexer>()->getCacheStatsString() + "; " +
+		getCanonicalFilePathCache()->getCacheStatsString());
+}
+
 bool CxxVerboseAstVisitor::TraverseDecl(clang::Decl* d)
 {
 	if (d)
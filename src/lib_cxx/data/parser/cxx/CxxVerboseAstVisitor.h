@@ -19,6 +19,9 @@ public:
 		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
 		std::shared_ptr<IndexerStateInfo> indexerStateInfo);
 
+	// additionally logs the cache statistics of the translation unit
+	void indexDecl(clang::Decl* d) override;
+
 private:
 	typedef CxxAstVisitor base;
 
@@ -49,6 +49,13 @@ void PreprocessorCallbacks::FileChanged(
 		{
 			m_currentFileSymbolId = m_canonicalFilePathCache->getFileSymbolId(fileId);
 		}
+
+		// the file and its includes are still recorded, its macros were recorded elsewhere
+		if (m_currentPathIsProjectFile &&
+			m_canonicalFilePathCache->isSkippedFile(fileId, m_sourceManager))
+		{
+			m_currentPathIsProjectFile = false;
+		}
 	}
 }
 
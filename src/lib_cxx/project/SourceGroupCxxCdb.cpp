@@ -1,5 +1,7 @@
 #include "SourceGroupCxxCdb.h"
 
+#include <map>
+
 #include <clang/Tooling/JSONCompilationDatabase.h>
 #include <clang/Tooling/Tooling.h>
 
@@ -90,58 +92,50 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 	std::shared_ptr<CxxIndexerCommandProvider> provider =
 		std::make_shared<CxxIndexerCommandProvider>();
 
-	const FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(
+		m_settings->getCompilationDatabasePathExpandedAndAbsolute());
 	if (!cdb)
 	{
 		return provider;
 	}
 
-	std::vector<std::wstring> compilerFlags = getBaseCompilerFlags();
-	utility::append(compilerFlags, m_settings->getCompilerFlags());
+	const std::vector<std::shared_ptr<IndexerCommandCxx>> indexerCommands = getAllIndexerCommands(
+		cdb);
 
-	const std::vector<std::wstring> includePchFlags = utility::getIncludePchFlags(m_settings.get());
-
-	const std::set<FilePath> indexedHeaderPaths = utility::toSet(
-		m_settings->getIndexedHeaderPathsExpandedAndAbsolute());
-	const std::set<FilePathFilter> excludeFilters = utility::toSet(
-		m_settings->getExcludeFiltersExpandedAndAbsolute());
-	const std::set<FilePath>& sourceFilePaths = getAllSourceFilePaths(cdb);
-
-	for (const clang::tooling::CompileCommand& command: cdb->getAllCompileCommands())
+	std::map<FilePath, std::vector<std::wstring>> automaticPchFlags;
+	if (isAutomaticPchEnabled(cdb))
 	{
-		FilePath sourcePath = FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
-		if (!sourcePath.isAbsolute())
+		for (const utility::AutomaticPch& pch: utility::getAutomaticPchs(
+				 indexerCommands, m_settings->getPchDependenciesDirectoryPath()))
 		{
-			sourcePath = FilePath(utility::decodeFromUtf8(command.Directory + '/' + command.Filename))
-							 .makeCanonical();
-			if (!sourcePath.isAbsolute())
+			for (const FilePath& sourceFilePath: pch.sourceFilePaths)
 			{
-				sourcePath = cdbPath.getParentDirectory().getConcatenated(sourcePath).makeCanonical();
+				automaticPchFlags[sourceFilePath] = utility::getIncludePchFlags(pch);
 			}
 		}
+	}
 
-		if (info.filesToIndex.find(sourcePath) != info.filesToIndex.end() &&
-			sourceFilePaths.find(sourcePath) != sourceFilePaths.end())
+	for (std::shared_ptr<IndexerCommandCxx> indexerCommand: indexerCommands)
+	{
+		const FilePath& sourcePath = indexerCommand->getSourceFilePath();
+		if (info.filesToIndex.find(sourcePath) == info.filesToIndex.end())
 		{
-			std::vector<std::wstring> cdbFlags = utility::convert<std::string, std::wstring>(
-				command.CommandLine, [](const std::string& s) { return utility::decodeFromUtf8(s); });
-
-			utility::removeIncludePchFlag(cdbFlags);
-
-			if (command.CommandLine.size() != cdbFlags.size())
-			{
-				utility::append(cdbFlags, includePchFlags);
-			}
+			continue;
+		}
 
-			provider->addCommand(std::make_shared<IndexerCommandCxx>(
+		auto it = automaticPchFlags.find(sourcePath);
+		if (it != automaticPchFlags.end())
+		{
+			indexerCommand = std::make_shared<IndexerCommandCxx>(
 				sourcePath,
-				utility::concat(indexedHeaderPaths, {sourcePath}),
-				excludeFilters,
-				std::set<FilePathFilter>(),
-				FilePath(utility::decodeFromUtf8(command.Directory)),
-				utility::concat(cdbFlags, compilerFlags)));
+				indexerCommand->getIndexedPaths(),
+				indexerCommand->getExcludeFilters(),
+				indexerCommand->getIncludeFilters(),
+				indexerCommand->getWorkingDirectory(),
+				utility::concat(indexerCommand->getCompilerFlags(), it->second));
 		}
+
+		provider->addCommand(indexerCommand);
 	}
 
 	provider->logStats();
@@ -156,11 +150,36 @@ std::vector<std::shared_ptr<IndexerCommand>> SourceGroupCxxCdb::getIndexerComman
 }
 
 std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(
-	std::shared_ptr<StorageProvider> storageProvider, std::shared_ptr<DialogView> dialogView) const
+	const RefreshInfo& info,
+	std::shared_ptr<StorageProvider> storageProvider,
+	std::shared_ptr<DialogView> dialogView) const
 {
 	if (m_settings->getPchInputFilePath().empty())
 	{
-		return std::make_shared<TaskLambda>([]() {});
+		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(
+			m_settings->getCompilationDatabasePathExpandedAndAbsolute());
+		if (!cdb || !isAutomaticPchEnabled(cdb))
+		{
+			return std::make_shared<TaskLambda>([]() {});
+		}
+
+		// the groups are formed from all commands, so the precompiled headers don't change when
+		// only some of the files are indexed
+		std::vector<utility::AutomaticPch> pchs;
+		for (const utility::AutomaticPch& pch: utility::getAutomaticPchs(
+				 getAllIndexerCommands(cdb), m_settings->getPchDependenciesDirectoryPath()))
+		{
+			for (const FilePath& sourceFilePath: pch.sourceFilePaths)
+			{
+				if (info.filesToIndex.find(sourceFilePath) != info.filesToIndex.end())
+				{
+					pchs.push_back(pch);
+					break;
+				}
+			}
+		}
+
+		return utility::createBuildAutomaticPchTask(pchs, info, storageProvider, dialogView);
 	}
 
 	std::vector<std::wstring> compilerFlags;
@@ -237,6 +256,72 @@ std::shared_ptr<const SourceGroupSettings> SourceGroupCxxCdb::getSourceGroupSett
 	return m_settings;
 }
 
+std::vector<std::shared_ptr<IndexerCommandCxx>> SourceGroupCxxCdb::getAllIndexerCommands(
+	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const
+{
+	std::vector<std::shared_ptr<IndexerCommandCxx>> indexerCommands;
+
+	const FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
+
+	std::vector<std::wstring> compilerFlags = getBaseCompilerFlags();
+	utility::append(compilerFlags, m_settings->getCompilerFlags());
+
+	const std::vector<std::wstring> includePchFlags = utility::getIncludePchFlags(m_settings.get());
+
+	const std::set<FilePath> indexedHeaderPaths = utility::toSet(
+		m_settings->getIndexedHeaderPathsExpandedAndAbsolute());
+	const std::set<FilePathFilter> excludeFilters = utility::toSet(
+		m_settings->getExcludeFiltersExpandedAndAbsolute());
+	const std::set<FilePath>& sourceFilePaths = getAllSourceFilePaths(cdb);
+
+	for (const clang::tooling::CompileCommand& command: cdb->getAllCompileCommands())
+	{
+		FilePath sourcePath = FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
+		if (!sourcePath.isAbsolute())
+		{
+			sourcePath = FilePath(utility::decodeFromUtf8(command.Directory + '/' + command.Filename))
+							 .makeCanonical();
+			if (!sourcePath.isAbsolute())
+			{
+				sourcePath = cdbPath.getParentDirectory().getConcatenated(sourcePath).makeCanonical();
+			}
+		}
+
+		if (sourceFilePaths.find(sourcePath) != sourceFilePaths.end())
+		{
+			std::vector<std::wstring> cdbFlags = utility::convert<std::string, std::wstring>(
+				command.CommandLine, [](const std::string& s) { return utility::decodeFromUtf8(s); });
+
+			utility::removeIncludePchFlag(cdbFlags);
+
+			if (command.CommandLine.size() != cdbFlags.size())
+			{
+				utility::append(cdbFlags, includePchFlags);
+			}
+
+			indexerCommands.push_back(std::make_shared<IndexerCommandCxx>(
+				sourcePath,
+				utility::concat(indexedHeaderPaths, {sourcePath}),
+				excludeFilters,
+				std::set<FilePathFilter>(),
+				FilePath(utility::decodeFromUtf8(command.Directory)),
+				utility::concat(cdbFlags, compilerFlags)));
+		}
+	}
+
+	return indexerCommands;
+}
+
+bool SourceGroupCxxCdb::isAutomaticPchEnabled(
+	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const
+{
+	// a precompiled header configured by the user or the compilation database takes precedence
+	return ApplicationSettings::getInstance()->getAutomaticPchEnabled() &&
+		m_settings->getPchInputFilePath().empty() &&
+		!m_settings->getPchDependenciesDirectoryPath().empty() &&
+		!utility::containsIncludePchFlags(cdb);
+}
+
 std::vector<std::wstring> SourceGroupCxxCdb::getBaseCompilerFlags() const
 {
 	std::vector<std::wstring> compilerFlags;
@@ -16,6 +16,7 @@ class JSONCompilationDatabase;
 }
 }	 // namespace clang
 
+class IndexerCommandCxx;
 class SourceGroupSettingsCxxCdb;
 
 class SourceGroupCxxCdb: public SourceGroup
@@ -32,12 +33,16 @@ public:
 		const RefreshInfo& info) const override;
 	std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommands(const RefreshInfo& info) const override;
 	std::shared_ptr<Task> getPreIndexTask(
+		const RefreshInfo& info,
 		std::shared_ptr<StorageProvider> storageProvider,
 		std::shared_ptr<DialogView> dialogView) const override;
 
 private:
 	std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() override;
 	std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const override;
+	std::vector<std::shared_ptr<IndexerCommandCxx>> getAllIndexerCommands(
+		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const;
+	bool isAutomaticPchEnabled(std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const;
 	std::vector<std::wstring> getBaseCompilerFlags() const;
 
 	std::shared_ptr<SourceGroupSettingsCxxCdb> m_settings;
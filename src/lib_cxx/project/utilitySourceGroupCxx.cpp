@@ -1,5 +1,9 @@
 #include "utilitySourceGroupCxx.h"
 
+#include <fstream>
+#include <map>
+#include <tuple>
+
 #include <clang/Tooling/JSONCompilationDatabase.h>
 
 #include "CanonicalFilePathCache.h"
@@ -11,7 +15,9 @@
 #include "FileRegister.h"
 #include "FileSystem.h"
 #include "GeneratePCHAction.h"
+#include "IndexerCommandCxx.h"
 #include "ParserClientImpl.h"
+#include "RefreshInfo.h"
 #include "SingleFrontendActionFactory.h"
 #include "SourceGroupSettingsWithCxxPchOptions.h"
 #include "StorageProvider.h"
@@ -19,6 +25,190 @@
 #include "logging.h"
 #include "utility.h"
 
+namespace
+{
+const std::wstring automaticPchFileNamePrefix = L"automatic_";
+
+// returns the files the precompiled header was built from
+std::set<FilePath> buildPch(
+	const FilePath& pchInputFilePath,
+	const FilePath& pchOutputFilePath,
+	const FilePath& workingDirectory,
+	const std::vector<std::wstring>& compilerFlags,
+	std::shared_ptr<StorageProvider> storageProvider)
+{
+	CxxParser::initializeLLVM();
+
+	if (!pchOutputFilePath.getParentDirectory().exists())
+	{
+		FileSystem::createDirectory(pchOutputFilePath.getParentDirectory());
+	}
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	std::shared_ptr<ParserClientImpl> client = std::make_shared<ParserClientImpl>(storage.get());
+
+	std::shared_ptr<FileRegister> fileRegister = std::make_shared<FileRegister>(
+		pchInputFilePath, std::set<FilePath> {pchInputFilePath}, std::set<FilePathFilter> {});
+
+	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache =
+		std::make_shared<CanonicalFilePathCache>(fileRegister);
+
+	clang::tooling::CompileCommand pchCommand;
+	pchCommand.Filename = utility::encodeToUtf8(pchInputFilePath.fileName());
+	pchCommand.Directory = workingDirectory.str();
+	// DON'T use "-fsyntax-only" here because it will cause the output file to be erased
+	pchCommand.CommandLine = utility::concat(
+		{"clang-tool"}, CxxParser::getCommandlineArgumentsEssential(compilerFlags));
+
+	CxxCompilationDatabaseSingle compilationDatabase(pchCommand);
+	clang::tooling::ClangTool tool(
+		compilationDatabase, {utility::encodeToUtf8(pchInputFilePath.wstr())});
+	GeneratePCHAction* action = new GeneratePCHAction(client, canonicalFilePathCache);
+
+	llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> options = new clang::DiagnosticOptions();
+	CxxDiagnosticConsumer diagnostics(
+		llvm::errs(), &*options, client, canonicalFilePathCache, pchInputFilePath, true);
+
+	tool.setDiagnosticConsumer(&diagnostics);
+	tool.clearArgumentsAdjusters();
+	tool.run(new SingleFrontendActionFactory(action));
+
+	std::set<FilePath> filePaths;
+	for (const StorageFile& file: storage->getStorageFiles())
+	{
+		filePaths.insert(FilePath(file.filePath));
+	}
+
+	storageProvider->insert(storage);
+	return filePaths;
+}
+
+std::vector<std::wstring> getAutomaticPchCompilerFlags(const IndexerCommandCxx& indexerCommand)
+{
+	// the compiler, the source file and the output files of the command are not part of the pch
+	const std::wstring sourceFileName = indexerCommand.getSourceFilePath().fileName();
+	const std::set<std::wstring> outputFlags = {L"-o", L"-MF", L"-MT", L"-MQ"};
+	const std::set<std::wstring> omittedFlags = {L"-c", L"-M", L"-MM", L"-MD", L"-MMD", L"-MP"};
+
+	std::vector<std::wstring> compilerFlags;
+	const std::vector<std::wstring>& flags = indexerCommand.getCompilerFlags();
+	for (size_t i = 0; i < flags.size(); i++)
+	{
+		const std::wstring& flag = flags[i];
+		if (outputFlags.find(flag) != outputFlags.end())
+		{
+			i++;
+		}
+		else if (
+			(i != 0 || utility::isPrefix<std::wstring>(L"-", flag)) &&
+			omittedFlags.find(flag) == omittedFlags.end() &&
+			!utility::isPostfix(sourceFileName, flag))
+		{
+			compilerFlags.push_back(flag);
+		}
+	}
+	return compilerFlags;
+}
+
+FilePath getAutomaticPchStampFilePath(const AutomaticPch& pch)
+{
+	return pch.outputFilePath.replaceExtension(L"stamp");
+}
+
+// identifies the generated header and the command a precompiled header is built with
+std::string getAutomaticPchStamp(const AutomaticPch& pch)
+{
+	std::string stamp = "directory " + utility::encodeToUtf8(pch.workingDirectory.wstr()) + "\n";
+	for (const std::wstring& compilerFlag: pch.compilerFlags)
+	{
+		stamp += "flag " + utility::encodeToUtf8(compilerFlag) + "\n";
+	}
+	for (const std::string& includeDirective: pch.includeDirectives)
+	{
+		stamp += includeDirective + "\n";
+	}
+	return stamp;
+}
+
+// The stamp file holds the stamp of the precompiled header, followed by an empty line and the files
+// it was built from with their modification times.
+void writeAutomaticPchStampFile(
+	const AutomaticPch& pch, const std::string& stamp, const std::set<FilePath>& pchFilePaths)
+{
+	std::ofstream stampFile(getAutomaticPchStampFilePath(pch).str(), std::ios::binary);
+	stampFile << stamp << "\n";
+	for (const FilePath& filePath: pchFilePaths)
+	{
+		stampFile << FileSystem::getLastWriteTime(filePath).toString() << "\t"
+				  << utility::encodeToUtf8(filePath.wstr()) << "\n";
+	}
+}
+
+// The content of a precompiled header is only stored in the index when it is built, so it is also
+// rebuilt if any of its files get cleared from the index.
+bool isAutomaticPchUpToDate(
+	const AutomaticPch& pch, const std::string& stamp, const std::set<FilePath>& clearedFilePaths)
+{
+	if (!pch.outputFilePath.recheckExists())
+	{
+		return false;
+	}
+
+	std::ifstream stampFile(getAutomaticPchStampFilePath(pch).str(), std::ios::binary);
+	if (!stampFile.is_open())
+	{
+		return false;
+	}
+
+	std::string storedStamp;
+	std::string line;
+	while (std::getline(stampFile, line) && !line.empty())
+	{
+		storedStamp += line + "\n";
+	}
+
+	if (storedStamp != stamp || !stampFile.good())
+	{
+		return false;
+	}
+
+	while (std::getline(stampFile, line))
+	{
+		const size_t separator = line.find('\t');
+		if (separator == std::string::npos)
+		{
+			return false;
+		}
+
+		const FilePath filePath(utility::decodeFromUtf8(line.substr(separator + 1)));
+		if (clearedFilePaths.find(filePath) != clearedFilePaths.end() ||
+			FileSystem::getLastWriteTime(filePath).toString() != line.substr(0, separator))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+std::wstring getHeaderLanguage(const FilePath& sourceFilePath)
+{
+	const std::wstring extension = sourceFilePath.extension();
+	if (extension == L".c")
+	{
+		return L"c-header";
+	}
+	else if (extension == L".m")
+	{
+		return L"objective-c-header";
+	}
+	else if (extension == L".mm")
+	{
+		return L"objective-c++-header";
+	}
+	return L"c++-header";
+}
+}	 // namespace
+
 namespace utility
 {
 std::shared_ptr<Task> createBuildPchTask(
@@ -60,46 +250,248 @@ std::shared_ptr<Task> createBuildPchTask(
 				L"Generating precompiled header output for input file \"" +
 				pchInputFilePath.wstr() + L"\" at location \"" + pchOutputFilePath.wstr() + L"\"");
 
-			CxxParser::initializeLLVM();
+			buildPch(
+				pchInputFilePath,
+				pchOutputFilePath,
+				pchOutputFilePath.getParentDirectory(),
+				compilerFlags,
+				storageProvider);
+		});
+}
 
-			if (!pchOutputFilePath.getParentDirectory().exists())
+std::shared_ptr<Task> createBuildAutomaticPchTask(
+	const std::vector<AutomaticPch>& pchs,
+	const RefreshInfo& info,
+	std::shared_ptr<StorageProvider> storageProvider,
+	std::shared_ptr<DialogView> dialogView)
+{
+	if (pchs.empty())
+	{
+		return std::make_shared<TaskLambda>([]() {});
+	}
+
+	return std::make_shared<TaskLambda>([dialogView, storageProvider, pchs, info]() {
+		dialogView->showUnknownProgressDialog(
+			L"Preparing Indexing", L"Processing Precompiled Headers");
+
+		// all precompiled headers are rebuilt when the whole index gets cleared
+		const bool rebuildAll = info.mode == REFRESH_ALL_FILES;
+		const std::set<FilePath> clearedFilePaths = utility::concat(
+			info.filesToClear, info.nonIndexedFilesToClear);
+
+		for (const AutomaticPch& pch: pchs)
+		{
+			const std::string stamp = getAutomaticPchStamp(pch);
+			if (!rebuildAll && isAutomaticPchUpToDate(pch, stamp, clearedFilePaths))
 			{
-				FileSystem::createDirectory(pchOutputFilePath.getParentDirectory());
+				LOG_INFO(
+					L"Precompiled header at location \"" + pch.outputFilePath.wstr() +
+					L"\" is up to date.");
+				continue;
 			}
 
-			std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
-			std::shared_ptr<ParserClientImpl> client = std::make_shared<ParserClientImpl>(
-				storage.get());
+			LOG_INFO(
+				L"Generating precompiled header for " +
+				std::to_wstring(pch.sourceFilePaths.size()) + L" source files at location \"" +
+				pch.outputFilePath.wstr() + L"\"");
 
-			std::shared_ptr<FileRegister> fileRegister = std::make_shared<FileRegister>(
-				pchInputFilePath, std::set<FilePath> {pchInputFilePath}, std::set<FilePathFilter> {});
+			if (!pch.inputFilePath.getParentDirectory().exists())
+			{
+				FileSystem::createDirectory(pch.inputFilePath.getParentDirectory());
+			}
 
-			std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache =
-				std::make_shared<CanonicalFilePathCache>(fileRegister);
+			// a stale output of a previous run must not be used if the build fails
+			if (pch.outputFilePath.exists())
+			{
+				FileSystem::remove(pch.outputFilePath);
+			}
+			FileSystem::remove(getAutomaticPchStampFilePath(pch));
 
-			clang::tooling::CompileCommand pchCommand;
-			pchCommand.Filename = utility::encodeToUtf8(pchInputFilePath.fileName());
-			pchCommand.Directory = pchOutputFilePath.getParentDirectory().str();
-			// DON'T use "-fsyntax-only" here because it will cause the output file to be erased
-			pchCommand.CommandLine = utility::concat(
-				{"clang-tool"}, CxxParser::getCommandlineArgumentsEssential(compilerFlags));
+			{
+				std::ofstream inputFile(pch.inputFilePath.str());
+				for (const std::string& includeDirective: pch.includeDirectives)
+				{
+					inputFile << includeDirective << "\n";
+				}
+			}
+
+			std::vector<std::wstring> compilerFlags = pch.compilerFlags;
+			compilerFlags.push_back(pch.inputFilePath.wstr());
+			compilerFlags.push_back(L"-emit-pch");
+			compilerFlags.push_back(L"-o");
+			compilerFlags.push_back(pch.outputFilePath.wstr());
 
-			CxxCompilationDatabaseSingle compilationDatabase(pchCommand);
-			clang::tooling::ClangTool tool(
-				compilationDatabase, {utility::encodeToUtf8(pchInputFilePath.wstr())});
-			GeneratePCHAction* action = new GeneratePCHAction(client, canonicalFilePathCache);
+			const std::set<FilePath> pchFilePaths = buildPch(
+				pch.inputFilePath,
+				pch.outputFilePath,
+				pch.workingDirectory,
+				compilerFlags,
+				storageProvider);
 
-			llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> options =
-				new clang::DiagnosticOptions();
-			CxxDiagnosticConsumer diagnostics(
-				llvm::errs(), &*options, client, canonicalFilePathCache, pchInputFilePath, true);
+			if (pch.outputFilePath.recheckExists())
+			{
+				writeAutomaticPchStampFile(pch, stamp, pchFilePaths);
+			}
+		}
+	});
+}
 
-			tool.setDiagnosticConsumer(&diagnostics);
-			tool.clearArgumentsAdjusters();
-			tool.run(new SingleFrontendActionFactory(action));
+std::vector<AutomaticPch> getAutomaticPchs(
+	const std::vector<std::shared_ptr<IndexerCommandCxx>>& indexerCommands,
+	const FilePath& pchDirectoryPath)
+{
+	// building a precompiled header only pays off if it is used by several translation units
+	const size_t minSourceFileCount = 2;
 
-			storageProvider->insert(storage);
-		});
+	// quoted includes are resolved relative to the source file, so groups don't span directories
+	std::map<
+		std::tuple<size_t, std::wstring, std::wstring>,
+		std::vector<std::shared_ptr<IndexerCommandCxx>>>
+		groups;
+	for (const std::shared_ptr<IndexerCommandCxx>& indexerCommand: indexerCommands)
+	{
+		const FilePath& sourceFilePath = indexerCommand->getSourceFilePath();
+		groups[std::make_tuple(
+				   indexerCommand->getPreprocessorContextHash(),
+				   sourceFilePath.getParentDirectory().wstr(),
+				   getHeaderLanguage(sourceFilePath))]
+			.push_back(indexerCommand);
+	}
+
+	std::vector<AutomaticPch> pchs;
+	for (const auto& it: groups)
+	{
+		const std::vector<std::shared_ptr<IndexerCommandCxx>>& groupCommands = it.second;
+		if (groupCommands.size() < minSourceFileCount)
+		{
+			continue;
+		}
+
+		std::vector<std::string> includeDirectives = getLeadingIncludeDirectives(
+			groupCommands.front()->getSourceFilePath());
+		for (size_t i = 1; i < groupCommands.size() && !includeDirectives.empty(); i++)
+		{
+			const std::vector<std::string> otherIncludeDirectives = getLeadingIncludeDirectives(
+				groupCommands[i]->getSourceFilePath());
+
+			size_t commonCount = 0;
+			while (commonCount < includeDirectives.size() &&
+				   commonCount < otherIncludeDirectives.size() &&
+				   includeDirectives[commonCount] == otherIncludeDirectives[commonCount])
+			{
+				commonCount++;
+			}
+			includeDirectives.resize(commonCount);
+		}
+
+		if (includeDirectives.empty())
+		{
+			continue;
+		}
+
+		const std::wstring& sourceDirectory = std::get<1>(it.first);
+		const std::wstring& headerLanguage = std::get<2>(it.first);
+
+		size_t hash = std::get<0>(it.first);
+		hash = hash * 31 + std::hash<std::wstring>()(sourceDirectory + L"|" + headerLanguage);
+		for (const std::string& includeDirective: includeDirectives)
+		{
+			hash = hash * 31 + std::hash<std::string>()(includeDirective);
+		}
+
+		AutomaticPch pch;
+		pch.inputFilePath = pchDirectoryPath.getConcatenated(
+			automaticPchFileNamePrefix + std::to_wstring(hash) + L".h");
+		pch.outputFilePath = pch.inputFilePath.replaceExtension(L"pch");
+		pch.workingDirectory = groupCommands.front()->getWorkingDirectory();
+		pch.compilerFlags = getAutomaticPchCompilerFlags(*groupCommands.front());
+		pch.compilerFlags.push_back(L"-iquote");
+		pch.compilerFlags.push_back(sourceDirectory);
+		pch.compilerFlags.push_back(L"-x");
+		pch.compilerFlags.push_back(headerLanguage);
+		pch.includeDirectives = includeDirectives;
+		for (const std::shared_ptr<IndexerCommandCxx>& indexerCommand: groupCommands)
+		{
+			pch.sourceFilePaths.insert(indexerCommand->getSourceFilePath());
+		}
+		pchs.push_back(pch);
+	}
+
+	return pchs;
+}
+
+std::vector<std::string> getLeadingIncludeDirectives(const FilePath& sourceFilePath)
+{
+	std::vector<std::string> includeDirectives;
+
+	std::ifstream sourceFile(sourceFilePath.str());
+	bool inBlockComment = false;
+	std::string line;
+	while (std::getline(sourceFile, line))
+	{
+		line = utility::trim(line);
+
+		if (inBlockComment)
+		{
+			const size_t commentEnd = line.find("*/");
+			if (commentEnd == std::string::npos)
+			{
+				continue;
+			}
+			inBlockComment = false;
+			line = utility::trim(line.substr(commentEnd + 2));
+		}
+
+		if (utility::isPrefix<std::string>("/*", line))
+		{
+			const size_t commentEnd = line.find("*/", 2);
+			if (commentEnd == std::string::npos)
+			{
+				inBlockComment = true;
+				continue;
+			}
+			line = utility::trim(line.substr(commentEnd + 2));
+		}
+
+		if (line.empty() || utility::isPrefix<std::string>("//", line))
+		{
+			continue;
+		}
+
+		// everything else, including conditionals and macro includes, ends the shared prefix
+		if (!utility::isPrefix<std::string>("#", line))
+		{
+			break;
+		}
+
+		const std::string directive = utility::trim(line.substr(1));
+		if (!utility::isPrefix<std::string>("include", directive))
+		{
+			break;
+		}
+
+		const std::string includedFile = utility::trim(directive.substr(7));
+		if (includedFile.empty() || (includedFile[0] != '<' && includedFile[0] != '"'))
+		{
+			break;
+		}
+
+		const size_t includedFileEnd = includedFile.find(includedFile[0] == '<' ? '>' : '"', 1);
+		if (includedFileEnd == std::string::npos)
+		{
+			break;
+		}
+
+		includeDirectives.push_back("#include " + includedFile.substr(0, includedFileEnd + 1));
+	}
+
+	return includeDirectives;
+}
+
+bool isAutomaticPchFilePath(const FilePath& filePath)
+{
+	return utility::isPrefix(automaticPchFileNamePrefix, filePath.fileName()) &&
+		filePath.extension() == L".pch";
 }
 
 std::shared_ptr<clang::tooling::JSONCompilationDatabase> loadCDB(
@@ -195,4 +587,9 @@ std::vector<std::wstring> getIncludePchFlags(const SourceGroupSettingsWithCxxPch
 
 	return {};
 }
+
+std::vector<std::wstring> getIncludePchFlags(const AutomaticPch& pch)
+{
+	return {L"-fallow-pch-with-compiler-errors", L"-include-pch", pch.outputFilePath.wstr()};
+}
 }	 // namespace utility
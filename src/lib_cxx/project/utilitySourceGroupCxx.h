@@ -2,9 +2,12 @@
 #define UTILITY_SOURCE_GROUP_CXX_H
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "FilePath.h"
+
 namespace clang
 {
 namespace tooling
@@ -14,18 +17,43 @@ class JSONCompilationDatabase;
 }	 // namespace clang
 
 class DialogView;
-class FilePath;
+class IndexerCommandCxx;
 class SourceGroupSettingsWithCxxPchOptions;
 class StorageProvider;
 class Task;
 
+struct RefreshInfo;
+
 namespace utility
 {
+// precompiled header shared by translation units with equal flags in the same directory that start
+// with the same includes
+struct AutomaticPch
+{
+	FilePath inputFilePath;
+	FilePath outputFilePath;
+	FilePath workingDirectory;
+	std::vector<std::wstring> compilerFlags;
+	std::vector<std::string> includeDirectives;
+	std::set<FilePath> sourceFilePaths;
+};
+
 std::shared_ptr<Task> createBuildPchTask(
 	const SourceGroupSettingsWithCxxPchOptions* settings,
 	std::vector<std::wstring> compilerFlags,
 	std::shared_ptr<StorageProvider> storageProvider,
 	std::shared_ptr<DialogView> dialogView);
+std::shared_ptr<Task> createBuildAutomaticPchTask(
+	const std::vector<AutomaticPch>& pchs,
+	const RefreshInfo& info,
+	std::shared_ptr<StorageProvider> storageProvider,
+	std::shared_ptr<DialogView> dialogView);
+
+std::vector<AutomaticPch> getAutomaticPchs(
+	const std::vector<std::shared_ptr<IndexerCommandCxx>>& indexerCommands,
+	const FilePath& pchDirectoryPath);
+std::vector<std::string> getLeadingIncludeDirectives(const FilePath& sourceFilePath);
+bool isAutomaticPchFilePath(const FilePath& filePath);
 
 std::shared_ptr<clang::tooling::JSONCompilationDatabase> loadCDB(
 	const FilePath& cdbPath, std::string* error = nullptr);
@@ -34,6 +62,7 @@ bool containsIncludePchFlag(const std::vector<std::string>& args);
 std::vector<std::wstring> getWithRemoveIncludePchFlag(const std::vector<std::wstring>& args);
 void removeIncludePchFlag(std::vector<std::wstring>& args);
 std::vector<std::wstring> getIncludePchFlags(const SourceGroupSettingsWithCxxPchOptions* settings);
+std::vector<std::wstring> getIncludePchFlags(const AutomaticPch& pch);
 }	 // namespace utility
 
 #endif	  // UTILITY_SOURCE_GROUP_CXX_H
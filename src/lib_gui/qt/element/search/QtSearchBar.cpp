@@ -4,6 +4,8 @@
 
 #include "MessageActivateFullTextSearch.h"
 #include "MessageActivateOverview.h"
+#include "MessageInterruptFullTextSearch.h"
+#include "MessageInterruptTrail.h"
 #include "MessageSearch.h"
 #include "MessageSearchAutocomplete.h"
 #include "QtSearchBarButton.h"
@@ -101,6 +103,8 @@ void QtSearchBar::refreshStyle()
 
 void QtSearchBar::homeButtonClicked()
 {
+	MessageInterruptFullTextSearch().dispatch();
+	MessageInterruptTrail().dispatch();
 	MessageActivateOverview().dispatch();
 }
 
@@ -111,10 +115,14 @@ void QtSearchBar::requestAutocomplete(const std::wstring& query, NodeTypeSet acc
 
 void QtSearchBar::requestSearch(const std::vector<SearchMatch>& matches, NodeTypeSet acceptedNodeTypes)
 {
+	MessageInterruptFullTextSearch().dispatch();
+	MessageInterruptTrail().dispatch();
 	MessageSearch(matches, acceptedNodeTypes).dispatch();
 }
 
 void QtSearchBar::requestFullTextSearch(const std::wstring& query, bool caseSensitive)
 {
+	MessageInterruptFullTextSearch().dispatch();
+	MessageInterruptTrail().dispatch();
 	MessageActivateFullTextSearch(query, caseSensitive).dispatch();
 }
@@ -12,6 +12,7 @@
 
 #include "ColorScheme.h"
 #include "MessageActivateTrail.h"
+#include "MessageInterruptTrail.h"
 #include "NodeTypeSet.h"
 #include "QtMainWindow.h"
 #include "QtSmartSearchBox.h"
@@ -338,6 +339,7 @@ QtCustomTrailView::QtCustomTrailView(ViewLayout* viewLayout)
 				m_slider->value() == m_slider->maximum() ? 0 : m_slider->value(),
 				m_horizontalButton->isChecked());
 
+			MessageInterruptTrail().dispatch();
 			m_controllerProxy.executeAsTaskWithArgs(&CustomTrailController::activateTrail, message);
 
 			setError("");
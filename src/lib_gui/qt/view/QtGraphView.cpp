@@ -20,6 +20,7 @@
 #include "MessageActivateTrail.h"
 #include "MessageCustomTrailShow.h"
 #include "MessageDeactivateEdge.h"
+#include "MessageInterruptTrail.h"
 #include "MessageRefreshUI.h"
 #include "MessageScrollGraph.h"
 #include "MessageStatus.h"
@@ -831,6 +832,7 @@ void QtGraphView::activateTrail(bool forward)
 	MessageActivateTrail message = getMessageActivateTrail(forward);
 	if (message.edgeTypes)
 	{
+		MessageInterruptTrail().dispatch();
 		message.dispatch();
 	}
 }
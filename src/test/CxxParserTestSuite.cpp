@@ -4,14 +4,20 @@
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
 
+#	include "ApplicationSettings.h"
+#	include "FileSystem.h"
+#	include "LogManager.h"
 #	include "TextAccess.h"
 #	include "utility.h"
 #	include "utilityString.h"
 
 #	include "CxxParser.h"
+#	include "IndexedFileRegistry.h"
 #	include "IndexerCommandCxx.h"
 #	include "IndexerStateInfo.h"
+#	include "IntermediateStorage.h"
 #	include "ParserClientImpl.h"
+#	include "PersistentStorage.h"
 
 #	include "TestFileRegister.h"
 #	include "TestIntermediateStorage.h"
@@ -33,6 +39,170 @@ std::shared_ptr<TestIntermediateStorage> parseCode(
 	storage->generateStringLists();
 	return storage;
 }
+
+class TestIndexedFileRegistry: public IndexedFileRegistry
+{
+public:
+	bool isFileIndexed(const FilePath& filePath, size_t preprocessorContextHash) override
+	{
+		checkedFilePaths.insert(filePath);
+		checkedPreprocessorContextHashes.insert(preprocessorContextHash);
+		return indexedFilePaths.find(filePath) != indexedFilePaths.end();
+	}
+
+	void addIndexedFiles(
+		const std::vector<FilePath>& filePaths, size_t preprocessorContextHash) override
+	{
+		indexedFilePaths.insert(filePaths.begin(), filePaths.end());
+	}
+
+	std::set<FilePath> indexedFilePaths;
+	std::set<FilePath> checkedFilePaths;
+	std::set<size_t> checkedPreprocessorContextHashes;
+};
+
+std::shared_ptr<TestIntermediateStorage> parseSkippedHeaderCode(
+	IndexedFileRegistry* indexedFileRegistry, size_t* preprocessorContextHash = nullptr)
+{
+	const FilePath sourceFilePath(L"data/CxxParserTestSuite/skipped_header/code.cpp");
+	std::shared_ptr<IndexerCommandCxx> indexerCommand = std::make_shared<IndexerCommandCxx>(
+		sourceFilePath,
+		std::set<FilePath> {FilePath(L"data/CxxParserTestSuite/skipped_header/")},
+		std::set<FilePathFilter>(),
+		std::set<FilePathFilter>(),
+		FilePath(L"."),
+		std::vector<std::wstring> {L"-std=c++1z", sourceFilePath.wstr()});
+	if (preprocessorContextHash)
+	{
+		*preprocessorContextHash = indexerCommand->getPreprocessorContextHash();
+	}
+
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo = std::make_shared<IndexerStateInfo>();
+	indexerStateInfo->indexedFileRegistry = indexedFileRegistry;
+
+	std::shared_ptr<TestIntermediateStorage> storage = std::make_shared<TestIntermediateStorage>();
+	CxxParser parser(
+		std::make_shared<ParserClientImpl>(storage.get()),
+		std::make_shared<TestFileRegister>(),
+		indexerStateInfo);
+	parser.buildIndex(indexerCommand);
+	storage->generateStringLists();
+	return storage;
+}
+
+FilePath getSkippedHeaderFilePath(const std::wstring& fileName)
+{
+	return FilePath(L"data/CxxParserTestSuite/skipped_header/" + fileName)
+		.makeAbsolute()
+		.makeCanonical();
+}
+
+// the elements are listed with their locations, e.g. "A <1:1 <1:7 1:7> 3:1>"
+bool containsElementNamed(const std::vector<std::wstring>& elements, const std::wstring& name)
+{
+	for (const std::wstring& element: elements)
+	{
+		if (utility::isPrefix(name + L" <", element))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool containsElementNamedAt(
+	const std::vector<std::wstring>& elements,
+	const std::wstring& name,
+	const std::wstring& tokenLocation)
+{
+	for (const std::wstring& element: elements)
+	{
+		if (utility::isPrefix(name + L" <", element) &&
+			element.find(tokenLocation) != std::wstring::npos)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// each symbol is declared again after its first declaration
+std::string getRedeclarationCode()
+{
+	return "class A;\n"
+		   "class A\n"
+		   "{\n"
+		   "public:\n"
+		   "	void foo();\n"
+		   "	static int s_count;\n"
+		   "};\n"
+		   "void A::foo()\n"
+		   "{\n"
+		   "}\n"
+		   "int A::s_count = 0;\n"
+		   "void bar();\n"
+		   "void bar()\n"
+		   "{\n"
+		   "	A a;\n"
+		   "	a.foo();\n"
+		   "}\n";
+}
+
+std::shared_ptr<TestIntermediateStorage> parseMainDefinitionsCode()
+{
+	const FilePath directoryPath(L"data/CxxParserTestSuite/main_definitions/");
+
+	std::shared_ptr<TestIntermediateStorage> storage = std::make_shared<TestIntermediateStorage>();
+	CxxParser parser(
+		std::make_shared<ParserClientImpl>(storage.get()),
+		std::make_shared<TestFileRegister>(),
+		std::make_shared<IndexerStateInfo>());
+	for (const std::wstring& fileName: {L"first.cpp", L"second.cpp"})
+	{
+		const FilePath sourceFilePath = directoryPath.getConcatenated(fileName);
+		parser.buildIndex(std::make_shared<IndexerCommandCxx>(
+			sourceFilePath,
+			std::set<FilePath> {directoryPath},
+			std::set<FilePathFilter>(),
+			std::set<FilePathFilter>(),
+			FilePath(L"."),
+			std::vector<std::wstring> {L"-std=c++1z", sourceFilePath.wstr()}));
+	}
+	storage->generateStringLists();
+	return storage;
+}
+
+class CacheStatsLogger: public Logger
+{
+public:
+	CacheStatsLogger(): Logger("CacheStatsLogger") {}
+
+	std::wstring lastCacheStats;
+
+private:
+	void logInfo(const LogMessage& message) override
+	{
+		if (utility::isPrefix<std::wstring>(L"Indexer - Cache stats: ", message.message))
+		{
+			lastCacheStats = message.message;
+		}
+	}
+
+	void logWarning(const LogMessage& message) override {}
+	void logError(const LogMessage& message) override {}
+};
+
+// reads the count from "..., 3 redeclaration hits, ..."
+size_t getRedeclarationCacheHits(const std::wstring& cacheStats)
+{
+	const size_t end = cacheStats.find(L" redeclaration hits");
+	const size_t begin = cacheStats.rfind(L", ", end);
+	if (end == std::wstring::npos || begin == std::wstring::npos)
+	{
+		return 0;
+	}
+	return std::stoul(cacheStats.substr(begin + 2, end - begin - 2));
+}
 }	 // namespace
 
 TEST_CASE("cxx parser finds global variable declaration")
@@ -3990,6 +4160,158 @@ TEST_CASE("cxx parser parses multiple files")
 	REQUIRE(storage.includes.size() == 1);
 }
 
+TEST_CASE("cxx parser records content of headers not indexed by other translation units")
+{
+	TestIndexedFileRegistry indexedFileRegistry;
+	std::shared_ptr<TestIntermediateStorage> storage = parseSkippedHeaderCode(&indexedFileRegistry);
+
+	REQUIRE(storage->errors.size() == 0);
+
+	REQUIRE(storage->classes.size() == 3);
+	REQUIRE(containsElementNamed(storage->classes, L"Header"));
+	REQUIRE(storage->macros.size() == 2);
+	REQUIRE(containsElementNamed(storage->macros, L"HEADER_MACRO"));
+	REQUIRE(storage->comments.size() == 2);
+}
+
+TEST_CASE("cxx parser skips content of header indexed by other translation unit")
+{
+	TestIndexedFileRegistry indexedFileRegistry;
+	indexedFileRegistry.indexedFilePaths.insert(getSkippedHeaderFilePath(L"header.h"));
+
+	size_t preprocessorContextHash = 0;
+	std::shared_ptr<TestIntermediateStorage> storage = parseSkippedHeaderCode(
+		&indexedFileRegistry, &preprocessorContextHash);
+
+	REQUIRE(storage->errors.size() == 0);
+
+	REQUIRE(
+		indexedFileRegistry.checkedPreprocessorContextHashes ==
+		std::set<size_t> {preprocessorContextHash});
+
+	// declarations, macros and comments of the skipped header are not recorded
+	REQUIRE(storage->classes.size() == 2);
+	REQUIRE(containsElementNamed(storage->classes, L"Source"));
+	REQUIRE(containsElementNamed(storage->classes, L"Nested"));
+	REQUIRE(!containsElementNamed(storage->classes, L"Header"));
+	REQUIRE(storage->macros.size() == 1);
+	REQUIRE(containsElementNamed(storage->macros, L"SOURCE_MACRO"));
+	REQUIRE(storage->comments.size() == 1);
+
+	// the skipped header is still recorded as indexed file and with its include edges
+	REQUIRE(storage->files.size() == 3);
+	bool headerFileIndexed = false;
+	for (const StorageFile& file: storage->getStorageFiles())
+	{
+		if (FilePath(file.filePath) == getSkippedHeaderFilePath(L"header.h"))
+		{
+			headerFileIndexed = file.indexed;
+		}
+	}
+	REQUIRE(headerFileIndexed);
+
+	REQUIRE(storage->includes.size() == 2);
+	REQUIRE(containsElementNamed(storage->includes, L"code.cpp -> header.h"));
+	REQUIRE(containsElementNamed(storage->includes, L"header.h -> nested.h"));
+}
+
+TEST_CASE("cxx parser never skips content of main file")
+{
+	TestIndexedFileRegistry indexedFileRegistry;
+	indexedFileRegistry.indexedFilePaths.insert(getSkippedHeaderFilePath(L"code.cpp"));
+	indexedFileRegistry.indexedFilePaths.insert(getSkippedHeaderFilePath(L"header.h"));
+	indexedFileRegistry.indexedFilePaths.insert(getSkippedHeaderFilePath(L"nested.h"));
+
+	std::shared_ptr<TestIntermediateStorage> storage = parseSkippedHeaderCode(&indexedFileRegistry);
+
+	REQUIRE(
+		indexedFileRegistry.checkedFilePaths.find(getSkippedHeaderFilePath(L"code.cpp")) ==
+		indexedFileRegistry.checkedFilePaths.end());
+
+	REQUIRE(storage->classes.size() == 1);
+	REQUIRE(containsElementNamed(storage->classes, L"Source"));
+	REQUIRE(storage->macros.size() == 1);
+	REQUIRE(containsElementNamed(storage->macros, L"SOURCE_MACRO"));
+	REQUIRE(storage->comments.size() == 1);
+	REQUIRE(storage->files.size() == 3);
+}
+
+TEST_CASE("cxx parser records redeclarations with symbol of first declaration")
+{
+	std::shared_ptr<TestIntermediateStorage> client = parseCode(getRedeclarationCode());
+
+	// each redeclaration gets the name that is resolved for it on its own
+	REQUIRE(containsElementNamedAt(client->classes, L"A", L"<1:7 1:7>"));
+	REQUIRE(containsElementNamedAt(client->classes, L"A", L"<2:7 2:7>"));
+	REQUIRE(containsElementNamedAt(client->methods, L"public void A::foo()", L"<5:7 5:9>"));
+	REQUIRE(containsElementNamedAt(client->methods, L"public void A::foo()", L"<8:9 8:11>"));
+	REQUIRE(
+		containsElementNamedAt(client->fields, L"public static int A::s_count", L"<6:13 6:19>"));
+	REQUIRE(
+		containsElementNamedAt(client->fields, L"public static int A::s_count", L"<11:8 11:14>"));
+	REQUIRE(containsElementNamedAt(client->functions, L"void bar()", L"<12:6 12:8>"));
+	REQUIRE(containsElementNamedAt(client->functions, L"void bar()", L"<13:6 13:8>"));
+
+	REQUIRE(
+		utility::containsElement<std::wstring>(client->typeUses, L"void bar() -> A <15:2 15:2>"));
+	REQUIRE(utility::containsElement<std::wstring>(
+		client->calls, L"void bar() -> void A::foo() <16:4 16:6>"));
+}
+
+TEST_CASE("cxx parser records main definitions of different files as different symbols")
+{
+	std::shared_ptr<TestIntermediateStorage> storage = parseMainDefinitionsCode();
+
+	REQUIRE(storage->errors.size() == 0);
+
+	// the declaration in the header is not the first declaration of the definitions
+	std::set<std::wstring> mainFileNames;
+	for (const StorageNode& node: storage->getStorageNodes())
+	{
+		for (const std::wstring& fileName: {L"main.h", L"first.cpp", L"second.cpp"})
+		{
+			if (node.serializedName.find(L".:main:." + fileName) != std::wstring::npos)
+			{
+				mainFileNames.insert(fileName);
+			}
+		}
+	}
+	REQUIRE(mainFileNames == std::set<std::wstring>({L"main.h", L"first.cpp", L"second.cpp"}));
+}
+
+TEST_CASE("cxx parser logs symbol cache stats with redeclaration hits")
+{
+	ApplicationSettings* appSettings = ApplicationSettings::getInstance().get();
+	const bool loggingEnabled = appSettings->getLoggingEnabled();
+	const bool verboseIndexerLoggingEnabled = appSettings->getVerboseIndexerLoggingEnabled();
+	const bool logManagerEnabled = LogManager::getInstance()->getLoggingEnabled();
+
+	std::shared_ptr<CacheStatsLogger> logger = std::make_shared<CacheStatsLogger>();
+	appSettings->setLoggingEnabled(true);
+	appSettings->setVerboseIndexerLoggingEnabled(true);
+	LogManager::getInstance()->setLoggingEnabled(true);
+	LogManager::getInstance()->addLogger(logger);
+
+	std::shared_ptr<TestIntermediateStorage> verboseClient = parseCode(getRedeclarationCode());
+
+	LogManager::getInstance()->removeLogger(logger);
+	LogManager::getInstance()->setLoggingEnabled(logManagerEnabled);
+	appSettings->setVerboseIndexerLoggingEnabled(verboseIndexerLoggingEnabled);
+	appSettings->setLoggingEnabled(loggingEnabled);
+
+	std::shared_ptr<TestIntermediateStorage> client = parseCode(getRedeclarationCode());
+
+	REQUIRE(utility::isPrefix<std::wstring>(
+		L"Indexer - Cache stats: decl symbols: ", logger->lastCacheStats));
+	REQUIRE(getRedeclarationCacheHits(logger->lastCacheStats) > 0);
+
+	// the verbose visitor records the same symbols
+	REQUIRE(verboseClient->classes == client->classes);
+	REQUIRE(verboseClient->methods == client->methods);
+	REQUIRE(verboseClient->fields == client->fields);
+	REQUIRE(verboseClient->functions == client->functions);
+	REQUIRE(verboseClient->calls == client->calls);
+}
 
 TEST_CASE("cxx parser finds braces of class decl")
 {
@@ -4218,6 +4540,123 @@ TEST_CASE("cxx parser finds location of block comment")
 	REQUIRE(utility::containsElement<std::wstring>(client->comments, L"comment <1:1 2:17>"));
 }
 
+TEST_CASE("benchmark cxx parser records nested template names", "[.][benchmark]")
+{
+	// every call refers to a member of a nested class template by its fully qualified name
+	std::string code =
+		"namespace a { namespace b {\n"
+		"template <typename T> struct Outer {\n"
+		"	template <typename U> struct Inner {\n"
+		"		template <typename V> struct Deep { static int get(V v) { return 0; } };\n"
+		"	};\n"
+		"};\n"
+		"} }\n";
+	const std::vector<std::string> types = {"int", "char", "float", "double", "long"};
+	for (size_t i = 0; i < 200; i++)
+	{
+		code += "int f" + std::to_string(i) + "() {\n";
+		for (size_t j = 0; j < 20; j++)
+		{
+			code += "	a::b::Outer<" + types[i % types.size()] + ">::Inner<" +
+				types[j % types.size()] + ">::Deep<" + types[(i + j) % types.size()] +
+				">::get(0);\n";
+		}
+		code += "	return 0;\n}\n";
+	}
+
+	BENCHMARK("parse 4000 nested template calls")
+	{
+		parseCode(code);
+	}
+
+	const FilePath sourceFilePath(L"data/CxxParserTestSuite/code.cpp");
+	std::shared_ptr<IndexerCommandCxx> indexerCommand = std::make_shared<IndexerCommandCxx>(
+		sourceFilePath,
+		std::set<FilePath> {FilePath(L"data/CxxParserTestSuite/")},
+		std::set<FilePathFilter>(),
+		std::set<FilePathFilter>(),
+		FilePath(L"."),
+		std::vector<std::wstring> {L"-std=c++1z", sourceFilePath.wstr()});
+
+	BENCHMARK("parse multiple files")
+	{
+		TestIntermediateStorage storage;
+		CxxParser parser(
+			std::make_shared<ParserClientImpl>(&storage),
+			std::make_shared<TestFileRegister>(),
+			std::make_shared<IndexerStateInfo>());
+		parser.buildIndex(indexerCommand);
+	}
+}
+
+TEST_CASE("benchmark indexing with storage performance profiles", "[.][benchmark]")
+{
+	// every translation unit is parsed and injected into a fresh index database like in indexing
+	std::vector<std::string> codes;
+	for (size_t i = 0; i < 100; i++)
+	{
+		std::string code = "namespace n" + std::to_string(i % 10) + " {\n";
+		for (size_t j = 0; j < 20; j++)
+		{
+			const std::string name = "C" + std::to_string(i) + "_" + std::to_string(j);
+			code += "class " + name + " {\npublic:\n	int get() const { return m_value; }\n" +
+				"	void set(int value) { m_value = value; }\nprivate:\n	int m_value;\n};\n" +
+				"int use" + name + "() { " + name + " c; c.set(1); return c.get(); }\n";
+		}
+		code += "}\n";
+		codes.push_back(code);
+	}
+
+	const FilePath indexDbPath(L"data/test.sqlite");
+	const FilePath bookmarkDbPath(L"data/testBookmarks.sqlite");
+
+	ApplicationSettings* appSettings = ApplicationSettings::getInstance().get();
+	const std::string journalMode = appSettings->getStorageBulkJournalMode();
+	const std::string synchronous = appSettings->getStorageBulkSynchronous();
+
+	const std::vector<std::pair<std::string, std::string>> profiles = {
+		{"DELETE", "FULL"}, {"WAL", "NORMAL"}, {"MEMORY", "OFF"}};
+	for (const std::pair<std::string, std::string>& profile: profiles)
+	{
+		appSettings->setStorageBulkJournalMode(profile.first);
+		appSettings->setStorageBulkSynchronous(profile.second);
+
+		BENCHMARK("index with journal_mode " + profile.first + " and synchronous " + profile.second)
+		{
+			{
+				PersistentStorage storage(indexDbPath, bookmarkDbPath);
+				storage.setup();
+				storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+				for (size_t i = 0; i < codes.size(); i++)
+				{
+					IntermediateStorage intermediateStorage;
+					CxxParser parser(
+						std::make_shared<ParserClientImpl>(&intermediateStorage),
+						std::make_shared<TestFileRegister>(),
+						std::make_shared<IndexerStateInfo>());
+					parser.buildIndex(
+						L"input" + std::to_wstring(i) + L".cc",
+						TextAccess::createFromString(codes[i]),
+						{L"-std=c++1z"});
+					storage.inject(&intermediateStorage);
+				}
+				storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+				storage.buildCaches();
+			}
+
+			for (const FilePath& filePath: utility::concat(
+					 std::vector<FilePath> {indexDbPath, bookmarkDbPath},
+					 PersistentStorage::getJournalFilePaths(indexDbPath)))
+			{
+				FileSystem::remove(filePath);
+			}
+		}
+	}
+
+	appSettings->setStorageBulkJournalMode(journalMode);
+	appSettings->setStorageBulkSynchronous(synchronous);
+}
+
 void _test_TEST()
 {
 	std::shared_ptr<TestIntermediateStorage> client = parseCode(
@@ -0,0 +1,93 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include "EdgeCache.h"
+#include "FilePath.h"
+#include "FileSystem.h"
+
+namespace
+{
+std::vector<StorageEdge> getTestEdges()
+{
+	return {
+		StorageEdge(7, 1, 10, 11),
+		StorageEdge(3, 2, 10, 12),
+		StorageEdge(5, 1, 12, 10),
+		StorageEdge(9, 4, 11, 11),
+		StorageEdge(4, 2, 13, 12)};
+}
+
+std::vector<Id> getEdgeIds(const std::vector<StorageEdge>& edges)
+{
+	std::vector<Id> edgeIds;
+	for (const StorageEdge& edge: edges)
+	{
+		edgeIds.push_back(edge.id);
+	}
+	return edgeIds;
+}
+}	 // namespace
+
+TEST_CASE("edge cache finds edges by id")
+{
+	EdgeCache cache;
+	REQUIRE(!cache.isBuilt());
+
+	cache.build(getTestEdges());
+	REQUIRE(cache.isBuilt());
+	REQUIRE(5 == cache.getEdgeCount());
+
+	const StorageEdge edge = cache.getEdgeById(5);
+	REQUIRE(5 == edge.id);
+	REQUIRE(1 == edge.type);
+	REQUIRE(12 == edge.sourceNodeId);
+	REQUIRE(10 == edge.targetNodeId);
+
+	REQUIRE(cache.isEdge(9));
+	REQUIRE(!cache.isEdge(10));
+	REQUIRE(0 == cache.getEdgeById(6).id);
+
+	REQUIRE(std::vector<Id>({3, 7}) == getEdgeIds(cache.getEdgesByIds({7, 6, 3, 7})));
+}
+
+TEST_CASE("edge cache finds edges of nodes")
+{
+	EdgeCache cache;
+	cache.build(getTestEdges());
+
+	REQUIRE(std::vector<Id>({3, 7}) == getEdgeIds(cache.getEdgesBySourceId(10)));
+	REQUIRE(std::vector<Id>({3, 4}) == getEdgeIds(cache.getEdgesByTargetId(12)));
+	REQUIRE(cache.getEdgesBySourceId(14).empty());
+
+	REQUIRE(
+		std::vector<Id>({3, 7, 9}) == getEdgeIds(cache.getEdgesBySourceIds({11, 10, 14, 10})));
+	REQUIRE(std::vector<Id>({5, 3, 4}) == getEdgeIds(cache.getEdgesByTargetIds({12, 10})));
+
+	// the edge from the node to itself is only returned once
+	REQUIRE(std::vector<Id>({7, 9}) == getEdgeIds(cache.getEdgesBySourceOrTargetId(11)));
+}
+
+TEST_CASE("edge cache is loaded from file for same storage time")
+{
+	const FilePath filePath(L"data/SQLiteTestSuite/test.sqlite_edges");
+
+	{
+		EdgeCache cache;
+		cache.build(getTestEdges());
+		REQUIRE(cache.save(filePath, "2020-01-01 10:00:00"));
+	}
+
+	EdgeCache cache;
+	REQUIRE(!cache.load(filePath, "2020-01-01 10:00:01"));
+	REQUIRE(!cache.isBuilt());
+
+	REQUIRE(cache.load(filePath, "2020-01-01 10:00:00"));
+	REQUIRE(5 == cache.getEdgeCount());
+	REQUIRE(std::vector<Id>({3, 7}) == getEdgeIds(cache.getEdgesBySourceId(10)));
+	REQUIRE(std::vector<Id>({5}) == getEdgeIds(cache.getEdgesByTargetId(10)));
+	REQUIRE(13 == cache.getEdgeById(4).sourceNodeId);
+
+	cache.clear();
+	FileSystem::remove(filePath);
+}
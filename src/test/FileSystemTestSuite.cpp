@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "FileSystem.h"
+#include "FileSystemSnapshot.h"
 #include "utility.h"
 
 namespace
@@ -132,6 +133,29 @@ TEST_CASE("find file infos with symlinks")
 #endif
 }
 
+TEST_CASE("snapshot of file paths contains stat data of existing files")
+{
+	const FilePath existingFilePath(L"data/FileSystemTestSuite/main.cpp");
+	const FilePath otherExistingFilePath(L"data/FileSystemTestSuite/src/test.h");
+	const FilePath missingFilePath(L"data/FileSystemTestSuite/missing.cpp");
+
+	const FileSystemSnapshot snapshot = FileSystemSnapshot::createForFilePaths(
+		{existingFilePath, missingFilePath, otherExistingFilePath});
+
+	REQUIRE(snapshot.getFileCount() == 2);
+	REQUIRE(snapshot.exists(existingFilePath));
+	REQUIRE(snapshot.exists(otherExistingFilePath));
+	REQUIRE_FALSE(snapshot.exists(missingFilePath));
+
+	REQUIRE(
+		snapshot.getFileByteSize(existingFilePath) ==
+		FileSystem::getFileByteSize(existingFilePath));
+	REQUIRE(
+		snapshot.getFileInfo(existingFilePath).lastWriteTime.toString() ==
+		FileSystem::getLastWriteTime(existingFilePath).toString());
+	REQUIRE(snapshot.getFileInfo(missingFilePath).path.empty());
+}
+
 TEST_CASE("find symlinked directories")
 {
 #ifndef _WIN32
@@ -0,0 +1,214 @@
+#include "catch.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "FileSystem.h"
+#include "FullTextSearchIndex.h"
+#include "SuffixArray.h"
+#include "TextAccess.h"
+#include "utilityString.h"
+
+namespace
+{
+void requireSameSuffixArray(const std::wstring& text)
+{
+	SuffixArray sais(text, SuffixArray::BUILD_ALGORITHM_SAIS);
+	SuffixArray prefixDoubling(text, SuffixArray::BUILD_ALGORITHM_PREFIX_DOUBLING);
+
+	REQUIRE(sais.getArray() == prefixDoubling.getArray());
+	REQUIRE(sais.getLCP() == prefixDoubling.getLCP());
+}
+
+std::wstring getRandomText(std::mt19937& generator, size_t length, wchar_t alphabetSize)
+{
+	std::wstring text;
+	for (size_t i = 0; i < length; i++)
+	{
+		text.push_back(L'a' + static_cast<wchar_t>(generator() % alphabetSize));
+	}
+	return text;
+}
+
+std::vector<std::wstring> getSampleFileTexts()
+{
+	std::vector<std::wstring> texts;
+	for (const FilePath& filePath: FileSystem::getFilePathsFromDirectory(
+			 FilePath(L"data/JavaIndexSampleProjectsTestSuite/JavaSymbolSolver060/src/"
+					  L"java-symbol-solver-core/com/github/javaparser/symbolsolver/"
+					  L"javaparsermodel"),
+			 {L".java"}))
+	{
+		texts.push_back(utility::decodeFromUtf8(TextAccess::createFromFile(filePath)->getText()));
+	}
+	return texts;
+}
+}	 // namespace
+
+TEST_CASE("suffix array of single character")
+{
+	SuffixArray array(L"a");
+
+	REQUIRE(array.getArray() == std::vector<int>({0}));
+	REQUIRE(array.getLCP() == std::vector<int>({0}));
+}
+
+TEST_CASE("suffix array is sorted case insensitive")
+{
+	SuffixArray array(L"BaNaNa");
+
+	REQUIRE(array.getArray() == std::vector<int>({5, 3, 1, 0, 4, 2}));
+	REQUIRE(array.getLCP() == std::vector<int>({1, 3, 0, 0, 2, 0}));
+}
+
+TEST_CASE("suffix array of repeated character")
+{
+	SuffixArray array(std::wstring(100, L'x'));
+
+	for (int i = 0; i < 100; i++)
+	{
+		REQUIRE(array.getArray()[i] == 99 - i);
+	}
+}
+
+TEST_CASE("suffix array built without text matches suffix array")
+{
+	for (const std::wstring& text: {L"BaNaNa", L"mississippi", L"int foo = 0; int bar = Foo();"})
+	{
+		REQUIRE(SuffixArray::buildArray(text) == SuffixArray(text).getArray());
+		REQUIRE(
+			SuffixArray::buildArray(text, SuffixArray::BUILD_ALGORITHM_PREFIX_DOUBLING) ==
+			SuffixArray(text, SuffixArray::BUILD_ALGORITHM_PREFIX_DOUBLING).getArray());
+	}
+}
+
+TEST_CASE("sa-is suffix array matches prefix doubling for edge cases")
+{
+	requireSameSuffixArray(L"a");
+	requireSameSuffixArray(L"ab");
+	requireSameSuffixArray(L"ba");
+	requireSameSuffixArray(L"mississippi");
+	requireSameSuffixArray(L"abracadabra");
+	requireSameSuffixArray(std::wstring(1000, L' '));
+	requireSameSuffixArray(L"\U00010000\xFFFF\x0001\U00010000\x0001");
+}
+
+TEST_CASE("sa-is suffix array matches prefix doubling for random texts")
+{
+	std::mt19937 generator(42);
+	for (size_t i = 0; i < 500; i++)
+	{
+		requireSameSuffixArray(getRandomText(generator, 1 + generator() % 200, 1 + generator() % 4));
+	}
+}
+
+TEST_CASE("sa-is suffix array matches prefix doubling for source files")
+{
+	for (const std::wstring& text: getSampleFileTexts())
+	{
+		requireSameSuffixArray(text);
+	}
+}
+
+TEST_CASE("suffix array finds all occurrences of term")
+{
+	SuffixArray array(L"int foo = 0; int bar = Foo(); // FOO");
+
+	REQUIRE(array.searchForTerm(L"foo") == std::vector<int>({4, 23, 33}));
+	REQUIRE(array.searchForTerm(L"INT") == std::vector<int>({0, 13}));
+	REQUIRE(array.searchForTerm(L"baz").empty());
+}
+
+TEST_CASE("fulltext search index finds term case insensitive in original text")
+{
+	FullTextSearchIndex index;
+	index.addFile(1, L"int foo = 0; int bar = Foo(); // FOO");
+
+	const std::vector<FullTextSearchResult> results = index.searchForTerm(L"fOo");
+	REQUIRE(results.size() == 1);
+	REQUIRE(results[0].positions == std::vector<int>({4, 23, 33}));
+	REQUIRE(index.searchForTerm(L"INT")[0].positions == std::vector<int>({0, 13}));
+	REQUIRE(index.searchForTerm(L"baz").empty());
+}
+
+TEST_CASE("fulltext search index converts positions to line and column")
+{
+	FullTextSearchIndex index;
+	index.addFile(1, L"int foo;\nFOO bar\n\nfoo\nfo\no");
+
+	std::vector<FullTextSearchResult> results = index.searchForTerm(L"foo");
+	REQUIRE(results.size() == 1);
+
+	std::vector<ParseLocation> locations = index.getLocationsForResult(results[0], L"foo", false);
+	REQUIRE(locations.size() == 3);
+	REQUIRE(locations[0].startLineNumber == 1);
+	REQUIRE(locations[0].startColumnNumber == 5);
+	REQUIRE(locations[0].endLineNumber == 1);
+	REQUIRE(locations[0].endColumnNumber == 7);
+	REQUIRE(locations[1].startLineNumber == 2);
+	REQUIRE(locations[1].startColumnNumber == 1);
+	REQUIRE(locations[2].startLineNumber == 4);
+	REQUIRE(locations[2].endColumnNumber == 3);
+
+	REQUIRE(index.getLocationsForResult(results[0], L"FOO", true).size() == 1);
+
+	results = index.searchForTerm(L"o\no");
+	REQUIRE(results.size() == 1);
+
+	locations = index.getLocationsForResult(results[0], L"o\no", true);
+	REQUIRE(locations.size() == 1);
+	REQUIRE(locations[0].startLineNumber == 5);
+	REQUIRE(locations[0].startColumnNumber == 2);
+	REQUIRE(locations[0].endLineNumber == 6);
+	REQUIRE(locations[0].endColumnNumber == 1);
+}
+
+TEST_CASE("fulltext search index updates and removes files by id")
+{
+	FullTextSearchIndex index;
+	index.addFile(1, L"foo");
+	index.addFile(2, L"foo bar");
+	index.addFile(3, L"bar foo");
+
+	index.updateFile(2, L"bar");
+	index.removeFile(1);
+
+	REQUIRE_FALSE(index.hasFile(1));
+	REQUIRE(index.hasFile(2));
+	REQUIRE(index.hasFile(3));
+	REQUIRE(index.fileCount() == 2);
+
+	std::vector<FullTextSearchResult> results = index.searchForTerm(L"foo");
+	REQUIRE(results.size() == 1);
+	REQUIRE(results[0].fileId == 3);
+	REQUIRE(index.getLocationsForResult(results[0], L"foo", false).size() == 1);
+
+	results = index.searchForTerm(L"bar");
+	REQUIRE(results.size() == 2);
+	for (const FullTextSearchResult& result: results)
+	{
+		std::vector<ParseLocation> locations = index.getLocationsForResult(result, L"bar", false);
+		REQUIRE(locations.size() == 1);
+		REQUIRE(locations[0].startColumnNumber == 1);
+	}
+}
+
+TEST_CASE("benchmark suffix array construction", "[.][benchmark]")
+{
+	std::wstring text;
+	for (const std::wstring& fileText: getSampleFileTexts())
+	{
+		text += fileText;
+	}
+
+	BENCHMARK("sa-is")
+	{
+		SuffixArray array(text, SuffixArray::BUILD_ALGORITHM_SAIS);
+	}
+
+	BENCHMARK("prefix doubling")
+	{
+		SuffixArray array(text, SuffixArray::BUILD_ALGORITHM_PREFIX_DOUBLING);
+	}
+}
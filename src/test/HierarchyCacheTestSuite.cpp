@@ -0,0 +1,93 @@
+#include "catch.hpp"
+
+#include <set>
+#include <vector>
+
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "HierarchyCache.h"
+
+namespace
+{
+HierarchyCacheFileConnection createConnection(
+	Id edgeId, Id fromId, Id toId, bool sourceVisible, bool targetImplicit)
+{
+	HierarchyCacheFileConnection connection = HierarchyCacheFileConnection();
+	connection.edgeId = edgeId;
+	connection.fromId = fromId;
+	connection.toId = toId;
+	connection.sourceVisible = sourceVisible;
+	connection.targetImplicit = targetImplicit;
+	return connection;
+}
+
+void buildTestCache(HierarchyCache& cache)
+{
+	// namespace 1 contains class 2 with the members 3 and 4, class 5 derives from class 2
+	cache.build(
+		{createConnection(10, 1, 2, false, false),
+		 createConnection(11, 2, 3, true, false),
+		 createConnection(12, 2, 4, true, true)},
+		{{13, 5, 2}},
+		{{11, 101}, {12, 100}});
+}
+
+void requireTestCache(const HierarchyCache& cache)
+{
+	REQUIRE(2 == cache.getLastVisibleParentNodeId(3));
+	REQUIRE(2 == cache.getLastVisibleParentNodeId(2));
+	REQUIRE(!cache.nodeIsVisible(1));
+	REQUIRE(cache.nodeIsImplicit(4));
+	REQUIRE(1 == cache.getFirstChildIdsCountForNodeId(2));
+
+	std::set<Id> nodeIds;
+	std::set<Id> edgeIds;
+	cache.addAllChildIdsForNodeId(2, &nodeIds, &edgeIds);
+	REQUIRE(std::set<Id>({3, 4}) == nodeIds);
+	REQUIRE(std::set<Id>({11, 12}) == edgeIds);
+
+	REQUIRE(1 == cache.getInheritanceEdgesForNodeId(5, {2}).size());
+
+	REQUIRE(101 == cache.getMemberEdgeOrderId(11));
+	REQUIRE(100 == cache.getMemberEdgeOrderId(12));
+	REQUIRE(10 == cache.getMemberEdgeOrderId(10));
+}
+}	 // namespace
+
+TEST_CASE("hierarchy cache is built from connections")
+{
+	HierarchyCache cache;
+	buildTestCache(cache);
+	requireTestCache(cache);
+
+	cache.clear();
+	REQUIRE(!cache.nodeHasChildren(2));
+	REQUIRE(11 == cache.getMemberEdgeOrderId(11));
+}
+
+TEST_CASE("hierarchy cache is loaded from file for same storage time")
+{
+	const FilePath filePath(L"data/SQLiteTestSuite/test.sqlite_hierarchy");
+
+	{
+		HierarchyCache cache;
+		buildTestCache(cache);
+		REQUIRE(HierarchyCache::save(
+			filePath,
+			"2020-01-01 10:00:00",
+			{createConnection(10, 1, 2, false, false),
+			 createConnection(11, 2, 3, true, false),
+			 createConnection(12, 2, 4, true, true)},
+			{{13, 5, 2}},
+			{{11, 101}, {12, 100}}));
+	}
+
+	HierarchyCache cache;
+	REQUIRE(!cache.load(filePath, "2020-01-01 10:00:01"));
+	REQUIRE(!cache.nodeHasChildren(2));
+
+	REQUIRE(cache.load(filePath, "2020-01-01 10:00:00"));
+	requireTestCache(cache);
+
+	FileSystem::remove(filePath);
+}
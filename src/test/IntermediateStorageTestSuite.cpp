@@ -0,0 +1,266 @@
+#include "catch.hpp"
+
+#include <string>
+
+#include "Edge.h"
+#include "IntermediateStorage.h"
+#include "NameHierarchy.h"
+#include "NodeType.h"
+#include "ParseLocation.h"
+#include "ParserClientImpl.h"
+
+namespace
+{
+// records the name the way it was done before the names were interned, by serializing and adding
+// every prefix of the name until one is already known
+Id addNodeHierarchyOfAllPrefixes(IntermediateStorage& storage, const NameHierarchy& nameHierarchy)
+{
+	Id childNodeId = 0;
+	Id firstNodeId = 0;
+	for (size_t i = nameHierarchy.size(); i > 0; i--)
+	{
+		std::pair<Id, bool> ret = storage.addNode(StorageNodeData(
+			NodeType::typeToInt(NodeType::NODE_SYMBOL),
+			NameHierarchy::serializeRange(nameHierarchy, 0, i)));
+
+		if (!firstNodeId)
+		{
+			firstNodeId = ret.first;
+		}
+
+		if (childNodeId != 0)
+		{
+			storage.addEdge(StorageEdgeData(Edge::EDGE_MEMBER, ret.first, childNodeId));
+		}
+
+		if (!ret.second)
+		{
+			return firstNodeId;
+		}
+
+		childNodeId = ret.first;
+	}
+	return firstNodeId;
+}
+
+NameHierarchy createNameHierarchy(const std::vector<std::wstring>& names)
+{
+	return NameHierarchy(names, NAME_DELIMITER_CXX);
+}
+
+std::vector<std::wstring> getNodeStrings(const IntermediateStorage& storage)
+{
+	std::vector<std::wstring> nodeStrings;
+	for (const StorageNode& node: storage.getStorageNodes())
+	{
+		nodeStrings.push_back(
+			std::to_wstring(node.id) + L" " + std::to_wstring(node.type) + L" " +
+			node.serializedName);
+	}
+	return nodeStrings;
+}
+
+std::vector<std::wstring> getEdgeStrings(const IntermediateStorage& storage)
+{
+	std::vector<std::wstring> edgeStrings;
+	for (const StorageEdge& edge: storage.getStorageEdges())
+	{
+		edgeStrings.push_back(
+			std::to_wstring(edge.id) + L" " + std::to_wstring(edge.type) + L" " +
+			std::to_wstring(edge.sourceNodeId) + L" -> " + std::to_wstring(edge.targetNodeId));
+	}
+	return edgeStrings;
+}
+}	 // namespace
+
+TEST_CASE("intermediate storage returns same id for duplicate node")
+{
+	IntermediateStorage storage;
+
+	const std::pair<Id, bool> first = storage.addNode(StorageNodeData(0, L"a"));
+	const std::pair<Id, bool> second = storage.addNode(StorageNodeData(0, L"b"));
+	const std::pair<Id, bool> duplicate = storage.addNode(StorageNodeData(0, L"a"));
+
+	REQUIRE(first.second);
+	REQUIRE(second.second);
+	REQUIRE(!duplicate.second);
+	REQUIRE(first.first == duplicate.first);
+	REQUIRE(first.first != second.first);
+	REQUIRE(2 == storage.getStorageNodes().size());
+}
+
+TEST_CASE("intermediate storage returns same id for duplicate edge and source location")
+{
+	IntermediateStorage storage;
+
+	const Id sourceId = storage.addNode(StorageNodeData(0, L"a")).first;
+	const Id targetId = storage.addNode(StorageNodeData(0, L"b")).first;
+
+	const Id edgeId = storage.addEdge(StorageEdgeData(1, sourceId, targetId));
+	REQUIRE(edgeId == storage.addEdge(StorageEdgeData(1, sourceId, targetId)));
+	REQUIRE(edgeId != storage.addEdge(StorageEdgeData(2, sourceId, targetId)));
+	REQUIRE(2 == storage.getStorageEdges().size());
+
+	const StorageSourceLocationData location(sourceId, 1, 2, 1, 5, 0);
+	const Id locationId = storage.addSourceLocation(location);
+	REQUIRE(locationId == storage.addSourceLocation(location));
+	REQUIRE(
+		locationId != storage.addSourceLocation(StorageSourceLocationData(sourceId, 1, 2, 1, 5, 1)));
+	REQUIRE(2 == storage.getStorageSourceLocations().size());
+}
+
+TEST_CASE("intermediate storage removes duplicate occurrences")
+{
+	IntermediateStorage storage;
+
+	storage.addOccurrence(StorageOccurrence(2, 1));
+	storage.addOccurrence(StorageOccurrence(1, 1));
+	storage.addOccurrences({StorageOccurrence(2, 1), StorageOccurrence(1, 2)});
+
+	const std::vector<StorageOccurrence>& occurrences = storage.getStorageOccurrences();
+	REQUIRE(3 == occurrences.size());
+	REQUIRE(1 == occurrences[0].elementId);
+	REQUIRE(1 == occurrences[0].sourceLocationId);
+	REQUIRE(1 == occurrences[1].elementId);
+	REQUIRE(2 == occurrences[1].sourceLocationId);
+	REQUIRE(2 == occurrences[2].elementId);
+
+	storage.addOccurrence(StorageOccurrence(1, 1));
+	REQUIRE(3 == storage.getStorageOccurrences().size());
+}
+
+TEST_CASE("intermediate storage returns sorted local symbols and source locations")
+{
+	IntermediateStorage storage;
+
+	const Id idB = storage.addLocalSymbol(StorageLocalSymbolData(L"b"));
+	const Id idA = storage.addLocalSymbol(StorageLocalSymbolData(L"a"));
+	REQUIRE(idB == storage.addLocalSymbol(StorageLocalSymbolData(L"b")));
+
+	const std::vector<StorageLocalSymbol>& localSymbols = storage.getStorageLocalSymbols();
+	REQUIRE(2 == localSymbols.size());
+	REQUIRE(L"a" == localSymbols[0].name);
+	REQUIRE(idA == localSymbols[0].id);
+	REQUIRE(L"b" == localSymbols[1].name);
+	REQUIRE(idB == localSymbols[1].id);
+
+	// lookups still work after the symbols got sorted
+	REQUIRE(idA == storage.addLocalSymbol(StorageLocalSymbolData(L"a")));
+	REQUIRE(idB == storage.addLocalSymbol(StorageLocalSymbolData(L"b")));
+
+	storage.addSourceLocation(StorageSourceLocationData(1, 5, 1, 5, 2, 0));
+	storage.addSourceLocation(StorageSourceLocationData(1, 2, 1, 2, 2, 0));
+
+	const std::vector<StorageSourceLocation>& locations = storage.getStorageSourceLocations();
+	REQUIRE(2 == locations.size());
+	REQUIRE(2 == locations[0].startLine);
+	REQUIRE(5 == locations[1].startLine);
+}
+
+TEST_CASE("parser client records same nodes and member edges as serializing every prefix")
+{
+	IntermediateStorage storage;
+	ParserClientImpl client(&storage);
+	IntermediateStorage expectedStorage;
+
+	std::vector<Id> ids;
+	std::vector<Id> expectedIds;
+	const auto recordSymbol = [&](const NameHierarchy& nameHierarchy) {
+		ids.push_back(client.recordSymbol(nameHierarchy));
+		expectedIds.push_back(addNodeHierarchyOfAllPrefixes(expectedStorage, nameHierarchy));
+	};
+	const auto addNode = [&](const NameHierarchy& nameHierarchy) {
+		const StorageNodeData nodeData(
+			NodeType::typeToInt(NodeType::NODE_SYMBOL), NameHierarchy::serialize(nameHierarchy));
+		ids.push_back(storage.addNode(nodeData).first);
+		expectedIds.push_back(expectedStorage.addNode(nodeData).first);
+	};
+
+	NameHierarchy functionName = createNameHierarchy({L"a", L"b"});
+	functionName.push(NameElement(L"f", L"void", L"()"));
+	NameHierarchy overloadName = createNameHierarchy({L"a", L"b"});
+	overloadName.push(NameElement(L"f", L"void", L"(int)"));
+
+	// names sharing prefixes of different lengths
+	recordSymbol(createNameHierarchy({L"a", L"b", L"c"}));
+	recordSymbol(createNameHierarchy({L"a", L"b", L"d"}));
+	recordSymbol(createNameHierarchy({L"a", L"e"}));
+	recordSymbol(functionName);
+	recordSymbol(overloadName);
+	recordSymbol(createNameHierarchy({L"a", L"b", L"c"}));
+
+	// a prefix recorded after the longer name and a longer name recorded after its prefix
+	recordSymbol(createNameHierarchy({L"a", L"b"}));
+	recordSymbol(createNameHierarchy({L"g"}));
+	recordSymbol(createNameHierarchy({L"g", L"h", L"i"}));
+
+	// names whose nodes were added without recording them as symbols
+	addNode(createNameHierarchy({L"x", L"y"}));
+	recordSymbol(createNameHierarchy({L"x", L"y", L"z"}));
+	recordSymbol(createNameHierarchy({L"x", L"y", L"w"}));
+	recordSymbol(createNameHierarchy({L"x", L"y"}));
+	addNode(createNameHierarchy({L"p", L"q"}));
+	recordSymbol(createNameHierarchy({L"p", L"q"}));
+	recordSymbol(createNameHierarchy({L"p", L"q", L"r"}));
+	addNode(createNameHierarchy({L"a", L"b", L"j"}));
+	recordSymbol(createNameHierarchy({L"a", L"b", L"j", L"k"}));
+
+	REQUIRE(ids == expectedIds);
+	REQUIRE(getNodeStrings(storage) == getNodeStrings(expectedStorage));
+	REQUIRE(getEdgeStrings(storage) == getEdgeStrings(expectedStorage));
+}
+
+TEST_CASE("benchmark recording translation unit", "[.][benchmark]")
+{
+	// replays the records of a synthetic translation unit that references the symbols of its
+	// headers over and over, which is what makes deduplication expensive for real projects
+	const size_t fileCount = 50;
+	const size_t symbolCount = 200;
+	const size_t referenceCount = 20000;
+
+	size_t locationCount = 0;
+	BENCHMARK("record " + std::to_string(referenceCount) + " references")
+	{
+		IntermediateStorage storage;
+		ParserClientImpl client(&storage);
+
+		std::vector<Id> fileIds;
+		for (size_t i = 0; i < fileCount; i++)
+		{
+			fileIds.push_back(
+				client.recordFile(FilePath(L"path/to/header_" + std::to_wstring(i) + L".h"), true));
+		}
+
+		for (size_t i = 0; i < referenceCount; i++)
+		{
+			const Id fileId = fileIds[i % fileCount];
+			const size_t line = i / fileCount + 1;
+
+			NameHierarchy contextName(NAME_DELIMITER_CXX);
+			contextName.push(L"some_namespace");
+			contextName.push(L"function_" + std::to_wstring(i % symbolCount));
+			const Id contextId = client.recordSymbol(contextName);
+			client.recordSymbolKind(contextId, SYMBOL_FUNCTION);
+			client.recordLocation(
+				contextId, ParseLocation(fileId, line, 1, line, 10), ParseLocationType::TOKEN);
+
+			NameHierarchy referencedName(NAME_DELIMITER_CXX);
+			referencedName.push(L"some_namespace");
+			referencedName.push(L"SomeType_" + std::to_wstring((i * 7) % symbolCount));
+			const Id referencedId = client.recordSymbol(referencedName);
+			client.recordSymbolKind(referencedId, SYMBOL_CLASS);
+
+			client.recordReference(
+				REFERENCE_TYPE_USAGE,
+				referencedId,
+				contextId,
+				ParseLocation(fileId, line, 12, line, 20));
+			client.recordLocalSymbol(
+				L"local_" + std::to_wstring(i % symbolCount),
+				ParseLocation(fileId, line, 22, line, 30));
+		}
+
+		locationCount = storage.getStorageSourceLocations().size();
+	}
+	REQUIRE(locationCount > 0);
+}
@@ -1,6 +1,9 @@
 #include "catch.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 #include "Message.h"
@@ -108,6 +111,39 @@ private:
 	}
 };
 
+class LatencyMessageListener: public MessageListener<TestMessage>
+{
+public:
+	// returns the time from dispatching the message until the handler was called
+	std::chrono::microseconds dispatchAndWait()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_handled = false;
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		TestMessage().dispatch();
+
+		m_condition.wait(lock, [this]() { return m_handled; });
+		return std::chrono::duration_cast<std::chrono::microseconds>(m_handleTime - start);
+	}
+
+private:
+	virtual void handleMessage(TestMessage* message)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_handleTime = std::chrono::steady_clock::now();
+			m_handled = true;
+		}
+		m_condition.notify_all();
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::chrono::steady_clock::time_point m_handleTime;
+	bool m_handled = false;
+};
+
 void waitForThread()
 {
 	static const int THREAD_WAIT_TIME_MS = 20;
@@ -237,3 +273,23 @@ TEST_CASE("listener registration to front and back within message handling")
 	REQUIRE(2 == listener.m_listeners[3]->m_messageCount);
 	REQUIRE(2 == listener.m_listeners[4]->m_messageCount);
 }
+
+TEST_CASE("benchmark message dispatch to handler latency", "[.][benchmark]")
+{
+	MessageQueue::getInstance()->startMessageLoopThreaded();
+
+	LatencyMessageListener listener;
+	std::chrono::microseconds maxLatency(0);
+
+	BENCHMARK("100 dispatches")
+	{
+		for (size_t i = 0; i < 100; i++)
+		{
+			maxLatency = std::max(maxLatency, listener.dispatchAndWait());
+		}
+	}
+
+	MessageQueue::getInstance()->stopMessageLoop();
+
+	WARN("max dispatch to handler latency: " << maxLatency.count() << " us");
+}
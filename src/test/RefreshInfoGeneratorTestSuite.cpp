@@ -1070,3 +1070,48 @@ TEST_CASE(
 	}
 	cleanup();
 }
+
+TEST_CASE("does not clear indexed file that was touched without changing its content")
+{
+	cleanup();
+	{
+		const FilePath touchedFilePath = m_sourceFolder.getConcatenated(L"touched_file.cpp");
+		const FilePath changedFilePath = m_sourceFolder.getConcatenated(L"changed_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(std::shared_ptr<SourceGroupTest>(
+			new SourceGroupTest({touchedFilePath, changedFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		// the content hashes are taken when the files are added to the storage
+		addFileToFileSystem(touchedFilePath);
+		addVeryOldFileToStorage(touchedFilePath, true, true, storage);
+		addFileToFileSystem(changedFilePath);
+		addVeryOldFileToStorage(changedFilePath, true, true, storage);
+
+		{
+			std::ofstream file;
+			file.open(changedFilePath.str());
+			file << "This is some file CONTENT.\n";
+		}
+
+		storage->buildCaches();
+
+		const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			sourceGroups, storage);
+
+		REQUIRE(REFRESH_UPDATED_FILES == refreshInfo.mode);
+		REQUIRE(0 == refreshInfo.nonIndexedFilesToClear.size());
+		REQUIRE(1 == refreshInfo.filesToClear.size());
+		REQUIRE(1 == refreshInfo.filesToIndex.size());
+
+		REQUIRE(utility::containsElement<FilePath>(
+			utility::toVector(refreshInfo.filesToClear), changedFilePath));
+		REQUIRE(utility::containsElement<FilePath>(
+			utility::toVector(refreshInfo.filesToIndex), changedFilePath));
+	}
+	cleanup();
+}
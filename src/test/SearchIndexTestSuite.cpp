@@ -1,5 +1,9 @@
 #include "catch.hpp"
 
+#include <string>
+
+#include "FilePath.h"
+#include "FileSystem.h"
 #include "NameHierarchy.h"
 #include "SearchIndex.h"
 #include "utility.h"
@@ -91,3 +95,103 @@ TEST_CASE("search index rates higher on consecutive letters")
 	REQUIRE(L"ocbcabc" == results[0].text);
 	REQUIRE(L"oaabbcc" == results[1].text);
 }
+
+TEST_CASE("search index finds elements of each type sharing a name")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo", NodeType::NODE_NAMESPACE);
+	index.addNode(2, L"foo", NodeType::NODE_FUNCTION);
+	index.addNode(3, L"foobar", NodeType::NODE_CLASS);
+	index.finishSetup();
+
+	std::vector<SearchResult> results = index.search(
+		L"foo", NodeTypeSet(NodeType(NodeType::NODE_FUNCTION)), 0);
+
+	REQUIRE(1 == results.size());
+	REQUIRE(1 == results[0].elementIds.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 2));
+}
+
+TEST_CASE("search index finds names with non ascii characters")
+{
+	SearchIndex index;
+	index.addNode(1, L"gr\u00fc\u00dfe::stra\u00dfe");
+	index.addNode(2, L"gruss::strasse");
+	index.finishSetup();
+
+	std::vector<SearchResult> results = index.search(L"\u00df", NodeTypeSet::all(), 0);
+
+	REQUIRE(1 == results.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 1));
+}
+
+TEST_CASE("search index is loaded from file for same storage time")
+{
+	const FilePath filePath(L"data/SQLiteTestSuite/test.sqlite_symbols");
+
+	{
+		SearchIndex index;
+		index.addNode(1, L"foo::bar", NodeType::NODE_CLASS);
+		index.addNode(2, L"foo::baz", NodeType::NODE_FUNCTION);
+		index.finishSetup();
+		REQUIRE(index.save(filePath, "2020-01-01 10:00:00"));
+	}
+
+	SearchIndex index;
+	REQUIRE(!index.load(filePath, "2020-01-01 10:00:01"));
+	REQUIRE(index.search(L"ba", NodeTypeSet::all(), 0).empty());
+
+	REQUIRE(index.load(filePath, "2020-01-01 10:00:00"));
+	std::vector<SearchResult> results = index.search(L"ba", NodeTypeSet::all(), 0);
+	REQUIRE(2 == results.size());
+
+	results = index.search(L"ba", NodeTypeSet(NodeType(NodeType::NODE_FUNCTION)), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(L"foo::baz" == results[0].text);
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 2));
+
+	index.clear();
+	FileSystem::remove(filePath);
+}
+
+TEST_CASE("benchmark search index keystrokes", "[.][benchmark]")
+{
+	SearchIndex index;
+
+	// names shaped like qualified C++ symbols with many shared prefixes
+	const std::vector<std::wstring> words = {
+		L"Storage", L"Search", L"Index", L"Node", L"Edge", L"Graph", L"Token", L"Source",
+		L"Location", L"File", L"Component", L"Controller", L"View", L"Message", L"Task"};
+	Id id = 1;
+	for (size_t n = 0; n < 20; n++)
+	{
+		for (size_t c = 0; c < 500; c++)
+		{
+			const std::wstring className = words[c % words.size()] +
+				words[(c / words.size()) % words.size()] + std::to_wstring(c);
+			for (size_t m = 0; m < 20; m++)
+			{
+				index.addNode(
+					id++,
+					L"ns" + std::to_wstring(n) + L"::" + className + L"::get" +
+						words[(c + m) % words.size()] + std::to_wstring(m));
+			}
+		}
+	}
+
+	BENCHMARK("build 200000 names")
+	{
+		index.finishSetup();
+	}
+
+	WARN("nodes: " << index.getNodeCount() << " edges: " << index.getEdgeCount());
+
+	const std::wstring query = L"searchnodeget";
+	for (size_t i = 1; i <= query.size(); i += 4)
+	{
+		BENCHMARK("keystroke " + std::to_string(i))
+		{
+			index.search(query.substr(0, i), NodeTypeSet::all(), 100, 100);
+		}
+	}
+}
@@ -1,8 +1,12 @@
 #include "catch.hpp"
 
+#include <chrono>
 #include <memory>
 #include <thread>
 
+#include "IntermediateStorage.h"
+#include "InterprocessIndexingStatusManager.h"
+#include "InterprocessIntermediateStorageManager.h"
 #include "SharedMemory.h"
 
 TEST_CASE("shared memory")
@@ -95,3 +99,164 @@ TEST_CASE("shared memory")
 		}
 	}
 }
+
+TEST_CASE("shared memory wait returns on change")
+{
+	SharedMemory memory("waiting", 1000, SharedMemory::CREATE_AND_DELETE);
+
+	std::thread thread([]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		SharedMemory memory("waiting", 0, SharedMemory::OPEN_ONLY);
+		SharedMemory::ScopedAccess access(&memory);
+		*access.accessValue<int>("count") = 1;
+		access.notifyAll();
+	});
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	memory.waitForChange(10000);
+	const std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - start;
+
+	thread.join();
+
+	REQUIRE(duration < std::chrono::seconds(5));
+
+	SharedMemory::ScopedAccess access(&memory);
+	REQUIRE(*access.accessValue<int>("count") == 1);
+}
+
+namespace
+{
+std::shared_ptr<IntermediateStorage> createIntermediateStorage(size_t fileCount)
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+
+	for (size_t i = 0; i < fileCount; i++)
+	{
+		const std::wstring name = L"file" + std::to_wstring(i);
+		const Id fileId = storage->addNode(StorageNodeData(1, name + L".cpp")).first;
+		storage->addFile(StorageFile(fileId, name + L".cpp", L"cpp", "", true, i % 2 == 0));
+
+		const Id nodeId = storage->addNode(StorageNodeData(2, name + L"::function")).first;
+		storage->addSymbol(StorageSymbol(nodeId, 1));
+		storage->addComponentAccess(StorageComponentAccess(nodeId, 3));
+
+		const Id edgeId = storage->addEdge(StorageEdgeData(4, fileId, nodeId));
+		const Id localSymbolId = storage->addLocalSymbol(StorageLocalSymbolData(name + L"<0:0>"));
+
+		const Id locationId = storage->addSourceLocation(
+			StorageSourceLocationData(fileId, i + 1, 2, i + 1, 10, 1));
+		storage->addOccurrence(StorageOccurrence(nodeId, locationId));
+		storage->addOccurrence(StorageOccurrence(edgeId, locationId));
+		storage->addOccurrence(StorageOccurrence(localSymbolId, locationId));
+	}
+
+	storage->addError(StorageErrorData(L"error", L"file0.cpp", true, false));
+
+	return storage;
+}
+}	 // namespace
+
+TEST_CASE("shared memory passes intermediate storage between processes")
+{
+	InterprocessIntermediateStorageManager owner("test", 0, true);
+	InterprocessIntermediateStorageManager client("test", 0, false);
+
+	std::shared_ptr<IntermediateStorage> storage = createIntermediateStorage(10);
+	client.pushIntermediateStorage(storage);
+	client.pushIntermediateStorage(std::make_shared<IntermediateStorage>());
+	REQUIRE(owner.getIntermediateStorageCount() == 2);
+
+	std::shared_ptr<IntermediateStorage> result = owner.popIntermediateStorage();
+	REQUIRE(result);
+	REQUIRE(result->getNextId() == storage->getNextId());
+
+	REQUIRE(result->getStorageNodes().size() == storage->getStorageNodes().size());
+	for (size_t i = 0; i < storage->getStorageNodes().size(); i++)
+	{
+		REQUIRE(result->getStorageNodes()[i].id == storage->getStorageNodes()[i].id);
+		REQUIRE(result->getStorageNodes()[i].type == storage->getStorageNodes()[i].type);
+		REQUIRE(
+			result->getStorageNodes()[i].serializedName ==
+			storage->getStorageNodes()[i].serializedName);
+	}
+
+	REQUIRE(result->getStorageFiles().size() == 10);
+	REQUIRE(result->getStorageFiles()[3].filePath == L"file3.cpp");
+	REQUIRE(result->getStorageFiles()[3].languageIdentifier == L"cpp");
+	REQUIRE(result->getStorageFiles()[3].indexed);
+	REQUIRE(!result->getStorageFiles()[3].complete);
+
+	REQUIRE(result->getStorageSymbols().size() == 10);
+	REQUIRE(result->getStorageEdges().size() == 10);
+	REQUIRE(result->getStorageEdges()[5].id == storage->getStorageEdges()[5].id);
+	REQUIRE(
+		result->getStorageEdges()[5].targetNodeId == storage->getStorageEdges()[5].targetNodeId);
+
+	REQUIRE(result->getStorageLocalSymbols().size() == 10);
+	REQUIRE(
+		result->getStorageLocalSymbols()[7].name == storage->getStorageLocalSymbols()[7].name);
+
+	REQUIRE(result->getStorageSourceLocations().size() == 10);
+	REQUIRE(
+		result->getStorageSourceLocations()[2].startLine ==
+		storage->getStorageSourceLocations()[2].startLine);
+	REQUIRE(result->getStorageOccurrences().size() == 30);
+	REQUIRE(result->getComponentAccesses().size() == 10);
+
+	REQUIRE(result->getErrors().size() == 1);
+	REQUIRE(result->getErrors()[0].message == L"error");
+	REQUIRE(result->getErrors()[0].translationUnit == L"file0.cpp");
+	REQUIRE(result->getErrors()[0].fatal);
+
+	result = owner.popIntermediateStorage();
+	REQUIRE(result);
+	REQUIRE(result->getStorageNodes().empty());
+
+	REQUIRE(!owner.popIntermediateStorage());
+}
+
+TEST_CASE("shared memory registers files indexed by other processes")
+{
+	InterprocessIndexingStatusManager owner("test", 0, true);
+	InterprocessIndexingStatusManager client1("test", 1, false);
+	InterprocessIndexingStatusManager client2("test", 2, false);
+
+	REQUIRE(!client2.isFileIndexed(FilePath(L"/src/a.h"), 1));
+
+	client1.addIndexedFiles({FilePath(L"/src/a.h"), FilePath(L"/src/b.h")}, 1);
+	REQUIRE(client2.isFileIndexed(FilePath(L"/src/a.h"), 1));
+	REQUIRE(client2.isFileIndexed(FilePath(L"/src/b.h"), 1));
+	REQUIRE(!client2.isFileIndexed(FilePath(L"/src/c.h"), 1));
+
+	// the same file seen with other flags may have different content
+	REQUIRE(!client2.isFileIndexed(FilePath(L"/src/a.h"), 2));
+
+	std::vector<FilePath> filePaths;
+	for (size_t i = 0; i < 20000; i++)
+	{
+		filePaths.push_back(
+			FilePath(L"/src/include/directory/header" + std::to_wstring(i) + L".h"));
+	}
+	client1.addIndexedFiles(filePaths, 2);
+	REQUIRE(client2.isFileIndexed(filePaths.back(), 2));
+	REQUIRE(client2.isFileIndexed(FilePath(L"/src/a.h"), 1));
+}
+
+TEST_CASE("benchmark shared memory intermediate storage", "[.][benchmark]")
+{
+	InterprocessIntermediateStorageManager owner("bench", 0, true);
+	InterprocessIntermediateStorageManager client("bench", 0, false);
+
+	std::shared_ptr<IntermediateStorage> storage = createIntermediateStorage(100000);
+
+	BENCHMARK("push 100000 files")
+	{
+		client.pushIntermediateStorage(storage);
+	}
+
+	BENCHMARK("pop 100000 files")
+	{
+		owner.popIntermediateStorage();
+	}
+}
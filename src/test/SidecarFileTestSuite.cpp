@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "SidecarFile.h"
+
+namespace
+{
+const uint64_t TEST_MAGIC = 0x5453455452435253;	   // "SRCTRTST"
+
+std::string readFile(const FilePath& filePath)
+{
+	std::ifstream stream(filePath.str(), std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+}	 // namespace
+
+TEST_CASE("sidecar file header is only accepted for same file type and storage time")
+{
+	const SidecarFile sidecarFile("test", TEST_MAGIC, 2);
+
+	SidecarFileHeader header;
+	REQUIRE(sidecarFile.initHeader(&header, "2020-01-01 10:00:00"));
+	REQUIRE(sidecarFile.checkHeader(&header, "2020-01-01 10:00:00"));
+	REQUIRE(!sidecarFile.checkHeader(&header, "2020-01-01 10:00:01"));
+
+	REQUIRE(!SidecarFile("test", TEST_MAGIC + 1, 2).checkHeader(&header, "2020-01-01 10:00:00"));
+	REQUIRE(!SidecarFile("test", TEST_MAGIC, 3).checkHeader(&header, "2020-01-01 10:00:00"));
+}
+
+TEST_CASE("sidecar file header does not accept a storage time that does not fit")
+{
+	const SidecarFile sidecarFile("test", TEST_MAGIC, 1);
+
+	SidecarFileHeader header;
+	REQUIRE(!sidecarFile.initHeader(
+		&header, std::string(SidecarFileHeader::MAX_STORAGE_TIME_LENGTH, '1')));
+
+	// a header read from a file is always terminated
+	REQUIRE(sidecarFile.initHeader(&header, ""));
+	std::memset(header.storageTime, '1', sizeof(header.storageTime));
+	REQUIRE(sidecarFile.checkHeader(
+		&header, std::string(SidecarFileHeader::MAX_STORAGE_TIME_LENGTH - 1, '1')));
+}
+
+TEST_CASE("sidecar file is only replaced if writing succeeds")
+{
+	const SidecarFile sidecarFile("test", TEST_MAGIC, 1);
+	const FilePath filePath(L"data/SQLiteTestSuite/test.sqlite_sidecar");
+
+	REQUIRE(sidecarFile.write(filePath, [](std::ostream& stream) {
+		stream << "old";
+		return true;
+	}));
+
+	REQUIRE(!sidecarFile.write(filePath, [](std::ostream& stream) {
+		stream << "partial";
+		return false;
+	}));
+	const std::string contentAfterFailure = readFile(filePath);
+	const bool tempFileExists = SidecarFile::getTempFilePath(filePath).recheckExists();
+
+	REQUIRE(sidecarFile.write(filePath, [](std::ostream& stream) {
+		stream << "new";
+		return true;
+	}));
+	const std::string contentAfterSuccess = readFile(filePath);
+
+	FileSystem::remove(filePath);
+
+	REQUIRE(contentAfterFailure == "old");
+	REQUIRE(!tempFileExists);
+	REQUIRE(contentAfterSuccess == "new");
+}
+
+TEST_CASE("sidecar file is not mapped if smaller than header")
+{
+	const SidecarFile sidecarFile("test", TEST_MAGIC, 1);
+	const FilePath filePath(L"data/SQLiteTestSuite/test.sqlite_sidecar");
+
+	std::unique_ptr<boost::interprocess::file_mapping> mapping;
+	std::unique_ptr<boost::interprocess::mapped_region> region;
+	const bool mappedMissingFile = sidecarFile.map(
+		filePath, sizeof(SidecarFileHeader), &mapping, &region);
+
+	{
+		std::ofstream stream(filePath.str(), std::ios::binary);
+		stream << "short";
+	}
+	const bool mappedShortFile = sidecarFile.map(
+		filePath, sizeof(SidecarFileHeader), &mapping, &region);
+	const bool mappedFile = sidecarFile.map(filePath, 5, &mapping, &region);
+	const size_t mappedSize = mappedFile ? region->get_size() : 0;
+
+	mapping.reset();
+	region.reset();
+	FileSystem::remove(filePath);
+
+	REQUIRE(!mappedMissingFile);
+	REQUIRE(!mappedShortFile);
+	REQUIRE(mappedFile);
+	REQUIRE(mappedSize == 5);
+}
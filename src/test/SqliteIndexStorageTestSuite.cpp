@@ -1,7 +1,12 @@
 #include "catch.hpp"
 
+#include <algorithm>
+#include <fstream>
+
+#include "ContentHasher.h"
 #include "FileSystem.h"
 #include "SqliteIndexStorage.h"
+#include "TextAccess.h"
 
 TEST_CASE("storage adds node successfully")
 {
@@ -76,3 +81,313 @@ TEST_CASE("storage removes edge successfully")
 
 	REQUIRE(0 == edgeCount);
 }
+
+TEST_CASE("storage removes elements located in cleared files")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	int nodeCount = -1;
+	int edgeCount = -1;
+	int sourceLocationCount = -1;
+	int occurrenceCount = -1;
+	std::vector<int> progress;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		int fileAId = storage.addNode(StorageNodeData(0, L"a"));
+		int fileBId = storage.addNode(StorageNodeData(0, L"b"));
+		storage.addFile(StorageFile(fileAId, L"a.cpp", L"cpp", "2000-01-01 00:00:00", false, true));
+		storage.addFile(StorageFile(fileBId, L"b.cpp", L"cpp", "2000-01-01 00:00:00", false, true));
+		int sourceNodeId = storage.addNode(StorageNodeData(0, L"x"));
+		int targetNodeId = storage.addNode(StorageNodeData(0, L"y"));
+		int edgeId = storage.addEdge(StorageEdgeData(0, sourceNodeId, targetNodeId));
+		int locationAId = storage.addSourceLocation(StorageSourceLocationData(fileAId, 1, 1, 1, 2, 0));
+		int locationBId = storage.addSourceLocation(StorageSourceLocationData(fileBId, 1, 1, 1, 2, 0));
+		storage.addOccurrence(StorageOccurrence(sourceNodeId, locationAId));
+		storage.addOccurrence(StorageOccurrence(edgeId, locationAId));
+		storage.addOccurrence(StorageOccurrence(targetNodeId, locationBId));
+		storage.commitTransaction();
+
+		storage.beginTransaction();
+		storage.removeElementsWithLocationInFiles(
+			{Id(fileAId)}, [&](int p, const std::wstring& phase) { progress.push_back(p); });
+		storage.commitTransaction();
+
+		nodeCount = storage.getNodeCount();
+		edgeCount = storage.getEdgeCount();
+		sourceLocationCount = storage.getSourceLocationCount();
+		occurrenceCount = static_cast<int>(
+			storage.getOccurrencesForElementIds({Id(sourceNodeId), Id(targetNodeId)}).size());
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(3 == nodeCount);	// both files and y
+	REQUIRE(0 == edgeCount);
+	REQUIRE(1 == sourceLocationCount);
+	REQUIRE(1 == occurrenceCount);
+	REQUIRE(!progress.empty());
+	REQUIRE(std::is_sorted(progress.begin(), progress.end()));
+}
+
+TEST_CASE("storage removes edges with missing nodes after deferred foreign key checks")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	size_t violationCount = 0;
+	int edgeCountBeforeCheck = -1;
+	int edgeCountAfterCheck = -1;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setForeignKeysEnabled(false);
+		storage.beginTransaction();
+		int sourceNodeId = storage.addNode(StorageNodeData(0, L"a"));
+		int targetNodeId = storage.addNode(StorageNodeData(0, L"b"));
+		storage.addEdge(StorageEdgeData(0, sourceNodeId, targetNodeId));
+		storage.addEdge(StorageEdgeData(0, sourceNodeId, targetNodeId + 100));
+		storage.commitTransaction();
+		edgeCountBeforeCheck = storage.getEdgeCount();
+
+		storage.setForeignKeysEnabled(true);
+		storage.beginTransaction();
+		violationCount = storage.removeForeignKeyViolations();
+		storage.commitTransaction();
+		edgeCountAfterCheck = storage.getEdgeCount();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(2 == edgeCountBeforeCheck);
+	REQUIRE(1 == violationCount);
+	REQUIRE(1 == edgeCountAfterCheck);
+}
+
+TEST_CASE("storage reads back compressed and uncompressed file content")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FilePath compressedFilePath(L"data/SQLiteTestSuite/compressed.cpp");
+	FilePath uncompressedFilePath(L"data/SQLiteTestSuite/uncompressed.cpp");
+
+	std::string text;
+	for (int i = 0; i < 100; i++)
+	{
+		text += "int foo" + std::to_string(i) + "() { return " + std::to_string(i) + "; }\n";
+	}
+	for (const FilePath& filePath: {compressedFilePath, uncompressedFilePath})
+	{
+		std::ofstream fileStream(filePath.str());
+		fileStream << text;
+	}
+
+	std::string compressedContent;
+	std::string uncompressedContent;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		storage.setFileContentCompressed(true);
+		int compressedFileId = storage.addNode(StorageNodeData(0, L"compressed"));
+		storage.addFile(
+			StorageFile(compressedFileId, compressedFilePath.wstr(), L"cpp", "", true, true));
+		storage.setFileContentCompressed(false);
+		int uncompressedFileId = storage.addNode(StorageNodeData(0, L"uncompressed"));
+		storage.addFile(
+			StorageFile(uncompressedFileId, uncompressedFilePath.wstr(), L"cpp", "", true, true));
+		storage.commitTransaction();
+
+		compressedContent = storage.getFileContentById(compressedFileId)->getText();
+		uncompressedContent = storage.getFileContentByPath(uncompressedFilePath.wstr())->getText();
+	}
+	FileSystem::remove(databasePath);
+	FileSystem::remove(compressedFilePath);
+	FileSystem::remove(uncompressedFilePath);
+
+	REQUIRE(text == compressedContent);
+	REQUIRE(text == uncompressedContent);
+}
+
+TEST_CASE("storage stores hash of raw file content for indexed files")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FilePath indexedFilePath(L"data/SQLiteTestSuite/indexed.cpp");
+	FilePath nonIndexedFilePath(L"data/SQLiteTestSuite/nonindexed.cpp");
+
+	const std::string text = "int foo()\r\n{\r\n\treturn 1;\r\n}\r\n";
+	for (const FilePath& filePath: {indexedFilePath, nonIndexedFilePath})
+	{
+		std::ofstream fileStream(filePath.str(), std::ios::binary);
+		fileStream << text;
+	}
+
+	bool indexedHasHash = false;
+	bool nonIndexedHasHash = false;
+	std::string contentHash;
+	uint64_t byteSize = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		int indexedFileId = storage.addNode(StorageNodeData(0, L"indexed"));
+		storage.addFile(StorageFile(indexedFileId, indexedFilePath.wstr(), L"cpp", "", true, true));
+		int nonIndexedFileId = storage.addNode(StorageNodeData(0, L"nonindexed"));
+		storage.addFile(
+			StorageFile(nonIndexedFileId, nonIndexedFilePath.wstr(), L"cpp", "", false, true));
+
+		indexedHasHash = storage.getFileContentHash(indexedFilePath.wstr(), contentHash, byteSize);
+		std::string unusedHash;
+		uint64_t unusedByteSize = 0;
+		nonIndexedHasHash = storage.getFileContentHash(
+			nonIndexedFilePath.wstr(), unusedHash, unusedByteSize);
+	}
+	FileSystem::remove(databasePath);
+	FileSystem::remove(indexedFilePath);
+	FileSystem::remove(nonIndexedFilePath);
+
+	REQUIRE(indexedHasHash);
+	REQUIRE(ContentHasher::hashString(text) == contentHash);
+	REQUIRE(text.size() == byteSize);
+	REQUIRE_FALSE(nonIndexedHasHash);
+}
+
+TEST_CASE("storage rolls back transaction with bulk performance profiles")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	const std::vector<std::pair<std::string, std::string>> modes = {
+		{"WAL", "NORMAL"}, {"MEMORY", "OFF"}};
+	for (const std::pair<std::string, std::string>& mode: modes)
+	{
+		int nodeCount = -1;
+		{
+			SqliteStorage::PerformanceProfile profile;
+			profile.journalMode = mode.first;
+			profile.synchronous = mode.second;
+			profile.tempStoreInMemory = true;
+
+			SqliteIndexStorage storage(databasePath);
+			storage.setup();
+			storage.setPerformanceProfile(profile);
+			storage.beginTransaction();
+			storage.addNode(StorageNodeData(0, L"a"));
+			storage.commitTransaction();
+			storage.beginTransaction();
+			storage.addNode(StorageNodeData(0, L"b"));
+			storage.rollbackTransaction();
+			nodeCount = storage.getNodeCount();
+		}
+		FileSystem::remove(databasePath);
+
+		REQUIRE(1 == nodeCount);
+	}
+}
+
+TEST_CASE("performance profile is crash safe unless journal or synchronization is off")
+{
+	SqliteStorage::PerformanceProfile profile;
+	REQUIRE(profile.isCrashSafe());
+
+	profile.journalMode = "wal";
+	profile.synchronous = "normal";
+	REQUIRE(profile.isCrashSafe());
+
+	profile.synchronous = "OFF";
+	REQUIRE_FALSE(profile.isCrashSafe());
+
+	profile.synchronous = "NORMAL";
+	profile.journalMode = "MEMORY";
+	REQUIRE_FALSE(profile.isCrashSafe());
+
+	profile.journalMode = "OFF";
+	REQUIRE_FALSE(profile.isCrashSafe());
+}
+
+TEST_CASE("benchmark storage injection with performance profiles", "[.][benchmark]")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	SqliteStorage::PerformanceProfile bulkProfile;
+	bulkProfile.journalMode = "WAL";
+	bulkProfile.synchronous = "NORMAL";
+	bulkProfile.cacheSizeKb = 256 * 1024;
+	bulkProfile.tempStoreInMemory = true;
+	bulkProfile.mmapSizeMb = 256;
+
+	SqliteStorage::PerformanceProfile unsafeBulkProfile = bulkProfile;
+	unsafeBulkProfile.journalMode = "MEMORY";
+	unsafeBulkProfile.synchronous = "OFF";
+
+	const std::vector<std::pair<std::string, SqliteStorage::PerformanceProfile>> profiles = {
+		{"default profile", SqliteStorage::PerformanceProfile()},
+		{"bulk profile", bulkProfile},
+		{"unsafe bulk profile", unsafeBulkProfile}};
+
+	for (const auto& profile: profiles)
+	{
+		{
+			SqliteIndexStorage storage(databasePath);
+			storage.setup();
+			storage.setPerformanceProfile(profile.second);
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+
+			BENCHMARK(profile.first)
+			{
+				// commit in small batches, like the injection of many small intermediate storages
+				for (int i = 0; i < 100; i++)
+				{
+					storage.beginTransaction();
+					for (int j = 0; j < 500; j++)
+					{
+						const std::wstring name = std::to_wstring(i) + L"_" + std::to_wstring(j);
+						const Id sourceNodeId = storage.addNode(StorageNodeData(0, L"a" + name));
+						const Id targetNodeId = storage.addNode(StorageNodeData(0, L"b" + name));
+						storage.addEdge(StorageEdgeData(0, sourceNodeId, targetNodeId));
+					}
+					storage.commitTransaction();
+				}
+			}
+		}
+		FileSystem::remove(databasePath);
+	}
+}
+
+TEST_CASE("benchmark file content compression", "[.][benchmark]")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	const std::vector<FilePath> filePaths = FileSystem::getFilePathsFromDirectory(
+		FilePath(L"../../src/lib"), {L".cpp", L".h"});
+
+	for (bool compressed: {false, true})
+	{
+		const std::string name = compressed ? "compressed" : "uncompressed";
+		std::vector<Id> fileIds;
+		{
+			SqliteIndexStorage storage(databasePath);
+			storage.setup();
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+			storage.setFileContentCompressed(compressed);
+
+			BENCHMARK("add " + std::to_string(filePaths.size()) + " " + name + " files")
+			{
+				storage.beginTransaction();
+				for (const FilePath& filePath: filePaths)
+				{
+					const Id fileId = storage.addNode(StorageNodeData(0, filePath.wstr()));
+					storage.addFile(StorageFile(fileId, filePath.wstr(), L"cpp", "", true, true));
+					fileIds.push_back(fileId);
+				}
+				storage.commitTransaction();
+			}
+
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+			size_t size = 0;
+			BENCHMARK("read " + name + " files")
+			{
+				for (Id fileId: fileIds)
+				{
+					size += storage.getFileContentById(fileId)->getText().size();
+				}
+			}
+			REQUIRE(size > 0);
+		}
+		WARN(name << " database size: " << FileSystem::getFileByteSize(databasePath) << " bytes");
+		FileSystem::remove(databasePath);
+	}
+}
@@ -0,0 +1,63 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <string>
+
+#include "IntermediateStorage.h"
+#include "StorageInjectionPipeline.h"
+#include "StorageProvider.h"
+
+namespace
+{
+std::shared_ptr<IntermediateStorage> createStorage(const std::wstring& fileName)
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	const Id fileId = storage->addNode(StorageNodeData(0, fileName)).first;
+	const Id sharedId = storage->addNode(StorageNodeData(0, L"shared")).first;
+	storage->addEdge(StorageEdgeData(1, fileId, sharedId));
+	storage->addSourceLocation(StorageSourceLocationData(fileId, 1, 1, 1, 5, 0));
+	return storage;
+}
+}	 // namespace
+
+TEST_CASE("storage injection pipeline injects all provided storages")
+{
+	std::shared_ptr<StorageProvider> storageProvider = std::make_shared<StorageProvider>();
+	storageProvider->insert(createStorage(L"a"));
+	storageProvider->insert(createStorage(L"b"));
+	storageProvider->insert(createStorage(L"c"));
+
+	IntermediateStorage target;
+	StorageInjectionPipeline pipeline(storageProvider, 2);
+
+	pipeline.start();
+	while (!pipeline.isDrained())
+	{
+		pipeline.injectNextBatch(&target, 25);
+	}
+	pipeline.stop();
+
+	// the shared node is only injected once
+	REQUIRE(4 == target.getStorageNodes().size());
+	REQUIRE(3 == target.getStorageEdges().size());
+	REQUIRE(3 == target.getSourceLocationCount());
+
+	const StorageInjectionStats stats = pipeline.getStats();
+	REQUIRE(3 == stats.preparedStorageCount);
+	REQUIRE(stats.preparedBatchCount == stats.injectedBatchCount);
+	REQUIRE(3 == stats.injectedSourceLocationCount);
+}
+
+TEST_CASE("storage injection pipeline returns prepared batches to provider on stop")
+{
+	std::shared_ptr<StorageProvider> storageProvider = std::make_shared<StorageProvider>();
+	storageProvider->insert(createStorage(L"a"));
+	storageProvider->insert(createStorage(L"b"));
+
+	StorageInjectionPipeline pipeline(storageProvider, 1);
+	pipeline.start();
+	pipeline.stop();
+
+	REQUIRE(pipeline.getStats().injectedBatchCount == 0);
+	REQUIRE(storageProvider->getStorageCount() > 0);
+}
@@ -1,10 +1,24 @@
 #include "catch.hpp"
 
+#include <chrono>
+#include <fstream>
+#include <thread>
+
 #include "utilityString.h"
 
+#include "ApplicationSettings.h"
+#include "FileSystem.h"
+#include "FullTextSearchIndex.h"
+#include "Graph.h"
 #include "IntermediateStorage.h"
+#include "MessageListener.h"
+#include "MessageQueue.h"
+#include "MessageStatus.h"
 #include "ParseLocation.h"
 #include "PersistentStorage.h"
+#include "SourceLocation.h"
+#include "SourceLocationCollection.h"
+#include "SourceLocationFile.h"
 
 namespace
 {
@@ -52,6 +66,198 @@ NameHierarchy createFunctionNameHierarchy(std::wstring ret, std::wstring name, s
 	nameHierarchy.push(NameElement(lastName, ret, parameters));
 	return nameHierarchy;
 }
+
+// a -> b -> d, a -> c -> d, a -> e -> f -> d and a -> h <- d, b -> g
+std::map<std::wstring, Id> injectTrailGraph(TestStorage& storage)
+{
+	std::shared_ptr<IntermediateStorage> intermetiateStorage = std::make_shared<IntermediateStorage>();
+
+	std::map<std::wstring, Id> ids;
+	for (const std::wstring& name: {L"a", L"b", L"c", L"d", L"e", L"f", L"g", L"h"})
+	{
+		ids[name] = intermetiateStorage
+						->addNode(StorageNodeData(
+							NodeType::typeToInt(NodeType::NODE_FUNCTION),
+							NameHierarchy::serialize(createNameHierarchy(name))))
+						.first;
+		intermetiateStorage->addSymbol(StorageSymbol(ids[name], DEFINITION_EXPLICIT));
+	}
+
+	const std::vector<std::pair<std::wstring, std::wstring>> calls = {
+		{L"a", L"b"},
+		{L"b", L"d"},
+		{L"a", L"c"},
+		{L"c", L"d"},
+		{L"a", L"e"},
+		{L"e", L"f"},
+		{L"f", L"d"},
+		{L"a", L"h"},
+		{L"d", L"h"},
+		{L"b", L"g"}};
+	for (const auto& call: calls)
+	{
+		intermetiateStorage->addEdge(StorageEdgeData(
+			Edge::typeToInt(Edge::EDGE_CALL), ids[call.first], ids[call.second]));
+	}
+
+	storage.inject(intermetiateStorage.get());
+	storage.buildCaches();
+
+	// the ids change when injected into the storage
+	for (auto& p: ids)
+	{
+		p.second = storage.getNodeIdForNameHierarchy(createNameHierarchy(p.first));
+	}
+	return ids;
+}
+
+std::set<std::wstring> getTrailNodeNames(
+	TestStorage& storage,
+	const std::map<std::wstring, Id>& ids,
+	bool directed,
+	bool shortestPathsOnly,
+	size_t maxNodeCount = 0,
+	std::function<bool()> isInterrupted = std::function<bool()>())
+{
+	std::shared_ptr<Graph> graph = storage.getGraphForTrail(
+		ids.at(L"a"),
+		ids.at(L"d"),
+		NodeType::NODE_FUNCTION,
+		Edge::EDGE_CALL,
+		false,
+		0,
+		directed,
+		shortestPathsOnly,
+		maxNodeCount,
+		isInterrupted);
+
+	std::set<std::wstring> names;
+	for (const auto& p: ids)
+	{
+		if (graph->getNodeById(p.second))
+		{
+			names.insert(p.first);
+		}
+	}
+	return names;
+}
+
+FilePath getFullTextSearchDirectoryPath()
+{
+	return FilePath(L"data/StorageTestSuite/fulltext_search").makeAbsolute();
+}
+
+FilePath getFullTextSearchFilePath(const std::wstring& fileName)
+{
+	return getFullTextSearchDirectoryPath().getConcatenated(fileName);
+}
+
+// writes the files to disk and injects them as indexed files, the storage reads their content
+void injectFullTextSearchFiles(
+	PersistentStorage& storage, const std::map<std::wstring, std::string>& fileContents)
+{
+	FileSystem::createDirectory(getFullTextSearchDirectoryPath());
+
+	std::shared_ptr<IntermediateStorage> intermetiateStorage = std::make_shared<IntermediateStorage>();
+	for (const auto& p: fileContents)
+	{
+		const FilePath filePath = getFullTextSearchFilePath(p.first);
+		{
+			std::ofstream file(filePath.str());
+			file << p.second;
+		}
+
+		const NameHierarchy nameHierarchy(filePath.wstr(), NAME_DELIMITER_FILE);
+		Id id = intermetiateStorage
+					->addNode(StorageNodeData(
+						NodeType::typeToInt(NodeType::NODE_FILE),
+						NameHierarchy::serialize(nameHierarchy)))
+					.first;
+		intermetiateStorage->addFile(StorageFile(id, filePath.wstr(), L"cpp", "", true, true));
+	}
+
+	storage.inject(intermetiateStorage.get());
+}
+
+void removeFullTextSearchFiles(PersistentStorage& storage)
+{
+	FileSystem::remove(
+		PersistentStorage::getFullTextSearchIndexFilePath(storage.getIndexDbFilePath()));
+
+	const FilePath directoryPath = getFullTextSearchDirectoryPath();
+	if (directoryPath.recheckExists())
+	{
+		for (const FilePath& path: FileSystem::getFilePathsFromDirectory(directoryPath))
+		{
+			FileSystem::remove(path);
+		}
+		FileSystem::remove(directoryPath);
+	}
+}
+
+std::set<Id> getSourceLocationIds(std::shared_ptr<SourceLocationCollection> collection)
+{
+	std::set<Id> locationIds;
+	collection->forEachSourceLocation([&locationIds](SourceLocation* location) {
+		locationIds.insert(location->getLocationId());
+	});
+	return locationIds;
+}
+
+std::wstring getLocationRangeString(
+	size_t startLineNumber, size_t startColumnNumber, size_t endLineNumber, size_t endColumnNumber)
+{
+	return std::to_wstring(startLineNumber) + L":" + std::to_wstring(startColumnNumber) + L"-" +
+		std::to_wstring(endLineNumber) + L":" + std::to_wstring(endColumnNumber);
+}
+
+// the ranges of the found locations in each file, e.g. "2:6-2:8"
+std::map<std::wstring, std::set<std::wstring>> getLocationRangeStrings(
+	std::shared_ptr<SourceLocationCollection> collection)
+{
+	std::map<std::wstring, std::set<std::wstring>> ranges;
+	collection->forEachSourceLocation([&ranges](SourceLocation* location) {
+		if (location->isStartLocation())
+		{
+			const SourceLocation* endLocation = location->getEndLocation();
+			ranges[location->getFilePath().wstr()].insert(getLocationRangeString(
+				location->getLineNumber(),
+				location->getColumnNumber(),
+				endLocation->getLineNumber(),
+				endLocation->getColumnNumber()));
+		}
+	});
+	return ranges;
+}
+
+class StatusMessageListener: public MessageListener<MessageStatus>
+{
+public:
+	std::vector<std::wstring> statuses;
+
+private:
+	void handleMessage(MessageStatus* message) override
+	{
+		statuses.push_back(message->status());
+	}
+};
+
+// collects the stati dispatched while running func
+std::vector<std::wstring> getStatusesDispatchedBy(std::function<void()> func)
+{
+	StatusMessageListener listener;
+	MessageQueue::getInstance()->startMessageLoopThreaded();
+
+	func();
+
+	do
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	} while (MessageQueue::getInstance()->hasMessagesQueued());
+	MessageQueue::getInstance()->stopMessageLoop();
+
+	return listener.statuses;
+}
 }	 // namespace
 
 TEST_CASE("storage saves file")
@@ -130,6 +336,407 @@ TEST_CASE("storage saves field as member")
 	REQUIRE(foundEdge);
 }
 
+TEST_CASE("storage builds same caches from database and cache files")
+{
+	NameHierarchy a = createNameHierarchy(L"Struct");
+	NameHierarchy b = createNameHierarchy(L"Struct::m_field");
+	NameHierarchy c = createNameHierarchy(L"Derived");
+
+	TestStorage storage;
+
+	std::shared_ptr<IntermediateStorage> intermetiateStorage = std::make_shared<IntermediateStorage>();
+
+	Id aId = intermetiateStorage
+				 ->addNode(StorageNodeData(
+					 NodeType::typeToInt(NodeType::NODE_STRUCT), NameHierarchy::serialize(a)))
+				 .first;
+	intermetiateStorage->addSymbol(StorageSymbol(aId, DEFINITION_EXPLICIT));
+
+	Id bId = intermetiateStorage
+				 ->addNode(StorageNodeData(
+					 NodeType::typeToInt(NodeType::NODE_FIELD), NameHierarchy::serialize(b)))
+				 .first;
+	intermetiateStorage->addSymbol(StorageSymbol(bId, DEFINITION_EXPLICIT));
+	intermetiateStorage->addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), aId, bId));
+
+	Id cId = intermetiateStorage
+				 ->addNode(StorageNodeData(
+					 NodeType::typeToInt(NodeType::NODE_STRUCT), NameHierarchy::serialize(c)))
+				 .first;
+	intermetiateStorage->addSymbol(StorageSymbol(cId, DEFINITION_EXPLICIT));
+	intermetiateStorage->addEdge(
+		StorageEdgeData(Edge::typeToInt(Edge::EDGE_INHERITANCE), cId, aId));
+
+	storage.inject(intermetiateStorage.get());
+
+	const Id structId = storage.getNodeIdForNameHierarchy(a);
+	const Id fieldId = storage.getNodeIdForNameHierarchy(b);
+
+	auto requireCaches = [&]() {
+		std::vector<SearchMatch> matches =
+			storage.getAutocompletionSymbolMatches(L"field", NodeTypeSet::all(), 10, 0);
+		REQUIRE(matches.size() == 1);
+		REQUIRE(matches[0].tokenIds == std::vector<Id>({fieldId}));
+
+		std::shared_ptr<Graph> graph = storage.getGraphForChildrenOfNodeId(structId);
+		REQUIRE(graph->getNodeById(fieldId) != nullptr);
+		REQUIRE(graph->getEdgeCount() == 1);
+	};
+
+	storage.buildCaches();
+	requireCaches();
+
+	storage.writeEdgeCache();
+	storage.writeSymbolCaches();
+
+	storage.buildCaches();
+	requireCaches();
+
+	// the caches without a file are built from the database, the others are still loaded
+	const std::vector<FilePath> cacheFilePaths =
+		PersistentStorage::getCacheFilePaths(storage.getIndexDbFilePath());
+	for (auto it = cacheFilePaths.rbegin(); it != cacheFilePaths.rend(); it++)
+	{
+		storage.clearCaches();
+		FileSystem::remove(*it);
+
+		storage.buildCaches();
+		requireCaches();
+	}
+}
+
+TEST_CASE("storage hands over fulltext search locations file by file")
+{
+	TestStorage storage;
+	injectFullTextSearchFiles(
+		storage, {{L"a.cpp", "foo\nbar foo\n"}, {L"b.cpp", "int Foo;\n"}, {L"c.cpp", "bar\n"}});
+	storage.buildCaches();
+
+	std::vector<std::shared_ptr<SourceLocationFile>> handedOverFiles;
+	std::shared_ptr<SourceLocationCollection> collection = storage.getFullTextSearchLocations(
+		L"foo", false, 0, [&handedOverFiles](std::shared_ptr<SourceLocationFile> file) {
+			handedOverFiles.push_back(file);
+			return true;
+		});
+
+	removeFullTextSearchFiles(storage);
+
+	REQUIRE(handedOverFiles.size() == 2);
+	REQUIRE(collection->getSourceLocationFileCount() == 2);
+	REQUIRE(collection->getSourceLocationCount() == 3);
+	for (const std::shared_ptr<SourceLocationFile>& file: handedOverFiles)
+	{
+		REQUIRE(collection->getSourceLocationFileByPath(file->getFilePath()) == file);
+	}
+	REQUIRE(
+		collection->getSourceLocationFileByPath(getFullTextSearchFilePath(L"a.cpp"))
+			->getSourceLocationCount() == 2);
+	REQUIRE(
+		collection->getSourceLocationFileByPath(getFullTextSearchFilePath(L"b.cpp"))
+			->getSourceLocationCount() == 1);
+}
+
+TEST_CASE("storage stops fulltext search when handed over locations are rejected")
+{
+	TestStorage storage;
+	injectFullTextSearchFiles(
+		storage, {{L"a.cpp", "foo\n"}, {L"b.cpp", "foo\n"}, {L"c.cpp", "foo\n"}});
+	storage.buildCaches();
+
+	size_t handedOverFileCount = 0;
+	std::shared_ptr<SourceLocationCollection> collection;
+	const std::vector<std::wstring> statuses = getStatusesDispatchedBy([&]() {
+		collection = storage.getFullTextSearchLocations(
+			L"foo", false, 0, [&handedOverFileCount](std::shared_ptr<SourceLocationFile> file) {
+				handedOverFileCount++;
+				return false;
+			});
+	});
+
+	removeFullTextSearchFiles(storage);
+
+	REQUIRE(handedOverFileCount == 1);
+	REQUIRE(collection->getSourceLocationFileCount() == 1);
+	REQUIRE(!statuses.empty());
+	REQUIRE(utility::isPostfix<std::wstring>(L"(interrupted)", statuses.back()));
+}
+
+TEST_CASE("storage limits fulltext search locations to max result count")
+{
+	TestStorage storage;
+	injectFullTextSearchFiles(
+		storage,
+		{{L"a.cpp", "foo foo foo\n"}, {L"b.cpp", "foo foo foo\n"}, {L"c.cpp", "foo foo foo\n"}});
+	storage.buildCaches();
+
+	std::shared_ptr<SourceLocationCollection> limitedCollection =
+		storage.getFullTextSearchLocations(L"foo", false, 4, nullptr);
+	std::shared_ptr<SourceLocationCollection> collection =
+		storage.getFullTextSearchLocations(L"foo", false, 0, nullptr);
+
+	removeFullTextSearchFiles(storage);
+
+	REQUIRE(collection->getSourceLocationCount() == 9);
+	REQUIRE(getSourceLocationIds(collection).size() == 9);
+
+	REQUIRE(limitedCollection->getSourceLocationCount() == 4);
+	REQUIRE(getSourceLocationIds(limitedCollection).size() == 4);
+}
+
+TEST_CASE("storage loads written fulltext search index with same results as in memory index")
+{
+	const std::map<std::wstring, std::string> fileContents = {
+		{L"a.cpp", "int Foo;\nvoid foo();\n\n  FOO foofoo\n"},
+		{L"b.cpp", "// foo\nbar\n"},
+		{L"c.cpp", "bar\n"}};
+
+	TestStorage storage;
+	injectFullTextSearchFiles(storage, fileContents);
+	storage.buildCaches();
+
+	FullTextSearchIndex memoryIndex;
+	std::map<Id, std::wstring> filePaths;
+	for (const auto& p: fileContents)
+	{
+		const FilePath filePath = getFullTextSearchFilePath(p.first);
+		const Id fileId = storage.getNodeIdForFileNode(filePath);
+		memoryIndex.addFile(fileId, utility::decodeFromUtf8(p.second));
+		filePaths[fileId] = filePath.wstr();
+	}
+
+	storage.writeFullTextSearchIndex();
+	const bool indexFileWritten =
+		PersistentStorage::getFullTextSearchIndexFilePath(storage.getIndexDbFilePath())
+			.recheckExists();
+
+	// loads the written index file instead of building the index from the database
+	storage.buildCaches();
+
+	std::vector<std::map<std::wstring, std::set<std::wstring>>> expectedRanges;
+	std::vector<std::map<std::wstring, std::set<std::wstring>>> loadedRanges;
+	for (const std::wstring& term: {L"foo", L"Foo", L"oo", L"bar", L"missing"})
+	{
+		for (const bool caseSensitive: {false, true})
+		{
+			std::map<std::wstring, std::set<std::wstring>> ranges;
+			for (const FullTextSearchResult& result: memoryIndex.searchForTerm(term))
+			{
+				for (const ParseLocation& location:
+					 memoryIndex.getLocationsForResult(result, term, caseSensitive))
+				{
+					ranges[filePaths[result.fileId]].insert(getLocationRangeString(
+						location.startLineNumber,
+						location.startColumnNumber,
+						location.endLineNumber,
+						location.endColumnNumber));
+				}
+			}
+			expectedRanges.push_back(ranges);
+
+			loadedRanges.push_back(getLocationRangeStrings(
+				storage.getFullTextSearchLocations(term, caseSensitive, 0, nullptr)));
+		}
+	}
+
+	removeFullTextSearchFiles(storage);
+
+	REQUIRE(indexFileWritten);
+	REQUIRE(
+		expectedRanges.front() ==
+		std::map<std::wstring, std::set<std::wstring>>(
+			{{getFullTextSearchFilePath(L"a.cpp").wstr(),
+			  {L"1:5-1:7", L"2:6-2:8", L"4:3-4:5", L"4:7-4:9", L"4:10-4:12"}},
+			 {getFullTextSearchFilePath(L"b.cpp").wstr(), {L"1:4-1:6"}}}));
+	REQUIRE(loadedRanges == expectedRanges);
+}
+
+TEST_CASE("storage refreshes fulltext search index of changed files only")
+{
+	FilePath previousDbFilePath;
+	{
+		TestStorage storage;
+		injectFullTextSearchFiles(storage, {{L"a.cpp", "foo bar\n"}, {L"b.cpp", "int foo;\n"}});
+		storage.writeFullTextSearchIndex();
+		previousDbFilePath = storage.getIndexDbFilePath();
+	}
+
+	// the refresh starts from a copy of the previous database like the indexer does
+	const FilePath refreshedDbFilePath(L"data/testRefreshed.sqlite");
+	FileSystem::copyFile(previousDbFilePath, refreshedDbFilePath);
+
+	std::map<std::wstring, std::set<std::wstring>> fooRanges;
+	std::map<std::wstring, std::set<std::wstring>> barRanges;
+	{
+		PersistentStorage storage(refreshedDbFilePath, FilePath(L"data/testBookmarks.sqlite"));
+		storage.setup();
+
+		// the changed file is added again with the same id, so its stale entry has to be removed
+		// when preparing the refresh
+		const std::vector<FilePath> changedFilePaths = {getFullTextSearchFilePath(L"b.cpp")};
+		storage.prepareFullTextSearchIndexRefresh(previousDbFilePath, changedFilePaths);
+		storage.clearFileElements(changedFilePaths, [](int, const std::wstring&) {});
+		injectFullTextSearchFiles(storage, {{L"b.cpp", "int bar;\n"}});
+
+		storage.writeFullTextSearchIndex();
+		storage.buildCaches();
+
+		fooRanges = getLocationRangeStrings(
+			storage.getFullTextSearchLocations(L"foo", false, 0, nullptr));
+		barRanges = getLocationRangeStrings(
+			storage.getFullTextSearchLocations(L"bar", false, 0, nullptr));
+
+		removeFullTextSearchFiles(storage);
+	}
+
+	FileSystem::remove(PersistentStorage::getFullTextSearchIndexFilePath(previousDbFilePath));
+	FileSystem::remove(refreshedDbFilePath);
+
+	REQUIRE(
+		fooRanges ==
+		std::map<std::wstring, std::set<std::wstring>>(
+			{{getFullTextSearchFilePath(L"a.cpp").wstr(), {L"1:1-1:3"}}}));
+	REQUIRE(
+		barRanges ==
+		std::map<std::wstring, std::set<std::wstring>>(
+			{{getFullTextSearchFilePath(L"a.cpp").wstr(), {L"1:5-1:7"}},
+			 {getFullTextSearchFilePath(L"b.cpp").wstr(), {L"1:5-1:7"}}}));
+}
+
+TEST_CASE("storage marks database while writing with bulk profile that is not crash safe")
+{
+	ApplicationSettings* appSettings = ApplicationSettings::getInstance().get();
+	const std::string journalMode = appSettings->getStorageBulkJournalMode();
+	const std::string synchronous = appSettings->getStorageBulkSynchronous();
+
+	bool markedWithSafeProfile = true;
+	bool markedWithUnsafeProfile = false;
+	bool markedAfterWriting = true;
+	FilePath markerFilePath;
+	{
+		TestStorage storage;
+		markerFilePath = PersistentStorage::getUnsafeWriteMarkerFilePath(
+			storage.getIndexDbFilePath());
+
+		appSettings->setStorageBulkJournalMode("WAL");
+		appSettings->setStorageBulkSynchronous("NORMAL");
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		markedWithSafeProfile = markerFilePath.recheckExists();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+		appSettings->setStorageBulkJournalMode("MEMORY");
+		appSettings->setStorageBulkSynchronous("OFF");
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		markedWithUnsafeProfile = markerFilePath.recheckExists();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		markedAfterWriting = markerFilePath.recheckExists();
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+	}
+
+	appSettings->setStorageBulkJournalMode(journalMode);
+	appSettings->setStorageBulkSynchronous(synchronous);
+
+	REQUIRE_FALSE(markedWithSafeProfile);
+	REQUIRE(markedWithUnsafeProfile);
+	REQUIRE_FALSE(markedAfterWriting);
+	// a storage that is closed without crashing leaves no marker behind
+	REQUIRE_FALSE(markerFilePath.recheckExists());
+}
+
+TEST_CASE("storage validates foreign keys of database left with deferred checks")
+{
+	bool markedWhileDeferred = false;
+	FilePath markerFilePath;
+	{
+		TestStorage storage;
+		markerFilePath = PersistentStorage::getDeferredForeignKeysMarkerFilePath(
+			storage.getIndexDbFilePath());
+
+		storage.deferForeignKeyChecks();
+		const Id sourceNodeId = storage.addNode(StorageNodeData(0, L"a")).first;
+		const Id targetNodeId = storage.addNode(StorageNodeData(0, L"b")).first;
+		storage.addEdge(StorageEdgeData(0, sourceNodeId, targetNodeId));
+		storage.addEdge(StorageEdgeData(0, sourceNodeId, targetNodeId + 100));
+		markedWhileDeferred = markerFilePath.recheckExists();
+
+		// closed without validation like a crash while indexing
+	}
+
+	bool validated = false;
+	size_t edgeCount = 0;
+	{
+		PersistentStorage storage(
+			FilePath(L"data/test.sqlite"), FilePath(L"data/testBookmarks.sqlite"));
+		validated = storage.validateDeferredForeignKeys();
+		edgeCount = storage.getStorageEdges().size();
+	}
+
+	REQUIRE(markedWhileDeferred);
+	REQUIRE(validated);
+	REQUIRE(1 == edgeCount);
+	REQUIRE_FALSE(markerFilePath.recheckExists());
+}
+
+TEST_CASE("storage trail contains all paths between origin and target")
+{
+	TestStorage storage;
+	std::map<std::wstring, Id> ids = injectTrailGraph(storage);
+
+	REQUIRE(
+		getTrailNodeNames(storage, ids, true, false) ==
+		std::set<std::wstring>({L"a", L"b", L"c", L"d", L"e", L"f"}));
+}
+
+TEST_CASE("storage trail with shortest paths only meets in the middle")
+{
+	TestStorage storage;
+	std::map<std::wstring, Id> ids = injectTrailGraph(storage);
+
+	REQUIRE(
+		getTrailNodeNames(storage, ids, true, true) ==
+		std::set<std::wstring>({L"a", L"b", L"c", L"d"}));
+}
+
+TEST_CASE("storage trail follows edges in both directions if undirected")
+{
+	TestStorage storage;
+	std::map<std::wstring, Id> ids = injectTrailGraph(storage);
+
+	REQUIRE(getTrailNodeNames(storage, ids, true, false).count(L"h") == 0);
+	REQUIRE(getTrailNodeNames(storage, ids, false, false).count(L"h") == 1);
+
+	REQUIRE(getTrailNodeNames(storage, ids, true, true).count(L"h") == 0);
+	REQUIRE(
+		getTrailNodeNames(storage, ids, false, true) ==
+		std::set<std::wstring>({L"a", L"b", L"c", L"d", L"h"}));
+}
+
+TEST_CASE("storage trail only contains origin if node budget is exhausted")
+{
+	TestStorage storage;
+	std::map<std::wstring, Id> ids = injectTrailGraph(storage);
+
+	for (bool shortestPathsOnly: {false, true})
+	{
+		REQUIRE(
+			getTrailNodeNames(storage, ids, true, shortestPathsOnly, 2) ==
+			std::set<std::wstring>({L"a"}));
+	}
+}
+
+TEST_CASE("storage trail is empty if interrupted")
+{
+	TestStorage storage;
+	std::map<std::wstring, Id> ids = injectTrailGraph(storage);
+
+	for (bool shortestPathsOnly: {false, true})
+	{
+		REQUIRE(getTrailNodeNames(storage, ids, true, shortestPathsOnly, 0, []() {
+					return true;
+				}).empty());
+	}
+}
+
 TEST_CASE("storage saves method static")
 {
 	// TestStorage storage;
@@ -0,0 +1,183 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include "FilePath.h"
+#	include "IndexerCommandCxx.h"
+#	include "utility.h"
+#	include "utilitySourceGroupCxx.h"
+
+namespace
+{
+FilePath getLeadingIncludeDirectivesFilePath(const std::wstring& fileName)
+{
+	return FilePath(L"data/UtilitySourceGroupCxxTestSuite/leading_include_directives/" + fileName)
+		.makeAbsolute();
+}
+
+FilePath getAutomaticPchsDirectoryPath()
+{
+	return FilePath(L"data/UtilitySourceGroupCxxTestSuite/automatic_pchs").makeAbsolute();
+}
+
+FilePath getPchDirectoryPath()
+{
+	return FilePath(L"data/UtilitySourceGroupCxxTestSuite/pch").makeAbsolute();
+}
+
+std::shared_ptr<IndexerCommandCxx> createIndexerCommand(
+	const std::wstring& fileName, const std::wstring& standardFlag = L"-std=c++17")
+{
+	const FilePath sourceFilePath = getAutomaticPchsDirectoryPath().getConcatenated(fileName);
+	return std::make_shared<IndexerCommandCxx>(
+		sourceFilePath,
+		std::set<FilePath> {sourceFilePath},
+		std::set<FilePathFilter>(),
+		std::set<FilePathFilter>(),
+		getAutomaticPchsDirectoryPath(),
+		std::vector<std::wstring> {
+			L"clang++",
+			standardFlag,
+			L"-c",
+			sourceFilePath.wstr(),
+			L"-o",
+			sourceFilePath.replaceExtension(L"o").wstr()});
+}
+
+std::set<FilePath> getSourceFilePaths(const std::vector<std::wstring>& fileNames)
+{
+	std::set<FilePath> sourceFilePaths;
+	for (const std::wstring& fileName: fileNames)
+	{
+		sourceFilePaths.insert(getAutomaticPchsDirectoryPath().getConcatenated(fileName));
+	}
+	return sourceFilePaths;
+}
+}	 // namespace
+
+TEST_CASE("leading include directives skip comments and empty lines")
+{
+	const std::vector<std::string> includeDirectives = utility::getLeadingIncludeDirectives(
+		getLeadingIncludeDirectivesFilePath(L"comments.cpp"));
+
+	REQUIRE(includeDirectives.size() == 5);
+	REQUIRE(includeDirectives[0] == "#include <vector>");
+	REQUIRE(includeDirectives[1] == "#include \"a.h\"");
+	REQUIRE(includeDirectives[2] == "#include \"b.h\"");
+	REQUIRE(includeDirectives[3] == "#include <c.h>");
+	REQUIRE(includeDirectives[4] == "#include \"d.h\"");
+}
+
+TEST_CASE("leading include directives end at conditional directive")
+{
+	const std::vector<std::string> includeDirectives = utility::getLeadingIncludeDirectives(
+		getLeadingIncludeDirectivesFilePath(L"conditional.cpp"));
+
+	REQUIRE(includeDirectives.size() == 1);
+	REQUIRE(includeDirectives[0] == "#include <vector>");
+}
+
+TEST_CASE("leading include directives end at macro include")
+{
+	const std::vector<std::string> includeDirectives = utility::getLeadingIncludeDirectives(
+		getLeadingIncludeDirectivesFilePath(L"macro_include.cpp"));
+
+	REQUIRE(includeDirectives.size() == 1);
+	REQUIRE(includeDirectives[0] == "#include <vector>");
+}
+
+TEST_CASE("leading include directives of missing file are empty")
+{
+	REQUIRE(utility::getLeadingIncludeDirectives(
+				getLeadingIncludeDirectivesFilePath(L"missing.cpp"))
+				.empty());
+}
+
+TEST_CASE("automatic pch contains common prefix of leading include directives")
+{
+	const std::vector<utility::AutomaticPch> pchs = utility::getAutomaticPchs(
+		{createIndexerCommand(L"first.cpp"), createIndexerCommand(L"second.cpp")},
+		getPchDirectoryPath());
+
+	REQUIRE(pchs.size() == 1);
+
+	const utility::AutomaticPch& pch = pchs.front();
+	REQUIRE(pch.includeDirectives.size() == 2);
+	REQUIRE(pch.includeDirectives[0] == "#include <vector>");
+	REQUIRE(pch.includeDirectives[1] == "#include \"common.h\"");
+	REQUIRE(pch.sourceFilePaths == getSourceFilePaths({L"first.cpp", L"second.cpp"}));
+
+	REQUIRE(pch.inputFilePath.getParentDirectory() == getPchDirectoryPath());
+	REQUIRE(utility::isPrefix<std::wstring>(L"automatic_", pch.inputFilePath.fileName()));
+	REQUIRE(pch.outputFilePath == pch.inputFilePath.replaceExtension(L"pch"));
+	REQUIRE(utility::isAutomaticPchFilePath(pch.outputFilePath));
+	REQUIRE(pch.workingDirectory == getAutomaticPchsDirectoryPath());
+}
+
+TEST_CASE("automatic pch is built with flags of group without source and output files")
+{
+	const std::vector<utility::AutomaticPch> pchs = utility::getAutomaticPchs(
+		{createIndexerCommand(L"first.cpp"), createIndexerCommand(L"second.cpp")},
+		getPchDirectoryPath());
+
+	REQUIRE(pchs.size() == 1);
+	REQUIRE(
+		pchs.front().compilerFlags ==
+		std::vector<std::wstring>(
+			{L"-std=c++17",
+			 L"-iquote",
+			 getAutomaticPchsDirectoryPath().wstr(),
+			 L"-x",
+			 L"c++-header"}));
+}
+
+TEST_CASE("automatic pchs are grouped by preprocessor context, directory and language")
+{
+	const std::vector<utility::AutomaticPch> pchs = utility::getAutomaticPchs(
+		{createIndexerCommand(L"first.cpp"),
+		 createIndexerCommand(L"second.cpp"),
+		 createIndexerCommand(L"third.cpp", L"-std=c++14"),
+		 createIndexerCommand(L"fourth.c"),
+		 createIndexerCommand(L"fifth.c"),
+		 createIndexerCommand(L"sub/sixth.cpp")},
+		getPchDirectoryPath());
+
+	REQUIRE(pchs.size() == 2);
+
+	std::set<std::set<FilePath>> groups;
+	for (const utility::AutomaticPch& pch: pchs)
+	{
+		groups.insert(pch.sourceFilePaths);
+
+		const bool isCHeader = pch.compilerFlags.back() == L"c-header";
+		REQUIRE(
+			pch.sourceFilePaths ==
+			(isCHeader ? getSourceFilePaths({L"fourth.c", L"fifth.c"})
+					   : getSourceFilePaths({L"first.cpp", L"second.cpp"})));
+		REQUIRE(
+			pch.includeDirectives.front() ==
+			(isCHeader ? "#include <stdio.h>" : "#include <vector>"));
+	}
+	REQUIRE(groups.size() == 2);
+	REQUIRE(pchs[0].inputFilePath != pchs[1].inputFilePath);
+}
+
+TEST_CASE("automatic pch is not created for single source file")
+{
+	REQUIRE(utility::getAutomaticPchs({createIndexerCommand(L"first.cpp")}, getPchDirectoryPath())
+				.empty());
+}
+
+TEST_CASE("automatic pch is not created without common leading include directives")
+{
+	REQUIRE(utility::getAutomaticPchs(
+				{createIndexerCommand(L"first.cpp"),
+				 createIndexerCommand(L"second.cpp"),
+				 createIndexerCommand(L"seventh.cpp")},
+				getPchDirectoryPath())
+				.empty());
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
@@ -1,6 +1,10 @@
 #include "catch.hpp"
 
+#include <algorithm>
+
+#include "ContentHasher.h"
 #include "utility.h"
+#include "utilityCompression.h"
 
 TEST_CASE("trim blank spaces of string")
 {
@@ -11,3 +15,58 @@ TEST_CASE("trim blank spaces of wstring")
 {
 	REQUIRE(utility::trim(L" foo  ") == L"foo");
 }
+
+TEST_CASE("compressed lz4 block decompresses to original data")
+{
+	std::string data;
+	for (int i = 0; i < 1000; i++)
+	{
+		data += "line " + std::to_string(i % 17) + " aaaaaaaaaaaaaaaaaaaa\n";
+	}
+
+	for (const std::string& original: {std::string(), std::string("a"), data})
+	{
+		const std::string block = utility::compressLz4Block(original);
+		std::string decompressed;
+		REQUIRE(utility::decompressLz4Block(block, original.size(), decompressed));
+		REQUIRE(original == decompressed);
+	}
+
+	REQUIRE(utility::compressLz4Block(data).size() < data.size() / 4);
+}
+
+TEST_CASE("malformed lz4 block fails to decompress")
+{
+	const std::string block = utility::compressLz4Block(std::string(1000, 'a'));
+	std::string decompressed;
+
+	REQUIRE_FALSE(utility::decompressLz4Block(block, 999, decompressed));
+	REQUIRE_FALSE(utility::decompressLz4Block(block.substr(0, block.size() - 2), 1000, decompressed));
+	REQUIRE_FALSE(utility::decompressLz4Block(std::string("\x1F\x61\x00\x00", 4), 5, decompressed));
+}
+
+TEST_CASE("content hasher matches xxhash64 reference values")
+{
+	REQUIRE("ef46db3751d8e999" == ContentHasher::hashString(""));
+	REQUIRE("d24ec4f1a98c6e5b" == ContentHasher::hashString("a"));
+	REQUIRE("44bc2cf5ad770999" == ContentHasher::hashString("abc"));
+}
+
+TEST_CASE("content hasher hashes data independently of the chunks it is passed in")
+{
+	std::string data;
+	for (int i = 0; i < 1000; i++)
+	{
+		data += std::to_string(i * i) + " ";
+	}
+
+	for (size_t chunkSize: {1, 7, 31, 32, 33, 1000})
+	{
+		ContentHasher hasher;
+		for (size_t pos = 0; pos < data.size(); pos += chunkSize)
+		{
+			hasher.update(data.data() + pos, std::min(chunkSize, data.size() - pos));
+		}
+		REQUIRE(ContentHasher::hashString(data) == hasher.getHexDigest());
+	}
+}
@@ -0,0 +1,75 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "WorkStealingExecutor.h"
+
+TEST_CASE("work stealing executor visits every index exactly once")
+{
+	WorkStealingExecutor executor(3);
+
+	std::vector<std::atomic<int>> visits(1000);
+	for (std::atomic<int>& visit: visits)
+	{
+		visit = 0;
+	}
+
+	REQUIRE(executor.parallelFor(visits.size(), 7, [&visits](size_t i) { visits[i]++; }));
+
+	for (const std::atomic<int>& visit: visits)
+	{
+		REQUIRE(visit == 1);
+	}
+}
+
+TEST_CASE("work stealing executor runs loops without worker threads")
+{
+	WorkStealingExecutor executor(0);
+
+	std::atomic<size_t> sum(0);
+	REQUIRE(executor.parallelFor(100, 10, [&sum](size_t i) { sum += i; }));
+	REQUIRE(sum == 4950);
+}
+
+TEST_CASE("work stealing executor balances skewed work")
+{
+	WorkStealingExecutor executor(3);
+
+	// all slow items end up in the range of a single thread, the others have to steal them
+	std::atomic<size_t> count(0);
+	REQUIRE(executor.parallelFor(40, 1, [&count](size_t i) {
+		if (i < 10)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		count++;
+	}));
+	REQUIRE(count == 40);
+}
+
+TEST_CASE("work stealing executor stops starting chunks when cancelled")
+{
+	WorkStealingExecutor executor(2);
+
+	std::atomic<size_t> count(0);
+	const bool finished = executor.parallelFor(
+		10000, 1, [&count](size_t i) { count++; }, [&count]() { return count >= 100; });
+
+	REQUIRE_FALSE(finished);
+	REQUIRE(count >= 100);
+	REQUIRE(count < 10000);
+}
+
+TEST_CASE("work stealing executor runs nested loops")
+{
+	WorkStealingExecutor executor(2);
+
+	std::atomic<size_t> count(0);
+	REQUIRE(executor.parallelFor(8, 1, [&](size_t i) {
+		executor.parallelFor(50, 5, [&count](size_t j) { count++; });
+	}));
+	REQUIRE(count == 400);
+}